@@ -33,6 +33,7 @@
 #include <inviwo/core/datastructures/representationfactory.h>
 #include <inviwo/core/datastructures/representationconverterfactory.h>
 #include <inviwo/core/datastructures/representationfactorymanager.h>
+#include <inviwo/core/util/evaluationprofiler.h>
 
 #include <typeindex>
 #include <mutex>
@@ -225,6 +226,7 @@ const T* Data<Self, Repr>::getValidRepresentation() const {
     if (auto package = factory->getRepresentationConverter(lastValidRepresentation_->getTypeIndex(),
                                                            std::type_index(typeid(T)))) {
         for (auto converter : package->getConverters()) {
+            EvaluationProfiler::Scope scope("convert", typeid(*converter));
             auto dest = converter->getConverterID().second;
             auto it = representations_.find(dest);
             if (it != representations_.end()) {  // Next repr. already exist, just update it
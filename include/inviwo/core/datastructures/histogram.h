@@ -32,7 +32,9 @@
 #include <inviwo/core/common/inviwocoredefine.h>
 #include <inviwo/core/util/glm.h>
 
+#include <array>
 #include <iterator>
+#include <limits>
 #include <vector>
 
 namespace inviwo {
@@ -73,11 +75,79 @@ protected:
     double maximumBinCount_;
 };
 
+class HistogramContainer;
+
+namespace util {
+
+/**
+ * Accumulates integer histogram bins and statistics for data with up to four components.
+ * Separate parts of the data can be accumulated in parallel into separate accumulators, which are
+ * then combined using merge(). A fine accumulator can be rebinned to a different range and bin
+ * count without touching the data again.
+ */
+class IVW_CORE_API HistogramAccumulator {
+public:
+    HistogramAccumulator() = default;
+
+    /**
+     * Create an accumulator for values of type T. For integral types the number of bins is
+     * limited to the number of values in \p dataRange.
+     */
+    template <typename T>
+    static HistogramAccumulator create(dvec2 dataRange, size_t bins);
+
+    /**
+     * Add the values in [begin, end). Only every \p stride value is used, strides larger than one
+     * require random access iterators.
+     */
+    template <typename Iter>
+    void add(Iter begin, Iter end, size_t stride = 1);
+
+    /**
+     * Add the bins and statistics of \p other, which has to have the same range and bins.
+     */
+    void merge(const HistogramAccumulator& other);
+
+    /**
+     * Redistribute the bins into \p bins bins over \p dataRange. Each bin is moved as a whole,
+     * using its lower edge for integral data, where a bin holds a single value, and its center
+     * otherwise. Bins outside of \p dataRange are dropped, the statistics are kept as is.
+     */
+    HistogramAccumulator rebin(dvec2 dataRange, size_t bins) const;
+
+    HistogramContainer toContainer() const;
+
+    dvec2 getDataRange() const { return dataRange_; }
+    size_t getBins() const { return bins_; }
+    size_t getComponents() const { return extent_; }
+    size_t getCount() const { return count_; }
+    bool isIntegral() const { return integral_; }
+    const std::vector<size_t>& getCounts(size_t component) const { return counts_[component]; }
+
+private:
+    HistogramAccumulator(dvec2 dataRange, size_t bins, size_t extent, bool integral);
+
+    dvec2 dataRange_{0.0, 0.0};
+    size_t bins_ = 0;
+    size_t extent_ = 0;
+    bool integral_ = false;
+
+    std::array<std::vector<size_t>, 4> counts_;
+    std::array<double, 4> min_;
+    std::array<double, 4> max_;
+    std::array<double, 4> sum_;
+    std::array<double, 4> sum2_;
+    size_t count_ = 0;
+};
+
+}  // namespace util
+
 class IVW_CORE_API HistogramContainer {
 public:
     HistogramContainer() = default;
     template <typename FirstIter, typename LastIter>
     HistogramContainer(dvec2 range, size_t bins, FirstIter begin, LastIter end);
+    explicit HistogramContainer(std::vector<NormalizedHistogram> histograms);
 
     const NormalizedHistogram& operator[](size_t i) const;
     const NormalizedHistogram& get(size_t i) const;
@@ -94,10 +164,22 @@ private:
     std::vector<NormalizedHistogram> histograms_;
 };
 
-template <typename FirstIter, typename LastIter>
-HistogramContainer::HistogramContainer(dvec2 dataRange, size_t bins, FirstIter begin,
-                                       LastIter end) {
-    using T = typename std::iterator_traits<FirstIter>::value_type;
+template <typename T>
+util::HistogramAccumulator util::HistogramAccumulator::create(dvec2 dataRange, size_t bins) {
+    constexpr size_t extent = util::rank<T>::value > 0 ? util::extent<T>::value : 1;
+    static_assert(extent <= 4, "Only types with up to four components are supported");
+
+    constexpr bool integral = !util::is_floating_point<typename util::value_type<T>::type>::value;
+    // check whether number of bins exceeds the data range only if it is an integral type
+    if constexpr (integral) {
+        bins = std::min(bins, static_cast<std::size_t>(dataRange.y - dataRange.x + 1));
+    }
+    return HistogramAccumulator(dataRange, bins, extent, integral);
+}
+
+template <typename Iter>
+void util::HistogramAccumulator::add(Iter begin, Iter end, size_t stride) {
+    using T = typename std::iterator_traits<Iter>::value_type;
 
     // a double type with the same extent as T
     using D = typename util::same_extent<T, double>::type;
@@ -106,28 +188,17 @@ HistogramContainer::HistogramContainer(dvec2 dataRange, size_t bins, FirstIter b
 
     constexpr size_t extent = util::rank<T>::value > 0 ? util::extent<T>::value : 1;
 
-    // check whether number of bins exceeds the data range only if it is an integral type
-    if constexpr (!util::is_floating_point<typename util::value_type<T>::type>::value) {
-        bins = std::min(bins, static_cast<std::size_t>(dataRange.y - dataRange.x + 1));
-    }
-
-    std::array<std::vector<double>, extent> histData;
-    for (size_t i = 0; i < extent; ++i) {
-        histData[i].resize(bins, 0.0);
-    }
-
     D min(std::numeric_limits<double>::max());
     D max(std::numeric_limits<double>::lowest());
     D sum(0);
     D sum2(0);
     size_t count(0);
 
-    const D rangeMin(dataRange.x);
-    const D rangeScaleFactor(static_cast<double>(bins - 1) / (dataRange.y - dataRange.x));
-
-    for (; begin != end; ++begin) {
+    const D rangeMin(dataRange_.x);
+    const D rangeScaleFactor(static_cast<double>(bins_ - 1) / (dataRange_.y - dataRange_.x));
 
-        const auto val = static_cast<D>(*begin);
+    const auto accumulate = [&](const T& value) {
+        const auto val = static_cast<D>(value);
 
         min = glm::min(min, val);
         max = glm::max(max, val);
@@ -139,21 +210,42 @@ HistogramContainer::HistogramContainer(dvec2 dataRange, size_t bins, FirstIter b
 
         for (size_t i = 0; i < extent; ++i) {
             const auto v = util::glmcomp(ind, i);
-            if (v < bins) {
-                histData[i][v]++;
+            if (v < bins_) {
+                counts_[i][v]++;
             }
         }
-    }
+    };
 
-    const auto dcount = static_cast<double>(count);
-    const auto mean = sum / dcount;
-    const auto stddev = glm::sqrt((dcount * sum2 - sum * sum) / (dcount * (dcount - D{1})));
+    if constexpr (std::is_base_of_v<std::random_access_iterator_tag,
+                                    typename std::iterator_traits<Iter>::iterator_category>) {
+        const auto size = static_cast<size_t>(std::distance(begin, end));
+        stride = std::max(stride, size_t{1});
+        for (size_t i = 0; i < size; i += stride) {
+            accumulate(begin[i]);
+        }
+    } else {
+        for (; begin != end; ++begin) {
+            accumulate(*begin);
+        }
+    }
 
     for (size_t i = 0; i < extent; ++i) {
-        histograms_.emplace_back(dataRange, std::move(histData[i]), util::glmcomp(min, i),
-                                 util::glmcomp(max, i), util::glmcomp(mean, i),
-                                 util::glmcomp(stddev, i));
+        min_[i] = std::min(min_[i], static_cast<double>(util::glmcomp(min, i)));
+        max_[i] = std::max(max_[i], static_cast<double>(util::glmcomp(max, i)));
+        sum_[i] += util::glmcomp(sum, i);
+        sum2_[i] += util::glmcomp(sum2, i);
     }
+    count_ += count;
+}
+
+template <typename FirstIter, typename LastIter>
+HistogramContainer::HistogramContainer(dvec2 dataRange, size_t bins, FirstIter begin,
+                                       LastIter end) {
+    using T = typename std::iterator_traits<FirstIter>::value_type;
+
+    auto acc = util::HistogramAccumulator::create<T>(dataRange, bins);
+    acc.add(begin, end);
+    *this = acc.toContainer();
 }
 
 }  // namespace inviwo
@@ -32,15 +32,18 @@
 #include <inviwo/core/common/inviwocoredefine.h>
 #include <inviwo/core/util/dispatcher.h>
 #include <inviwo/core/util/glm.h>
+#include <inviwo/core/datastructures/histogram.h>
 #include <inviwo/core/datastructures/volume/volumeram.h>
 
 #include <atomic>
+#include <functional>
 #include <memory>
 #include <vector>
 
 namespace inviwo {
 
 class HistogramSupplier;
+class VolumeBricked;
 
 class IVW_CORE_API HistogramCalculationState {
 public:
@@ -54,24 +57,51 @@ public:
 
     ~HistogramCalculationState() { *stop_ = true; }
 
+    /**
+     * Call \p callback with the final histograms, directly if they are already calculated.
+     */
     void whenDone(std::function<void(const HistogramContainer&)> callback);
+    /**
+     * Call \p callback with each intermediate estimate of the histograms and with the final
+     * histograms. The first estimate is based on a subset of the data and arrives well before the
+     * full calculation is done.
+     */
+    void whenUpdated(std::function<void(const HistogramContainer&)> callback);
 
     size_t getBins() const { return bins_; }
     dvec2 getDataRange() const { return dataRange_; }
+    bool isDone() const { return done; }
 
 private:
     std::weak_ptr<HistogramContainer> container_;
     Dispatcher<void(const HistogramContainer&)> callbacks_;
+    Dispatcher<void(const HistogramContainer&)> updateCallbacks_;
     std::vector<std::shared_ptr<std::function<void(const HistogramContainer&)>>> callbackHandles_;
     std::shared_ptr<std::atomic<bool>> stop_;
     bool done = false;
+    // Fine histogram of all data, used to rebin when only the range or bin count changes
+    std::shared_ptr<const util::HistogramAccumulator> base_;
 
     size_t bins_;
     dvec2 dataRange_;
 };
 
+/**
+ * Calculates and holds the histograms of some data. The calculation runs on the thread pool,
+ * split into parts that accumulate into separate integer bins and are merged when done. A coarse
+ * estimate from a strided subset of the data is delivered first, see
+ * HistogramCalculationState::whenUpdated. The full calculation is done at a fine resolution,
+ * such that later requests for a different bin count or a sub range only rebin the result.
+ */
 class IVW_CORE_API HistogramSupplier {
 public:
+    /// The minimum number of bins of the cached fine histogram
+    static constexpr size_t baseBins = 65536;
+    /// The approximate number of values used for the coarse estimate
+    static constexpr size_t estimateSamples = 1 << 20;
+    /// The minimum number of values handled by each task in the full calculation
+    static constexpr size_t minPartSize = 1 << 22;
+
     HistogramSupplier();
     HistogramSupplier(const HistogramSupplier& rhs);
     HistogramSupplier(HistogramSupplier&& rhs) = default;
@@ -92,8 +122,30 @@ public:
 protected:
     std::shared_ptr<HistogramCalculationState> startCalculation(
         std::shared_ptr<const VolumeRAM> volumeRam, dvec2 dataRange, size_t bins) const;
+    /**
+     * Calculate the histograms brick by brick. The bricks are split into a few ranges per thread,
+     * and each range is accumulated by one task.
+     */
+    std::shared_ptr<HistogramCalculationState> startCalculation(
+        std::shared_ptr<const VolumeBricked> volumeBricked, dvec2 dataRange, size_t bins) const;
 
 private:
+    struct Calculation {
+        /// The number of parts the data is split into, each is accumulated by a separate task
+        size_t parts;
+        /// Accumulate the given part of the data into a histogram with the given range and bins
+        std::function<util::HistogramAccumulator(size_t part, dvec2 dataRange, size_t bins)>
+            accumulate;
+        /// Accumulate a subset of the data, returns an empty accumulator if not worthwhile
+        std::function<util::HistogramAccumulator(dvec2 dataRange, size_t bins)> estimate;
+    };
+
+    std::shared_ptr<HistogramCalculationState> dispatchCalculation(Calculation calculation,
+                                                                   dvec2 dataRange,
+                                                                   size_t bins) const;
+
+    static void update(std::shared_ptr<HistogramCalculationState> state,
+                       const HistogramContainer& histograms);
     static void done(std::shared_ptr<HistogramCalculationState> state,
                      HistogramContainer histograms);
 
@@ -30,6 +30,7 @@
 #pragma once
 
 #include <inviwo/core/datastructures/image/layerram.h>
+#include <inviwo/core/datastructures/ramallocator.h>
 
 #include <algorithm>
 
@@ -48,10 +49,26 @@ public:
                                const SwizzleMask& swizzleMask = swizzlemasks::rgba,
                                InterpolationType interpolation = InterpolationType::Linear,
                                const Wrapping2D& wrap = wrapping2d::clampAll);
+    /**
+     * Create a layer with data allocated by the RAMAllocator, with init DataInit::Uninitialized
+     * the data is left uninitialized and has to be written by the caller.
+     */
+    LayerRAMPrecision(size2_t dimensions, LayerType type, DataInit init,
+                      const SwizzleMask& swizzleMask = swizzlemasks::rgba,
+                      InterpolationType interpolation = InterpolationType::Linear,
+                      const Wrapping2D& wrap = wrapping2d::clampAll);
     LayerRAMPrecision(T* data, size2_t dimensions, LayerType type = LayerType::Color,
                       const SwizzleMask& swizzleMask = swizzlemasks::rgba,
                       InterpolationType interpolation = InterpolationType::Linear,
                       const Wrapping2D& wrap = wrapping2d::clampAll);
+    /**
+     * Create a layer using data, which has to hold glm::compMul(dimensions) elements. Use
+     * allocateRAMData or adoptRAMData to create it.
+     */
+    LayerRAMPrecision(RAMData<T> data, size2_t dimensions, LayerType type = LayerType::Color,
+                      const SwizzleMask& swizzleMask = swizzlemasks::rgba,
+                      InterpolationType interpolation = InterpolationType::Linear,
+                      const Wrapping2D& wrap = wrapping2d::clampAll);
     LayerRAMPrecision(const LayerRAMPrecision<T>& rhs);
     LayerRAMPrecision<T>& operator=(const LayerRAMPrecision<T>& that);
     virtual LayerRAMPrecision<T>* clone() const override;
@@ -102,7 +119,7 @@ public:
 
 private:
     size2_t dimensions_;
-    std::unique_ptr<T[]> data_;
+    RAMData<T> data_;
     SwizzleMask swizzleMask_;
     InterpolationType interpolation_;
     Wrapping2D wrapping_;
@@ -130,15 +147,22 @@ template <typename T>
 LayerRAMPrecision<T>::LayerRAMPrecision(size2_t dimensions, LayerType type,
                                         const SwizzleMask& swizzleMask,
                                         InterpolationType interpolation, const Wrapping2D& wrapping)
+    : LayerRAMPrecision(dimensions, type, DataInit::Uninitialized, swizzleMask, interpolation,
+                        wrapping) {
+    std::fill(data_.get(), data_.get() + glm::compMul(dimensions_),
+              (type == LayerType::Depth) ? T{1} : T{0});
+}
+
+template <typename T>
+LayerRAMPrecision<T>::LayerRAMPrecision(size2_t dimensions, LayerType type, DataInit init,
+                                        const SwizzleMask& swizzleMask,
+                                        InterpolationType interpolation, const Wrapping2D& wrapping)
     : LayerRAM(type, DataFormat<T>::get())
     , dimensions_(dimensions)
-    , data_(new T[dimensions_.x * dimensions_.y]())
+    , data_(allocateRAMData<T>(glm::compMul(dimensions_), init))
     , swizzleMask_(swizzleMask)
     , interpolation_{interpolation}
-    , wrapping_{wrapping} {
-    std::fill(data_.get(), data_.get() + glm::compMul(dimensions_),
-              (type == LayerType::Depth) ? T{1} : T{0});
-}
+    , wrapping_{wrapping} {}
 
 template <typename T>
 LayerRAMPrecision<T>::LayerRAMPrecision(T* data, size2_t dimensions, LayerType type,
@@ -146,7 +170,8 @@ LayerRAMPrecision<T>::LayerRAMPrecision(T* data, size2_t dimensions, LayerType t
                                         InterpolationType interpolation, const Wrapping2D& wrapping)
     : LayerRAM(type, DataFormat<T>::get())
     , dimensions_(dimensions)
-    , data_(data ? data : new T[dimensions_.x * dimensions_.y]())
+    , data_(data ? RAMData<T>(data)
+                 : allocateRAMData<T>(glm::compMul(dimensions_), DataInit::Uninitialized))
     , swizzleMask_(swizzleMask)
     , interpolation_{interpolation}
     , wrapping_{wrapping} {
@@ -156,11 +181,22 @@ LayerRAMPrecision<T>::LayerRAMPrecision(T* data, size2_t dimensions, LayerType t
     }
 }
 
+template <typename T>
+LayerRAMPrecision<T>::LayerRAMPrecision(RAMData<T> data, size2_t dimensions, LayerType type,
+                                        const SwizzleMask& swizzleMask,
+                                        InterpolationType interpolation, const Wrapping2D& wrapping)
+    : LayerRAM(type, DataFormat<T>::get())
+    , dimensions_(dimensions)
+    , data_(std::move(data))
+    , swizzleMask_(swizzleMask)
+    , interpolation_{interpolation}
+    , wrapping_{wrapping} {}
+
 template <typename T>
 LayerRAMPrecision<T>::LayerRAMPrecision(const LayerRAMPrecision<T>& rhs)
     : LayerRAM(rhs)
     , dimensions_(rhs.dimensions_)
-    , data_(new T[dimensions_.x * dimensions_.y])
+    , data_(allocateRAMData<T>(glm::compMul(dimensions_), DataInit::Uninitialized))
     , swizzleMask_(rhs.swizzleMask_)
     , interpolation_{rhs.interpolation_}
     , wrapping_{rhs.wrapping_} {
@@ -173,7 +209,7 @@ LayerRAMPrecision<T>& LayerRAMPrecision<T>::operator=(const LayerRAMPrecision<T>
         LayerRAM::operator=(that);
 
         const auto dim = that.dimensions_;
-        auto data = std::make_unique<T[]>(dim.x * dim.y);
+        auto data = allocateRAMData<T>(glm::compMul(dim), DataInit::Uninitialized);
         std::memcpy(data.get(), that.data_.get(), dim.x * dim.y * sizeof(T));
         data_.swap(data);
 
@@ -211,7 +247,7 @@ const void* LayerRAMPrecision<T>::getData() const {
 
 template <typename T>
 void inviwo::LayerRAMPrecision<T>::setData(void* d, size2_t dimensions) {
-    std::unique_ptr<T[]> data(static_cast<T*>(d));
+    RAMData<T> data(static_cast<T*>(d));
     data_.swap(data);
     std::swap(dimensions_, dimensions);
 }
@@ -219,7 +255,7 @@ void inviwo::LayerRAMPrecision<T>::setData(void* d, size2_t dimensions) {
 template <typename T>
 void LayerRAMPrecision<T>::setDimensions(size2_t dimensions) {
     if (dimensions != dimensions_) {
-        auto data = std::make_unique<T[]>(dimensions.x * dimensions.y);
+        auto data = allocateRAMData<T>(glm::compMul(dimensions));
         data_.swap(data);
         std::swap(dimensions, dimensions_);
     }
@@ -0,0 +1,221 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#pragma once
+
+#include <inviwo/core/common/inviwocoredefine.h>
+
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <type_traits>
+
+namespace inviwo {
+
+/**
+ * How the data of a new RAM representation is initialized. Use Uninitialized when all the data
+ * will be overwritten anyway, to avoid touching the memory twice.
+ */
+enum class DataInit { Zero, Uninitialized };
+
+/**
+ * \ingroup datastructures
+ * Interface for allocating the memory of the data of RAM representations, see VolumeRAMPrecision
+ * and LayerRAMPrecision. New data is allocated by the allocator returned by RAMAllocator::get(),
+ * which is a PooledRAMAllocator unless replaced using RAMAllocator::set(). The data keeps a
+ * reference to the allocator it was allocated by, so the allocator can be replaced at any time.
+ */
+class IVW_CORE_API RAMAllocator {
+public:
+    /// All allocations have to be aligned to at least this many bytes
+    static constexpr size_t alignment = 64;
+
+    struct Stats {
+        size_t allocations = 0;      ///< Number of allocations
+        size_t reused = 0;           ///< Number of allocations that reused pooled memory
+        size_t bytesInUse = 0;       ///< Bytes currently handed out
+        size_t peakBytesInUse = 0;   ///< Maximum of bytesInUse
+        size_t bytesPooled = 0;      ///< Bytes kept in the pool for reuse
+        size_t buffersPooled = 0;    ///< Number of allocations kept in the pool
+        size_t bytesFreed = 0;       ///< Bytes returned to the system
+        size_t hugePageBytes = 0;    ///< Bytes currently handed out that use huge pages
+    };
+
+    virtual ~RAMAllocator() = default;
+
+    /**
+     * Allocate at least size bytes aligned to RAMAllocator::alignment. The memory is not
+     * initialized.
+     * @throws std::bad_alloc if the allocation fails
+     */
+    virtual void* allocate(size_t size) = 0;
+
+    /**
+     * Release memory from allocate, size has to be the size passed to allocate.
+     */
+    virtual void deallocate(void* ptr, size_t size) noexcept = 0;
+
+    virtual Stats getStats() const = 0;
+
+    /**
+     * The allocator used for new data of RAM representations
+     */
+    static std::shared_ptr<RAMAllocator> get();
+
+    /**
+     * Replace the allocator used for new data, nullptr restores the default PooledRAMAllocator.
+     */
+    static void set(std::shared_ptr<RAMAllocator> allocator);
+};
+
+/**
+ * \ingroup datastructures
+ * The default RAMAllocator. All allocations are aligned to 64 bytes, allocations of at least 2 MB
+ * are aligned to 2 MB and marked for transparent huge pages where supported.
+ *
+ * Released memory is not returned to the system right away but kept in a pool, sorted into size
+ * classes with a spacing of 1/8 of a power of two. A later allocation of the same size class
+ * reuses the memory, which avoids the page faults and zeroing of fresh memory when, for example, a
+ * processor creates a new output of the same size for every evaluation. The pool holds at most
+ * getCapacity() bytes, the least recently released memory is freed first.
+ */
+class IVW_CORE_API PooledRAMAllocator : public RAMAllocator {
+public:
+    static constexpr size_t hugePageSize = size_t{2} << 20;
+    /// Smaller allocations are not pooled
+    static constexpr size_t minPoolSize = size_t{64} << 10;
+    static constexpr size_t defaultCapacity = size_t{256} << 20;
+
+    explicit PooledRAMAllocator(size_t capacity = defaultCapacity);
+    PooledRAMAllocator(const PooledRAMAllocator&) = delete;
+    PooledRAMAllocator& operator=(const PooledRAMAllocator&) = delete;
+    /// Frees all pooled memory
+    virtual ~PooledRAMAllocator();
+
+    /**
+     * Allocate at least size bytes, from the pool if possible.
+     * @throws std::bad_alloc if the allocation fails
+     */
+    virtual void* allocate(size_t size) override;
+    virtual void deallocate(void* ptr, size_t size) noexcept override;
+    virtual Stats getStats() const override;
+
+    /**
+     * Set the maximum number of bytes kept in the pool, pooled memory exceeding the new capacity
+     * is freed. Setting the capacity to 0 disables the pooling.
+     */
+    void setCapacity(size_t bytes);
+    size_t getCapacity() const;
+
+    /**
+     * Free all pooled memory
+     */
+    void trim();
+
+    /**
+     * The size class an allocation of size bytes is rounded up to
+     */
+    static size_t sizeClass(size_t size);
+
+    /**
+     * The allocator used by RAMAllocator::get() unless replaced, its capacity is set by the
+     * "RAM Pool Capacity" system setting.
+     */
+    static std::shared_ptr<PooledRAMAllocator> getDefault();
+
+private:
+    class Pool;
+    std::unique_ptr<Pool> pool_;
+};
+
+/**
+ * Deleter for the data of RAM representations. The data is either allocated by a RAMAllocator or
+ * with new[], which is the case for data handed over to the representations by readers and such.
+ * The data can also be memory owned by some other object, like a NumPy array, that is kept alive
+ * until the data is released.
+ */
+template <typename T>
+class RAMDeleter {
+public:
+    /// Deleter for data allocated with new[]
+    RAMDeleter() = default;
+    /// Deleter for data allocated with allocator->allocate(size)
+    RAMDeleter(std::shared_ptr<RAMAllocator> allocator, size_t size)
+        : size_{size}, allocator_{std::move(allocator)} {}
+    /// Deleter for data owned by owner, the data is released by releasing owner
+    explicit RAMDeleter(std::shared_ptr<void> owner) : owner_{std::move(owner)} {}
+
+    void operator()(T* ptr) const noexcept {
+        if (owner_) {
+            owner_.reset();
+        } else if (allocator_) {
+            allocator_->deallocate(ptr, size_);
+            allocator_.reset();
+        } else {
+            delete[] ptr;
+        }
+    }
+
+private:
+    size_t size_ = 0;
+    mutable std::shared_ptr<RAMAllocator> allocator_;
+    mutable std::shared_ptr<void> owner_;
+};
+
+template <typename T>
+using RAMData = std::unique_ptr<T[], RAMDeleter<T>>;
+
+/**
+ * Wrap data owned by owner without copying it. The owner is kept alive until the returned data is
+ * released, and has to keep data valid until then.
+ */
+template <typename T>
+RAMData<T> adoptRAMData(T* data, std::shared_ptr<void> owner) {
+    return RAMData<T>(data, RAMDeleter<T>{std::move(owner)});
+}
+
+/**
+ * Allocate data for count elements of type T using allocator, by default RAMAllocator::get().
+ * Types that are not trivially copyable are allocated with new[] and always value initialized.
+ */
+template <typename T>
+RAMData<T> allocateRAMData(size_t count, DataInit init = DataInit::Zero,
+                           std::shared_ptr<RAMAllocator> allocator = RAMAllocator::get()) {
+    if constexpr (std::is_trivially_copyable_v<T> && std::is_trivially_destructible_v<T>) {
+        const size_t size = count * sizeof(T);
+        auto ptr = static_cast<T*>(allocator->allocate(size));
+        auto data = RAMData<T>(ptr, RAMDeleter<T>{std::move(allocator), size});
+        if (init == DataInit::Zero) std::memset(data.get(), 0, size);
+        return data;
+    } else {
+        return RAMData<T>(new T[count]());
+    }
+}
+
+}  // namespace inviwo
@@ -0,0 +1,212 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#pragma once
+
+#include <inviwo/core/common/inviwocoredefine.h>
+#include <inviwo/core/datastructures/volume/volumerepresentation.h>
+#include <inviwo/core/datastructures/volume/volume.h>
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace inviwo {
+
+class VolumeRAM;
+
+namespace kind {
+struct Bricked {};
+}  // namespace kind
+
+/**
+ * \ingroup datastructures
+ * \brief Interface for loading bricks of a VolumeBricked.
+ * @see RawVolumeBrickLoader
+ */
+class IVW_CORE_API VolumeBrickLoader {
+public:
+    virtual ~VolumeBrickLoader() = default;
+
+    /**
+     * Load the voxels of the brick starting at voxel \p offset with the size \p extent into
+     * \p dest. \p dest has room for glm::compMul(extent) voxels linearized in x, then y, then z.
+     * Will be called concurrently from several threads.
+     * @throws DataReaderException if the brick could not be loaded
+     */
+    virtual void loadBrick(size3_t offset, size3_t extent, void* dest) const = 0;
+};
+
+/**
+ * \ingroup datastructures
+ * \brief A volume representation that is divided into bricks, which are loaded on demand.
+ *
+ * The volume is divided into bricks of size getBrickSize(), the bricks along the upper borders
+ * might be smaller. Bricks are numbered in x, then y, then z order, see getBrickCounts().
+ * Bricks are loaded by a VolumeBrickLoader when they are requested and kept in a least recently
+ * used cache of bounded size, which allows processing volumes that are larger than the available
+ * memory brick by brick. The bricks and the cache are shared between clones of the
+ * representation.
+ *
+ * Algorithms that only need to look at each voxel once should use forEachBrick(), which
+ * prefetches the following bricks on the thread pool while the current brick is processed.
+ * readRegion() assembles a part of the volume into a VolumeRAM.
+ *
+ * A VolumeBricked can be converted to a VolumeRAM of the whole volume, given that it fits in
+ * memory. There is no conversion back, hence editing a volume invalidates the bricks.
+ *
+ * \code{.cpp}
+ * auto loader = std::make_shared<RawVolumeBrickLoader>(file, 0, true, dims, DataFloat32::get());
+ * auto volume = std::make_shared<Volume>(
+ *     std::make_shared<VolumeBricked>(loader, dims, DataFloat32::get(), size3_t{64}));
+ *
+ * double sum = 0.0;
+ * volume->getRepresentation<VolumeBricked>()->forEachBrick([&](const VolumeRAM& brick, size3_t) {
+ *     ...
+ * });
+ * \endcode
+ *
+ * @see util::getBrickedRepresentation
+ */
+class IVW_CORE_API VolumeBricked : public VolumeRepresentation {
+public:
+    /**
+     * The default maximum size of the brick cache in bytes
+     */
+    static constexpr size_t defaultCacheSize = size_t{512} * 1024 * 1024;
+
+    /**
+     * Create a bricked representation of a volume of size \p dimensions.
+     * @param loader used to load the bricks
+     * @param dimensions of the volume
+     * @param format of the volume
+     * @param brickSize size of the bricks, components of zero will use the volume dimensions
+     * @param cacheSize maximum size in bytes of the bricks kept in memory
+     */
+    VolumeBricked(std::shared_ptr<const VolumeBrickLoader> loader, size3_t dimensions,
+                  const DataFormatBase* format, size3_t brickSize = size3_t{64},
+                  size_t cacheSize = defaultCacheSize,
+                  const SwizzleMask& swizzleMask = swizzlemasks::rgba,
+                  InterpolationType interpolation = InterpolationType::Linear,
+                  const Wrapping3D& wrapping = wrapping3d::clampAll);
+    VolumeBricked(const VolumeBricked& rhs) = default;
+    VolumeBricked& operator=(const VolumeBricked& that) = default;
+    virtual VolumeBricked* clone() const override;
+    virtual ~VolumeBricked() = default;
+
+    virtual std::type_index getTypeIndex() const override final;
+
+    virtual void setDimensions(size3_t dimensions) override;
+    virtual const size3_t& getDimensions() const override;
+
+    virtual void setSwizzleMask(const SwizzleMask& mask) override;
+    virtual SwizzleMask getSwizzleMask() const override;
+
+    virtual void setInterpolation(InterpolationType interpolation) override;
+    virtual InterpolationType getInterpolation() const override;
+
+    virtual void setWrapping(const Wrapping3D& wrapping) override;
+    virtual Wrapping3D getWrapping() const override;
+
+    size3_t getBrickSize() const;
+    /**
+     * Number of bricks along each axis
+     */
+    size3_t getBrickCounts() const;
+    size_t getNumberOfBricks() const;
+
+    /**
+     * Position of the first voxel of brick \p brick
+     */
+    size3_t getBrickOffset(size_t brick) const;
+    /**
+     * Size of brick \p brick, which is smaller than the brick size along the upper borders
+     */
+    size3_t getBrickExtent(size_t brick) const;
+
+    /**
+     * Indices of all bricks intersecting the region starting at \p offset of size \p extent
+     */
+    std::vector<size_t> getBricks(size3_t offset, size3_t extent) const;
+
+    /**
+     * Returns the voxels of brick \p brick, loading them if they are not in the cache. The
+     * returned brick stays valid when it is evicted from the cache.
+     * @throws DataReaderException if the brick could not be loaded
+     */
+    std::shared_ptr<const VolumeRAM> getBrick(size_t brick) const;
+
+    /**
+     * Start loading brick \p brick on the thread pool, if it is not in the cache already.
+     * Does nothing if there is no thread pool.
+     */
+    void prefetch(size_t brick) const;
+
+    /**
+     * Call \p callback for each brick with the voxels of the brick and the position of its first
+     * voxel, in the order of the brick indices. The \p prefetch following bricks are loaded in
+     * the background.
+     */
+    void forEachBrick(const std::function<void(const VolumeRAM& brick, size3_t offset)>& callback,
+                      size_t prefetch = 4) const;
+
+    /**
+     * Copy the region starting at \p offset of size \p extent into a new VolumeRAM, only the
+     * bricks intersecting the region are loaded.
+     */
+    std::shared_ptr<VolumeRAM> readRegion(size3_t offset, size3_t extent) const;
+    /**
+     * Copy the region starting at \p offset with the size of \p dest into \p dest
+     */
+    void readRegion(size3_t offset, VolumeRAM& dest) const;
+
+    /**
+     * Maximum size in bytes of the bricks kept in the cache
+     */
+    size_t getCacheSize() const;
+    void setCacheSize(size_t bytes);
+    /**
+     * Remove all bricks from the cache
+     */
+    void clearCache() const;
+
+private:
+    class Bricks;
+    std::shared_ptr<Bricks> bricks_;
+    SwizzleMask swizzleMask_;
+    InterpolationType interpolation_;
+    Wrapping3D wrapping_;
+};
+
+template <>
+struct representation_traits<Volume, kind::Bricked> {
+    using type = VolumeBricked;
+};
+
+}  // namespace inviwo
@@ -33,6 +33,7 @@
 #include <inviwo/core/datastructures/representationconverter.h>
 #include <inviwo/core/datastructures/volume/volumeram.h>
 #include <inviwo/core/datastructures/volume/volumedisk.h>
+#include <inviwo/core/datastructures/volume/volumebricked.h>
 #include <inviwo/core/datastructures/volume/volumeramprecision.h>
 
 namespace inviwo {
@@ -46,4 +47,16 @@ public:
                         std::shared_ptr<VolumeRAM> destination) const override;
 };
 
+/**
+ * Assembles all bricks of a VolumeBricked into a VolumeRAM, the whole volume has to fit in memory.
+ */
+class IVW_CORE_API VolumeBricked2RAMConverter
+    : public RepresentationConverterType<VolumeRepresentation, VolumeBricked, VolumeRAM> {
+public:
+    virtual std::shared_ptr<VolumeRAM> createFrom(
+        std::shared_ptr<const VolumeBricked> source) const override;
+    virtual void update(std::shared_ptr<const VolumeBricked> source,
+                        std::shared_ptr<VolumeRAM> destination) const override;
+};
+
 }  // namespace inviwo
@@ -30,6 +30,7 @@
 #pragma once
 
 #include <inviwo/core/datastructures/volume/volumeram.h>
+#include <inviwo/core/datastructures/ramallocator.h>
 #include <inviwo/core/util/glm.h>
 #include <inviwo/core/util/stdextensions.h>
 
@@ -47,10 +48,30 @@ public:
                                 const SwizzleMask& swizzleMask = swizzlemasks::rgba,
                                 InterpolationType interpolation = InterpolationType::Linear,
                                 const Wrapping3D& wrapping = wrapping3d::clampAll);
+    /**
+     * Create a volume with data allocated by the RAMAllocator, with init DataInit::Uninitialized
+     * the data is left uninitialized and has to be written by the caller.
+     */
+    VolumeRAMPrecision(size3_t dimensions, DataInit init,
+                       const SwizzleMask& swizzleMask = swizzlemasks::rgba,
+                       InterpolationType interpolation = InterpolationType::Linear,
+                       const Wrapping3D& wrapping = wrapping3d::clampAll);
+    /**
+     * Create a volume taking ownership of data, which has to be allocated with new[]. If data is
+     * nullptr, zero initialized data is allocated.
+     */
     VolumeRAMPrecision(T* data, size3_t dimensions,
                        const SwizzleMask& swizzleMask = swizzlemasks::rgba,
                        InterpolationType interpolation = InterpolationType::Linear,
                        const Wrapping3D& wrapping = wrapping3d::clampAll);
+    /**
+     * Create a volume using data, which has to hold glm::compMul(dimensions) elements. Use
+     * allocateRAMData or adoptRAMData to create it.
+     */
+    VolumeRAMPrecision(RAMData<T> data, size3_t dimensions,
+                       const SwizzleMask& swizzleMask = swizzlemasks::rgba,
+                       InterpolationType interpolation = InterpolationType::Linear,
+                       const Wrapping3D& wrapping = wrapping3d::clampAll);
     VolumeRAMPrecision(const VolumeRAMPrecision<T>& rhs);
     VolumeRAMPrecision<T>& operator=(const VolumeRAMPrecision<T>& that);
     virtual VolumeRAMPrecision<T>* clone() const override;
@@ -111,7 +132,7 @@ public:
 private:
     size3_t dimensions_;
     bool ownsDataPtr_;
-    std::unique_ptr<T[]> data_;
+    RAMData<T> data_;
     SwizzleMask swizzleMask_;
     InterpolationType interpolation_;
     Wrapping3D wrapping_;
@@ -139,10 +160,17 @@ template <typename T>
 VolumeRAMPrecision<T>::VolumeRAMPrecision(size3_t dimensions, const SwizzleMask& swizzleMask,
                                           InterpolationType interpolation,
                                           const Wrapping3D& wrapping)
+    : VolumeRAMPrecision(dimensions, DataInit::Zero, swizzleMask, interpolation, wrapping) {}
+
+template <typename T>
+VolumeRAMPrecision<T>::VolumeRAMPrecision(size3_t dimensions, DataInit init,
+                                          const SwizzleMask& swizzleMask,
+                                          InterpolationType interpolation,
+                                          const Wrapping3D& wrapping)
     : VolumeRAM(DataFormat<T>::get())
     , dimensions_(dimensions)
     , ownsDataPtr_(true)
-    , data_(new T[dimensions_.x * dimensions_.y * dimensions_.z]())
+    , data_(allocateRAMData<T>(glm::compMul(dimensions_), init))
     , swizzleMask_(swizzleMask)
     , interpolation_{interpolation}
     , wrapping_{wrapping} {}
@@ -155,7 +183,20 @@ VolumeRAMPrecision<T>::VolumeRAMPrecision(T* data, size3_t dimensions,
     : VolumeRAM(DataFormat<T>::get())
     , dimensions_(dimensions)
     , ownsDataPtr_(true)
-    , data_(data ? data : new T[dimensions_.x * dimensions_.y * dimensions_.z]())
+    , data_(data ? RAMData<T>(data) : allocateRAMData<T>(glm::compMul(dimensions_)))
+    , swizzleMask_(swizzleMask)
+    , interpolation_{interpolation}
+    , wrapping_{wrapping} {}
+
+template <typename T>
+VolumeRAMPrecision<T>::VolumeRAMPrecision(RAMData<T> data, size3_t dimensions,
+                                          const SwizzleMask& swizzleMask,
+                                          InterpolationType interpolation,
+                                          const Wrapping3D& wrapping)
+    : VolumeRAM(DataFormat<T>::get())
+    , dimensions_(dimensions)
+    , ownsDataPtr_(true)
+    , data_(std::move(data))
     , swizzleMask_(swizzleMask)
     , interpolation_{interpolation}
     , wrapping_{wrapping} {}
@@ -165,7 +206,7 @@ VolumeRAMPrecision<T>::VolumeRAMPrecision(const VolumeRAMPrecision<T>& rhs)
     : VolumeRAM(rhs)
     , dimensions_(rhs.dimensions_)
     , ownsDataPtr_(true)
-    , data_(new T[dimensions_.x * dimensions_.y * dimensions_.z])
+    , data_(allocateRAMData<T>(glm::compMul(dimensions_), DataInit::Uninitialized))
     , swizzleMask_(rhs.swizzleMask_)
     , interpolation_{rhs.interpolation_}
     , wrapping_{rhs.wrapping_} {
@@ -178,7 +219,7 @@ VolumeRAMPrecision<T>& VolumeRAMPrecision<T>::operator=(const VolumeRAMPrecision
     if (this != &that) {
         VolumeRAM::operator=(that);
         auto dim = that.dimensions_;
-        auto data = std::make_unique<T[]>(dim.x * dim.y * dim.z);
+        auto data = allocateRAMData<T>(glm::compMul(dim), DataInit::Uninitialized);
         std::memcpy(data.get(), that.data_.get(), dim.x * dim.y * dim.z * sizeof(T));
         data_.swap(data);
         std::swap(dim, dimensions_);
@@ -231,7 +272,7 @@ const void* VolumeRAMPrecision<T>::getData(size_t pos) const {
 
 template <typename T>
 void VolumeRAMPrecision<T>::setData(void* d, size3_t dimensions) {
-    std::unique_ptr<T[]> data(static_cast<T*>(d));
+    RAMData<T> data(static_cast<T*>(d));
     data_.swap(data);
     std::swap(dimensions_, dimensions);
 
@@ -257,7 +298,7 @@ size_t VolumeRAMPrecision<T>::getNumberOfBytes() const {
 template <typename T>
 void VolumeRAMPrecision<T>::setDimensions(size3_t dimensions) {
     if (dimensions_ != dimensions) {
-        auto data = std::make_unique<T[]>(dimensions.x * dimensions.y * dimensions.z);
+        auto data = allocateRAMData<T>(glm::compMul(dimensions));
         data_.swap(data);
         dimensions_ = dimensions;
         if (!ownsDataPtr_) data.release();
@@ -30,14 +30,42 @@
 #pragma once
 
 #include <inviwo/core/common/inviwocoredefine.h>
+#include <functional>
 #include <string>
 
 namespace inviwo {
 
 namespace util {
 
+/**
+ * Read \p bytes from \p file starting at \p offset into \p dest. The byte order of each element
+ * of \p elementSize bytes is reversed if \p littleEndian does not match the system.
+ * @param progress optional callback, called with the fraction of the data read so far.
+ * @throws DataReaderException if the file could not be opened or has less than \p bytes after
+ * \p offset
+ */
 void IVW_CORE_API readBytesIntoBuffer(const std::string& file, size_t offset, size_t bytes,
-                                      bool littleEndian, size_t elementSize, void* dest);
+                                      bool littleEndian, size_t elementSize, void* dest,
+                                      const std::function<void(float)>& progress = {});
+
+/**
+ * Copy \p bytes from \p source to \p dest. The byte order of each element of \p elementSize
+ * bytes is reversed if \p littleEndian does not match the system. \p source and \p dest may be
+ * the same buffer. The copy is split into chunks that are processed by the calling thread together
+ * with tasks in the thread pool, see util::forEachIndexParallel. The caller never waits on other
+ * pool work, hence this can be used by representation loaders, which run while the Data is locked.
+ * @param progress optional callback, called on the calling thread with the fraction of the data
+ * copied so far.
+ */
+void IVW_CORE_API copyBytesIntoBuffer(const void* source, size_t bytes, bool littleEndian,
+                                      size_t elementSize, void* dest,
+                                      const std::function<void(float)>& progress = {});
+
+/**
+ * Returns true if the system is little endian.
+ */
+bool IVW_CORE_API isSystemLittleEndian();
+
 }  // namespace util
 
 }  // namespace inviwo
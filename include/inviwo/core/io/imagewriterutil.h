@@ -32,13 +32,23 @@
 #include <inviwo/core/common/inviwocoredefine.h>
 #include <inviwo/core/util/fileextension.h>
 #include <inviwo/core/datastructures/image/layer.h>
+#include <inviwo/core/io/datawriter.h>
 
+#include <memory>
 #include <string>
 
 namespace inviwo {
 
 namespace util {
 
+/**
+ * Get a writer for layers of the file type \p extension, or of the extension of \p path if there
+ * is no writer for \p extension.
+ * @return nullptr if there is no writer for the file type
+ */
+IVW_CORE_API std::unique_ptr<DataWriterType<Layer>> getLayerWriter(
+    std::string_view path, const FileExtension& extension = FileExtension());
+
 IVW_CORE_API void saveLayer(const Layer& layer, std::string_view path,
                             const FileExtension& extension = FileExtension());
 
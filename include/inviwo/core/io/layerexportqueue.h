@@ -0,0 +1,129 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#pragma once
+
+#include <inviwo/core/common/inviwocoredefine.h>
+#include <inviwo/core/util/fileextension.h>
+
+#include <chrono>
+#include <cstddef>
+#include <deque>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace inviwo {
+
+class Layer;
+class LayerRAM;
+
+/**
+ * \ingroup dataio
+ * \brief Writes layers to disk on the thread pool, e.g. the frames of an animation.
+ *
+ * enqueue() copies the layer into a LayerRAM buffer and returns, the encoding and writing of the
+ * file is done by a DataWriter on the thread pool. Hence the next frame can be rendered while the
+ * previous frames are being encoded. The buffers are recycled once a frame is written. At most
+ * getCapacity() frames are pending at a time; when the queue is full, enqueue() blocks until the
+ * oldest frame is written, which bounds the memory used by the buffers.
+ *
+ * Without a thread pool the layers are written directly in enqueue(). Writers of different
+ * frames run concurrently, errors are logged and counted in the statistics.
+ *
+ * Should be used from the main thread only.
+ * @see util::saveLayer, util::saveAllCanvases
+ */
+class IVW_CORE_API LayerExportQueue {
+public:
+    using duration = std::chrono::duration<double>;
+
+    struct Statistics {
+        size_t written = 0;         ///< Number of frames written
+        size_t failed = 0;          ///< Number of frames that could not be written
+        size_t blocked = 0;         ///< Number of calls to enqueue that waited for a full queue
+        duration blockedTime{0.0};  ///< Total time enqueue waited for a full queue
+        duration writeTime{0.0};    ///< Total time spent encoding and writing frames
+        duration elapsed{0.0};      ///< Time from the first enqueue to the last finished frame
+
+        /**
+         * Frames written per second of elapsed time
+         */
+        double framesPerSecond() const;
+    };
+
+    /**
+     * @param capacity maximum number of pending frames, 0 means two per thread of the pool
+     */
+    explicit LayerExportQueue(size_t capacity = 0);
+    LayerExportQueue(const LayerExportQueue&) = delete;
+    LayerExportQueue& operator=(const LayerExportQueue&) = delete;
+    /**
+     * Waits for all pending frames
+     */
+    ~LayerExportQueue();
+
+    /**
+     * Copy \p layer and write it to \p path on the thread pool. The writer is selected by
+     * \p extension, or by the extension of \p path if there is no writer for \p extension, like
+     * in util::saveLayer. Blocks while the queue is full.
+     * @return false if there is no writer for the file type, true otherwise
+     */
+    bool enqueue(const Layer& layer, std::string_view path,
+                 const FileExtension& extension = FileExtension());
+
+    /**
+     * Wait until all pending frames are written
+     */
+    void wait();
+
+    size_t getCapacity() const;
+    /**
+     * Number of frames that are not written yet
+     */
+    size_t getPending() const;
+
+    Statistics getStatistics() const;
+    void resetStatistics();
+
+private:
+    struct State;
+
+    std::shared_ptr<LayerRAM> acquireBuffer(const LayerRAM& src);
+
+    size_t capacity_;
+    std::deque<std::future<void>> pending_;
+    std::shared_ptr<State> state_;
+};
+
+}  // namespace inviwo
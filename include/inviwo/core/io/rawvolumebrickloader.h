@@ -0,0 +1,94 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#pragma once
+
+#include <inviwo/core/common/inviwocoredefine.h>
+#include <inviwo/core/datastructures/volume/volumebricked.h>
+
+#include <memory>
+#include <string>
+
+namespace inviwo {
+
+namespace util {
+class MemoryMappedFile;
+}
+
+/**
+ * \class RawVolumeBrickLoader
+ * \brief A loader of bricks from raw files. Used to create VolumeBricked representations.
+ *
+ * The raw file is memory mapped, hence the operating system only reads the parts of the file
+ * covered by the requested bricks. With Layout::Linear the file contains the voxels linearized in
+ * x, then y, then z, i.e. the layout of regular raw files, and each brick is gathered row by row.
+ * With Layout::Bricked the file contains the bricks of size \p brickSize one after the other in
+ * brick index order, see util::writeBrickedRawFile. Then each brick is a contiguous part of the
+ * file, which makes loading bricks much faster for large volumes. The bricks requested from a
+ * Layout::Bricked loader have to match the bricks of the file.
+ */
+class IVW_CORE_API RawVolumeBrickLoader : public VolumeBrickLoader {
+public:
+    enum class Layout { Linear, Bricked };
+
+    /**
+     * @throws DataReaderException if the file could not be opened or is too small
+     */
+    RawVolumeBrickLoader(const std::string& rawFile, size_t offset, bool littleEndian,
+                         size3_t dimensions, const DataFormatBase* format,
+                         Layout layout = Layout::Linear, size3_t brickSize = size3_t{0});
+    virtual ~RawVolumeBrickLoader();
+
+    virtual void loadBrick(size3_t offset, size3_t extent, void* dest) const override;
+
+    Layout getLayout() const { return layout_; }
+
+private:
+    std::unique_ptr<util::MemoryMappedFile> file_;
+    size_t offset_;
+    bool littleEndian_;
+    size3_t dimensions_;
+    const DataFormatBase* format_;
+    Layout layout_;
+    size3_t brickSize_;
+};
+
+namespace util {
+
+/**
+ * Write all bricks of \p volume to \p filePath in brick index order, in the byte order of the
+ * system. The file can be read using a RawVolumeBrickLoader with Layout::Bricked and the brick
+ * size of \p volume. Only a few bricks are kept in memory at a time.
+ * @throws DataWriterException if the file could not be written
+ */
+IVW_CORE_API void writeBrickedRawFile(const VolumeBricked& volume, const std::string& filePath);
+
+}  // namespace util
+
+}  // namespace inviwo
@@ -36,7 +36,10 @@
 #include <inviwo/core/datastructures/diskrepresentation.h>
 #include <inviwo/core/datastructures/volume/volumerepresentation.h>
 
+#include <any>
+#include <functional>
 #include <string>
+#include <string_view>
 #include <memory>
 
 namespace inviwo {
@@ -45,21 +48,69 @@ namespace inviwo {
  * \class RawVolumeRAMLoader
  * \brief A loader of raw files. Used to create VolumeRAM representations.
  * This class us used by the DatVolumeSequenceReader, IvfVolumeReader and RawVolumeReader.
+ *
+ * In Mode::Read the data is read into a newly allocated buffer. In Mode::MemoryMap the file is
+ * memory mapped instead. If the byte order of the file matches the system and the data is
+ * suitably aligned, the created VolumeRAM uses the mapped memory directly, i.e. no data is copied
+ * and the operating system pages in the data when it is accessed. Changes to the VolumeRAM are
+ * never written to the file. Otherwise the data is copied and byte swapped from the mapping.
+ * Note that the file must not be modified while a memory mapped volume uses it.
+ *
+ * @see util::loadVolumeRAMAsync to load the data without blocking the calling thread.
  */
-
 class IVW_CORE_API RawVolumeRAMLoader : public DiskRepresentationLoader<VolumeRepresentation> {
 public:
-    RawVolumeRAMLoader(const std::string& rawFile, size_t offset, bool littleEndian);
+    enum class Mode { Read, MemoryMap };
+
+    RawVolumeRAMLoader(const std::string& rawFile, size_t offset, bool littleEndian,
+                       Mode mode = Mode::Read);
     virtual RawVolumeRAMLoader* clone() const override;
     virtual std::shared_ptr<VolumeRepresentation> createRepresentation(
         const VolumeRepresentation& src) const override;
     virtual void updateRepresentation(std::shared_ptr<VolumeRepresentation> dest,
                                       const VolumeRepresentation& src) const override;
 
+    Mode getMode() const { return mode_; }
+
+    /**
+     * Set a callback that is called with the fraction of the data loaded while creating or
+     * updating a representation. Might be called from any thread.
+     */
+    void setProgressCallback(std::function<void(float)> progress);
+
 private:
     std::string rawFile_;
     size_t offset_;
     bool littleEndian_;
+    Mode mode_;
+    std::function<void(float)> progress_;
+};
+
+/**
+ * \brief Reader options for how raw volume data is loaded, shared by the readers using a
+ * RawVolumeRAMLoader.
+ *
+ * Supported options:
+ *  - "MemoryMap" (bool, default false): memory map the raw file instead of reading it, see
+ *    RawVolumeRAMLoader::Mode::MemoryMap.
+ *  - "BrickSize" (size3_t, default 0): if not zero, create a VolumeBricked representation with
+ *    bricks of this size instead of a VolumeDisk, to process volumes that do not fit in memory.
+ */
+struct IVW_CORE_API RawVolumeReaderOptions {
+    /**
+     * Set option \p key to \p value
+     * @return true if \p key is a supported option and \p value has the right type
+     */
+    bool setOption(std::string_view key, const std::any& value);
+    /**
+     * @return the value of option \p key, or an empty std::any if \p key is not supported
+     */
+    std::any getOption(std::string_view key) const;
+
+    RawVolumeRAMLoader::Mode getMode() const;
+
+    bool memoryMap = false;
+    size3_t brickSize{0u};
 };
 
 }  // namespace inviwo
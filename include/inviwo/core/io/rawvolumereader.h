@@ -35,6 +35,7 @@
 #include <inviwo/core/datastructures/volume/volumedisk.h>
 #include <inviwo/core/datastructures/volume/volumeramprecision.h>
 #include <inviwo/core/io/datareader.h>
+#include <inviwo/core/io/rawvolumeramloader.h>
 #include <inviwo/core/io/volumedatareaderdialog.h>
 
 #include <memory>
@@ -61,6 +62,12 @@ public:
     virtual std::shared_ptr<Volume> readData(const std::string& filePath,
                                              MetaDataOwner* metadata) override;
 
+    /**
+     * Supports the options of RawVolumeReaderOptions.
+     */
+    virtual bool setOption(std::string_view key, std::any value) override;
+    virtual std::any getOption(std::string_view key) override;
+
     bool haveReadLittleEndian() const { return littleEndian_; }
     const DataFormatBase* getFormat() const { return format_; }
 
@@ -73,6 +80,7 @@ private:
     DataMapper dataMapper_;
     size_t byteOffset_;
     bool parametersSet_;
+    RawVolumeReaderOptions options_;
 };
 
 }  // namespace inviwo
@@ -0,0 +1,80 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#pragma once
+
+#include <inviwo/core/common/inviwocoredefine.h>
+
+#include <iosfwd>
+
+namespace ticpp {
+class Document;
+}  // namespace ticpp
+
+namespace inviwo {
+using TxDocument = ticpp::Document;
+
+namespace util {
+
+/**
+ * Writes a serialized document in a compact binary encoding. The binary encoding is used for
+ * snapshots that never leave the application, like the undo stack, where the cost of printing
+ * and parsing xml dominates. Xml remains the interchange format for workspaces on disk.
+ *
+ * The encoding starts with a magic header followed by a table of all element and attribute
+ * names, every string is length prefixed and all names are referred to by their index in the
+ * table. Consecutive sibling elements with the same name and attribute names, like the items of a
+ * list or the points of a transfer function, are written as a run where the names are stored once
+ * followed by only the attribute values of each element.
+ *
+ * The encoding stores the same document as the xml, so attribute values are still the strings
+ * written with toStr and parsed with fromStr. There is no binary representation of numbers and no
+ * bulk storage of arrays, the gain comes only from not printing, escaping, and tokenizing xml.
+ * @see readBinaryDocument
+ * @throws SerializationException
+ */
+IVW_CORE_API void writeBinaryDocument(const TxDocument& doc, std::ostream& stream);
+
+/**
+ * Reads a document written by writeBinaryDocument from the current position of the stream and
+ * appends its content to doc.
+ * @see writeBinaryDocument
+ * @throws SerializationException if the data is not a valid binary document.
+ */
+IVW_CORE_API void readBinaryDocument(std::istream& stream, TxDocument& doc);
+
+/**
+ * Checks, without consuming any input, if the next byte of the stream starts a binary document.
+ * Xml documents will never match.
+ */
+IVW_CORE_API bool isBinaryDocument(std::istream& stream);
+
+}  // namespace util
+
+}  // namespace inviwo
@@ -68,7 +68,8 @@ public:
 
     /**
      * \brief Deserialize content from a stream.
-     * @param stream Stream with content that is to be deserialized.
+     * @param stream Stream with content that is to be deserialized, either xml or data written by
+     * Serializer::writeBinary.
      * @param refPath Used to calculate paths relative to the stream source if any.
      */
     Deserializer(std::istream& stream, std::string_view refPath);
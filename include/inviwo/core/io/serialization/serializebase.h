@@ -119,7 +119,8 @@ public:
      * and de-serializer. Some of them are reference data manager,
      * (ticpp::Node) node switch and factory registration.
      *
-     * @param stream containing all xml data (for reading).
+     * @param stream containing all xml data, or data written by Serializer::writeBinary
+     * (for reading).
      * @param path A path that will be used to decode the location of data during deserialization.
      */
     SerializeBase(std::istream& stream, std::string_view path);
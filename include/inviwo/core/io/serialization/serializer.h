@@ -79,6 +79,18 @@ public:
      */
     virtual void writeFile(std::ostream& stream, bool format = false);
 
+    /**
+     * \brief Writes serialized data to stream using the binary encoding of
+     * util::writeBinaryDocument.
+     *
+     * The binary encoding is faster to write and read than xml, but should only be used for data
+     * that does not leave the application, like undo snapshots. A Deserializer will detect the
+     * encoding automatically.
+     * @param stream Stream to be written to, should be opened in binary mode.
+     * @throws SerializationException
+     */
+    virtual void writeBinary(std::ostream& stream);
+
     // std containers
     template <typename T, typename Pred = util::alwaysTrue, typename Proj = util::identity>
     void serialize(std::string_view key, const std::vector<T>& sVector,
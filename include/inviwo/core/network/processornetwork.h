@@ -42,6 +42,7 @@
 #include <inviwo/core/util/exception.h>
 
 #include <string_view>
+#include <mutex>
 
 namespace inviwo {
 
@@ -231,6 +232,9 @@ public:
      * @brief Get Property by path
      * @param path string of dot separated identifiers starting with a processor identifier followed
      * by property identifiers.
+     * Like the other lookups of the network this must not be called concurrently with changes to
+     * the network, i.e. usually it is called from the main thread. Several threads may call it at
+     * the same time while the network is not changed.
      * @return the property or nullptr if not found
      */
     Property* getProperty(std::string_view path) const;
@@ -293,9 +297,12 @@ public:
 
 private:
     void removeProcessorHelper(Processor* processor);
+    void clearPropertyPathCache();
 
     // PropertyOwnerObserver overrides
+    virtual void onDidAddProperty(Property* property, size_t index) override;
     virtual void onWillRemoveProperty(Property* property, size_t index) override;
+    virtual void onDidChangePropertyIdentifier(Property* property) override;
 
     // ProcessorObserver overrides.
     virtual void onAboutPropertyChange(Property*) override;
@@ -333,6 +340,13 @@ private:
     std::vector<Processor*> processorsInvalidating_;
 
     std::unordered_map<Processor*, Processor::NameDispatcherHandle> onIdChange_;
+
+    // Resolved property paths, cleared on any change to processors, properties, or identifiers.
+    // getProperty is const and several threads may look up paths at the same time, hence the
+    // mutex. The generation is incremented by every clear.
+    mutable std::mutex propertyPathCacheMutex_;
+    mutable std::unordered_map<std::string, Property*> propertyPathCache_;
+    size_t propertyPathCacheGeneration_ = 0;
 };
 
 template <class T>
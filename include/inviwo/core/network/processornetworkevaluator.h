@@ -35,11 +35,27 @@
 #include <inviwo/core/network/processornetworkevaluationobserver.h>
 #include <inviwo/core/network/evaluationerrorhandler.h>
 
+#include <vector>
+
 namespace inviwo {
 
 class Processor;
 class ProcessorNetwork;
 
+/**
+ * Strategy used by the ProcessorNetworkEvaluator to process the network.
+ */
+enum class EvaluationMode {
+    /// Process all processors in topological order on the calling thread.
+    Serial,
+    /// Schedule processors as a dependency graph. Processors tagged with Tag::ThreadSafe will
+    /// have their Processor::process() executed on the thread pool as soon as all their
+    /// predecessors are done. Everything else, i.e. initializeResources, inport callbacks,
+    /// observer notifications, and the process of all other processors, still happen on the
+    /// calling thread.
+    Parallel
+};
+
 class IVW_CORE_API ProcessorNetworkEvaluator : public ProcessorNetworkObserver,
                                                public ProcessorObserver,
                                                public ProcessorNetworkEvaluationObservable {
@@ -50,6 +66,13 @@ public:
     virtual ~ProcessorNetworkEvaluator() = default;
     void setExceptionHandler(EvaluationErrorHandler handler);
 
+    /**
+     * Select the evaluation strategy, the default is EvaluationMode::Serial.
+     * @see EvaluationMode
+     */
+    void setEvaluationMode(EvaluationMode mode);
+    EvaluationMode getEvaluationMode() const;
+
 private:
     // ProcessorNetworkObserver overrides
     virtual void onProcessorNetworkEvaluateRequest() override;
@@ -65,12 +88,28 @@ private:
 
     void requestEvaluate();
     void evaluate();
+    void evaluateSerial();
+    void evaluateParallel();
+
+    /**
+     * Run initializeResources and the inport onChange callbacks of the processor.
+     * @return false if any of them threw, the error has then been reported to the exception
+     * handler.
+     */
+    bool prepareProcess(Processor* processor);
+    /**
+     * Mark the processor as valid if it is still ready and notify observers that the processing
+     * is done. If error is set it will be reported to the exception handler.
+     */
+    void finishProcess(Processor* processor, std::exception_ptr error);
+    void handleNotReady(Processor* processor);
 
     ProcessorNetwork* processorNetwork_;
     // the sorted list of processors obtained through topological sorting
     std::vector<Processor*> processorsSorted_;
     bool evaulationQueued_;
     EvaluationErrorHandler exceptionHandler_;
+    EvaluationMode evaluationMode_;
 };
 
 }  // namespace inviwo
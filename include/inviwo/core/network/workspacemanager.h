@@ -91,7 +91,8 @@ public:
      *      The same refPath should be given when loading. Most often this should be the path to the
      *      saved file.
      * \param exceptionHandler A callback for handling errors.
-     * \param mode to indicate if we are saving to disk or undo-stack
+     * \param mode to indicate if we are saving to disk or undo-stack. The undo-stack uses the
+     *      binary encoding of Serializer::writeBinary, disk uses xml. Both can be loaded by load.
      */
     void save(std::ostream& stream, std::string_view refPath,
               const ExceptionHandler& exceptionHandler = StandardExceptionHandler(),
@@ -64,6 +64,13 @@ public:
     static const Tag CPU;
     static const Tag PY;
 
+    /**
+     * Marks a processor whose Processor::process() can be run on a thread pool worker while
+     * other processors are processed, see EvaluationMode::Parallel. Such a processor may only
+     * touch its own ports and properties in process(), and must not block on the main thread.
+     */
+    static const Tag ThreadSafe;
+
 private:
     std::string tag_;
 };
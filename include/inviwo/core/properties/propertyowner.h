@@ -37,6 +37,7 @@
 #include <vector>
 #include <memory>
 #include <string_view>
+#include <unordered_map>
 #include <tcb/span.hpp>
 
 namespace inviwo {
@@ -172,9 +173,19 @@ protected:
                          bool recursiveSearch = false) const;
 
 private:
+    friend Property;
+
     Property* removeProperty(std::vector<Property*>::iterator it);
     bool findPropsForComposites(TxElement*);
+
+    // Called by Property::setIdentifier around the change of the identifier
+    void indexProperty(Property* property);
+    void unindexProperty(Property* property);
+
     InvalidationLevel invalidationLevel_;
+
+    // Lookup from identifier to property, the keys refer to the identifiers of the properties.
+    std::unordered_map<std::string_view, Property*> index_;
 };
 
 template <class T>
@@ -52,6 +52,12 @@ public:
 
     virtual void onWillRemoveProperty(Property* property, size_t index);
     virtual void onDidRemoveProperty(Property* property, size_t index);
+
+    /**
+     * Called after the identifier of one of the owned properties has changed, i.e. the paths
+     * of the property and of all its sub properties are no longer the same.
+     */
+    virtual void onDidChangePropertyIdentifier(Property* property);
 };
 
 class IVW_CORE_API PropertyOwnerObservable : public Observable<PropertyOwnerObserver> {
@@ -64,6 +70,8 @@ public:
 
     void notifyObserversWillRemoveProperty(Property* property, size_t index);
     void notifyObserversDidRemoveProperty(Property* property, size_t index);
+
+    void notifyObserversDidChangePropertyIdentifier(Property* property);
 };
 
 }  // namespace inviwo
@@ -103,6 +103,11 @@ public:
     const std::string getOutputPath() const;
     const std::string getWorkspacePath() const;
     const std::string getLogToFileFileName() const;
+    /**
+     * The file to write the evaluation trace to, see EvaluationProfiler, or an empty string if
+     * --trace was not given.
+     */
+    std::string getTraceFileName() const;
     bool getQuitApplicationAfterStartup() const;
     bool getLoadWorkspaceFromArg() const;
     bool getShowSplashScreen() const;
@@ -128,6 +133,7 @@ private:
     TCLAP::ValueArg<std::string> workspace_;
     TCLAP::ValueArg<std::string> outputPath_;
     TCLAP::ValueArg<std::string> logfile_;
+    TCLAP::ValueArg<std::string> trace_;
     TCLAP::SwitchArg logConsole_;
     TCLAP::SwitchArg noSplashScreen_;
     TCLAP::SwitchArg quitAfterStartup_;
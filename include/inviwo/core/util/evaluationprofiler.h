@@ -0,0 +1,167 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#pragma once
+
+#include <inviwo/core/common/inviwocoredefine.h>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iosfwd>
+#include <memory>
+#include <string_view>
+#include <typeinfo>
+#include <vector>
+
+namespace inviwo {
+
+/**
+ * \ingroup util
+ * Records timings of the network evaluation, i.e. processor initializeResources, inport onChange
+ * callbacks and process, as well as the representation conversions in Data::getRepresentation.
+ * The profiler is always compiled in but disabled by default, when disabled a Scope costs a
+ * single atomic load. Enable it with setEnabled or by starting the application with
+ * `--trace <file>`, which writes a Chrome trace of the recorded events to file on exit.
+ *
+ * Events are recorded into a fixed size ring buffer without locking, when the buffer is full the
+ * oldest events are overwritten. Use writeChromeTrace to export the events in the Chrome trace
+ * event format, which can be opened in chrome://tracing or https://ui.perfetto.dev.
+ */
+class IVW_CORE_API EvaluationProfiler {
+public:
+    struct Event {
+        /// What was measured, e.g. "process", has to be a string with static storage duration
+        const char* category = nullptr;
+        /// The source of the event, used when no name is given, e.g. the type of a converter
+        const std::type_info* type = nullptr;
+        /// The name of the event, e.g. a processor identifier, zero terminated and truncated
+        std::array<char, 64> name{};
+        std::int64_t start = 0;     ///< nanoseconds since the creation of the profiler
+        std::int64_t duration = 0;  ///< nanoseconds
+        std::uint32_t thread = 0;   ///< id of the recording thread, see threadId()
+    };
+
+    /**
+     * Measures the time from construction to destruction if the profiler is enabled at
+     * construction. The name has to stay valid during the lifetime of the scope.
+     */
+    class Scope {
+    public:
+        Scope(const char* category, std::string_view name) noexcept
+            : category_{category}, name_{name}, type_{nullptr}, start_{begin()} {}
+        Scope(const char* category, const std::type_info& type) noexcept
+            : category_{category}, name_{}, type_{&type}, start_{begin()} {}
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+        ~Scope() {
+            if (start_ >= 0) EvaluationProfiler::get().record(category_, name_, type_, start_);
+        }
+
+    private:
+        static std::int64_t begin() noexcept {
+            auto& profiler = EvaluationProfiler::get();
+            return profiler.isEnabled() ? profiler.now() : -1;
+        }
+
+        const char* category_;
+        std::string_view name_;
+        const std::type_info* type_;
+        std::int64_t start_;
+    };
+
+    static EvaluationProfiler& get();
+
+    EvaluationProfiler(const EvaluationProfiler&) = delete;
+    EvaluationProfiler& operator=(const EvaluationProfiler&) = delete;
+
+    /**
+     * Start or stop recording, the ring buffer is allocated the first time the profiler is
+     * enabled.
+     */
+    void setEnabled(bool enabled);
+    bool isEnabled() const noexcept { return enabled_.load(std::memory_order_acquire); }
+
+    /**
+     * Set the number of events kept in the ring buffer, the default is 65536. Clears all recorded
+     * events and must not be called while recording.
+     */
+    void setCapacity(size_t capacity);
+    size_t getCapacity() const;
+
+    /**
+     * Remove all recorded events, must not be called while recording.
+     */
+    void clear();
+
+    /**
+     * Record an event that started at start, see now(), and ends now.
+     */
+    void record(const char* category, std::string_view name, const std::type_info* type,
+                std::int64_t start) noexcept;
+    void record(const Event& event) noexcept;
+
+    /**
+     * The recorded events that are still in the ring buffer, oldest first. Can be called while
+     * recording, events that are being written are skipped.
+     */
+    std::vector<Event> getEvents() const;
+
+    /**
+     * Write the recorded events as Chrome trace event json
+     */
+    void writeChromeTrace(std::ostream& os) const;
+
+    /// nanoseconds since the creation of the profiler
+    std::int64_t now() const noexcept {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                   std::chrono::steady_clock::now() - epoch_)
+            .count();
+    }
+
+    /// A small number identifying the calling thread
+    static std::uint32_t threadId() noexcept;
+
+private:
+    EvaluationProfiler();
+
+    struct Slot {
+        std::atomic<std::uint64_t> sequence{0};
+        Event event;
+    };
+
+    std::atomic<bool> enabled_;
+    std::atomic<std::uint64_t> head_;
+    size_t capacity_;
+    std::unique_ptr<Slot[]> slots_;
+    std::chrono::steady_clock::time_point epoch_;
+};
+
+}  // namespace inviwo
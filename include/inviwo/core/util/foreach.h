@@ -33,6 +33,12 @@
 #include <inviwo/core/common/inviwoapplication.h>
 #include <inviwo/core/util/settings/systemsettings.h>
 
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <memory>
+#include <mutex>
 #include <utility>
 
 namespace inviwo {
@@ -51,6 +57,49 @@ void foreach (IT a, IT b, Callback && callback, [[maybe_unused]] size_t startInd
     }
 }
 
+template <typename Callback>
+class IndexBatch {
+public:
+    IndexBatch(size_t count, Callback& callback) : count_{count}, callback_{&callback} {}
+
+    // Take indices until there are none left. The callback is only touched after an index has been
+    // taken, so a helper task that starts after the batch is done never uses it.
+    void run() {
+        for (size_t i = next_++; i < count_; i = next_++) {
+            if (!failed_) {
+                try {
+                    (*callback_)(i);
+                } catch (...) {
+                    std::scoped_lock lock{mutex_};
+                    if (!exception_) exception_ = std::current_exception();
+                    failed_ = true;
+                }
+            }
+            if (++finished_ == count_) {
+                std::scoped_lock lock{mutex_};
+                done_.notify_all();
+            }
+        }
+    }
+
+    // Wait for the indices that are still being processed by other threads
+    void wait() {
+        std::unique_lock lock{mutex_};
+        done_.wait(lock, [&]() { return finished_ == count_; });
+        if (exception_) std::rethrow_exception(exception_);
+    }
+
+private:
+    const size_t count_;
+    Callback* callback_;
+    std::atomic<size_t> next_{0};
+    std::atomic<size_t> finished_{0};
+    std::atomic<bool> failed_{false};
+    std::mutex mutex_;
+    std::condition_variable done_;
+    std::exception_ptr exception_;
+};
+
 }  // namespace detail
 
 /**
@@ -136,9 +185,48 @@ void forEachParallel(const Iterable& iterable, Callback&& callback, size_t jobs
     const auto futures =
         forEachParallelAsync<Iterable, Callback>(iterable, std::forward<Callback>(callback), jobs);
 
+    auto& pool = InviwoApplication::getPtr()->getThreadPool();
     for (const auto& e : futures) {
-        e.wait();
+        pool.wait(e);
+    }
+}
+
+/**
+ * Call \p callback for each index in [0, count) using the calling thread together with up to
+ * \p helpers tasks in the Inviwo thread pool. The indices are handed out through a shared counter
+ * and the calling thread keeps taking indices until none are left. After that it only waits for
+ * the indices other threads are already working on, never for queued tasks, and it does not run
+ * any other tasks of the pool. Hence, unlike forEachParallel, it can be used while holding a lock,
+ * for example in a representation loader, as long as \p callback does not take that lock.
+ * If the application is not initialized or the pool is empty, all indices are processed on the
+ * calling thread.
+ *
+ * @param count the number of indices
+ * @param callback called as `callback(size_t index)`. If it throws, the remaining indices are
+ * skipped and the first exception is rethrown to the caller.
+ * @param helpers the maximum number of helper tasks, if helpers==0 (default) the pool size is used
+ */
+template <typename Callback>
+void forEachIndexParallel(size_t count, Callback&& callback, size_t helpers = 0) {
+    if (count == 0) return;
+    ThreadPool* pool = nullptr;
+    if (InviwoApplication::isInitialized()) pool = &InviwoApplication::getPtr()->getThreadPool();
+    const auto poolSize = pool ? pool->getSize() : size_t{0};
+    if (helpers == 0) helpers = poolSize;
+    helpers = std::min({helpers, poolSize, count - 1});
+
+    if (helpers == 0) {
+        for (size_t i = 0; i < count; ++i) callback(i);
+        return;
+    }
+
+    auto batch =
+        std::make_shared<detail::IndexBatch<std::remove_reference_t<Callback>>>(count, callback);
+    for (size_t i = 0; i < helpers; ++i) {
+        pool->enqueueRaw([batch]() { batch->run(); });
     }
+    batch->run();
+    batch->wait();
 }
 
 }  // namespace util
@@ -0,0 +1,153 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <list>
+#include <optional>
+#include <unordered_map>
+#include <utility>
+
+namespace inviwo {
+
+namespace util {
+
+/**
+ * \class LRUCache
+ * \brief A cache with a bounded total cost that evicts the least recently used entries first.
+ *
+ * Every entry has a cost, for example its size in bytes. When an entry is added and the total
+ * cost exceeds the capacity, the least recently used entries are evicted until the cache fits
+ * again. The entry that was just added is never evicted, hence a single entry larger than the
+ * capacity is kept until the next insertion.
+ * Accessing an entry with get() marks it as most recently used.
+ *
+ * The cache is not thread safe.
+ */
+template <typename Key, typename Value, typename Hash = std::hash<Key>>
+class LRUCache {
+public:
+    explicit LRUCache(size_t capacity) : capacity_{capacity} {}
+
+    /**
+     * Returns the value for \p key and marks it as most recently used, or std::nullopt if the
+     * key is not in the cache.
+     */
+    std::optional<Value> get(const Key& key) {
+        auto it = lookup_.find(key);
+        if (it == lookup_.end()) return std::nullopt;
+        entries_.splice(entries_.begin(), entries_, it->second);
+        return it->second->value;
+    }
+
+    /**
+     * Add or replace the value for \p key and evict the least recently used entries until the
+     * total cost is within the capacity.
+     */
+    void put(const Key& key, Value value, size_t cost = 1) {
+        if (auto it = lookup_.find(key); it != lookup_.end()) {
+            cost_ -= it->second->cost;
+            entries_.erase(it->second);
+            lookup_.erase(it);
+        }
+        entries_.push_front(Entry{key, std::move(value), cost});
+        lookup_.emplace(key, entries_.begin());
+        cost_ += cost;
+        evict();
+    }
+
+    /**
+     * Returns a pointer to the value for \p key without marking it as used, or nullptr if the
+     * key is not in the cache. The pointer is valid until the entry is removed.
+     */
+    const Value* peek(const Key& key) const {
+        auto it = lookup_.find(key);
+        return it != lookup_.end() ? &it->second->value : nullptr;
+    }
+
+    bool contains(const Key& key) const { return lookup_.find(key) != lookup_.end(); }
+
+    /**
+     * Remove \p key from the cache, returns true if it was found.
+     */
+    bool erase(const Key& key) {
+        auto it = lookup_.find(key);
+        if (it == lookup_.end()) return false;
+        cost_ -= it->second->cost;
+        entries_.erase(it->second);
+        lookup_.erase(it);
+        return true;
+    }
+
+    void clear() {
+        entries_.clear();
+        lookup_.clear();
+        cost_ = 0;
+    }
+
+    size_t size() const { return entries_.size(); }
+    bool empty() const { return entries_.empty(); }
+
+    /**
+     * The sum of the costs of all entries in the cache.
+     */
+    size_t getCost() const { return cost_; }
+    size_t getCapacity() const { return capacity_; }
+    void setCapacity(size_t capacity) {
+        capacity_ = capacity;
+        evict();
+    }
+
+private:
+    struct Entry {
+        Key key;
+        Value value;
+        size_t cost;
+    };
+
+    void evict() {
+        while (cost_ > capacity_ && entries_.size() > 1) {
+            auto& last = entries_.back();
+            cost_ -= last.cost;
+            lookup_.erase(last.key);
+            entries_.pop_back();
+        }
+    }
+
+    size_t capacity_;
+    size_t cost_ = 0;
+    std::list<Entry> entries_;
+    std::unordered_map<Key, typename std::list<Entry>::iterator, Hash> lookup_;
+};
+
+}  // namespace util
+
+}  // namespace inviwo
@@ -0,0 +1,110 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#pragma once
+
+#include <inviwo/core/common/inviwocoredefine.h>
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace inviwo {
+
+namespace util {
+
+/**
+ * \class MemoryMappedFile
+ * \brief RAII class for a read-only memory mapping of an entire file.
+ *
+ * The file contents are paged in by the operating system on first access, which avoids copying
+ * the file into a separate buffer and allows several threads to read different parts of the file
+ * concurrently. An empty file results in an empty mapping.
+ *
+ * With Mode::CopyOnWrite the mapping is also writable, modified pages are copied and the changes
+ * are never written back to the file.
+ */
+class IVW_CORE_API MemoryMappedFile {
+public:
+    /**
+     * Hint to the operating system about the expected access pattern
+     */
+    enum class Access { Normal, Sequential, Random };
+
+    enum class Mode { ReadOnly, CopyOnWrite };
+
+    /**
+     * Map the file at \p filePath into memory
+     * @throws FileException if the file cannot be opened or mapped
+     */
+    explicit MemoryMappedFile(std::string_view filePath, Access access = Access::Normal,
+                              Mode mode = Mode::ReadOnly);
+    MemoryMappedFile(const MemoryMappedFile&) = delete;
+    MemoryMappedFile& operator=(const MemoryMappedFile&) = delete;
+    MemoryMappedFile(MemoryMappedFile&& rhs) noexcept;
+    MemoryMappedFile& operator=(MemoryMappedFile&& rhs) noexcept;
+    ~MemoryMappedFile();
+
+    const char* data() const { return data_; }
+    /**
+     * Writable pointer to the mapped data, requires Mode::CopyOnWrite
+     */
+    char* mutableData() const {
+        return mode_ == Mode::CopyOnWrite ? const_cast<char*>(data_) : nullptr;
+    }
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    std::string_view view() const { return {data_, size_}; }
+    const std::string& getFilePath() const { return filePath_; }
+    Mode getMode() const { return mode_; }
+
+    /**
+     * Ask the operating system to start reading the given range of the file into memory in the
+     * background. Returns immediately, this is only a hint and might be ignored.
+     */
+    void prefetch(size_t offset, size_t size) const;
+
+private:
+    void unmap();
+
+    std::string filePath_;
+    Mode mode_;
+    const char* data_;
+    size_t size_;
+#ifdef WIN32
+    void* file_;
+    void* mapping_;
+#else
+    int file_;
+#endif
+};
+
+}  // namespace util
+
+}  // namespace inviwo
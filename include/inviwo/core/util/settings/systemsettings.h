@@ -32,6 +32,7 @@
 #include <inviwo/core/util/settings/settings.h>
 #include <inviwo/core/properties/optionproperty.h>
 #include <inviwo/core/properties/boolproperty.h>
+#include <inviwo/core/properties/buttonproperty.h>
 #include <inviwo/core/properties/ordinalproperty.h>
 #include <inviwo/core/properties/stringproperty.h>
 
@@ -51,6 +52,9 @@ public:
     StringProperty workspaceAuthor_;
     TemplateOptionProperty<UsageMode> applicationUsageMode_;
     IntSizeTProperty poolSize_;
+    IntSizeTProperty ramPoolCapacity_;  ///< Capacity of the default PooledRAMAllocator in MB
+    ButtonProperty logRAMAllocatorStats_;
+    BoolProperty parallelEvaluation_;
     BoolProperty enablePortInspectors_;
     IntProperty portInspectorSize_;
     BoolProperty enableTouchProperty_;
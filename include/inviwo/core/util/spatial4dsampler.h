@@ -34,6 +34,9 @@
 #include <inviwo/core/datastructures/coordinatetransformer.h>
 #include <inviwo/core/datastructures/datatraits.h>
 
+#include <array>
+#include <algorithm>
+
 namespace inviwo {
 
 class IVW_CORE_API Spatial4DSamplerBase {
@@ -59,6 +62,20 @@ public:
     virtual bool withinBounds(const dvec4& pos, Space space = Space::Data) const;
     virtual bool withinBounds(const vec4& pos, Space space = Space::Data) const;
 
+    /**
+     * Sample \p count positions in one call. The positions are given in a structure of arrays
+     * layout, i.e. `pos[d][i]` is component d of position i, and the samples are written to
+     * `result[0..count)`. Only the spatial components are transformed, the time component is
+     * passed through as is.
+     */
+    virtual void sampleBatch(const std::array<const double*, 4>& pos, Vector<DataDims, T>* result,
+                             size_t count, Space space = Space::Data) const;
+    /**
+     * Batched version of withinBounds, see sampleBatch for the layout of \p pos.
+     */
+    virtual void withinBoundsBatch(const std::array<const double*, 4>& pos, bool* result,
+                                   size_t count, Space space = Space::Data) const;
+
     const SpatialCoordinateTransformer<3>& getCoordinateTransformer() const;
     mat4 getModelMatrix() const;
     mat4 getWorldMatrix() const;
@@ -67,6 +84,23 @@ protected:
     virtual Vector<DataDims, T> sampleDataSpace(const dvec4& pos) const = 0;
     virtual bool withinBoundsDataSpace(const dvec4& pos) const = 0;
 
+    /**
+     * Sample a batch of data space positions. The default implementation calls sampleDataSpace
+     * for each position.
+     */
+    virtual void sampleDataSpaceBatch(const std::array<const double*, 4>& pos,
+                                      Vector<DataDims, T>* result, size_t count) const;
+    virtual void withinBoundsDataSpaceBatch(const std::array<const double*, 4>& pos, bool* result,
+                                            size_t count) const;
+
+    template <typename Callback>
+    void forEachDataSpaceChunk(const std::array<const double*, 4>& pos, size_t count, Space space,
+                               Callback&& callback) const;
+
+    static dvec4 gather(const std::array<const double*, 4>& pos, size_t i) {
+        return dvec4{pos[0][i], pos[1][i], pos[2][i], pos[3][i]};
+    }
+
     std::shared_ptr<const SpatialEntity<3>> spatialEntity_;
 };
 
@@ -134,6 +168,73 @@ bool Spatial4DSampler<DataDims, T>::withinBounds(const vec4& pos, Space space) c
     return withinBounds(static_cast<dvec4>(pos), space);
 }
 
+template <unsigned DataDims, typename T>
+void Spatial4DSampler<DataDims, T>::sampleBatch(const std::array<const double*, 4>& pos,
+                                                Vector<DataDims, T>* result, size_t count,
+                                                Space space) const {
+    forEachDataSpaceChunk(pos, count, space,
+                          [&](const auto& dataPos, size_t offset, size_t size) {
+                              sampleDataSpaceBatch(dataPos, result + offset, size);
+                          });
+}
+
+template <unsigned DataDims, typename T>
+void Spatial4DSampler<DataDims, T>::withinBoundsBatch(const std::array<const double*, 4>& pos,
+                                                      bool* result, size_t count,
+                                                      Space space) const {
+    forEachDataSpaceChunk(pos, count, space,
+                          [&](const auto& dataPos, size_t offset, size_t size) {
+                              withinBoundsDataSpaceBatch(dataPos, result + offset, size);
+                          });
+}
+
+template <unsigned DataDims, typename T>
+void Spatial4DSampler<DataDims, T>::sampleDataSpaceBatch(const std::array<const double*, 4>& pos,
+                                                         Vector<DataDims, T>* result,
+                                                         size_t count) const {
+    for (size_t i = 0; i < count; ++i) {
+        result[i] = sampleDataSpace(gather(pos, i));
+    }
+}
+
+template <unsigned DataDims, typename T>
+void Spatial4DSampler<DataDims, T>::withinBoundsDataSpaceBatch(
+    const std::array<const double*, 4>& pos, bool* result, size_t count) const {
+    for (size_t i = 0; i < count; ++i) {
+        result[i] = withinBoundsDataSpace(gather(pos, i));
+    }
+}
+
+template <unsigned DataDims, typename T>
+template <typename Callback>
+void Spatial4DSampler<DataDims, T>::forEachDataSpaceChunk(const std::array<const double*, 4>& pos,
+                                                          size_t count, Space space,
+                                                          Callback&& callback) const {
+    if (space == Space::Data) {
+        callback(pos, size_t{0}, count);
+        return;
+    }
+
+    const auto m = spatialEntity_->getCoordinateTransformer().getMatrix(space, Space::Data);
+
+    constexpr size_t chunkSize = 64;
+    std::array<std::array<double, chunkSize>, 3> buffer;
+    const std::array<const double*, 4> dataPos{buffer[0].data(), buffer[1].data(),
+                                               buffer[2].data(), nullptr};
+
+    for (size_t offset = 0; offset < count; offset += chunkSize) {
+        const size_t size = std::min(chunkSize, count - offset);
+        for (size_t i = 0; i < size; ++i) {
+            const auto p = m * vec4(static_cast<vec3>(gather(pos, offset + i)), 1.0f);
+            const auto v = vec3(p) / p.w;
+            for (size_t d = 0; d < 3; ++d) buffer[d][i] = v[d];
+        }
+        auto chunk = dataPos;
+        chunk[3] = pos[3] + offset;
+        callback(chunk, offset, size);
+    }
+}
+
 template <unsigned DataDims, typename T>
 const SpatialCoordinateTransformer<3>& Spatial4DSampler<DataDims, T>::getCoordinateTransformer()
     const {
@@ -32,6 +32,9 @@
 #include <inviwo/core/datastructures/spatialdata.h>
 #include <inviwo/core/datastructures/datatraits.h>
 
+#include <array>
+#include <algorithm>
+
 namespace inviwo {
 
 /**
@@ -60,6 +63,21 @@ public:
     virtual bool withinBounds(const Vector<SpatialDims, double>& pos, Space space) const;
     virtual bool withinBounds(const Vector<SpatialDims, float>& pos, Space space) const;
 
+    /**
+     * Sample \p count positions in one call. The positions are given in a structure of arrays
+     * layout, i.e. `pos[d][i]` is component d of position i, in the space the sampler was
+     * created with. The samples are written to `result[0..count)`. The coordinate transform is
+     * applied to the whole batch before calling sampleDataSpaceBatch, which derived samplers can
+     * override to avoid a virtual call and format conversion per sample.
+     */
+    virtual void sampleBatch(const std::array<const double*, SpatialDims>& pos,
+                             Vector<DataDims, T>* result, size_t count) const;
+    /**
+     * Batched version of withinBounds, see sampleBatch for the layout of \p pos.
+     */
+    virtual void withinBoundsBatch(const std::array<const double*, SpatialDims>& pos,
+                                   bool* result, size_t count) const;
+
     Matrix<SpatialDims, float> getBasis() const;
     Matrix<SpatialDims + 1, float> getModelMatrix() const;
     Matrix<SpatialDims + 1, float> getWorldMatrix() const;
@@ -70,6 +88,30 @@ protected:
     virtual Vector<DataDims, T> sampleDataSpace(const Vector<SpatialDims, double>& pos) const = 0;
     virtual bool withinBoundsDataSpace(const Vector<SpatialDims, double>& pos) const = 0;
 
+    /**
+     * Sample a batch of data space positions. The default implementation calls sampleDataSpace
+     * for each position.
+     */
+    virtual void sampleDataSpaceBatch(const std::array<const double*, SpatialDims>& pos,
+                                      Vector<DataDims, T>* result, size_t count) const;
+    virtual void withinBoundsDataSpaceBatch(const std::array<const double*, SpatialDims>& pos,
+                                            bool* result, size_t count) const;
+
+    /**
+     * Transform a batch of positions from the space of the sampler to data space in chunks and
+     * call \p callback(dataPos, offset, size) for each chunk.
+     */
+    template <typename Callback>
+    void forEachDataSpaceChunk(const std::array<const double*, SpatialDims>& pos, size_t count,
+                               Callback&& callback) const;
+
+    static Vector<SpatialDims, double> gather(const std::array<const double*, SpatialDims>& pos,
+                                              size_t i) {
+        Vector<SpatialDims, double> p{0.0};
+        for (unsigned int d = 0; d < SpatialDims; ++d) p[d] = pos[d][i];
+        return p;
+    }
+
     Space space_;
     const SpatialEntity<SpatialDims>& spatialEntity_;
     Matrix<SpatialDims + 1, double> transform_;
@@ -171,6 +213,67 @@ bool SpatialSampler<SpatialDims, DataDims, T>::withinBounds(const Vector<Spatial
     }
 }
 
+template <unsigned int SpatialDims, unsigned int DataDims, typename T>
+void SpatialSampler<SpatialDims, DataDims, T>::sampleBatch(
+    const std::array<const double*, SpatialDims>& pos, Vector<DataDims, T>* result,
+    size_t count) const {
+    forEachDataSpaceChunk(pos, count, [&](const auto& dataPos, size_t offset, size_t size) {
+        sampleDataSpaceBatch(dataPos, result + offset, size);
+    });
+}
+
+template <unsigned int SpatialDims, unsigned int DataDims, typename T>
+void SpatialSampler<SpatialDims, DataDims, T>::withinBoundsBatch(
+    const std::array<const double*, SpatialDims>& pos, bool* result, size_t count) const {
+    forEachDataSpaceChunk(pos, count, [&](const auto& dataPos, size_t offset, size_t size) {
+        withinBoundsDataSpaceBatch(dataPos, result + offset, size);
+    });
+}
+
+template <unsigned int SpatialDims, unsigned int DataDims, typename T>
+void SpatialSampler<SpatialDims, DataDims, T>::sampleDataSpaceBatch(
+    const std::array<const double*, SpatialDims>& pos, Vector<DataDims, T>* result,
+    size_t count) const {
+    for (size_t i = 0; i < count; ++i) {
+        result[i] = sampleDataSpace(gather(pos, i));
+    }
+}
+
+template <unsigned int SpatialDims, unsigned int DataDims, typename T>
+void SpatialSampler<SpatialDims, DataDims, T>::withinBoundsDataSpaceBatch(
+    const std::array<const double*, SpatialDims>& pos, bool* result, size_t count) const {
+    for (size_t i = 0; i < count; ++i) {
+        result[i] = withinBoundsDataSpace(gather(pos, i));
+    }
+}
+
+template <unsigned int SpatialDims, unsigned int DataDims, typename T>
+template <typename Callback>
+void SpatialSampler<SpatialDims, DataDims, T>::forEachDataSpaceChunk(
+    const std::array<const double*, SpatialDims>& pos, size_t count, Callback&& callback) const {
+    if (space_ == Space::Data) {
+        callback(pos, size_t{0}, count);
+        return;
+    }
+
+    constexpr size_t chunkSize = 64;
+    std::array<std::array<double, chunkSize>, SpatialDims> buffer;
+    std::array<const double*, SpatialDims> dataPos;
+    for (unsigned int d = 0; d < SpatialDims; ++d) dataPos[d] = buffer[d].data();
+
+    for (size_t offset = 0; offset < count; offset += chunkSize) {
+        const size_t size = std::min(chunkSize, count - offset);
+        for (size_t i = 0; i < size; ++i) {
+            const auto p =
+                transform_ * Vector<SpatialDims + 1, double>(gather(pos, offset + i), 1.0);
+            for (unsigned int d = 0; d < SpatialDims; ++d) {
+                buffer[d][i] = p[d] / p[SpatialDims];
+            }
+        }
+        callback(dataPos, offset, size);
+    }
+}
+
 template <unsigned int SpatialDims, unsigned int DataDims, typename T>
 const SpatialCoordinateTransformer<SpatialDims>&
 SpatialSampler<SpatialDims, DataDims, T>::getCoordinateTransformer() const {
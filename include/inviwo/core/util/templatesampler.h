@@ -70,6 +70,10 @@ public:
 
     virtual Vector<DataDims, T> sampleDataSpace(const dvec3& pos) const override;
 
+protected:
+    virtual void sampleDataSpaceBatch(const std::array<const double*, 3>& pos,
+                                      Vector<DataDims, T>* result, size_t count) const override;
+
 private:
     Vector<DataDims, T> getVoxel(const size3_t& pos) const;
     virtual bool withinBoundsDataSpace(const dvec3& pos) const override;
@@ -135,10 +139,20 @@ Vector<DataDims, T> TemplateVolumeSampler<DataType, P, T, DataDims>::sampleDataS
     return Interpolation<Vector<DataDims, T>, P>::trilinear(samples, interpolants);
 }
 
+template <typename DataType, typename P, typename T, unsigned int DataDims>
+void TemplateVolumeSampler<DataType, P, T, DataDims>::sampleDataSpaceBatch(
+    const std::array<const double*, 3>& pos, Vector<DataDims, T>* result, size_t count) const {
+    // Qualified call to bypass the virtual dispatch, the data type is known statically here
+    for (size_t i = 0; i < count; ++i) {
+        result[i] = TemplateVolumeSampler::sampleDataSpace(dvec3{pos[0][i], pos[1][i], pos[2][i]});
+    }
+}
+
 template <typename DataType, typename P, typename T, unsigned int DataDims>
 Vector<DataDims, T> TemplateVolumeSampler<DataType, P, T, DataDims>::getVoxel(
     const size3_t& pos) const {
-    return static_cast<const Vector<DataDims, T>>(data_[ic_(pos)]);
+    // The upper neighbors of a position on the border are outside of the volume
+    return static_cast<const Vector<DataDims, T>>(data_[ic_(glm::min(pos, dims_ - size3_t(1)))]);
 }
 
 }  // namespace inviwo
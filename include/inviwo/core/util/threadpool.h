@@ -60,38 +60,144 @@
 
 #include <warn/push>
 #include <warn/ignore/all>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <deque>
 #include <vector>
-#include <queue>
 #include <memory>
+#include <new>
 #include <thread>
 #include <mutex>
+#include <shared_mutex>
 #include <condition_variable>
 #include <future>
 #include <functional>
 #include <stdexcept>
 #include <atomic>
+#include <type_traits>
 #include <warn/pop>
 
 namespace inviwo {
 
+/**
+ * \class ThreadPool
+ * \brief A work-stealing thread pool
+ *
+ * Each worker thread has its own task queues. Tasks enqueued from a worker thread of the pool are
+ * put in the queue of that worker, and are run last in first out by the worker itself, while idle
+ * workers steal from the other end of the queue. Tasks enqueued from other threads go to a shared
+ * queue that workers take small batches from. Each queue is split by Priority, and interactive
+ * tasks are always taken before background tasks.
+ *
+ * A task may enqueue sub tasks and wait for them using wait(), which will run other pending tasks
+ * on the worker thread instead of blocking it.
+ */
 class IVW_CORE_API ThreadPool {
 public:
+    enum class Priority : size_t {
+        Interactive,  //< Short tasks that someone is waiting for, the default.
+        Background    //< Long running tasks, only run when there are no interactive tasks.
+    };
+
+    /**
+     * Type erased move only void() functor. Functors no larger than BufferSize are stored
+     * inline without any heap allocation.
+     */
+    class Task {
+    public:
+        static constexpr size_t BufferSize = 64;
+
+        Task() noexcept = default;
+        template <typename F, typename = std::enable_if_t<!std::is_same_v<std::decay_t<F>, Task>>>
+        Task(F&& f);
+        Task(const Task&) = delete;
+        Task(Task&& rhs) noexcept;
+        Task& operator=(const Task&) = delete;
+        Task& operator=(Task&& rhs) noexcept;
+        ~Task();
+
+        explicit operator bool() const noexcept { return ops_ != nullptr; }
+        void operator()() { ops_->invoke(&buffer_); }
+
+    private:
+        struct Ops {
+            void (*invoke)(void*);
+            void (*move)(void* from, void* to);
+            void (*destroy)(void*);
+        };
+        template <typename Fun>
+        static constexpr Ops inlineOps{
+            [](void* f) { (*static_cast<Fun*>(f))(); },
+            [](void* from, void* to) {
+                new (to) Fun(std::move(*static_cast<Fun*>(from)));
+                static_cast<Fun*>(from)->~Fun();
+            },
+            [](void* f) { static_cast<Fun*>(f)->~Fun(); }};
+        template <typename Fun>
+        static constexpr Ops heapOps{
+            [](void* f) { (**static_cast<Fun**>(f))(); },
+            [](void* from, void* to) { *static_cast<Fun**>(to) = *static_cast<Fun**>(from); },
+            [](void* f) { delete *static_cast<Fun**>(f); }};
+
+        const Ops* ops_ = nullptr;
+        std::aligned_storage_t<BufferSize, alignof(std::max_align_t)> buffer_;
+    };
+
     ThreadPool(
         size_t threads, std::function<void()> onThreadStart = []() {},
         std::function<void()> onThreadStop = []() {});
     ~ThreadPool();
 
     /**
-     * Enqueue function f with arguments args. The function f may throw exceptions.
+     * Enqueue function f with arguments args with Priority::Interactive. The function f may throw
+     * exceptions. The only allocation is the shared state of the returned future, which also
+     * holds f and its arguments.
      * @return a future to the result of f
      */
     template <class F, class... Args>
     auto enqueue(F&& f, Args&&... args) -> std::future<std::invoke_result_t<F, Args...>>;
 
     /**
-     * Enqueue a plain functor. The functor may not throw exceptions.
+     * Enqueue function f with arguments args with the given priority. The function f may throw
+     * exceptions.
+     * @return a future to the result of f
+     */
+    template <class F, class... Args>
+    auto enqueue(Priority priority, F&& f, Args&&... args)
+        -> std::future<std::invoke_result_t<F, Args...>>;
+
+    /**
+     * Enqueue a plain functor. The functor may not throw exceptions. Functors no larger than
+     * Task::BufferSize are enqueued without any heap allocation.
+     */
+    void enqueueRaw(Task f, Priority priority = Priority::Interactive);
+
+    /**
+     * Wait for the future to become ready. When called from a worker thread of this pool, pending
+     * tasks are run while waiting, such that a task can wait for its sub tasks without tying up
+     * the worker, and such that waiting for sub tasks can not deadlock the pool even if all
+     * workers do it. When there is nothing to run, the worker sleeps until the future is ready or
+     * until a new task is enqueued. Otherwise this is equivalent to future.wait().
+     *
+     * Note that a task run while waiting may be any pending task of the pool. Hence the caller
+     * must not hold any lock that such a task could try to acquire. On a worker thread, the
+     * future has to be the result of a task of this pool, e.g. from enqueue() or dispatchPool(),
+     * since a sleeping worker is only woken when a task of the pool finishes.
+     */
+    template <class T>
+    void wait(const std::future<T>& future);
+
+    /**
+     * Run one pending task on the calling thread if it is a worker thread of this pool.
+     * @return true if a task was run
      */
-    void enqueueRaw(std::function<void()> f);
+    bool runPendingTask();
+
+    /**
+     * Returns true if the calling thread is one of the worker threads of this pool.
+     */
+    bool isWorkerThread() const;
 
     size_t trySetSize(size_t size);
     size_t getSize() const;
@@ -99,6 +205,9 @@ public:
     size_t getQueueSize();
 
 private:
+    static constexpr size_t numPriorities = 2;
+    using Queues = std::array<std::deque<Task>, numPriorities>;
+
     enum class State {
         Free,     //< Worker is waiting for tasks.
         Working,  //< Worker is running a task.
@@ -115,42 +224,135 @@ private:
         Worker& operator=(Worker&& rhs) = delete;
         ~Worker();
 
+        ThreadPool& pool;
         std::atomic<State> state;  //< State of the worker
+        std::mutex mutex;          //< Guards tasks
+        Queues tasks;              //< Tasks enqueued by this worker or taken from the pool
+        size_t victim = 0;         //< Where to start looking for tasks to steal
         std::thread thread;
     };
+
+    Worker* getCurrentWorker() const;
+    void push(Task task, Priority priority);
+    Task pop(Worker& worker);
+    void wakeOne();
+    void wakeAll();
+    void wakeWaiting();
+    void run(Task& task);
+
+    // Sleep until ready() is true, a task is queued, or any task has finished.
+    template <class Ready>
+    void sleepWhileWaiting(Ready ready);
+
     // need to keep track of threads so we can join them
     std::vector<std::unique_ptr<Worker>> workers;
+    std::shared_mutex workers_mutex;  // guards workers against stealing while resizing
+    std::atomic<size_t> numWorkers{0};
 
-    // the task queue
-    std::queue<std::function<void()>> tasks;
+    // the shared task queue, for tasks enqueued from outside the pool
+    Queues tasks;
+    std::mutex queue_mutex;
 
     // synchronization
-    std::mutex queue_mutex;
+    std::atomic<size_t> queued{0};    // number of tasks in all queues
+    std::atomic<size_t> sleeping{0};  // number of workers waiting on condition
+    std::mutex sleep_mutex;
     std::condition_variable condition;
 
+    // synchronization of workers waiting for a future
+    std::atomic<size_t> completed{0};  // number of finished tasks
+    std::atomic<size_t> waiting{0};    // number of workers waiting on wait_condition
+    std::mutex wait_mutex;
+    std::condition_variable wait_condition;
+
     // Thread start end exit actions
     std::function<void()> onThreadStart_;
     std::function<void()> onThreadStop_;
 };
 
+template <typename F, typename>
+ThreadPool::Task::Task(F&& f) {
+    using Fun = std::decay_t<F>;
+    if constexpr (sizeof(Fun) <= BufferSize && alignof(Fun) <= alignof(std::max_align_t) &&
+                  std::is_nothrow_move_constructible_v<Fun>) {
+        new (&buffer_) Fun(std::forward<F>(f));
+        ops_ = &inlineOps<Fun>;
+    } else {
+        *reinterpret_cast<Fun**>(&buffer_) = new Fun(std::forward<F>(f));
+        ops_ = &heapOps<Fun>;
+    }
+}
+
+inline ThreadPool::Task::Task(Task&& rhs) noexcept : ops_{rhs.ops_} {
+    if (ops_) {
+        ops_->move(&rhs.buffer_, &buffer_);
+        rhs.ops_ = nullptr;
+    }
+}
+
+inline ThreadPool::Task& ThreadPool::Task::operator=(Task&& rhs) noexcept {
+    if (this != &rhs) {
+        if (ops_) ops_->destroy(&buffer_);
+        ops_ = rhs.ops_;
+        if (ops_) {
+            ops_->move(&rhs.buffer_, &buffer_);
+            rhs.ops_ = nullptr;
+        }
+    }
+    return *this;
+}
+
+inline ThreadPool::Task::~Task() {
+    if (ops_) ops_->destroy(&buffer_);
+}
+
 // add new work item to the pool
 template <class F, class... Args>
 auto ThreadPool::enqueue(F&& f, Args&&... args) -> std::future<std::invoke_result_t<F, Args...>> {
+    return enqueue(Priority::Interactive, std::forward<F>(f), std::forward<Args>(args)...);
+}
+
+template <class F, class... Args>
+auto ThreadPool::enqueue(Priority priority, F&& f, Args&&... args)
+    -> std::future<std::invoke_result_t<F, Args...>> {
     using return_type = std::invoke_result_t<F, Args...>;
 
-    auto task = std::make_shared<std::packaged_task<return_type()>>(
-        std::bind(std::forward<F>(f), std::forward<Args>(args)...));
+    std::packaged_task<return_type()> task{
+        std::bind(std::forward<F>(f), std::forward<Args>(args)...)};
 
-    std::future<return_type> res = task->get_future();
+    std::future<return_type> res = task.get_future();
 
-    if (workers.empty()) {
-        (*task)();  // No worker threads, just run the task.
+    if (getSize() == 0) {
+        task();  // No worker threads, just run the task.
     } else {
-        std::unique_lock<std::mutex> lock(queue_mutex);
-        tasks.emplace([task]() { (*task)(); });
+        push(Task{std::move(task)}, priority);
     }
-    condition.notify_one();
     return res;
 }
 
+template <class T>
+void ThreadPool::wait(const std::future<T>& future) {
+    if (!isWorkerThread()) {
+        future.wait();
+        return;
+    }
+    const auto ready = [&future]() {
+        return future.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+    };
+    while (!ready()) {
+        if (!runPendingTask()) sleepWhileWaiting(ready);
+    }
+}
+
+template <class Ready>
+void ThreadPool::sleepWhileWaiting(Ready ready) {
+    // Same protocol as for the sleeping workers, announce that we are waiting before checking,
+    // run() and push() update their counters before checking for waiting workers.
+    std::unique_lock<std::mutex> lock(wait_mutex);
+    ++waiting;
+    const size_t done = completed;
+    wait_condition.wait(lock, [&]() { return queued > 0 || completed != done || ready(); });
+    --waiting;
+}
+
 }  // namespace inviwo
@@ -37,6 +37,7 @@
 namespace inviwo {
 
 class ProcessorNetwork;
+class LayerExportQueue;
 
 class Property;
 class ProcessorWidget;
@@ -45,9 +46,15 @@ namespace util {
 
 IVW_CORE_API void saveNetwork(ProcessorNetwork* network, std::string_view filename);
 
+/**
+ * Save the visible layer of all canvases in \p network to \p dir. If \p queue is given, the
+ * layers are copied and written on the thread pool by the queue, otherwise they are written
+ * before returning.
+ */
 IVW_CORE_API void saveAllCanvases(ProcessorNetwork* network, std::string_view dir,
                                   std::string_view name = "UPN", std::string_view ext = ".png",
-                                  bool onlyActiveCanvases = false);
+                                  bool onlyActiveCanvases = false,
+                                  LayerExportQueue* queue = nullptr);
 
 IVW_CORE_API bool isValidIdentifierCharacter(char c, std::string_view extra = "");
 
@@ -35,6 +35,7 @@
 #include <inviwo/core/util/interpolation.h>
 #include <inviwo/core/datastructures/volume/volume.h>
 #include <inviwo/core/datastructures/volume/volumeram.h>
+#include <inviwo/core/datastructures/volume/volumeramprecision.h>
 
 #include <inviwo/core/util/spatialsampler.h>
 
@@ -57,6 +58,17 @@ public:
     virtual bool withinBoundsDataSpace(const dvec3& pos) const override;
 
 protected:
+    /**
+     * Dispatches on the data format once per batch and interpolates directly from the typed
+     * voxel data, avoiding the virtual VolumeRAM::getAsDVec* call per voxel.
+     */
+    virtual void sampleDataSpaceBatch(const std::array<const double*, 3>& pos,
+                                      Vector<DataDims, double>* result,
+                                      size_t count) const override;
+
+    template <typename GetVoxel>
+    Vector<DataDims, double> interpolate(const dvec3& pos, GetVoxel&& getVoxel) const;
+
     Vector<DataDims, double> getVoxel(const size3_t& pos) const;
 
     std::shared_ptr<const Volume> volume_;
@@ -81,6 +93,33 @@ VolumeDoubleSampler<DataDims>::VolumeDoubleSampler(const Volume& vol, Coordinate
 
 template <unsigned int DataDims>
 Vector<DataDims, double> VolumeDoubleSampler<DataDims>::sampleDataSpace(const dvec3& pos) const {
+    return interpolate(pos, [this](const size3_t& p) { return getVoxel(p); });
+}
+
+template <unsigned int DataDims>
+void VolumeDoubleSampler<DataDims>::sampleDataSpaceBatch(const std::array<const double*, 3>& pos,
+                                                         Vector<DataDims, double>* result,
+                                                         size_t count) const {
+    ram_->dispatch<void>([&](const auto vrprecision) {
+        using ValueType = util::PrecisionValueType<decltype(vrprecision)>;
+        const ValueType* data = vrprecision->getDataTyped();
+        const util::IndexMapper3D im(dims_);
+        const size3_t maxIndex = dims_ - size3_t(1);
+
+        const auto getVoxel = [&](const size3_t& p) {
+            return util::glm_convert<Vector<DataDims, double>>(
+                data[im(glm::min(p, maxIndex))]);
+        };
+        for (size_t i = 0; i < count; ++i) {
+            result[i] = interpolate(dvec3{pos[0][i], pos[1][i], pos[2][i]}, getVoxel);
+        }
+    });
+}
+
+template <unsigned int DataDims>
+template <typename GetVoxel>
+Vector<DataDims, double> VolumeDoubleSampler<DataDims>::interpolate(const dvec3& pos,
+                                                                    GetVoxel&& getVoxel) const {
     if (!withinBoundsDataSpace(pos)) {
         return Vector<DataDims, double>(0.0);
     }
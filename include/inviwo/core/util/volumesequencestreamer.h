@@ -0,0 +1,123 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#pragma once
+
+#include <inviwo/core/common/inviwocoredefine.h>
+#include <inviwo/core/util/volumesequenceutils.h>
+
+#include <cstddef>
+#include <future>
+#include <memory>
+#include <optional>
+#include <unordered_map>
+
+namespace inviwo {
+
+/**
+ * \ingroup util
+ * Streams the steps of a VolumeSequence during playback. Every time a step is selected, the
+ * VolumeRAM representations of the next steps are created on the thread pool, and the
+ * representations of steps that are not needed anymore are removed to stay within a memory
+ * budget.
+ *
+ * The playback direction and the number of steps between two selections are taken from the last
+ * two selected steps, hence prefetching follows the sequence forwards, backwards and when steps
+ * are skipped at high speed. Only steps with a valid VolumeDisk representation are prefetched and
+ * evicted, i.e. steps that can be loaded again. All other representations of evicted steps are
+ * removed, which means that other users of the sequence must not keep representations of steps
+ * other than the selected one while the streamer is used with a memory budget.
+ *
+ * Should be used from the main thread only.
+ */
+class IVW_CORE_API VolumeSequenceStreamer {
+public:
+    struct Statistics {
+        size_t hits = 0;           ///< Selected steps that were already loaded
+        size_t waits = 0;          ///< Selected steps that were still being prefetched
+        size_t misses = 0;         ///< Selected steps that were not loaded
+        size_t prefetched = 0;     ///< Steps loaded ahead of time
+        size_t evicted = 0;        ///< Steps whose representations were removed
+        size_t residentBytes = 0;  ///< Size of the loaded and loading steps after the last select
+    };
+
+    /**
+     * @param prefetchSteps number of steps to load ahead of the selected one
+     * @param memoryBudget maximum size in bytes of the loaded steps, 0 means unlimited
+     */
+    explicit VolumeSequenceStreamer(size_t prefetchSteps = 2, size_t memoryBudget = 0);
+    VolumeSequenceStreamer(const VolumeSequenceStreamer&) = delete;
+    VolumeSequenceStreamer& operator=(const VolumeSequenceStreamer&) = delete;
+    ~VolumeSequenceStreamer();
+
+    /**
+     * Set the sequence to stream, resets the playback direction if the sequence changes.
+     */
+    void setSequence(std::shared_ptr<const VolumeSequence> sequence);
+    const std::shared_ptr<const VolumeSequence>& getSequence() const;
+
+    void setPrefetchSteps(size_t steps);
+    size_t getPrefetchSteps() const;
+
+    /**
+     * Set the maximum size in bytes of the VolumeRAM representations of the loaded steps, 0
+     * means unlimited. The budget is applied on the next call to select. The selected step is
+     * never evicted, hence the budget might be exceeded if it is smaller than one step.
+     */
+    void setMemoryBudget(size_t bytes);
+    size_t getMemoryBudget() const;
+
+    /**
+     * Notify the streamer that step \p index, zero based, is selected. Updates the statistics,
+     * removes the representations of steps outside of the budget, and starts loading the next
+     * steps in the playback direction.
+     */
+    void select(size_t index);
+
+    /**
+     * Wait until all steps that are being prefetched are loaded.
+     */
+    void wait();
+
+    const Statistics& getStatistics() const;
+    void resetStatistics();
+
+private:
+    void collect();
+
+    std::shared_ptr<const VolumeSequence> sequence_;
+    size_t prefetchSteps_;
+    size_t memoryBudget_;
+    std::optional<size_t> last_;
+    std::ptrdiff_t step_;
+    std::unordered_map<size_t, std::future<void>> loading_;
+    Statistics stats_;
+};
+
+}  // namespace inviwo
@@ -32,6 +32,7 @@
 #include <inviwo/core/common/inviwocoredefine.h>
 #include <inviwo/core/util/glmvec.h>
 
+#include <future>
 #include <tuple>
 #include <memory>
 #include <utility>
@@ -39,6 +40,7 @@
 namespace inviwo {
 
 class Volume;
+class VolumeBricked;
 
 namespace util {
 
@@ -70,6 +72,30 @@ size3_t IVW_CORE_API getVolumeDimensions(const std::shared_ptr<const Volume>& vo
  */
 double IVW_CORE_API voxelVolume(const Volume& volume);
 
+/**
+ * \brief create the VolumeRAM representation of the volume on the thread pool
+ *
+ * Loading a large volume from disk can take a long time. This function starts loading it in the
+ * background, such that the calling thread, i.e. the GUI, stays responsive. Calls to
+ * getRepresentation<VolumeRAM>() on other threads will wait until the loading is done. If there
+ * is no thread pool the representation is created directly.
+ *
+ * @return a future that becomes ready when the VolumeRAM representation exists, and holds any
+ * exception thrown while loading.
+ */
+std::future<void> IVW_CORE_API loadVolumeRAMAsync(std::shared_ptr<const Volume> volume);
+
+/**
+ * \brief returns the VolumeBricked representation if the volume should be processed brick by brick
+ *
+ * That is the case if the volume has a VolumeBricked representation but no VolumeRAM
+ * representation, i.e. it might not fit in memory. Algorithms that can process the volume brick
+ * by brick can use this to avoid creating a VolumeRAM representation of the whole volume.
+ *
+ * @return the VolumeBricked representation or nullptr
+ */
+const VolumeBricked* IVW_CORE_API getBrickedRepresentation(const Volume& volume);
+
 }  // namespace util
 
 }  // namespace inviwo
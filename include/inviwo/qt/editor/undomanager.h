@@ -35,9 +35,11 @@
 #include <inviwo/core/network/processornetworkobserver.h>
 #include <inviwo/core/network/workspacemanager.h>
 
+#include <chrono>
 #include <memory>
 #include <optional>
 #include <string>
+#include <vector>
 
 class QAction;
 class QEvent;
@@ -46,9 +48,14 @@ namespace inviwo {
 
 class InviwoMainWindow;
 class AutoSaver;
+class SnapshotStore;
 
 /**
  * \class UndoManager
+ * Keeps a stack of workspace snapshots for undo and redo. The snapshots are split into content
+ * defined chunks that are shared between all snapshots, so each step only needs memory for the
+ * parts of the workspace that changed. Property changes that follow each other quickly are
+ * coalesced into one step, changes to the network structure always get a step of their own.
  */
 class IVW_QTEDITOR_API UndoManager : public ProcessorNetworkObserver {
 public:
@@ -74,7 +81,8 @@ public:
     void restore();
 
 private:
-    using DiffType = std::vector<std::string>::iterator::difference_type;
+    using Snapshot = std::vector<std::shared_ptr<const std::string>>;
+    using DiffType = std::vector<Snapshot>::iterator::difference_type;
 
     void updateActions();
 
@@ -93,8 +101,12 @@ private:
 
     bool dirty_ = true;
     bool isRestoring = false;
+    bool structural_ = false;
+    bool headStructural_ = true;
+    std::chrono::steady_clock::time_point lastPush_;
     DiffType head_ = -1;
-    std::vector<std::shared_ptr<const std::string>> undoBuffer_;
+    std::unique_ptr<SnapshotStore> snapshots_;
+    std::vector<Snapshot> undoBuffer_;
 
     QAction* undoAction_;
     QAction* redoAction_;
@@ -31,6 +31,7 @@
 #include <modules/animation/animationmoduledefine.h>
 #include <inviwo/core/util/timer.h>
 #include <inviwo/core/common/inviwoapplication.h>
+#include <inviwo/core/io/layerexportqueue.h>
 
 #include <modules/animation/datastructures/animation.h>
 #include <modules/animation/datastructures/animationtime.h>
@@ -173,6 +174,8 @@ protected:
         std::string baseFileName;
         std::vector<RenderCanvasSize> origCanvasSettings;
         std::string canvasIndicator;
+        /// Writes the frames on the thread pool while the next frames are rendered
+        std::unique_ptr<LayerExportQueue> exportQueue;
     };
 
     /// State needed during rendering
@@ -307,6 +307,8 @@ void AnimationController::render() {
         }
     }
 
+    renderState_.exportQueue = std::make_unique<LayerExportQueue>();
+
     // Switch Buttons
     renderAction.setVisible(false);
     renderActionStop.setVisible(true);
@@ -316,6 +318,19 @@ void AnimationController::render() {
 }
 
 void AnimationController::afterRender() {
+    // Wait for the last frames to be written
+    if (renderState_.exportQueue) {
+        renderState_.exportQueue->wait();
+        const auto stats = renderState_.exportQueue->getStatistics();
+        LogInfo("Exported " << stats.written << " frames in " << stats.elapsed.count() << "s ("
+                            << stats.framesPerSecond() << " frames/s), waited "
+                            << stats.blockedTime.count() << "s for the export queue");
+        if (stats.failed > 0) {
+            LogWarn(stats.failed << " frames could not be exported");
+        }
+        renderState_.exportQueue.reset();
+    }
+
     // Switch Buttons
     renderActionStop.setVisible(false);
     renderAction.setVisible(true);
@@ -431,7 +446,8 @@ void AnimationController::tickRender() {
         auto ext = FileExtension::createFileExtensionFromString(renderImageExtension.get());
         // - save active canvases
         util::saveAllCanvases(app_->getProcessorNetwork(), renderLocation.get(),
-                              fileNamePattern.str(), ext.extension_, true);
+                              fileNamePattern.str(), ext.extension_, true,
+                              renderState_.exportQueue.get());
     }
 
     // Next!
@@ -37,6 +37,7 @@
 namespace inviwo {
 
 class VolumeRAM;
+class VolumeBricked;
 class LayerRAM;
 class BufferRAM;
 
@@ -49,12 +50,24 @@ namespace util {
 IVW_MODULE_BASE_API std::pair<dvec4, dvec4> volumeMinMax(
     const VolumeRAM* volume, IgnoreSpecialValues ignore = IgnoreSpecialValues::No);
 
+/**
+ * Compute the minimum and maximum values brick by brick, only a few bricks are kept in memory at
+ * a time.
+ */
+IVW_MODULE_BASE_API std::pair<dvec4, dvec4> volumeMinMax(
+    const VolumeBricked* volume, IgnoreSpecialValues ignore = IgnoreSpecialValues::No);
+
 IVW_MODULE_BASE_API std::pair<dvec4, dvec4> layerMinMax(
     const LayerRAM* layer, IgnoreSpecialValues ignore = IgnoreSpecialValues::No);
 
 IVW_MODULE_BASE_API std::pair<dvec4, dvec4> bufferMinMax(
     const BufferRAM* layer, IgnoreSpecialValues ignore = IgnoreSpecialValues::No);
 
+/**
+ * Compute the minimum and maximum values of the volume. Volumes that only have a VolumeBricked
+ * representation are processed brick by brick.
+ * @see util::getBrickedRepresentation
+ */
 IVW_MODULE_BASE_API std::pair<dvec4, dvec4> volumeMinMax(
     const Volume* volume, IgnoreSpecialValues ignore = IgnoreSpecialValues::No);
 
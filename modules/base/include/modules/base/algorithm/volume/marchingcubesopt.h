@@ -66,6 +66,32 @@ IVW_MODULE_BASE_API std::shared_ptr<Mesh> marchingCubesOpt(
     std::shared_ptr<const Volume> volume, double iso, const vec4& color, bool invert, bool enclose,
     std::function<void(float)> progressCallback = nullptr,
     std::function<bool(const size3_t&)> maskingCallback = nullptr);
+
+/**
+ * Extracts an iso surface from a volume using the Marching Cubes algorithm, like
+ * util::marchingCubesOpt, but splits the volume into z-slabs that are processed concurrently on
+ * the thread pool. The vertices on the boundary between two slabs are welded when the slabs are
+ * stitched together, so the result has the same positions and triangles as
+ * util::marchingCubesOpt. Bricks of 8x8x8 cells that the surface can not pass through are skipped.
+ *
+ * @param volume the scalar volume
+ * @param iso iso-value for the extracted surface
+ * @param color the color of the resulting surface
+ * @param invert flips the normals of the surface normals (useful when values greater than the
+ * iso-value is 'outside' of the surface)
+ * @param enclose whether to create surface where the iso surface intersects the volume boundaries
+ * @param progressCallback if set, will be called will executing with the current progress in the
+ * interval [0,1], useful for progress bars. Might be called from any of the pool threads, but
+ * never concurrently.
+ * @param maskingCallback optional callback to test whether current cell should be evaluated or not
+ * (return true to include current cell). Will be called concurrently from the pool threads.
+ * @param slabs the number of slabs to use, 0 will choose depending on the size of the thread pool
+ * and the volume
+ */
+IVW_MODULE_BASE_API std::shared_ptr<Mesh> marchingCubesParallel(
+    std::shared_ptr<const Volume> volume, double iso, const vec4& color, bool invert, bool enclose,
+    std::function<void(float)> progressCallback = nullptr,
+    std::function<bool(const size3_t&)> maskingCallback = nullptr, size_t slabs = 0);
 }  // namespace util
 
 namespace marching {
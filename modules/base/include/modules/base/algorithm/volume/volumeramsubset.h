@@ -37,6 +37,11 @@ namespace inviwo {
 
 class IVW_MODULE_BASE_API VolumeRAMSubSet {
 public:
+    /**
+     * Extract the subset of size \p dim starting at \p offset from \p in, which can be a
+     * VolumeRAM or a VolumeBricked. For a VolumeBricked only the bricks covering the subset are
+     * loaded.
+     */
     static std::shared_ptr<VolumeRAM> apply(const VolumeRepresentation* in, size3_t dim,
                                             size3_t offset,
                                             const VolumeBorders& border = VolumeBorders(),
@@ -0,0 +1,264 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#pragma once
+
+#include <modules/base/basemoduledefine.h>
+#include <inviwo/core/common/inviwo.h>
+#include <inviwo/core/common/inviwoapplication.h>
+#include <inviwo/core/datastructures/image/imagetypes.h>
+#include <inviwo/core/datastructures/volume/volumeramprecision.h>
+#include <inviwo/core/util/foreach.h>
+#include <inviwo/core/util/glm.h>
+#include <inviwo/core/util/indexmapper.h>
+
+#include <algorithm>
+#include <array>
+#include <memory>
+#include <numeric>
+#include <utility>
+#include <vector>
+
+namespace inviwo {
+
+class Volume;
+
+namespace util {
+
+/**
+ * A voxel together with its six face neighbors, used to compute finite differences in
+ * util::forEachStencil. The values are converted to V, a type with the same extent as the voxel
+ * type and the floating point value type F. The neighbors outside of the volume are given by the
+ * wrapping of the volume, for Wrapping::Clamp that is the border voxel itself, which gives one
+ * sided first derivatives at the border and second derivatives as if the values outside were equal
+ * to the border value.
+ */
+template <typename V, typename F>
+struct Stencil {
+    using value_type = V;
+    using float_type = F;
+
+    /// Central difference along axis, in world space units
+    V derivative(size_t axis) const { return (next[axis] - prev[axis]) * invSpan[axis]; }
+    /// Second order central difference along axis, in world space units
+    V secondDerivative(size_t axis) const {
+        return (next[axis] - F{2} * center + prev[axis]) * invSpacing2[axis];
+    }
+    V laplacian() const { return secondDerivative(0) + secondDerivative(1) + secondDerivative(2); }
+
+    V center;
+    std::array<V, 3> prev;
+    std::array<V, 3> next;
+    /// One over the world space distance between prev and next along each axis
+    std::array<F, 3> invSpan;
+    /// One over the squared world space voxel spacing along each axis
+    std::array<F, 3> invSpacing2;
+};
+
+/**
+ * The gradient of one channel of the stencil
+ */
+template <typename V, typename F>
+Vector<3, F> gradient(const Stencil<V, F>& s, size_t channel = 0) {
+    const auto dx = s.derivative(0);
+    const auto dy = s.derivative(1);
+    const auto dz = s.derivative(2);
+    return {util::glmcomp(dx, channel), util::glmcomp(dy, channel), util::glmcomp(dz, channel)};
+}
+
+template <typename F>
+F divergence(const Stencil<Vector<3, F>, F>& s) {
+    return s.derivative(0).x + s.derivative(1).y + s.derivative(2).z;
+}
+
+template <typename F>
+Vector<3, F> curl(const Stencil<Vector<3, F>, F>& s) {
+    const auto dx = s.derivative(0);
+    const auto dy = s.derivative(1);
+    const auto dz = s.derivative(2);
+    return {dy.z - dz.y, dz.x - dx.z, dx.y - dy.x};
+}
+
+namespace detail {
+
+/**
+ * The indices of the previous and next neighbor of index i along an axis of the given size
+ */
+inline std::pair<size_t, size_t> stencilNeighbors(size_t i, size_t size, Wrapping wrapping) {
+    if (size < 2) return {0, 0};
+    const size_t last = size - 1;
+    switch (wrapping) {
+        case Wrapping::Repeat:
+            return {i == 0 ? last : i - 1, i == last ? 0 : i + 1};
+        case Wrapping::Mirror:
+            return {i == 0 ? 1 : i - 1, i == last ? last - 1 : i + 1};
+        case Wrapping::Clamp:
+        default:
+            return {i == 0 ? 0 : i - 1, i == last ? last : i + 1};
+    }
+}
+
+/**
+ * One over the world space distance between the neighbors of index i
+ */
+template <typename F>
+F stencilInvSpan(size_t i, size_t size, Wrapping wrapping, double spacing) {
+    const bool oneSided = wrapping == Wrapping::Clamp && size > 1 && (i == 0 || i + 1 == size);
+    return static_cast<F>(1.0 / ((oneSided ? 1.0 : 2.0) * spacing));
+}
+
+/**
+ * Call func(z) for each z-slice, the slices are split into jobs on the thread pool using
+ * util::forEachParallel, or processed serially if there is no application
+ */
+template <typename Func>
+void forEachSlice(size_t slices, Func&& func, size_t jobs = 0) {
+    if (!InviwoApplication::isInitialized()) {
+        for (size_t z = 0; z < slices; ++z) {
+            func(z);
+        }
+        return;
+    }
+    std::vector<size_t> zs(slices);
+    std::iota(zs.begin(), zs.end(), size_t{0});
+    util::forEachParallel(zs, [&func](size_t z) { func(z); }, jobs);
+}
+
+}  // namespace detail
+
+/**
+ * Call kernel(stencil, index) for each voxel of the z-slice z, where index is the linear index of
+ * the voxel, see util::forEachStencil.
+ */
+template <typename F = float, typename T, typename Kernel>
+void forEachStencilInSlice(const VolumeRAMPrecision<T>& ram, const Wrapping3D& wrapping,
+                           const dvec3& spacing, size_t z, Kernel&& kernel) {
+    using V = typename util::same_extent<T, F>::type;
+
+    const size3_t dims = ram.getDimensions();
+    const util::IndexMapper3D im(dims);
+    const T* data = ram.getDataTyped();
+
+    Stencil<V, F> s;
+    for (size_t i = 0; i < 3; ++i) {
+        s.invSpacing2[i] = static_cast<F>(1.0 / (spacing[i] * spacing[i]));
+    }
+
+    const auto [zPrev, zNext] = detail::stencilNeighbors(z, dims.z, wrapping[2]);
+    s.invSpan[2] = detail::stencilInvSpan<F>(z, dims.z, wrapping[2], spacing.z);
+
+    for (size_t y = 0; y < dims.y; ++y) {
+        const auto [yPrev, yNext] = detail::stencilNeighbors(y, dims.y, wrapping[1]);
+        s.invSpan[1] = detail::stencilInvSpan<F>(y, dims.y, wrapping[1], spacing.y);
+
+        const size_t rowIndex = im(0, y, z);
+        const T* row = data + rowIndex;
+        const T* rowYPrev = data + im(0, yPrev, z);
+        const T* rowYNext = data + im(0, yNext, z);
+        const T* rowZPrev = data + im(0, y, zPrev);
+        const T* rowZNext = data + im(0, y, zNext);
+
+        const auto visit = [&](size_t x, size_t xPrev, size_t xNext) {
+            s.center = static_cast<V>(row[x]);
+            s.prev = {static_cast<V>(row[xPrev]), static_cast<V>(rowYPrev[x]),
+                      static_cast<V>(rowZPrev[x])};
+            s.next = {static_cast<V>(row[xNext]), static_cast<V>(rowYNext[x]),
+                      static_cast<V>(rowZNext[x])};
+            kernel(std::as_const(s), rowIndex + x);
+        };
+        const auto visitBorder = [&](size_t x) {
+            const auto [xPrev, xNext] = detail::stencilNeighbors(x, dims.x, wrapping[0]);
+            s.invSpan[0] = detail::stencilInvSpan<F>(x, dims.x, wrapping[0], spacing.x);
+            visit(x, xPrev, xNext);
+        };
+
+        if (dims.x == 0) continue;
+        visitBorder(0);
+        // the interior of the row only reads contiguous memory and is free of branches
+        s.invSpan[0] = detail::stencilInvSpan<F>(1, dims.x, wrapping[0], spacing.x);
+        for (size_t x = 1; x + 1 < dims.x; ++x) {
+            visit(x, x - 1, x + 1);
+        }
+        if (dims.x > 1) visitBorder(dims.x - 1);
+    }
+}
+
+/**
+ * Call kernel(stencil, index) for each voxel of the volume data, with stencil being a
+ * util::Stencil of the voxel and index the linear index of the voxel. The z-slices are
+ * processed in parallel on the thread pool, rows in x are traversed with contiguous memory
+ * access. Useful for computing derivatives, and combinations of them, in one pass over the data:
+ * @code
+ * util::forEachStencil(*ram, volume.getWrapping(), spacing, [&](const auto& s, size_t i) {
+ *     gradient[i] = util::gradient(s);
+ *     laplacian[i] = s.laplacian();
+ * });
+ * @endcode
+ * @param ram the voxel data
+ * @param wrapping how the neighbors outside of the volume are found
+ * @param spacing the world space distance between voxels along each axis
+ * @param kernel the callback, will be called concurrently for different voxels
+ * @param jobs number of jobs to split the volume into, 0 (default) uses 4 times the pool size.
+ * @see util::voxelSpacing
+ */
+template <typename F = float, typename T, typename Kernel>
+void forEachStencil(const VolumeRAMPrecision<T>& ram, const Wrapping3D& wrapping,
+                    const dvec3& spacing, Kernel&& kernel, size_t jobs = 0) {
+    detail::forEachSlice(
+        ram.getDimensions().z,
+        [&](size_t z) { forEachStencilInSlice<F>(ram, wrapping, spacing, z, kernel); }, jobs);
+}
+
+/**
+ * The world space distance between voxels along each axis of the volume
+ */
+IVW_MODULE_BASE_API dvec3 voxelSpacing(const Volume& volume);
+
+enum class VolumeDerivative { Gradient, GradientMagnitude, Divergence, Curl, Laplacian };
+
+/**
+ * Computes derivatives of the volume in one pass over the voxel data using central differences,
+ * see util::forEachStencil. The gradient and the gradient magnitude are computed for one channel,
+ * the divergence and the curl require a volume with three channels, and the Laplacian is computed
+ * for each channel. The gradient and the curl are of vec3 type, the divergence and the gradient
+ * magnitude are scalar, and the Laplacian has the same number of channels as the volume.
+ *
+ * @param volume the input volume
+ * @param derivatives the derivatives to compute
+ * @param channel the channel used for the gradient and gradient magnitude
+ * @return one volume for each derivative, in the order requested
+ * @throws Exception if the divergence or curl is requested for a volume without three channels,
+ *         or if channel is out of range
+ */
+IVW_MODULE_BASE_API std::vector<std::unique_ptr<Volume>> derivativeVolumes(
+    const Volume& volume, const std::vector<VolumeDerivative>& derivatives, size_t channel = 0);
+
+}  // namespace util
+
+}  // namespace inviwo
@@ -47,7 +47,12 @@ namespace util {
  * Implementation of Voronoi segmentation.
  *
  * The function returns a volume with each voxel containing the index for the closest seed point
- * (according to the power distance with or without weights).
+ * (according to the power distance with or without weights). The volume uses unsigned short
+ * voxels if all indices fit, otherwise uint32. Ties are resolved in favor of the seed point that
+ * comes first in seedPointsWithIndices.
+ *
+ * The seed points are binned into a uniform grid such that only the seed points close to a voxel
+ * need to be considered, which makes the run time roughly linear in the number of voxels.
  *
  *     * volumeDimensions is the dimensions for the volume.
  *     * indexToModelMatrix is the matrix to transform the voxel positions from index to model
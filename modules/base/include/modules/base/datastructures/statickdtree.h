@@ -0,0 +1,319 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#pragma once
+
+#include <modules/base/basemoduledefine.h>
+#include <inviwo/core/common/inviwoapplication.h>
+#include <inviwo/core/util/assertion.h>
+#include <inviwo/core/util/glm.h>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <future>
+#include <limits>
+#include <numeric>
+#include <vector>
+
+namespace inviwo {
+
+/**
+ * \class StaticKDTree
+ * \brief A balanced KD-tree over a fixed set of points for fast nearest neighbor queries
+ *
+ * The tree is built once from all points by recursively splitting at the median along the axis of
+ * largest extent. It is stored implicitly: the points are reordered such that the node of the
+ * range [begin, end) is the point in the middle of the range, its left subtree is [begin, mid) and
+ * its right subtree (mid, end). Ranges with at most LeafSize points are not split further and are
+ * searched linearly. The coordinates are stored as one array per dimension, without any pointers.
+ *
+ * All queries return the index of the points in the order they were given to the constructor,
+ * together with the squared distance to the query point.
+ * The batched queries distribute the query points over the thread pool, and fall back to a serial
+ * loop if there is no InviwoApplication or the pool size is zero.
+ *
+ * In contrast to KDTree, points can not be inserted or removed after construction.
+ */
+template <unsigned char N, typename P = double>
+class StaticKDTree {
+public:
+    using Point = Vector<N, P>;
+    static constexpr std::size_t LeafSize = 8;
+
+    struct Neighbor {
+        std::size_t index;  ///< index of the point in the input order
+        P sqDist;           ///< squared distance to the query point
+    };
+
+    StaticKDTree() = default;
+    explicit StaticKDTree(const std::vector<Point>& points);
+
+    std::size_t size() const { return indices_.size(); }
+    bool empty() const { return indices_.empty(); }
+
+    /**
+     * Returns the closest point to \p pos, ties are resolved in favor of the lower index.
+     * Requires the tree not to be empty.
+     */
+    Neighbor findNearest(const Point& pos) const;
+
+    /**
+     * Returns the \p k closest points to \p pos sorted by increasing distance. Fewer than \p k
+     * points are returned if the tree contains fewer points.
+     */
+    std::vector<Neighbor> findNNearest(const Point& pos, std::size_t k) const;
+
+    /**
+     * Returns all points within distance \p radius of \p pos (inclusive) in no particular order.
+     */
+    std::vector<Neighbor> findCloseTo(const Point& pos, P radius) const;
+
+    /**
+     * Batched version of findNearest(const Point&), requires the tree not to be empty. The
+     * result for positions[i] is at index i.
+     */
+    std::vector<Neighbor> findNearest(const std::vector<Point>& positions) const;
+
+    /**
+     * Batched version of findNNearest(const Point&, std::size_t), the result for positions[i] is
+     * at index i.
+     */
+    std::vector<std::vector<Neighbor>> findNNearest(const std::vector<Point>& positions,
+                                                    std::size_t k) const;
+
+    /**
+     * Batched version of findCloseTo(const Point&, P), the result for positions[i] is at index i.
+     */
+    std::vector<std::vector<Neighbor>> findCloseTo(const std::vector<Point>& positions,
+                                                   P radius) const;
+
+private:
+    void build(std::vector<std::size_t>& order, const std::vector<Point>& points,
+               std::size_t begin, std::size_t end);
+
+    P sqDist(std::size_t i, const Point& pos) const {
+        P res{0};
+        for (unsigned char d = 0; d < N; ++d) {
+            const P diff = coords_[d][i] - pos[d];
+            res += diff * diff;
+        }
+        return res;
+    }
+
+    /**
+     * Visits all points that might be within maxSqDist of pos. The visitor is called with the
+     * position in the internal order and the squared distance, and may shrink maxSqDist.
+     */
+    template <typename Visitor>
+    void search(const Point& pos, std::size_t begin, std::size_t end, P& maxSqDist,
+                Visitor& visitor) const;
+
+    template <typename Result, typename Query>
+    static std::vector<Result> batch(const std::vector<Point>& positions, Query query);
+
+    std::array<std::vector<P>, N> coords_;
+    std::vector<std::size_t> indices_;
+    std::vector<unsigned char> splitDims_;
+};
+
+template <unsigned char N, typename P>
+StaticKDTree<N, P>::StaticKDTree(const std::vector<Point>& points)
+    : indices_(points.size()), splitDims_(points.size(), 0) {
+    std::iota(indices_.begin(), indices_.end(), std::size_t{0});
+    build(indices_, points, 0, points.size());
+
+    for (unsigned char d = 0; d < N; ++d) {
+        coords_[d].resize(points.size());
+        for (std::size_t i = 0; i < points.size(); ++i) {
+            coords_[d][i] = points[indices_[i]][d];
+        }
+    }
+}
+
+template <unsigned char N, typename P>
+void StaticKDTree<N, P>::build(std::vector<std::size_t>& order, const std::vector<Point>& points,
+                               std::size_t begin, std::size_t end) {
+    while (end - begin > LeafSize) {
+        Point min{points[order[begin]]};
+        Point max{min};
+        for (auto i = begin + 1; i < end; ++i) {
+            min = glm::min(min, points[order[i]]);
+            max = glm::max(max, points[order[i]]);
+        }
+        const auto extent = max - min;
+        unsigned char dim = 0;
+        for (unsigned char d = 1; d < N; ++d) {
+            if (extent[d] > extent[dim]) dim = d;
+        }
+
+        const auto mid = begin + (end - begin) / 2;
+        std::nth_element(
+            order.begin() + begin, order.begin() + mid, order.begin() + end,
+            [&](std::size_t a, std::size_t b) { return points[a][dim] < points[b][dim]; });
+        splitDims_[mid] = dim;
+
+        build(order, points, begin, mid);
+        begin = mid + 1;
+    }
+}
+
+template <unsigned char N, typename P>
+template <typename Visitor>
+void StaticKDTree<N, P>::search(const Point& pos, std::size_t begin, std::size_t end,
+                                P& maxSqDist, Visitor& visitor) const {
+    while (end - begin > LeafSize) {
+        const auto mid = begin + (end - begin) / 2;
+        const auto dim = splitDims_[mid];
+        const P diff = pos[dim] - coords_[dim][mid];
+
+        if (const auto dist = sqDist(mid, pos); dist <= maxSqDist) visitor(mid, dist);
+
+        // descend into the half containing pos first, the other one only if it can contain
+        // points within maxSqDist
+        if (diff < 0) {
+            search(pos, begin, mid, maxSqDist, visitor);
+            if (diff * diff > maxSqDist) return;
+            begin = mid + 1;
+        } else {
+            search(pos, mid + 1, end, maxSqDist, visitor);
+            if (diff * diff > maxSqDist) return;
+            end = mid;
+        }
+    }
+    for (auto i = begin; i < end; ++i) {
+        if (const auto dist = sqDist(i, pos); dist <= maxSqDist) visitor(i, dist);
+    }
+}
+
+template <unsigned char N, typename P>
+auto StaticKDTree<N, P>::findNearest(const Point& pos) const -> Neighbor {
+    IVW_ASSERT(!empty(), "findNearest requires a non-empty tree");
+    std::size_t best = 0;
+    P maxSqDist = std::numeric_limits<P>::max();
+    auto visitor = [&](std::size_t i, P dist) {
+        if (dist < maxSqDist || (dist == maxSqDist && indices_[i] < indices_[best])) {
+            best = i;
+            maxSqDist = dist;
+        }
+    };
+    search(pos, 0, size(), maxSqDist, visitor);
+    return {indices_[best], maxSqDist};
+}
+
+template <unsigned char N, typename P>
+auto StaticKDTree<N, P>::findNNearest(const Point& pos, std::size_t k) const
+    -> std::vector<Neighbor> {
+    std::vector<Neighbor> heap;
+    if (k == 0) return heap;
+    heap.reserve(std::min(k, size()));
+
+    const auto closer = [](const Neighbor& a, const Neighbor& b) {
+        return a.sqDist < b.sqDist || (a.sqDist == b.sqDist && a.index < b.index);
+    };
+    P maxSqDist = std::numeric_limits<P>::max();
+    auto visitor = [&](std::size_t i, P dist) {
+        const Neighbor n{indices_[i], dist};
+        if (heap.size() < k) {
+            heap.push_back(n);
+            std::push_heap(heap.begin(), heap.end(), closer);
+        } else if (closer(n, heap.front())) {
+            std::pop_heap(heap.begin(), heap.end(), closer);
+            heap.back() = n;
+            std::push_heap(heap.begin(), heap.end(), closer);
+        } else {
+            return;
+        }
+        if (heap.size() == k) maxSqDist = heap.front().sqDist;
+    };
+    search(pos, 0, size(), maxSqDist, visitor);
+
+    std::sort_heap(heap.begin(), heap.end(), closer);
+    return heap;
+}
+
+template <unsigned char N, typename P>
+auto StaticKDTree<N, P>::findCloseTo(const Point& pos, P radius) const -> std::vector<Neighbor> {
+    std::vector<Neighbor> result;
+    P maxSqDist = radius * radius;
+    auto visitor = [&](std::size_t i, P dist) { result.push_back({indices_[i], dist}); };
+    search(pos, 0, size(), maxSqDist, visitor);
+    return result;
+}
+
+template <unsigned char N, typename P>
+template <typename Result, typename Query>
+std::vector<Result> StaticKDTree<N, P>::batch(const std::vector<Point>& positions, Query query) {
+    std::vector<Result> result(positions.size());
+
+    const size_t jobs = InviwoApplication::isInitialized()
+                            ? 4 * InviwoApplication::getPtr()->getPoolSize()
+                            : 0;
+    if (jobs == 0 || positions.size() < 2 * jobs) {
+        for (std::size_t i = 0; i < positions.size(); ++i) result[i] = query(positions[i]);
+        return result;
+    }
+
+    std::vector<std::future<void>> futures;
+    for (size_t job = 0; job < jobs; ++job) {
+        const auto start = job * positions.size() / jobs;
+        const auto stop = (job + 1) * positions.size() / jobs;
+        futures.push_back(dispatchPool([&, start, stop]() {
+            for (auto i = start; i < stop; ++i) result[i] = query(positions[i]);
+        }));
+    }
+    auto& pool = InviwoApplication::getPtr()->getThreadPool();
+    for (const auto& e : futures) {
+        pool.wait(e);
+    }
+    return result;
+}
+
+template <unsigned char N, typename P>
+auto StaticKDTree<N, P>::findNearest(const std::vector<Point>& positions) const
+    -> std::vector<Neighbor> {
+    IVW_ASSERT(!empty(), "findNearest requires a non-empty tree");
+    return batch<Neighbor>(positions, [this](const Point& pos) { return findNearest(pos); });
+}
+
+template <unsigned char N, typename P>
+auto StaticKDTree<N, P>::findNNearest(const std::vector<Point>& positions, std::size_t k) const
+    -> std::vector<std::vector<Neighbor>> {
+    return batch<std::vector<Neighbor>>(
+        positions, [this, k](const Point& pos) { return findNNearest(pos, k); });
+}
+
+template <unsigned char N, typename P>
+auto StaticKDTree<N, P>::findCloseTo(const std::vector<Point>& positions, P radius) const
+    -> std::vector<std::vector<Neighbor>> {
+    return batch<std::vector<Neighbor>>(
+        positions, [this, radius](const Point& pos) { return findCloseTo(pos, radius); });
+}
+
+}  // namespace inviwo
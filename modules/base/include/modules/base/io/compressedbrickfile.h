@@ -0,0 +1,234 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#pragma once
+
+#include <modules/base/basemoduledefine.h>
+#include <inviwo/core/common/inviwo.h>
+#include <inviwo/core/datastructures/diskrepresentation.h>
+#include <inviwo/core/datastructures/volume/volumebricked.h>
+#include <inviwo/core/datastructures/volume/volumerepresentation.h>
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace inviwo {
+
+class VolumeRAM;
+
+namespace util {
+class MemoryMappedFile;
+}
+
+/**
+ * \class CompressedBrickFile
+ * \brief Reads volumes stored as independently compressed bricks.
+ *
+ * The file starts with an index of the position and compressed size of every brick, optionally
+ * followed by the minimum and maximum value of each brick, and then the bricks compressed with
+ * zlib one after the other. The bricks are numbered in x, then y, then z order like the bricks of
+ * a VolumeBricked, and the voxels of each brick are linearized in x, then y, then z. The index is
+ * read when the file is opened, the bricks are decompressed on demand. Hence any brick can be
+ * decompressed without touching the rest of the file, and several bricks can be decompressed
+ * concurrently. The file is memory mapped and must not be modified while it is open.
+ *
+ * Files are written by util::writeCompressedBrickFile and referenced from ivf files with the
+ * "Compression" key, see util::writeCompressedIvfVolume.
+ */
+class IVW_MODULE_BASE_API CompressedBrickFile {
+public:
+    /**
+     * @param filePath the file to read
+     * @param offset byte offset of the start of the bricked data in the file
+     * @param littleEndian byte order of the voxels
+     * @param dimensions of the volume
+     * @param format of the volume
+     * @param brickSize size of the bricks the file was written with
+     * @throws DataReaderException if the file could not be opened or the index does not match
+     * the dimensions and brick size
+     */
+    CompressedBrickFile(const std::string& filePath, size_t offset, bool littleEndian,
+                        size3_t dimensions, const DataFormatBase* format, size3_t brickSize);
+    CompressedBrickFile(const CompressedBrickFile&) = delete;
+    CompressedBrickFile& operator=(const CompressedBrickFile&) = delete;
+    ~CompressedBrickFile();
+
+    const std::string& getFilePath() const;
+    size3_t getDimensions() const;
+    const DataFormatBase* getDataFormat() const;
+
+    size3_t getBrickSize() const;
+    /**
+     * Number of bricks along each axis
+     */
+    size3_t getBrickCounts() const;
+    size_t getNumberOfBricks() const;
+    /**
+     * Position of the first voxel of brick \p brick
+     */
+    size3_t getBrickOffset(size_t brick) const;
+    /**
+     * Size of brick \p brick, which is smaller than the brick size along the upper borders
+     */
+    size3_t getBrickExtent(size_t brick) const;
+    /**
+     * Indices of all bricks intersecting the region starting at \p offset of size \p extent
+     */
+    std::vector<size_t> getBricks(size3_t offset, size3_t extent) const;
+    /**
+     * Size in bytes of the compressed data of brick \p brick
+     */
+    size_t getCompressedSize(size_t brick) const;
+
+    /**
+     * Whether the file contains the minimum and maximum value of each brick
+     */
+    bool hasBrickMinMax() const;
+    /**
+     * The component-wise minimum and maximum values of brick \p brick, zero for non-existing
+     * components. Can be used to skip bricks without reading them, e.g. empty bricks of a
+     * segmentation.
+     * @throws Exception if the file does not contain the minimum and maximum values
+     */
+    std::pair<dvec4, dvec4> getBrickMinMax(size_t brick) const;
+
+    /**
+     * Decompress brick \p brick into \p dest, which has room for glm::compMul(getBrickExtent())
+     * voxels. Can be called concurrently from several threads.
+     * @throws DataReaderException if the brick data is corrupt
+     */
+    void readBrick(size_t brick, void* dest) const;
+
+    /**
+     * Decompress the region starting at \p offset of size \p extent into \p dest, which has room
+     * for glm::compMul(extent) voxels linearized in x, then y, then z. Only the bricks
+     * intersecting the region are decompressed, in parallel by the calling thread together with
+     * the thread pool, see util::forEachIndexParallel. The calling thread does not run other
+     * tasks of the pool, so this can be called while holding a lock.
+     * @param offset position of the first voxel of the region
+     * @param extent size of the region
+     * @param dest the destination
+     * @param progress optional callback called with the fraction of the decompressed bricks
+     * @throws DataReaderException if the brick data is corrupt
+     */
+    void readRegion(size3_t offset, size3_t extent, void* dest,
+                    const std::function<void(float)>& progress = nullptr) const;
+
+private:
+    struct Entry {
+        size_t offset;
+        size_t size;
+    };
+
+    std::unique_ptr<util::MemoryMappedFile> file_;
+    size_t offset_;
+    bool littleEndian_;
+    size3_t dimensions_;
+    const DataFormatBase* format_;
+    size3_t brickSize_;
+    size3_t brickCounts_;
+    std::vector<Entry> index_;
+    std::vector<std::pair<dvec4, dvec4>> minMax_;
+};
+
+/**
+ * \class CompressedVolumeBrickLoader
+ * \brief Loads the bricks of a VolumeBricked from a CompressedBrickFile.
+ *
+ * The bricks requested have to match the bricks of the file.
+ */
+class IVW_MODULE_BASE_API CompressedVolumeBrickLoader : public VolumeBrickLoader {
+public:
+    explicit CompressedVolumeBrickLoader(std::shared_ptr<const CompressedBrickFile> file);
+    virtual ~CompressedVolumeBrickLoader() = default;
+
+    virtual void loadBrick(size3_t offset, size3_t extent, void* dest) const override;
+
+private:
+    std::shared_ptr<const CompressedBrickFile> file_;
+};
+
+/**
+ * \class CompressedVolumeRAMLoader
+ * \brief Creates VolumeRAM representations from a CompressedBrickFile.
+ *
+ * All bricks are decompressed in parallel directly into the new representation.
+ */
+class IVW_MODULE_BASE_API CompressedVolumeRAMLoader
+    : public DiskRepresentationLoader<VolumeRepresentation> {
+public:
+    explicit CompressedVolumeRAMLoader(std::shared_ptr<const CompressedBrickFile> file);
+    virtual CompressedVolumeRAMLoader* clone() const override;
+    virtual ~CompressedVolumeRAMLoader() = default;
+
+    virtual std::shared_ptr<VolumeRepresentation> createRepresentation(
+        const VolumeRepresentation& src) const override;
+    virtual void updateRepresentation(std::shared_ptr<VolumeRepresentation> dest,
+                                      const VolumeRepresentation& src) const override;
+
+    const std::shared_ptr<const CompressedBrickFile>& getFile() const { return file_; }
+
+    /**
+     * Set a callback that is called with the fraction of the data loaded while creating or
+     * updating a representation. Might be called from any thread.
+     */
+    void setProgressCallback(std::function<void(float)> progress);
+
+private:
+    std::shared_ptr<const CompressedBrickFile> file_;
+    std::function<void(float)> progress_;
+};
+
+namespace util {
+
+struct IVW_MODULE_BASE_API CompressedBrickSettings {
+    /// Size of the bricks, larger bricks compress better but make reading sub-regions slower
+    size3_t brickSize{64};
+    /// zlib compression level, 1 is the fastest and 9 compresses best
+    int level = 1;
+    /// Store the minimum and maximum value of each brick
+    bool brickMinMax = true;
+};
+
+/**
+ * Write \p volume as compressed bricks to \p filePath, in the byte order of the system. The
+ * bricks are compressed in parallel on the thread pool, and only a few bricks are kept in memory
+ * at a time. The file can be read using a CompressedBrickFile with the brick size of \p settings.
+ * @throws DataWriterException if the file could not be written
+ */
+IVW_MODULE_BASE_API void writeCompressedBrickFile(const VolumeRAM& volume,
+                                                  const std::string& filePath,
+                                                  const CompressedBrickSettings& settings = {});
+
+}  // namespace util
+
+}  // namespace inviwo
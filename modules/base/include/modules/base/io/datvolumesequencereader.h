@@ -34,6 +34,7 @@
 #include <inviwo/core/common/inviwo.h>
 #include <inviwo/core/datastructures/volume/volume.h>
 #include <inviwo/core/io/datareader.h>
+#include <inviwo/core/io/rawvolumeramloader.h>
 
 namespace inviwo {
 
@@ -80,8 +81,16 @@ public:
 
     virtual std::shared_ptr<VolumeSequence> readData(const std::string& filePath) override;
 
+    /**
+     * Supports the "MemoryMap" option of RawVolumeReaderOptions. The "BrickSize" option is not
+     * supported, the time steps are always loaded as a whole.
+     */
+    virtual bool setOption(std::string_view key, std::any value) override;
+    virtual std::any getOption(std::string_view key) override;
+
 private:
     bool enableLogOutput_;
+    RawVolumeReaderOptions options_;
 };
 
 }  // namespace inviwo
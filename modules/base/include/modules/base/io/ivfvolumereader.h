@@ -33,6 +33,7 @@
 #include <modules/base/basemoduledefine.h>
 #include <inviwo/core/common/inviwo.h>
 #include <inviwo/core/io/datareader.h>
+#include <inviwo/core/io/rawvolumeramloader.h>
 #include <inviwo/core/datastructures/volume/volume.h>
 
 namespace inviwo {
@@ -48,6 +49,24 @@ public:
     virtual ~IvfVolumeReader() = default;
 
     virtual std::shared_ptr<Volume> readData(const std::string& filePath) override;
+
+    /**
+     * Supports the options of RawVolumeReaderOptions.
+     *
+     * If the ivf file contains a "BrickSize" the raw file is assumed to contain the bricks one
+     * after the other, see util::writeBrickedRawFile, and a VolumeBricked representation with
+     * that brick size is always created.
+     *
+     * If the ivf file contains a "Compression" the raw file is a CompressedBrickFile, see
+     * util::writeCompressedIvfVolume. Then a VolumeDisk representation that decompresses the
+     * bricks in parallel is created, or a VolumeBricked representation with the brick size of the
+     * file if the "BrickSize" option is not zero.
+     */
+    virtual bool setOption(std::string_view key, std::any value) override;
+    virtual std::any getOption(std::string_view key) override;
+
+private:
+    RawVolumeReaderOptions options_;
 };
 
 }  // namespace inviwo
@@ -34,6 +34,9 @@
 #include <inviwo/core/common/inviwo.h>
 #include <inviwo/core/io/datawriter.h>
 #include <inviwo/core/datastructures/volume/volume.h>
+#include <modules/base/io/compressedbrickfile.h>
+
+#include <optional>
 
 namespace inviwo {
 
@@ -43,18 +46,37 @@ namespace inviwo {
 class IVW_MODULE_BASE_API IvfVolumeWriter : public DataWriterType<Volume> {
 public:
     IvfVolumeWriter();
+    /**
+     * Create a writer that stores the voxels as compressed bricks, see
+     * util::writeCompressedIvfVolume
+     */
+    explicit IvfVolumeWriter(const util::CompressedBrickSettings& compression);
     IvfVolumeWriter(const IvfVolumeWriter& rhs);
     IvfVolumeWriter& operator=(const IvfVolumeWriter& that);
     virtual IvfVolumeWriter* clone() const;
     virtual ~IvfVolumeWriter() {}
 
     virtual void writeData(const Volume* data, const std::string filePath) const;
+
+private:
+    std::optional<util::CompressedBrickSettings> compression_;
 };
 
 namespace util {
 IVW_MODULE_BASE_API void writeIvfVolume(const Volume& data, const std::string filePath,
                                         bool overwrite = false);
-}
+
+/**
+ * Write \p data to an ivf file and store the voxels as independently compressed bricks in a
+ * separate ".zraw" file next to it, see CompressedBrickFile. The IvfVolumeReader decompresses
+ * the bricks in parallel, and can read the volume brick by brick into a VolumeBricked.
+ * @throws DataWriterException if a file exists and \p overwrite is false, or if the files could
+ * not be written
+ */
+IVW_MODULE_BASE_API void writeCompressedIvfVolume(const Volume& data, const std::string& filePath,
+                                                  const CompressedBrickSettings& settings = {},
+                                                  bool overwrite = false);
+}  // namespace util
 
 }  // namespace inviwo
 
@@ -65,6 +65,7 @@ public:
     enum class Method {
         MarchingCubes,
         MarchingCubesOpt,
+        MarchingCubesParallel,
         MarchingTetrahedron,
     };
 
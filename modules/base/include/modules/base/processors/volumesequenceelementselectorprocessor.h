@@ -34,6 +34,10 @@
 #include <inviwo/core/common/inviwo.h>
 #include <inviwo/core/datastructures/volume/volume.h>
 #include <inviwo/core/ports/volumeport.h>
+#include <inviwo/core/properties/compositeproperty.h>
+#include <inviwo/core/properties/ordinalproperty.h>
+#include <inviwo/core/properties/stringproperty.h>
+#include <inviwo/core/util/volumesequencestreamer.h>
 #include <modules/base/processors/vectorelementselectorprocessor.h>
 
 namespace inviwo {
@@ -41,7 +45,9 @@ namespace inviwo {
 /** \docpage{org.inviwo.TimeStepSelector, Volume Sequence/Time Selector}
  * ![](org.inviwo.TimeStepSelector.png?classIdentifier=org.inviwo.TimeStepSelector)
  *
- * Select a specific volume out of a sequence of volumes
+ * Select a specific volume out of a sequence of volumes. During playback the next volumes in the
+ * playback direction are loaded in the background, and volumes that are not needed anymore are
+ * unloaded to stay within the memory budget.
  *
  * ### Inport
  *   * __inport__ Sequence of volumes
@@ -50,6 +56,11 @@ namespace inviwo {
  *
  * ### Properties
  *   * __Step__ The volume sequence index to extract
+ *   * __Streaming__
+ *       + __Prefetch Steps__ Number of volumes to load ahead of the selected one
+ *       + __Memory Budget (MB)__ Maximum size of the loaded volumes, 0 means unlimited. Only
+ *         volumes that can be loaded again from disk are unloaded.
+ *       + __Statistics__ Hits, waits, and misses of the selected volumes
  */
 class IVW_MODULE_BASE_API VolumeSequenceElementSelectorProcessor
     : public VectorElementSelectorProcessor<Volume> {
@@ -57,8 +68,18 @@ public:
     VolumeSequenceElementSelectorProcessor();
     virtual ~VolumeSequenceElementSelectorProcessor() = default;
 
+    virtual void process() override;
+
     virtual const ProcessorInfo getProcessorInfo() const override;
     static const ProcessorInfo processorInfo_;
+
+private:
+    CompositeProperty streaming_;
+    IntSizeTProperty prefetchSteps_;
+    IntSizeTProperty memoryBudget_;
+    StringProperty statistics_;
+
+    VolumeSequenceStreamer streamer_;
 };
 
 }  // namespace inviwo
@@ -30,6 +30,8 @@
 #include <modules/base/algorithm/dataminmax.h>
 #include <inviwo/core/datastructures/volume/volume.h>
 #include <inviwo/core/datastructures/volume/volumeramprecision.h>
+#include <inviwo/core/datastructures/volume/volumebricked.h>
+#include <inviwo/core/util/volumeutils.h>
 #include <inviwo/core/datastructures/image/layer.h>
 #include <inviwo/core/datastructures/image/layerramprecision.h>
 #include <inviwo/core/datastructures/buffer/buffer.h>
@@ -44,6 +46,18 @@ std::pair<dvec4, dvec4> util::volumeMinMax(const VolumeRAM* volume, IgnoreSpecia
     });
 }
 
+std::pair<dvec4, dvec4> util::volumeMinMax(const VolumeBricked* volume,
+                                           IgnoreSpecialValues ignore) {
+    const auto& format = *volume->getDataFormat();
+    std::pair<dvec4, dvec4> minmax{dvec4{format.getMax()}, dvec4{format.getLowest()}};
+    volume->forEachBrick([&](const VolumeRAM& brick, size3_t) {
+        const auto brickMinMax = util::volumeMinMax(&brick, ignore);
+        minmax.first = glm::min(minmax.first, brickMinMax.first);
+        minmax.second = glm::max(minmax.second, brickMinMax.second);
+    });
+    return minmax;
+}
+
 std::pair<dvec4, dvec4> util::layerMinMax(const LayerRAM* layer, IgnoreSpecialValues ignore) {
     return layer->dispatch<std::pair<dvec4, dvec4>>([&ignore](auto lr) -> std::pair<dvec4, dvec4> {
         const auto dim = lr->getDimensions();
@@ -58,6 +72,9 @@ std::pair<dvec4, dvec4> util::bufferMinMax(const BufferRAM* buffer, IgnoreSpecia
 }
 
 std::pair<dvec4, dvec4> util::volumeMinMax(const Volume* volume, IgnoreSpecialValues ignore) {
+    if (auto bricked = util::getBrickedRepresentation(*volume)) {
+        return util::volumeMinMax(bricked, ignore);
+    }
     return util::volumeMinMax(volume->getRepresentation<VolumeRAM>(), ignore);
 }
 
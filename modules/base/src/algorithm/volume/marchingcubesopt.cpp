@@ -34,9 +34,15 @@
 #include <modules/base/datastructures/disjointsets.h>
 #include <glm/gtx/normal.hpp>
 
+#include <inviwo/core/common/inviwoapplication.h>
+
 #include <algorithm>
 #include <limits>
 #include <bitset>
+#include <cstdint>
+#include <future>
+#include <mutex>
+#include <optional>
 
 namespace inviwo {
 
@@ -244,7 +250,7 @@ class VCache {
 public:
     enum CacheName { xCacheCurr, xCacheNext, yCacheCurr, yCacheNext, zCacheCurr, zCacheNext };
     enum CachePosName { xCurr0, xCurr1, xNext0, xNext1, yCurr, yNext, zCurr, zNext };
-    VCache(const size2_t& dim) : cIm{dim} {
+    VCache(const size2_t& dim, size_t zStart = 0) : cIm{dim}, zStart_{zStart} {
         cache[xCacheCurr].resize(dim.x * dim.y);
         cache[xCacheNext].resize(dim.x * dim.y);
         cache[yCacheCurr].resize(dim.x * dim.y);
@@ -256,28 +262,28 @@ public:
     std::pair<size_t, bool> find(const size3_t& ind, int edge, const size_t& val) {
         switch (edge) {
             case 0:
-                if (ind.z == 0 && ind.y == 0) {
+                if (ind.z == zStart_ && ind.y == 0) {
                     cache[xCacheCurr][cIm(pos[xCurr0], ind.y)] = val;
                     return {val, true};
                 } else {
                     return {cache[xCacheCurr][cIm(pos[xCurr0], ind.y)], false};
                 }
             case 1:
-                if (ind.z == 0) {
+                if (ind.z == zStart_) {
                     cache[yCacheCurr][cIm(pos[yCurr] + 1, ind.y)] = val;
                     return {val, true};
                 } else {
                     return {cache[yCacheCurr][cIm(pos[yCurr] + 1, ind.y)], false};
                 }
             case 2:
-                if (ind.z == 0) {
+                if (ind.z == zStart_) {
                     cache[xCacheCurr][cIm(pos[xCurr1], ind.y + 1)] = val;
                     return {val, true};
                 } else {
                     return {cache[xCacheCurr][cIm(pos[xCurr1], ind.y + 1)], false};
                 }
             case 3:
-                if (ind.z == 0 && ind.x == 0) {
+                if (ind.z == zStart_ && ind.x == 0) {
                     cache[yCacheCurr][cIm(pos[yCurr], ind.y)] = val;
                     return {val, true};
                 } else {
@@ -355,6 +361,7 @@ public:
 
 private:
     util::IndexMapper2D cIm;
+    size_t zStart_;
     std::array<std::vector<size_t>, 6> cache;
     std::array<size_t, 8> pos;
 };
@@ -429,14 +436,251 @@ template <typename T, typename IsoTest>
 const std::array<OffsetIndexMasks, 4> Index<T, IsoTest>::oim_ = {
     {{0, 1, {0, 0, 0}}, {3, 2, {0, 1, 0}}, {4, 5, {0, 0, 1}}, {7, 6, {0, 1, 1}}}};
 
-}  // namespace
+// Thinner slabs spend too much time on their caches and on stitching
+constexpr size_t minSlabDepth = 16;
+
+/**
+ * The vertices, normals, and triangles of one z-slab of the volume. When slabs are stitched, the
+ * vertices on the first and last z-plane of the slab are recorded by the edge they are on.
+ */
+struct Slab {
+    static constexpr std::uint32_t none = std::numeric_limits<std::uint32_t>::max();
+
+    std::vector<vec3> positions;
+    std::vector<vec3> normals;
+    std::vector<std::uint32_t> indices;
+    // z-plane edge key (see planeEdgeKey) to vertex index
+    std::vector<std::uint32_t> bottom;
+    std::vector<std::uint32_t> top;
+};
 
-namespace util {
-std::shared_ptr<Mesh> marchingCubesOpt(std::shared_ptr<const Volume> volume, double iso,
-                                       const vec4& color, bool invert, bool enclose,
-                                       std::function<void(float)> progressCallback,
-                                       std::function<bool(const size3_t&)> maskingCallback) {
+/**
+ * Key of an edge in a z-plane, for the edges 0-3 (bottom) and 8-11 (top) of a cell.
+ */
+size_t planeEdgeKey(const size3_t& ind, int edge, size_t dimX) {
+    // {dx, dy, direction} for the edges 0-3, edges 8-11 match 0-3
+    static constexpr std::array<std::array<size_t, 3>, 4> edgeOffsets{
+        {{0, 0, 0}, {1, 0, 1}, {0, 1, 0}, {0, 0, 1}}};
+    const auto& o = edgeOffsets[edge % 4];
+    return 2 * ((ind.y + o[1]) * dimX + ind.x + o[0]) + o[2];
+}
 
+/**
+ * Marks bricks of cells that the iso surface can pass through, i.e. bricks with voxels on both
+ * sides of the iso value. Cells in other bricks need not be visited.
+ */
+class ActiveBricks {
+public:
+    static constexpr size_t brickSize = 8;
+
+    ActiveBricks(const size3_t& dim)
+        : cells_{dim - size3_t{1}}
+        , counts_{(cells_ + size3_t{brickSize - 1}) / brickSize}
+        , active_(counts_.x * counts_.y, 0) {}
+
+    /**
+     * Update the active bricks for the layer of bricks starting at cell z
+     */
+    template <typename T, typename IsoTest>
+    void update(const T* src, const util::IndexMapper3D& im, size_t z, const IsoTest& test) {
+        const size_t zEnd = std::min(z + brickSize, cells_.z);
+        for (size_t by = 0; by < counts_.y; ++by) {
+            for (size_t bx = 0; bx < counts_.x; ++bx) {
+                const size3_t begin{bx * brickSize, by * brickSize, z};
+                // the voxels of the cells in the brick, i.e. including the far border
+                const size3_t end{std::min(begin.x + brickSize, cells_.x) + 1,
+                                  std::min(begin.y + brickSize, cells_.y) + 1, zEnd + 1};
+                active_[by * counts_.x + bx] = isActive(src, im, begin, end, test);
+            }
+        }
+    }
+
+    bool operator()(size_t x, size_t y) const {
+        return active_[(y / brickSize) * counts_.x + x / brickSize] != 0;
+    }
+
+    /// The first cell after the brick containing cell x
+    size_t next(size_t x) const { return std::min((x / brickSize + 1) * brickSize, cells_.x); }
+
+private:
+    template <typename T, typename IsoTest>
+    static bool isActive(const T* src, const util::IndexMapper3D& im, const size3_t& begin,
+                         const size3_t& end, const IsoTest& test) {
+        const bool first = test(src[im(begin)]);
+        for (size_t z = begin.z; z < end.z; ++z) {
+            for (size_t y = begin.y; y < end.y; ++y) {
+                const T* row = src + im(begin.x, y, z);
+                for (size_t x = 0; x < end.x - begin.x; ++x) {
+                    if (test(row[x]) != first) return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    size3_t cells_;
+    size3_t counts_;
+    std::vector<char> active_;
+};
+
+/**
+ * Run marching cubes over the cells with z in [zBegin, zEnd). If the slab will be stitched to its
+ * neighbors, the slab.bottom and slab.top maps have to be allocated.
+ */
+template <typename T, typename IsoTest, typename MapValue>
+void marchSlab(const T* src, const size3_t& dim, size_t zBegin, size_t zEnd,
+               const IsoTest& isoTest, const MapValue& mapValue, bool skipEmpty,
+               const std::function<bool(const size3_t&)>& maskingCallback,
+               const std::function<void()>& layerDone, Slab& slab) {
+    static const marching::Config cube{};
+
+    const size3_t dim1 = dim - size3_t{1, 1, 1};
+    const util::IndexMapper3D im(dim);
+    const bool record = !slab.bottom.empty();
+
+    auto& positions = slab.positions;
+    auto& normals = slab.normals;
+    auto& indices = slab.indices;
+
+    const auto dr = dvec3(1.0) / dvec3{glm::max(size3_t{1}, (dim - size3_t{1}))};
+    const auto doffs = [&]() {
+        std::array<dvec3, 8> tmp;
+        std::transform(cube.vertices.begin(), cube.vertices.end(), tmp.begin(),
+                       [dr](auto& v) { return dr * dvec3{v}; });
+        return tmp;
+    }();
+
+    const auto interpolate = [src, im, &mapValue, &doffs](const size3_t& ind, const dvec3& pos,
+                                                          marching::Config::EdgeId e) {
+        const auto a = cube.edges[e][0];
+        const auto b = cube.edges[e][1];
+        const auto tv0 = src[im(ind + cube.vertices[a])];
+        const auto v0 = mapValue(tv0);
+        const auto tv1 = src[im(ind + cube.vertices[b])];
+        const auto v1 = mapValue(tv1);
+
+        const auto t = v0 / (v0 - v1);
+        const auto r0 = pos + doffs[a];
+        const auto r1 = pos + doffs[b];
+        return r0 + t * (r1 - r0);
+    };
+
+    VCache vcache(size2_t{dim.x, dim.y}, zBegin);
+    Index<T, IsoTest> index(src, im, isoTest);
+    std::optional<ActiveBricks> active;
+    if (skipEmpty && zBegin < zEnd) active.emplace(dim);
+
+    size3_t ind;
+    dvec3 pos{0.0};
+    // accumulate the position the same way for all slabs to get identical vertices at the seams
+    for (size_t z = 0; z < zBegin; ++z) pos.z += dr.z;
+
+    const float err =
+        static_cast<float>(4.0 * glm::epsilon<double>() * glm::epsilon<double>() * dr.x * dr.y);
+
+    for (ind.z = zBegin; ind.z < zEnd; ++ind.z, pos.z += dr.z) {
+        if (active && (ind.z == zBegin || (ind.z % ActiveBricks::brickSize) == 0)) {
+            active->update(src, im, ind.z, isoTest);
+        }
+        vcache.incZ();
+        for (ind.y = 0, pos.y = 0.0; ind.y < dim1.y; ++ind.y, pos.y += dr.y) {
+            ind.x = 0;
+            const auto cInd = im(ind);
+            vcache.incY();
+            index.init(cInd);
+            for (pos.x = 0.0; ind.x < dim1.x; ++ind.x, pos.x += dr.x) {
+                if (active && !(*active)(ind.x, ind.y)) {
+                    // skip to the last cell of the brick, and restart the index after it
+                    for (const auto next = active->next(ind.x) - 1; ind.x < next; ++ind.x) {
+                        pos.x += dr.x;
+                    }
+                    if (ind.x + 1 < dim1.x) index.init(cInd + ind.x + 1);
+                    continue;
+                }
+
+                index.update(cInd + ind.x);
+                if (index == 0 || index == 255) continue;
+                if (maskingCallback && !maskingCallback(ind)) continue;
+
+                std::array<size_t, 12> inds;
+                for (const auto edge : cube.caseEdges[index]) {
+                    const auto c = vcache.find(ind, edge, positions.size());
+                    inds[edge] = c.first;
+                    if (c.second) {
+                        if (record && ind.z == zBegin && edge < 4) {
+                            slab.bottom[planeEdgeKey(ind, edge, dim.x)] =
+                                static_cast<std::uint32_t>(positions.size());
+                        } else if (record && ind.z + 1 == zEnd && edge >= 8) {
+                            slab.top[planeEdgeKey(ind, edge, dim.x)] =
+                                static_cast<std::uint32_t>(positions.size());
+                        }
+                        const auto vertex = interpolate(ind, pos, edge);
+                        positions.emplace_back(vertex);
+                        normals.emplace_back(0.0f, 0.0f, 0.0f);
+                    }
+                }
+                for (const auto& tri : cube.caseTriangles[index]) {
+                    const auto side0 = positions[inds[tri[1]]] - positions[inds[tri[0]]];
+                    const auto side1 = positions[inds[tri[2]]] - positions[inds[tri[0]]];
+                    auto n = glm::cross(side0, side1);
+                    if (glm::length2(n) < err) {
+                        continue;  // triangle is so small area is 0.
+                    }
+                    n = glm::normalize(n);
+                    for (int v = 0; v < 3; ++v) {
+                        indices.push_back(static_cast<uint32_t>(inds[tri[v]]));
+                        normals[inds[tri[v]]] += n;
+                    }
+                }
+                vcache.incX(cube.caseIncrements[index]);
+            }
+        }
+        if (layerDone) layerDone();
+    }
+}
+
+/**
+ * Append the slabs to the first one. The vertices on the bottom plane of each slab were also
+ * created by the previous slab, they are replaced by those and their normals are merged.
+ */
+void stitch(std::vector<Slab>& slabs) {
+    auto& res = slabs.front();
+    // global index of the top plane vertices of the previous slab
+    std::vector<std::uint32_t> prevTop = std::move(res.top);
+
+    for (size_t s = 1; s < slabs.size(); ++s) {
+        auto& slab = slabs[s];
+        std::vector<std::uint32_t> map(slab.positions.size(), Slab::none);
+        for (size_t key = 0; key < slab.bottom.size(); ++key) {
+            const auto local = slab.bottom[key];
+            if (local != Slab::none && prevTop[key] != Slab::none) {
+                map[local] = prevTop[key];
+                res.normals[prevTop[key]] += slab.normals[local];
+            }
+        }
+        for (size_t i = 0; i < map.size(); ++i) {
+            if (map[i] == Slab::none) {
+                map[i] = static_cast<std::uint32_t>(res.positions.size());
+                res.positions.push_back(slab.positions[i]);
+                res.normals.push_back(slab.normals[i]);
+            }
+        }
+        std::transform(slab.indices.begin(), slab.indices.end(),
+                       std::back_inserter(res.indices), [&](auto i) { return map[i]; });
+
+        for (auto& vertex : slab.top) {
+            if (vertex != Slab::none) vertex = map[vertex];
+        }
+        prevTop = std::move(slab.top);
+        slab = Slab{};
+    }
+}
+
+std::shared_ptr<Mesh> extractSurface(std::shared_ptr<const Volume> volume, double iso,
+                                     const vec4& color, bool invert, bool enclose,
+                                     std::function<void(float)> progressCallback,
+                                     std::function<bool(const size3_t&)> maskingCallback,
+                                     size_t nSlabs, bool skipEmpty) {
     auto indexBuffer = std::make_shared<IndexBuffer>();
     auto vertexBuffer = std::make_shared<Buffer<vec3>>();
     auto textureBuffer = std::make_shared<Buffer<vec3>>();
@@ -453,89 +697,56 @@ std::shared_ptr<Mesh> marchingCubesOpt(std::shared_ptr<const Volume> volume, dou
     if (progressCallback) progressCallback(0.0f);
 
     const auto mc = [&](auto ram, auto isoTest, auto mapValue) {
-        using T = util::PrecisionValueType<decltype(ram)>;
-        static const marching::Config cube{};
-
-        const T* src = ram->getDataTyped();
+        const auto src = ram->getDataTyped();
         const size3_t dim{volume->getDimensions()};
-        const size3_t dim1 = dim - size3_t{1, 1, 1};
-        const util::IndexMapper3D im(dim);
-
-        const auto dr = dvec3(1.0) / dvec3{glm::max(size3_t{1}, (dim - size3_t{1}))};
-        const auto doffs = [&]() {
-            std::array<dvec3, 8> tmp;
-            std::transform(cube.vertices.begin(), cube.vertices.end(), tmp.begin(),
-                           [dr](auto& v) { return dr * dvec3{v}; });
-            return tmp;
-        }();
-
-        const auto interpolate = [src, im, &mapValue, &doffs](const size3_t& ind, const dvec3& pos,
-                                                              marching::Config::EdgeId e) {
-            const auto a = cube.edges[e][0];
-            const auto b = cube.edges[e][1];
-            const auto tv0 = src[im(ind + cube.vertices[a])];
-            const auto v0 = mapValue(tv0);
-            const auto tv1 = src[im(ind + cube.vertices[b])];
-            const auto v1 = mapValue(tv1);
-
-            const auto t = v0 / (v0 - v1);
-            const auto r0 = pos + doffs[a];
-            const auto r1 = pos + doffs[b];
-            return r0 + t * (r1 - r0);
+        const size_t layers = dim.z > 0 ? dim.z - 1 : 0;
+        nSlabs = std::clamp(nSlabs, size_t{1}, std::max(layers, size_t{1}));
+
+        std::vector<Slab> slabs(nSlabs);
+        if (nSlabs > 1) {
+            for (auto& slab : slabs) {
+                slab.bottom.resize(2 * dim.x * dim.y, Slab::none);
+                slab.top.resize(2 * dim.x * dim.y, Slab::none);
+            }
+        }
+
+        std::mutex progressMutex;
+        size_t layersDone = 0;
+        const auto layerDone = [&]() {
+            if (!progressCallback) return;
+            std::lock_guard<std::mutex> lock{progressMutex};
+            ++layersDone;
+            progressCallback(static_cast<float>(layersDone) / static_cast<float>(dim.z - 1));
+        };
+        const auto march = [&](size_t s) {
+            marchSlab(src, dim, layers * s / nSlabs, layers * (s + 1) / nSlabs, isoTest, mapValue,
+                      skipEmpty, maskingCallback, layerDone, slabs[s]);
         };
 
-        VCache vcache(size2_t{dim.x, dim.y});
-        Index<T, decltype(isoTest)> index(src, im, isoTest);
-        size3_t ind;
-        dvec3 pos;
-
-        const float err =
-            static_cast<float>(4.0 * glm::epsilon<double>() * glm::epsilon<double>() * dr.x * dr.y);
-
-        for (ind.z = 0, pos.z = 0.0; ind.z < dim1.z; ++ind.z, pos.z += dr.z) {
-            vcache.incZ();
-            for (ind.y = 0, pos.y = 0.0; ind.y < dim1.y; ++ind.y, pos.y += dr.y) {
-                ind.x = 0;
-                const auto cInd = im(ind);
-                vcache.incY();
-                index.init(cInd);
-                for (pos.x = 0.0; ind.x < dim1.x; ++ind.x, pos.x += dr.x) {
-                    index.update(cInd + ind.x);
-                    if (index == 0 || index == 255) continue;
-                    if (maskingCallback && !maskingCallback(ind)) continue;
-
-                    std::array<size_t, 12> inds;
-                    for (const auto edge : cube.caseEdges[index]) {
-                        const auto c = vcache.find(ind, edge, positions.size());
-                        inds[edge] = c.first;
-                        if (c.second) {
-                            const auto vertex = interpolate(ind, pos, edge);
-                            positions.emplace_back(vertex);
-                            normals.emplace_back(0.0f, 0.0f, 0.0f);
-                        }
-                    }
-                    for (const auto& tri : cube.caseTriangles[index]) {
-                        const auto side0 = positions[inds[tri[1]]] - positions[inds[tri[0]]];
-                        const auto side1 = positions[inds[tri[2]]] - positions[inds[tri[0]]];
-                        auto n = glm::cross(side0, side1);
-                        if (glm::length2(n) < err) {
-                            continue;  // triangle is so small area is 0.
-                        }
-                        n = glm::normalize(n);
-                        for (int v = 0; v < 3; ++v) {
-                            indices.push_back(static_cast<uint32_t>(inds[tri[v]]));
-                            normals[inds[tri[v]]] += n;
-                        }
-                    }
-                    vcache.incX(cube.caseIncrements[index]);
-                }
+        if (nSlabs > 1 && InviwoApplication::isInitialized() &&
+            InviwoApplication::getPtr()->getPoolSize() > 0) {
+            auto& pool = InviwoApplication::getPtr()->getThreadPool();
+            std::vector<std::future<void>> futures;
+            for (size_t s = 0; s < nSlabs; ++s) {
+                futures.push_back(pool.enqueue(march, s));
+            }
+            for (auto& future : futures) {
+                pool.wait(future);
             }
-            if (progressCallback) {
-                progressCallback(static_cast<float>(ind.z + 1) / static_cast<float>(dim.z - 1));
+            for (auto& future : futures) {
+                future.get();
             }
+        } else {
+            for (size_t s = 0; s < nSlabs; ++s) march(s);
         }
+        stitch(slabs);
+
+        positions = std::move(slabs.front().positions);
+        normals = std::move(slabs.front().normals);
+        indices = std::move(slabs.front().indices);
 
         if (enclose) {
+            const auto dr = dvec3(1.0) / dvec3{glm::max(size3_t{1}, (dim - size3_t{1}))};
             marching::encloseSurfce(src, dim, indexRAM, positions, normals, iso, invert, dr.x, dr.y,
                                     dr.z);
         }
@@ -581,6 +792,31 @@ std::shared_ptr<Mesh> marchingCubesOpt(std::shared_ptr<const Volume> volume, dou
 
     return mesh;
 }
+
+}  // namespace
+
+namespace util {
+std::shared_ptr<Mesh> marchingCubesOpt(std::shared_ptr<const Volume> volume, double iso,
+                                       const vec4& color, bool invert, bool enclose,
+                                       std::function<void(float)> progressCallback,
+                                       std::function<bool(const size3_t&)> maskingCallback) {
+    return extractSurface(volume, iso, color, invert, enclose, std::move(progressCallback),
+                          std::move(maskingCallback), 1, false);
+}
+
+std::shared_ptr<Mesh> marchingCubesParallel(std::shared_ptr<const Volume> volume, double iso,
+                                            const vec4& color, bool invert, bool enclose,
+                                            std::function<void(float)> progressCallback,
+                                            std::function<bool(const size3_t&)> maskingCallback,
+                                            size_t slabs) {
+    if (slabs == 0) {
+        const size_t poolSize =
+            InviwoApplication::isInitialized() ? InviwoApplication::getPtr()->getPoolSize() : 0;
+        slabs = std::min(2 * poolSize, volume->getDimensions().z / minSlabDepth);
+    }
+    return extractSurface(volume, iso, color, invert, enclose, std::move(progressCallback),
+                          std::move(maskingCallback), slabs, true);
+}
 }  // namespace util
 
 }  // namespace inviwo
@@ -28,15 +28,62 @@
  *********************************************************************************/
 
 #include <modules/base/algorithm/volume/volumelaplacian.h>
+#include <modules/base/algorithm/volume/volumestencil.h>
+
+#include <inviwo/core/datastructures/volume/volumeram.h>
+
+#include <algorithm>
 
 namespace inviwo {
 
 std::shared_ptr<Volume> util::volumeLaplacian(std::shared_ptr<const Volume> volume,
                                               VolumeLaplacianPostProcessing postProcessing,
                                               double scale) {
-    util::detail::VolumeLaplacianDispatcher disp;
-    return dispatching::dispatch<std::shared_ptr<Volume>, dispatching::filter::All>(
-        volume->getDataFormat()->getId(), disp, volume, postProcessing, scale);
+    std::shared_ptr<Volume> newVolume =
+        std::move(derivativeVolumes(*volume, {VolumeDerivative::Laplacian}).front());
+
+    // Make range symmetric
+    const auto rangemax = newVolume->dataMap_.dataRange.y;
+
+    // The Laplacian has float components, and the post processing is done per component
+    const auto transform = [&](auto func) {
+        auto ram = newVolume->getEditableRepresentation<VolumeRAM>();
+        auto data = static_cast<float*>(ram->getData());
+        const auto size =
+            glm::compMul(ram->getDimensions()) * ram->getDataFormat()->getComponents();
+        std::transform(data, data + size, data, func);
+    };
+
+    switch (postProcessing) {
+        case VolumeLaplacianPostProcessing::Normalized:
+            transform([&](float v) {
+                return (v + static_cast<float>(rangemax)) / static_cast<float>(2.0 * rangemax);
+            });
+            newVolume->dataMap_.dataRange = dvec2(0.0, 1.0);
+            newVolume->dataMap_.valueRange = dvec2(0.0, 1.0);
+            break;
+        case VolumeLaplacianPostProcessing::SignNormalized:
+            transform([&](float v) {
+                return (v + static_cast<float>(rangemax)) / static_cast<float>(rangemax) - 1.0f;
+            });
+            newVolume->dataMap_.dataRange = dvec2(-1.0, 1.0);
+            newVolume->dataMap_.valueRange = dvec2(-1.0, 1.0);
+            break;
+        case VolumeLaplacianPostProcessing::Scaled:
+            transform([&](float v) { return v * static_cast<float>(scale); });
+            newVolume->dataMap_.dataRange = dvec2(-rangemax * scale, rangemax * scale);
+            newVolume->dataMap_.valueRange = dvec2(-rangemax * scale, rangemax * scale);
+            break;
+        case VolumeLaplacianPostProcessing::None:
+        default:
+            newVolume->dataMap_.dataRange = dvec2(-rangemax, rangemax);
+            newVolume->dataMap_.valueRange = dvec2(-rangemax, rangemax);
+            break;
+    }
+
+    newVolume->dataMap_.valueUnit = "Laplacian";
+
+    return newVolume;
 }
 
 }  // namespace inviwo
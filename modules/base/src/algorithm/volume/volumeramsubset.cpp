@@ -28,6 +28,7 @@
  *********************************************************************************/
 
 #include <modules/base/algorithm/volume/volumeramsubset.h>
+#include <inviwo/core/datastructures/volume/volumebricked.h>
 
 #ifdef IVW_USE_OPENMP
 #include <omp.h>
@@ -122,6 +123,16 @@ std::shared_ptr<VolumeRAM> VolumeRAMSubSet::apply(const VolumeRepresentation* in
                                                   size3_t offset,
                                                   const VolumeBorders& border /*= VolumeBorders()*/,
                                                   bool clampBorderOutsideVolume /*= true*/) {
+    if (auto bricked = dynamic_cast<const VolumeBricked*>(in)) {
+        // Only read the bricks covering the subset and its borders inside the volume, the
+        // borders outside of the volume are handled as if the region was the whole volume
+        const auto dims = bricked->getDimensions();
+        const auto regionBegin = glm::min(offset - glm::min(border.llf, offset), dims);
+        const auto regionEnd = glm::max(glm::min(offset + dim + border.urb, dims), regionBegin);
+        const auto region = bricked->readRegion(regionBegin, regionEnd - regionBegin);
+        return apply(region.get(), dim, offset - regionBegin, border, clampBorderOutsideVolume);
+    }
+
     detail::VolumeRAMSubSetDispatcher disp;
     return dispatching::dispatch<std::shared_ptr<VolumeRAM>, dispatching::filter::All>(
         in->getDataFormat()->getId(), disp, in, dim, offset, border, clampBorderOutsideVolume);
@@ -0,0 +1,211 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <modules/base/algorithm/volume/volumestencil.h>
+
+#include <inviwo/core/datastructures/volume/volume.h>
+#include <inviwo/core/datastructures/volume/volumeram.h>
+#include <inviwo/core/util/exception.h>
+#include <inviwo/core/util/formats.h>
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <limits>
+#include <mutex>
+
+namespace inviwo {
+
+namespace util {
+
+dvec3 voxelSpacing(const Volume& volume) {
+    const dmat4 m{volume.getCoordinateTransformer().getDataToWorldMatrix()};
+    const auto a = m * dvec4(0.0, 0.0, 0.0, 1.0);
+    const auto b =
+        m * dvec4(dvec3(1.0) / dvec3(glm::max(volume.getDimensions(), size3_t(2)) - size3_t(1)),
+                  1.0);
+    return dvec3(b - a);
+}
+
+namespace {
+
+constexpr size_t nDerivatives = 5;
+
+// The min and max values written to each output
+using Ranges = std::array<dvec2, nDerivatives>;
+
+Ranges emptyRanges() {
+    Ranges ranges;
+    ranges.fill(dvec2{std::numeric_limits<double>::max(), std::numeric_limits<double>::lowest()});
+    return ranges;
+}
+
+template <typename T>
+void expand(dvec2& range, const T& value) {
+    for (size_t i = 0; i < util::flat_extent<T>::value; ++i) {
+        const auto v = static_cast<double>(util::glmcomp(value, i));
+        range.x = std::min(range.x, v);
+        range.y = std::max(range.y, v);
+    }
+}
+
+template <typename R>
+std::pair<std::unique_ptr<Volume>, R*> createOutput(const Volume& volume) {
+    auto ram = std::make_shared<VolumeRAMPrecision<R>>(volume.getDimensions(),
+                                                         DataInit::Uninitialized);
+    auto data = ram->getDataTyped();
+    auto output = std::make_unique<Volume>(ram);
+    output->setModelMatrix(volume.getModelMatrix());
+    output->setWorldMatrix(volume.getWorldMatrix());
+    output->setWrapping(volume.getWrapping());
+    output->dataMap_ = volume.dataMap_;
+    return {std::move(output), data};
+}
+
+}  // namespace
+
+std::vector<std::unique_ptr<Volume>> derivativeVolumes(
+    const Volume& volume, const std::vector<VolumeDerivative>& derivatives, size_t channel) {
+
+    const auto components = volume.getDataFormat()->getComponents();
+    if (channel >= components) {
+        throw Exception(fmt::format("Channel {} out of range for a volume with {} channels",
+                                    channel, components),
+                        IVW_CONTEXT_CUSTOM("util::derivativeVolumes"));
+    }
+    for (auto derivative : derivatives) {
+        if ((derivative == VolumeDerivative::Divergence || derivative == VolumeDerivative::Curl) &&
+            components != 3) {
+            throw Exception(
+                fmt::format("The divergence and curl require a volume with 3 channels, got {}",
+                            components),
+                IVW_CONTEXT_CUSTOM("util::derivativeVolumes"));
+        }
+    }
+    const auto requested = [&](VolumeDerivative d) {
+        return std::find(derivatives.begin(), derivatives.end(), d) != derivatives.end();
+    };
+
+    const auto spacing = voxelSpacing(volume);
+    const auto wrapping = volume.getWrapping();
+
+    std::array<std::unique_ptr<Volume>, nDerivatives> outputs;
+
+    volume.getRepresentation<VolumeRAM>()->dispatch<void>([&](auto ram) {
+        using T = util::PrecisionValueType<decltype(ram)>;
+        // single precision is sufficient unless the data is in double precision
+        using F = std::conditional_t<std::is_same_v<typename util::value_type<T>::type, double>,
+                                     double, float>;
+        using R = typename util::same_extent<T, float>::type;
+
+        const auto create = [&](VolumeDerivative d, auto tag) {
+            using Type = decltype(tag);
+            if (!requested(d)) return static_cast<Type*>(nullptr);
+            auto [output, data] = createOutput<Type>(volume);
+            outputs[static_cast<size_t>(d)] = std::move(output);
+            return data;
+        };
+        auto gradient = create(VolumeDerivative::Gradient, vec3{});
+        auto magnitude = create(VolumeDerivative::GradientMagnitude, float{});
+        auto divergence = create(VolumeDerivative::Divergence, float{});
+        auto curl = create(VolumeDerivative::Curl, vec3{});
+        auto laplacian = create(VolumeDerivative::Laplacian, R{});
+
+        std::mutex mutex;
+        Ranges ranges = emptyRanges();
+
+        detail::forEachSlice(ram->getDimensions().z, [&](size_t z) {
+            Ranges local = emptyRanges();
+            const auto kernel = [&](const auto& s, size_t i) {
+                if (gradient || magnitude) {
+                    const auto g = util::gradient(s, channel);
+                    if (gradient) {
+                        gradient[i] = static_cast<vec3>(g);
+                        expand(local[0], gradient[i]);
+                    }
+                    if (magnitude) {
+                        magnitude[i] = static_cast<float>(glm::length(g));
+                        expand(local[1], magnitude[i]);
+                    }
+                }
+                if constexpr (util::extent<T>::value == 3) {
+                    if (divergence) {
+                        divergence[i] = static_cast<float>(util::divergence(s));
+                        expand(local[2], divergence[i]);
+                    }
+                    if (curl) {
+                        curl[i] = static_cast<vec3>(util::curl(s));
+                        expand(local[3], curl[i]);
+                    }
+                }
+                if (laplacian) {
+                    laplacian[i] = static_cast<R>(s.laplacian());
+                    expand(local[4], laplacian[i]);
+                }
+            };
+            forEachStencilInSlice<F>(*ram, wrapping, spacing, z, kernel);
+
+            std::scoped_lock lock{mutex};
+            for (size_t i = 0; i < nDerivatives; ++i) {
+                ranges[i].x = std::min(ranges[i].x, local[i].x);
+                ranges[i].y = std::max(ranges[i].y, local[i].y);
+            }
+        });
+
+        for (size_t i = 0; i < nDerivatives; ++i) {
+            if (!outputs[i]) continue;
+            const double minV = ranges[i].x;
+            const double maxV = ranges[i].y;
+            const auto range = std::max(std::abs(minV), std::abs(maxV));
+            auto& dataMap = outputs[i]->dataMap_;
+            dataMap.dataRange = static_cast<VolumeDerivative>(i) ==
+                                        VolumeDerivative::GradientMagnitude
+                                    ? dvec2(0.0, maxV)
+                                    : dvec2(-range, range);
+            dataMap.valueRange = dvec2(minV, maxV);
+        }
+    });
+
+    std::vector<std::unique_ptr<Volume>> result;
+    for (auto derivative : derivatives) {
+        auto& output = outputs[static_cast<size_t>(derivative)];
+        if (output) {
+            result.push_back(std::move(output));
+        } else {
+            // the derivative was requested more than once
+            auto it = std::find(derivatives.begin(), derivatives.end(), derivative);
+            result.emplace_back(result[std::distance(derivatives.begin(), it)]->clone());
+        }
+    }
+    return result;
+}
+
+}  // namespace util
+
+}  // namespace inviwo
@@ -29,7 +29,10 @@
 
 #include <modules/base/algorithm/volume/volumevoronoi.h>
 
+#include <algorithm>
 #include <array>
+#include <cmath>
+#include <limits>
 
 namespace inviwo {
 namespace util {
@@ -69,12 +72,241 @@ constexpr auto build_array(Functor&& func) noexcept {
                                    std::make_integer_sequence<Index, N>());
 }
 
+/**
+ * Uniform grid over the seed points used to find the seed point with the smallest (power)
+ * distance without comparing against all seed points. The grid cells are visited in shells of
+ * increasing distance around the query point until the remaining cells cannot contain a closer
+ * seed point. For periodic axes the query is repeated for the images of the query point shifted
+ * by the volume size. Candidates are always compared using distance2(), hence the result is the
+ * same as for a linear search, including ties which are resolved in favor of the first seed
+ * point.
+ */
+class SeedGrid {
+public:
+    struct Seed {
+        vec3 pos;
+        float weight2;
+        std::uint32_t index;
+        std::uint32_t order;  //!< position in the list of seed points, used to resolve ties
+    };
+
+    SeedGrid(const std::vector<std::pair<uint32_t, vec3>>& seedPointsWithIndices,
+             const std::vector<float>* weights) {
+        std::vector<Seed> seeds(seedPointsWithIndices.size());
+        for (size_t i = 0; i < seeds.size(); ++i) {
+            const float w = weights ? (*weights)[i] : 0.0f;
+            seeds[i] = Seed{seedPointsWithIndices[i].second, w * w,
+                            seedPointsWithIndices[i].first, static_cast<std::uint32_t>(i)};
+            maxWeight2_ = std::max(maxWeight2_, seeds[i].weight2);
+        }
+
+        min_ = vec3{std::numeric_limits<float>::max()};
+        vec3 max{std::numeric_limits<float>::lowest()};
+        for (const auto& seed : seeds) {
+            min_ = glm::min(min_, seed.pos);
+            max = glm::max(max, seed.pos);
+        }
+        const vec3 extent = max - min_;
+
+        // Aim for about two seed points per cell, ignoring flat dimensions
+        const float targetCells = std::max(1.0f, static_cast<float>(seeds.size()) / 2.0f);
+        const float maxExtent = glm::compMax(extent);
+        float volume = 1.0f;
+        int nonFlat = 0;
+        for (int i = 0; i < 3; ++i) {
+            if (extent[i] > 1e-6f * maxExtent) {
+                volume *= extent[i];
+                ++nonFlat;
+            }
+        }
+        const float cellSize =
+            nonFlat > 0 ? std::pow(volume / targetCells, 1.0f / static_cast<float>(nonFlat))
+                        : 1.0f;
+        for (int i = 0; i < 3; ++i) {
+            if (nonFlat > 0 && extent[i] > 1e-6f * maxExtent) {
+                dims_[i] = static_cast<int>(
+                    std::clamp(std::ceil(extent[i] / cellSize), 1.0f, 1024.0f));
+                cellSize_[i] = extent[i] / static_cast<float>(dims_[i]);
+                invCellSize_[i] = static_cast<float>(dims_[i]) / extent[i];
+            } else {
+                dims_[i] = 1;
+                cellSize_[i] = std::max(extent[i], 1.0f);
+                invCellSize_[i] = 0.0f;
+            }
+        }
+        max_ = min_ + cellSize_ * vec3{dims_};
+
+        // bucket the seed points by cell, keeping the original order within each cell
+        const size_t nCells = static_cast<size_t>(dims_.x) * dims_.y * dims_.z;
+        cellStart_.assign(nCells + 1, 0);
+        std::vector<size_t> cells(seeds.size());
+        for (size_t i = 0; i < seeds.size(); ++i) {
+            const auto c = glm::clamp(cellOf(seeds[i].pos), ivec3{0}, dims_ - 1);
+            cells[i] = linear(c);
+            ++cellStart_[cells[i] + 1];
+        }
+        for (size_t i = 0; i < nCells; ++i) {
+            cellStart_[i + 1] += cellStart_[i];
+        }
+        seeds_.resize(seeds.size());
+        auto next = cellStart_;
+        for (size_t i = 0; i < seeds.size(); ++i) {
+            seeds_[next[cells[i]]++] = seeds[i];
+        }
+    }
+
+    template <Wrapping X, Wrapping Y, Wrapping Z>
+    const Seed& closest(const vec3& pos, const vec3& size) const {
+        const Seed* best = nullptr;
+        float bestDist = std::numeric_limits<float>::infinity();
+        const auto visitCell = [&](const ivec3& c) {
+            const auto cell = linear(c);
+            for (size_t i = cellStart_[cell]; i < cellStart_[cell + 1]; ++i) {
+                const auto& seed = seeds_[i];
+                const float dist = distance2<X, Y, Z>(seed.pos, pos, size) - seed.weight2;
+                if (!best || dist < bestDist || (dist == bestDist && seed.order < best->order)) {
+                    bestDist = dist;
+                    best = &seed;
+                }
+            }
+        };
+
+        const auto search = [&](const vec3& p) {
+            const auto cell = cellOf(p);
+            // shells closer than the grid do not contain any cells
+            int shell = glm::compMax(glm::max(glm::max(-cell, cell - (dims_ - 1)), ivec3{0}));
+            while (true) {
+                if (best) {
+                    const double bound =
+                        lowerBound2(p, cell, shell) - static_cast<double>(maxWeight2_);
+                    // leave some slack for rounding errors in the bound
+                    if (bound > bestDist + 1e-5 * (std::abs(bestDist) + bound)) return;
+                }
+                if (!visitShell(cell, shell, visitCell)) return;  // all cells visited
+                ++shell;
+            }
+        };
+
+        search(pos);
+
+        if constexpr (X == Wrapping::Repeat || Y == Wrapping::Repeat || Z == Wrapping::Repeat) {
+            // Images of the query point along periodic axes, skipping images that are already
+            // too far away from the grid along a single axis.
+            constexpr std::array<bool, 3> periodic{X == Wrapping::Repeat, Y == Wrapping::Repeat,
+                                                   Z == Wrapping::Repeat};
+            std::array<std::array<float, 3>, 3> offsets{};
+            std::array<size_t, 3> count{1, 1, 1};
+            for (int i = 0; i < 3; ++i) {
+                if (!periodic[i]) continue;
+                for (float offset : {-size[i], size[i]}) {
+                    const double p = static_cast<double>(pos[i]) + offset;
+                    const double d = std::max({0.0, min_[i] - p, p - max_[i]});
+                    const double bound = d * d - static_cast<double>(maxWeight2_);
+                    if (bound <= bestDist + 1e-5 * (std::abs(bestDist) + bound)) {
+                        offsets[i][count[i]++] = offset;
+                    }
+                }
+            }
+            for (size_t z = 0; z < count[2]; ++z) {
+                for (size_t y = 0; y < count[1]; ++y) {
+                    for (size_t x = 0; x < count[0]; ++x) {
+                        if (x == 0 && y == 0 && z == 0) continue;
+                        search(pos + vec3{offsets[0][x], offsets[1][y], offsets[2][z]});
+                    }
+                }
+            }
+        }
+        return *best;
+    }
+
+private:
+    ivec3 cellOf(const vec3& pos) const {
+        return ivec3{glm::floor((pos - min_) * invCellSize_)};
+    }
+    size_t linear(const ivec3& c) const {
+        return static_cast<size_t>(c.x) +
+               static_cast<size_t>(dims_.x) * (c.y + static_cast<size_t>(dims_.y) * c.z);
+    }
+
+    /**
+     * Lower bound for the squared distance between \p pos and any point of the grid not yet
+     * visited, i.e. outside of the shells closer than \p shell around \p cell.
+     */
+    double lowerBound2(const vec3& pos, const ivec3& cell, int shell) const {
+        // distance to the grid
+        double toGrid = 0.0;
+        for (int i = 0; i < 3; ++i) {
+            const double d = std::max({0.0, static_cast<double>(min_[i]) - pos[i],
+                                       static_cast<double>(pos[i]) - max_[i]});
+            toGrid += d * d;
+        }
+        if (shell == 0) return toGrid;
+
+        // distance to the closest face of the visited box that lies within the grid
+        double toFace = std::numeric_limits<double>::infinity();
+        for (int i = 0; i < 3; ++i) {
+            const int lo = cell[i] - (shell - 1);
+            const int hi = cell[i] + shell;  // exclusive
+            if (lo > 0) {
+                toFace = std::min(toFace, static_cast<double>(pos[i]) -
+                                              (static_cast<double>(min_[i]) +
+                                               static_cast<double>(lo) * cellSize_[i]));
+            }
+            if (hi < dims_[i]) {
+                toFace = std::min(toFace, static_cast<double>(min_[i]) +
+                                              static_cast<double>(hi) * cellSize_[i] - pos[i]);
+            }
+        }
+        if (toFace == std::numeric_limits<double>::infinity()) return toFace;
+        toFace = std::max(0.0, toFace);
+        return std::max(toGrid, toFace * toFace);
+    }
+
+    /**
+     * Visit all cells of the grid at a Chebyshev distance of \p shell from \p cell
+     * @return false if all cells of the grid were already visited in previous shells
+     */
+    template <typename Visitor>
+    bool visitShell(const ivec3& cell, int shell, Visitor& visitor) const {
+        if (shell > 0 && glm::all(glm::lessThanEqual(cell - (shell - 1), ivec3{0})) &&
+            glm::all(glm::greaterThanEqual(cell + (shell - 1), dims_ - 1))) {
+            return false;
+        }
+
+        const auto lo = cell - shell;
+        const auto hi = cell + shell;
+        const auto clo = glm::max(lo, ivec3{0});
+        const auto chi = glm::min(hi, dims_ - 1);
+        ivec3 c;
+        for (c.z = clo.z; c.z <= chi.z; ++c.z) {
+            for (c.y = clo.y; c.y <= chi.y; ++c.y) {
+                if (c.z == lo.z || c.z == hi.z || c.y == lo.y || c.y == hi.y) {
+                    for (c.x = clo.x; c.x <= chi.x; ++c.x) visitor(c);
+                } else {
+                    if (lo.x >= 0 && lo.x < dims_.x) visitor(ivec3{lo.x, c.y, c.z});
+                    if (shell > 0 && hi.x >= 0 && hi.x < dims_.x) visitor(ivec3{hi.x, c.y, c.z});
+                }
+            }
+        }
+        return true;
+    }
+
+    vec3 min_;
+    vec3 max_;
+    vec3 cellSize_;
+    vec3 invCellSize_;
+    ivec3 dims_;
+    float maxWeight2_ = 0.0f;
+    std::vector<size_t> cellStart_;
+    std::vector<Seed> seeds_;  //!< seed points sorted by cell
+};
+
 }  // namespace detail
 
-template <Wrapping X, Wrapping Y, Wrapping Z>
+template <Wrapping X, Wrapping Y, Wrapping Z, typename Label>
 void voronoiSegmentationImpl(const size3_t volumeDimensions, const mat4& indexToModelMatrix,
-                             const std::vector<std::pair<uint32_t, vec3>>& seedPointsWithIndices,
-                             VolumeRAMPrecision<unsigned short>& voronoiVolumeRep) {
+                             const detail::SeedGrid& grid,
+                             VolumeRAMPrecision<Label>& voronoiVolumeRep) {
 
     auto volumeIndices = voronoiVolumeRep.getDataTyped();
     util::IndexMapper3D index(volumeDimensions);
@@ -84,41 +316,38 @@ void voronoiSegmentationImpl(const size3_t volumeDimensions, const mat4& indexTo
 
     util::forEachVoxelParallel(volumeDimensions, [&](const size3_t& voxelPos) {
         const auto transformedVoxelPos = vec3{indexToModelMatrix * vec4{voxelPos, 1.0f}};
-        auto it = std::min_element(
-            seedPointsWithIndices.cbegin(), seedPointsWithIndices.cend(),
-            [&](const auto& p1, const auto& p2) {
-                return detail::distance2<X, Y, Z>(p1.second, transformedVoxelPos, size) <
-                       detail::distance2<X, Y, Z>(p2.second, transformedVoxelPos, size);
-            });
-        volumeIndices[index(voxelPos)] = static_cast<unsigned short>(it->first);
+        const auto& seed = grid.closest<X, Y, Z>(transformedVoxelPos, size);
+        volumeIndices[index(voxelPos)] = static_cast<Label>(seed.index);
     });
 }
 
-template <Wrapping X, Wrapping Y, Wrapping Z>
-void weightedVoronoiSegmentationImpl(
-    const size3_t volumeDimensions, const mat4& indexToModelMatrix,
-    const std::vector<std::pair<uint32_t, vec3>>& seedPointsWithIndices,
-    const std::vector<float>& weights, VolumeRAMPrecision<unsigned short>& voronoiVolumeRep) {
-
-    auto volumeIndices = voronoiVolumeRep.getDataTyped();
-    util::IndexMapper3D index(volumeDimensions);
-
-    const auto size = vec3{indexToModelMatrix * vec4{volumeDimensions, 1.0f}} -
-                      vec3{indexToModelMatrix * vec4{0.0f, 0.0f, 0.0f, 1.0f}};
-
-    util::forEachVoxelParallel(volumeDimensions, [&](const size3_t& voxelPos) {
-        const auto transformedVoxelPos = vec3{indexToModelMatrix * vec4{voxelPos, 1.0f}};
-        auto zipped = util::zip(seedPointsWithIndices, weights);
-
-        auto&& [posWithIndex, weight] =
-            *std::min_element(zipped.begin(), zipped.end(), [&](auto&& i1, auto&& i2) {
-                auto&& [p1, w1] = i1;
-                auto&& [p2, w2] = i2;
-                return detail::distance2<X, Y, Z>(p1.second, transformedVoxelPos, size) - w1 * w1 <
-                       detail::distance2<X, Y, Z>(p2.second, transformedVoxelPos, size) - w2 * w2;
+template <typename Label>
+void voronoiSegmentationDispatch(const size3_t volumeDimensions, const mat4& indexToModelMatrix,
+                                 const detail::SeedGrid& grid, const Wrapping3D& wrapping,
+                                 VolumeRAMPrecision<Label>& voronoiVolumeRep) {
+    using Functor = void (*)(const size3_t, const mat4&, const detail::SeedGrid&,
+                             VolumeRAMPrecision<Label>&);
+
+    constexpr auto table = detail::build_array<3>([&](auto x) constexpr {
+        using XT = decltype(x);
+        return detail::build_array<3>([&](auto y) constexpr {
+            using YT = decltype(y);
+            return detail::build_array<3>([&](auto z) constexpr->Functor {
+                using ZT = decltype(z);
+                return [](const size3_t dim, const mat4& matrix, const detail::SeedGrid& sg,
+                          VolumeRAMPrecision<Label>& volRep) {
+                    constexpr auto X = static_cast<Wrapping>(XT::value);
+                    constexpr auto Y = static_cast<Wrapping>(YT::value);
+                    constexpr auto Z = static_cast<Wrapping>(ZT::value);
+                    voronoiSegmentationImpl<X, Y, Z, Label>(dim, matrix, sg, volRep);
+                };
             });
-        volumeIndices[index(voxelPos)] = static_cast<unsigned short>(posWithIndex.first);
+        });
     });
+
+    table[static_cast<size_t>(wrapping[0])][static_cast<size_t>(wrapping[1])]
+         [static_cast<size_t>(wrapping[2])](volumeDimensions, indexToModelMatrix, grid,
+                                            voronoiVolumeRep);
 }
 
 std::shared_ptr<Volume> voronoiSegmentation(
@@ -138,73 +367,31 @@ std::shared_ptr<Volume> voronoiSegmentation(
             IVW_CONTEXT_CUSTOM("VoronoiSegmentation"));
     }
 
-    auto voronoiVolumeRep = std::make_shared<VolumeRAMPrecision<unsigned short>>(volumeDimensions);
-    auto voronoiVolume = std::make_shared<Volume>(voronoiVolumeRep);
-    voronoiVolume->setInterpolation(InterpolationType::Nearest);
-    voronoiVolume->setWrapping(wrapping);
-
     const auto imax =
         std::max_element(seedPointsWithIndices.begin(), seedPointsWithIndices.end(),
                          [](const auto& a, const auto& b) { return a.first < b.first; });
 
-    voronoiVolume->dataMap_.dataRange = dvec2{0.0, static_cast<double>(imax->first)};
-    voronoiVolume->dataMap_.valueRange = voronoiVolume->dataMap_.dataRange;
-
-    if (weights.has_value()) {
-        using Functor =
-            void (*)(const size3_t, const mat4&, const std::vector<std::pair<uint32_t, vec3>>&,
-                     const std::vector<float>&, VolumeRAMPrecision<unsigned short>&);
-
-        constexpr auto table = detail::build_array<3>([&](auto x) constexpr {
-            using XT = decltype(x);
-            return detail::build_array<3>([&](auto y) constexpr {
-                using YT = decltype(y);
-                return detail::build_array<3>([&](auto z) constexpr->Functor {
-                    using ZT = decltype(z);
-                    return [](const size3_t dim, const mat4& matrix,
-                              const std::vector<std::pair<uint32_t, vec3>>& sp,
-                              const std::vector<float>& w,
-                              VolumeRAMPrecision<unsigned short>& volRep) {
-                        constexpr auto X = static_cast<Wrapping>(XT::value);
-                        constexpr auto Y = static_cast<Wrapping>(YT::value);
-                        constexpr auto Z = static_cast<Wrapping>(ZT::value);
-                        weightedVoronoiSegmentationImpl<X, Y, Z>(dim, matrix, sp, w, volRep);
-                    };
-                });
-            });
-        });
-
-        table[static_cast<size_t>(wrapping[0])][static_cast<size_t>(wrapping[1])]
-             [static_cast<size_t>(wrapping[2])](volumeDimensions, indexToModelMatrix,
-                                                seedPointsWithIndices, *weights, *voronoiVolumeRep);
+    const detail::SeedGrid grid(seedPointsWithIndices, weights ? &*weights : nullptr);
 
+    std::shared_ptr<Volume> voronoiVolume;
+    if (imax->first <= std::numeric_limits<unsigned short>::max()) {
+        auto voronoiVolumeRep =
+            std::make_shared<VolumeRAMPrecision<unsigned short>>(volumeDimensions);
+        voronoiSegmentationDispatch(volumeDimensions, indexToModelMatrix, grid, wrapping,
+                                    *voronoiVolumeRep);
+        voronoiVolume = std::make_shared<Volume>(voronoiVolumeRep);
     } else {
-        using Functor =
-            void (*)(const size3_t, const mat4&, const std::vector<std::pair<uint32_t, vec3>>&,
-                     VolumeRAMPrecision<unsigned short>&);
-
-        constexpr auto table = detail::build_array<3>([&](auto x) constexpr {
-            using XT = decltype(x);
-            return detail::build_array<3>([&](auto y) constexpr {
-                using YT = decltype(y);
-                return detail::build_array<3>([&](auto z) constexpr->Functor {
-                    using ZT = decltype(z);
-                    return [](const size3_t dim, const mat4& matrix,
-                              const std::vector<std::pair<uint32_t, vec3>>& sp,
-                              VolumeRAMPrecision<unsigned short>& volRep) {
-                        constexpr auto X = static_cast<Wrapping>(XT::value);
-                        constexpr auto Y = static_cast<Wrapping>(YT::value);
-                        constexpr auto Z = static_cast<Wrapping>(ZT::value);
-                        voronoiSegmentationImpl<X, Y, Z>(dim, matrix, sp, volRep);
-                    };
-                });
-            });
-        });
-
-        table[static_cast<size_t>(wrapping[0])][static_cast<size_t>(wrapping[1])]
-             [static_cast<size_t>(wrapping[2])](volumeDimensions, indexToModelMatrix,
-                                                seedPointsWithIndices, *voronoiVolumeRep);
+        auto voronoiVolumeRep =
+            std::make_shared<VolumeRAMPrecision<std::uint32_t>>(volumeDimensions);
+        voronoiSegmentationDispatch(volumeDimensions, indexToModelMatrix, grid, wrapping,
+                                    *voronoiVolumeRep);
+        voronoiVolume = std::make_shared<Volume>(voronoiVolumeRep);
     }
+    voronoiVolume->setInterpolation(InterpolationType::Nearest);
+    voronoiVolume->setWrapping(wrapping);
+
+    voronoiVolume->dataMap_.dataRange = dvec2{0.0, static_cast<double>(imax->first)};
+    voronoiVolume->dataMap_.valueRange = voronoiVolume->dataMap_.dataRange;
 
     return voronoiVolume;
 }
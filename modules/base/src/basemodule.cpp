@@ -240,6 +240,7 @@ BaseModule::BaseModule(InviwoApplication* app) : InviwoModule(app, "Base") {
     // Register Data writers
     registerDataWriter(std::make_unique<DatVolumeWriter>());
     registerDataWriter(std::make_unique<IvfVolumeWriter>());
+    registerDataWriter(std::make_unique<IvfVolumeWriter>(util::CompressedBrickSettings{}));
     registerDataWriter(std::make_unique<StlWriter>());
     registerDataWriter(std::make_unique<BinarySTLWriter>());
     registerDataWriter(std::make_unique<WaveFrontWriter>());
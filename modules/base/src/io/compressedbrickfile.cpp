@@ -0,0 +1,484 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <modules/base/io/compressedbrickfile.h>
+#include <modules/base/algorithm/dataminmax.h>
+#include <inviwo/core/common/inviwoapplication.h>
+#include <inviwo/core/datastructures/volume/volumeramprecision.h>
+#include <inviwo/core/io/bytereaderutil.h>
+#include <inviwo/core/io/datareaderexception.h>
+#include <inviwo/core/io/datawriterexception.h>
+#include <inviwo/core/util/exception.h>
+#include <inviwo/core/util/filesystem.h>
+#include <inviwo/core/util/foreach.h>
+#include <inviwo/core/util/indexmapper.h>
+#include <inviwo/core/util/memorymappedfile.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <future>
+#include <limits>
+#include <thread>
+
+#include <fmt/format.h>
+#include <zlib.h>
+
+namespace inviwo {
+
+namespace {
+
+// File layout, all numbers are 64 bit little endian:
+//   magic, version, number of bricks, flags
+//   per brick: position relative to the start of the file, compressed size
+//   per brick if flagMinMax: 4 minimum and 4 maximum values as doubles
+//   compressed bricks
+constexpr std::array<char, 8> magic{'I', 'V', 'W', 'B', 'R', 'I', 'C', 'K'};
+constexpr std::uint64_t version = 1;
+constexpr std::uint64_t flagMinMax = 1;
+constexpr size_t headerSize = 32;
+constexpr size_t entrySize = 16;
+constexpr size_t minMaxSize = 64;
+
+void putU64(char* dest, std::uint64_t value) {
+    for (size_t i = 0; i < 8; ++i) {
+        dest[i] = static_cast<char>((value >> (8 * i)) & 0xff);
+    }
+}
+
+std::uint64_t getU64(const char* src) {
+    std::uint64_t value = 0;
+    for (size_t i = 0; i < 8; ++i) {
+        value |= static_cast<std::uint64_t>(static_cast<unsigned char>(src[i])) << (8 * i);
+    }
+    return value;
+}
+
+void putDouble(char* dest, double value) {
+    std::uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    putU64(dest, bits);
+}
+
+double getDouble(const char* src) {
+    const auto bits = getU64(src);
+    double value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+size3_t brickCounts(size3_t dimensions, size3_t brickSize) {
+    return (dimensions + brickSize - size3_t{1}) / brickSize;
+}
+
+// Copy the rows of the part of the \p srcExtent sized src starting at \p srcOffset into the part
+// of the \p destExtent sized dest starting at \p destOffset
+void copyRegion(const char* src, size3_t srcExtent, size3_t srcOffset, char* dest,
+                size3_t destExtent, size3_t destOffset, size3_t extent, size_t voxelSize) {
+    const util::IndexMapper3D srcIm{srcExtent};
+    const util::IndexMapper3D destIm{destExtent};
+    const auto rowSize = extent.x * voxelSize;
+    for (size_t z = 0; z < extent.z; ++z) {
+        for (size_t y = 0; y < extent.y; ++y) {
+            std::memcpy(dest + destIm(destOffset + size3_t{0, y, z}) * voxelSize,
+                        src + srcIm(srcOffset + size3_t{0, y, z}) * voxelSize, rowSize);
+        }
+    }
+}
+
+bool useThreadPool() {
+    return InviwoApplication::isInitialized() && InviwoApplication::getPtr()->getPoolSize() > 0;
+}
+
+}  // namespace
+
+CompressedBrickFile::CompressedBrickFile(const std::string& filePath, size_t offset,
+                                         bool littleEndian, size3_t dimensions,
+                                         const DataFormatBase* format, size3_t brickSize)
+    : offset_{offset}
+    , littleEndian_{littleEndian}
+    , dimensions_{dimensions}
+    , format_{format}
+    , brickSize_{brickSize}
+    , brickCounts_{0} {
+
+    if (glm::any(glm::equal(brickSize_, size3_t{0}))) {
+        throw DataReaderException(
+            fmt::format("Error: Invalid brick size for compressed file '{}'", filePath),
+            IVW_CONTEXT);
+    }
+    brickCounts_ = brickCounts(dimensions_, brickSize_);
+
+    try {
+        file_ = std::make_unique<util::MemoryMappedFile>(filePath,
+                                                         util::MemoryMappedFile::Access::Random);
+    } catch (const FileException& e) {
+        throw DataReaderException(e.getMessage(), IVW_CONTEXT);
+    }
+
+    const auto corrupt = [&](std::string_view reason) {
+        return DataReaderException(
+            fmt::format("Error: Invalid compressed file '{}': {}", filePath, reason),
+            IVW_CONTEXT);
+    };
+
+    if (offset_ > file_->size() || file_->size() - offset_ < headerSize) {
+        throw corrupt("the file is too small");
+    }
+    const auto size = file_->size() - offset_;
+    const auto header = file_->data() + offset_;
+    if (!std::equal(magic.begin(), magic.end(), header)) {
+        throw corrupt("unknown file type");
+    }
+    if (getU64(header + 8) != version) {
+        throw corrupt(fmt::format("unsupported version {}", getU64(header + 8)));
+    }
+    const auto count = getU64(header + 16);
+    if (count != glm::compMul(brickCounts_)) {
+        throw corrupt(fmt::format("expected {} bricks but found {}", glm::compMul(brickCounts_),
+                                  count));
+    }
+    const auto flags = getU64(header + 24);
+    const auto indexSize = count * (entrySize + ((flags & flagMinMax) ? minMaxSize : 0));
+    if (size - headerSize < indexSize) {
+        throw corrupt("the brick index is truncated");
+    }
+
+    index_.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        const auto entry = header + headerSize + i * entrySize;
+        const auto pos = getU64(entry);
+        const auto bytes = getU64(entry + 8);
+        if (pos > size || bytes > size - pos) {
+            throw corrupt(fmt::format("brick {} is outside of the file", i));
+        }
+        index_.push_back({static_cast<size_t>(pos), static_cast<size_t>(bytes)});
+    }
+    if (flags & flagMinMax) {
+        minMax_.reserve(count);
+        const auto minMax = header + headerSize + count * entrySize;
+        for (size_t i = 0; i < count; ++i) {
+            const auto values = minMax + i * minMaxSize;
+            std::pair<dvec4, dvec4> result;
+            for (glm::length_t c = 0; c < 4; ++c) {
+                result.first[c] = getDouble(values + 8 * c);
+                result.second[c] = getDouble(values + 32 + 8 * c);
+            }
+            minMax_.push_back(result);
+        }
+    }
+}
+
+CompressedBrickFile::~CompressedBrickFile() = default;
+
+const std::string& CompressedBrickFile::getFilePath() const { return file_->getFilePath(); }
+
+size3_t CompressedBrickFile::getDimensions() const { return dimensions_; }
+
+const DataFormatBase* CompressedBrickFile::getDataFormat() const { return format_; }
+
+size3_t CompressedBrickFile::getBrickSize() const { return brickSize_; }
+
+size3_t CompressedBrickFile::getBrickCounts() const { return brickCounts_; }
+
+size_t CompressedBrickFile::getNumberOfBricks() const { return index_.size(); }
+
+size3_t CompressedBrickFile::getBrickOffset(size_t brick) const {
+    return util::IndexMapper3D{brickCounts_}(brick) * brickSize_;
+}
+
+size3_t CompressedBrickFile::getBrickExtent(size_t brick) const {
+    return glm::min(brickSize_, dimensions_ - getBrickOffset(brick));
+}
+
+std::vector<size_t> CompressedBrickFile::getBricks(size3_t offset, size3_t extent) const {
+    std::vector<size_t> result;
+    const auto end = glm::min(offset + extent, dimensions_);
+    if (glm::any(glm::greaterThanEqual(offset, end))) return result;
+
+    const auto first = offset / brickSize_;
+    const auto last = (end - size3_t{1}) / brickSize_;
+    const util::IndexMapper3D im{brickCounts_};
+    result.reserve(glm::compMul(last - first + size3_t{1}));
+    for (auto z = first.z; z <= last.z; ++z) {
+        for (auto y = first.y; y <= last.y; ++y) {
+            for (auto x = first.x; x <= last.x; ++x) {
+                result.push_back(im(x, y, z));
+            }
+        }
+    }
+    return result;
+}
+
+size_t CompressedBrickFile::getCompressedSize(size_t brick) const { return index_.at(brick).size; }
+
+bool CompressedBrickFile::hasBrickMinMax() const { return !minMax_.empty(); }
+
+std::pair<dvec4, dvec4> CompressedBrickFile::getBrickMinMax(size_t brick) const {
+    if (minMax_.empty()) {
+        throw Exception(fmt::format("The file '{}' does not contain the minimum and maximum "
+                                    "values of the bricks",
+                                    getFilePath()),
+                        IVW_CONTEXT);
+    }
+    return minMax_.at(brick);
+}
+
+void CompressedBrickFile::readBrick(size_t brick, void* dest) const {
+    const auto& entry = index_.at(brick);
+    const auto bytes = glm::compMul(getBrickExtent(brick)) * format_->getSize();
+
+    auto destSize = static_cast<uLongf>(bytes);
+    const auto result =
+        uncompress(static_cast<Bytef*>(dest), &destSize,
+                   reinterpret_cast<const Bytef*>(file_->data() + offset_ + entry.offset),
+                   static_cast<uLong>(entry.size));
+    if (result != Z_OK || destSize != bytes) {
+        throw DataReaderException(
+            fmt::format("Error: Could not decompress brick {} of file '{}'", brick, getFilePath()),
+            IVW_CONTEXT);
+    }
+
+    const auto componentSize = format_->getSize() / format_->getComponents();
+    if (littleEndian_ != util::isSystemLittleEndian() && componentSize > 1) {
+        util::copyBytesIntoBuffer(dest, bytes, littleEndian_, componentSize, dest);
+    }
+}
+
+void CompressedBrickFile::readRegion(size3_t offset, size3_t extent, void* dest,
+                                     const std::function<void(float)>& progress) const {
+    if (glm::any(glm::greaterThan(offset + extent, dimensions_))) {
+        throw RangeException("Region is outside of the volume", IVW_CONTEXT);
+    }
+
+    const auto voxelSize = format_->getSize();
+    const auto destData = static_cast<char*>(dest);
+    const auto read = [&](size_t brick) {
+        const auto brickOffset = getBrickOffset(brick);
+        const auto brickExtent = getBrickExtent(brick);
+        if (brickOffset == offset && brickExtent == extent) {
+            readBrick(brick, destData);
+            return;
+        }
+        std::vector<char> buffer(glm::compMul(brickExtent) * voxelSize);
+        readBrick(brick, buffer.data());
+        const auto begin = glm::max(offset, brickOffset);
+        const auto end = glm::min(offset + extent, brickOffset + brickExtent);
+        copyRegion(buffer.data(), brickExtent, begin - brickOffset, destData, extent,
+                   begin - offset, end - begin, voxelSize);
+    };
+
+    // The loaders call this while the volume is locked, hence the calling thread decompresses
+    // bricks as well and only waits for bricks that are already being decompressed, it never
+    // runs other tasks of the pool.
+    const auto bricks = getBricks(offset, extent);
+    const auto caller = std::this_thread::get_id();
+    std::atomic<size_t> done{0};
+    util::forEachIndexParallel(bricks.size(), [&](size_t i) {
+        read(bricks[i]);
+        const auto count = ++done;
+        // Only report progress from the calling thread
+        if (progress && std::this_thread::get_id() == caller) {
+            progress(static_cast<float>(count) / static_cast<float>(bricks.size()));
+        }
+    });
+    if (progress) progress(1.0f);
+}
+
+CompressedVolumeBrickLoader::CompressedVolumeBrickLoader(
+    std::shared_ptr<const CompressedBrickFile> file)
+    : file_{std::move(file)} {}
+
+void CompressedVolumeBrickLoader::loadBrick(size3_t offset, size3_t extent, void* dest) const {
+    const auto brickSize = file_->getBrickSize();
+    const auto dimensions = file_->getDimensions();
+    if (offset % brickSize != size3_t{0} || glm::any(glm::greaterThanEqual(offset, dimensions)) ||
+        extent != glm::min(brickSize, dimensions - offset)) {
+        throw DataReaderException(
+            fmt::format("Error: Brick at ({}, {}, {}) does not match the bricks of the file '{}'",
+                        offset.x, offset.y, offset.z, file_->getFilePath()),
+            IVW_CONTEXT);
+    }
+    const auto brick = util::IndexMapper3D{file_->getBrickCounts()}(offset / brickSize);
+    file_->readBrick(brick, dest);
+}
+
+CompressedVolumeRAMLoader::CompressedVolumeRAMLoader(
+    std::shared_ptr<const CompressedBrickFile> file)
+    : file_{std::move(file)} {}
+
+CompressedVolumeRAMLoader* CompressedVolumeRAMLoader::clone() const {
+    return new CompressedVolumeRAMLoader(*this);
+}
+
+void CompressedVolumeRAMLoader::setProgressCallback(std::function<void(float)> progress) {
+    progress_ = std::move(progress);
+}
+
+std::shared_ptr<VolumeRepresentation> CompressedVolumeRAMLoader::createRepresentation(
+    const VolumeRepresentation& src) const {
+    auto volumeRAM = createVolumeRAM(src.getDimensions(), src.getDataFormat(), nullptr,
+                                     src.getSwizzleMask(), src.getInterpolation(),
+                                     src.getWrapping());
+    file_->readRegion(size3_t{0}, src.getDimensions(), volumeRAM->getData(), progress_);
+    return volumeRAM;
+}
+
+void CompressedVolumeRAMLoader::updateRepresentation(std::shared_ptr<VolumeRepresentation> dest,
+                                                     const VolumeRepresentation& src) const {
+    auto volumeDst = std::static_pointer_cast<VolumeRAM>(dest);
+
+    if (src.getDimensions() != volumeDst->getDimensions()) {
+        volumeDst->setDimensions(src.getDimensions());
+    }
+    file_->readRegion(size3_t{0}, src.getDimensions(), volumeDst->getData(), progress_);
+
+    volumeDst->setSwizzleMask(src.getSwizzleMask());
+    volumeDst->setInterpolation(src.getInterpolation());
+    volumeDst->setWrapping(src.getWrapping());
+}
+
+void util::writeCompressedBrickFile(const VolumeRAM& volume, const std::string& filePath,
+                                    const CompressedBrickSettings& settings) {
+    const auto dimensions = volume.getDimensions();
+    const auto brickSize = settings.brickSize;
+    const auto format = volume.getDataFormat();
+    const auto voxelSize = format->getSize();
+    if (glm::any(glm::equal(brickSize, size3_t{0}))) {
+        throw DataWriterException("Error: Invalid brick size",
+                                  IVW_CONTEXT_CUSTOM("writeCompressedBrickFile"));
+    }
+    if (glm::compMul(brickSize) * voxelSize > std::numeric_limits<uLong>::max()) {
+        throw DataWriterException("Error: The bricks are too large to be compressed",
+                                  IVW_CONTEXT_CUSTOM("writeCompressedBrickFile"));
+    }
+
+    auto out = filesystem::ofstream(filePath, std::ios::out | std::ios::binary);
+    if (!out.good()) {
+        throw DataWriterException("Error: Could not write to file: " + filePath,
+                                  IVW_CONTEXT_CUSTOM("writeCompressedBrickFile"));
+    }
+
+    const auto counts = brickCounts(dimensions, brickSize);
+    const util::IndexMapper3D brickIm{counts};
+    const auto count = glm::compMul(counts);
+
+    struct Brick {
+        std::vector<char> data;
+        std::pair<dvec4, dvec4> minMax;
+    };
+    const auto src = static_cast<const char*>(volume.getData());
+    const auto compressBrick = [&](size_t brick) {
+        const auto offset = brickIm(brick) * brickSize;
+        const auto extent = glm::min(brickSize, dimensions - offset);
+        auto brickRAM = createVolumeRAM(extent, format);
+        copyRegion(src, dimensions, offset, static_cast<char*>(brickRAM->getData()), extent,
+                   size3_t{0}, extent, voxelSize);
+
+        Brick result;
+        if (settings.brickMinMax) result.minMax = util::volumeMinMax(brickRAM.get());
+
+        const auto bytes = static_cast<uLong>(glm::compMul(extent) * voxelSize);
+        uLongf size = compressBound(bytes);
+        result.data.resize(size);
+        if (compress2(reinterpret_cast<Bytef*>(result.data.data()), &size,
+                      static_cast<const Bytef*>(brickRAM->getData()), bytes,
+                      settings.level) != Z_OK) {
+            throw DataWriterException(fmt::format("Error: Could not compress brick {}", brick),
+                                      IVW_CONTEXT_CUSTOM("writeCompressedBrickFile"));
+        }
+        result.data.resize(size);
+        return result;
+    };
+
+    const auto dataStart =
+        headerSize + count * (entrySize + (settings.brickMinMax ? minMaxSize : 0));
+    std::vector<char> header(dataStart, 0);
+    out.write(header.data(), header.size());
+
+    auto pos = dataStart;
+    const auto write = [&](size_t brick, const Brick& compressed) {
+        out.write(compressed.data.data(), compressed.data.size());
+        const auto entry = header.data() + headerSize + brick * entrySize;
+        putU64(entry, pos);
+        putU64(entry + 8, compressed.data.size());
+        pos += compressed.data.size();
+        if (settings.brickMinMax) {
+            const auto values = header.data() + headerSize + count * entrySize + brick * minMaxSize;
+            for (glm::length_t c = 0; c < 4; ++c) {
+                putDouble(values + 8 * c, compressed.minMax.first[c]);
+                putDouble(values + 32 + 8 * c, compressed.minMax.second[c]);
+            }
+        }
+    };
+
+    if (useThreadPool()) {
+        // Compress a few bricks ahead on the pool, and write them in order as they finish
+        auto& pool = InviwoApplication::getPtr()->getThreadPool();
+        const auto inFlight = 2 * InviwoApplication::getPtr()->getPoolSize();
+        std::deque<std::future<Brick>> pending;
+        size_t next = 0;
+        try {
+            for (size_t brick = 0; brick < count; ++brick) {
+                for (; next < count && next < brick + inFlight; ++next) {
+                    pending.push_back(dispatchPool(compressBrick, next));
+                }
+                pool.wait(pending.front());
+                auto compressed = pending.front().get();
+                pending.pop_front();
+                write(brick, compressed);
+            }
+        } catch (...) {
+            // The tasks refer to the volume and the settings
+            for (auto& future : pending) pool.wait(future);
+            throw;
+        }
+    } else {
+        for (size_t brick = 0; brick < count; ++brick) {
+            write(brick, compressBrick(brick));
+        }
+    }
+
+    std::copy(magic.begin(), magic.end(), header.data());
+    putU64(header.data() + 8, version);
+    putU64(header.data() + 16, count);
+    putU64(header.data() + 24, settings.brickMinMax ? flagMinMax : 0);
+    out.seekp(0);
+    out.write(header.data(), header.size());
+
+    if (!out.good()) {
+        throw DataWriterException("Error: Could not write to file: " + filePath,
+                                  IVW_CONTEXT_CUSTOM("writeCompressedBrickFile"));
+    }
+}
+
+}  // namespace inviwo
@@ -47,7 +47,7 @@
 namespace inviwo {
 
 DatVolumeSequenceReader::DatVolumeSequenceReader()
-    : DataReaderType<VolumeSequence>(), enableLogOutput_(true) {
+    : DataReaderType<VolumeSequence>(), enableLogOutput_(true), options_() {
     addExtension(FileExtension("dat", "Inviwo dat file format"));
 }
 
@@ -59,6 +59,16 @@ DatVolumeSequenceReader* DatVolumeSequenceReader::clone() const {
     return new DatVolumeSequenceReader(*this);
 }
 
+bool DatVolumeSequenceReader::setOption(std::string_view key, std::any value) {
+    if (key == "BrickSize") return false;
+    return options_.setOption(key, value);
+}
+
+std::any DatVolumeSequenceReader::getOption(std::string_view key) {
+    if (key == "BrickSize") return std::any{};
+    return options_.getOption(key);
+}
+
 std::shared_ptr<DatVolumeSequenceReader::VolumeSequence> DatVolumeSequenceReader::readData(
     const std::string& filePath) {
     std::string fileName = filePath;
@@ -252,6 +262,7 @@ std::shared_ptr<DatVolumeSequenceReader::VolumeSequence> DatVolumeSequenceReader
         for (size_t t = 0; t < state.datFiles.size(); ++t) {
             auto datVolReader = std::make_unique<DatVolumeSequenceReader>();
             datVolReader->enableLogOutput_ = false;
+            datVolReader->options_ = options_;
             auto path = filesystem::isAbsolutePath(state.datFiles[t])
                             ? state.datFiles[t]
                             : fileDirectory + "/" + state.datFiles[t];
@@ -347,8 +358,9 @@ std::shared_ptr<DatVolumeSequenceReader::VolumeSequence> DatVolumeSequenceReader
                                                          state.wrapping);
             const auto filePos = t * bytes + state.byteOffset;
 
-            auto loader = std::make_unique<RawVolumeRAMLoader>(fileDirectory + "/" + state.rawFile,
-                                                               filePos, state.littleEndian);
+            auto loader =
+                std::make_unique<RawVolumeRAMLoader>(fileDirectory + "/" + state.rawFile, filePos,
+                                                     state.littleEndian, options_.getMode());
             diskRepr->setLoader(loader.release());
             volumes->back()->addRepresentation(diskRepr);
             // Compute data range if not specified
@@ -28,21 +28,32 @@
  *********************************************************************************/
 
 #include <modules/base/io/ivfvolumereader.h>
+#include <modules/base/io/compressedbrickfile.h>
 #include <inviwo/core/datastructures/volume/volumeramprecision.h>
 #include <inviwo/core/datastructures/volume/volumedisk.h>
 #include <inviwo/core/util/filesystem.h>
 #include <inviwo/core/common/inviwoapplication.h>
 #include <inviwo/core/io/datareaderexception.h>
 #include <inviwo/core/io/rawvolumeramloader.h>
+#include <inviwo/core/io/rawvolumebrickloader.h>
 
 namespace inviwo {
 
-IvfVolumeReader::IvfVolumeReader() : DataReaderType<Volume>() {
+IvfVolumeReader::IvfVolumeReader()
+    : DataReaderType<Volume>(), options_{} {
     addExtension(FileExtension("ivf", "Inviwo ivf file format"));
 }
 
 IvfVolumeReader* IvfVolumeReader::clone() const { return new IvfVolumeReader(*this); }
 
+bool IvfVolumeReader::setOption(std::string_view key, std::any value) {
+    return options_.setOption(key, value);
+}
+
+std::any IvfVolumeReader::getOption(std::string_view key) {
+    return options_.getOption(key);
+}
+
 std::shared_ptr<Volume> IvfVolumeReader::readData(const std::string& filePath) {
     if (!filesystem::fileExists(filePath)) {
         throw DataReaderException("Error could not find input file: " + filePath, IVW_CONTEXT);
@@ -66,6 +77,15 @@ std::shared_ptr<Volume> IvfVolumeReader::readData(const std::string& filePath) {
     d.deserialize("Format", formatFlag);
     format = DataFormatBase::get(formatFlag);
     d.deserialize("Dimension", dimensions);
+    size3_t fileBrickSize{0u};
+    d.deserialize("BrickSize", fileBrickSize);
+    std::string compression;
+    d.deserialize("Compression", compression);
+    if (!compression.empty() && compression != "zlib") {
+        throw DataReaderException(
+            "Error: Unsupported compression '" + compression + "' in file: " + filePath,
+            IVW_CONTEXT);
+    }
 
     SwizzleMask swizzleMask{swizzlemasks::rgba};
     InterpolationType interpolation{InterpolationType::Linear};
@@ -90,10 +110,41 @@ std::shared_ptr<Volume> IvfVolumeReader::readData(const std::string& filePath) {
 
     volume->getMetaDataMap()->deserialize(d);
     littleEndian = volume->getMetaData<BoolMetaData>("LittleEndian", littleEndian);
+
+    if (!compression.empty()) {
+        auto file = std::make_shared<const CompressedBrickFile>(rawFile, byteOffset, littleEndian,
+                                                                dimensions, format, fileBrickSize);
+        if (options_.brickSize != size3_t{0u}) {
+            volume->addRepresentation(std::make_shared<VolumeBricked>(
+                std::make_shared<CompressedVolumeBrickLoader>(file), dimensions, format,
+                fileBrickSize, VolumeBricked::defaultCacheSize, swizzleMask, interpolation,
+                wrapping));
+        } else {
+            auto vd = std::make_shared<VolumeDisk>(filePath, dimensions, format, swizzleMask,
+                                                   interpolation, wrapping);
+            vd->setLoader(new CompressedVolumeRAMLoader(file));
+            volume->addRepresentation(vd);
+        }
+        return volume;
+    }
+
+    if (fileBrickSize != size3_t{0u} || options_.brickSize != size3_t{0u}) {
+        const auto layout = fileBrickSize != size3_t{0u} ? RawVolumeBrickLoader::Layout::Bricked
+                                                         : RawVolumeBrickLoader::Layout::Linear;
+        const auto brickSize = fileBrickSize != size3_t{0u} ? fileBrickSize : options_.brickSize;
+        auto loader = std::make_shared<RawVolumeBrickLoader>(
+            rawFile, byteOffset, littleEndian, dimensions, format, layout, brickSize);
+        volume->addRepresentation(std::make_shared<VolumeBricked>(
+            loader, dimensions, format, brickSize, VolumeBricked::defaultCacheSize, swizzleMask,
+            interpolation, wrapping));
+        return volume;
+    }
+
     auto vd = std::make_shared<VolumeDisk>(filePath, dimensions, format, swizzleMask, interpolation,
                                            wrapping);
 
-    auto loader = std::make_unique<RawVolumeRAMLoader>(rawFile, byteOffset, littleEndian);
+    auto loader = std::make_unique<RawVolumeRAMLoader>(rawFile, byteOffset, littleEndian,
+                                                       options_.getMode());
     vd->setLoader(loader.release());
 
     volume->addRepresentation(vd);
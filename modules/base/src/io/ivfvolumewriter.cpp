@@ -38,6 +38,11 @@ IvfVolumeWriter::IvfVolumeWriter() : DataWriterType<Volume>() {
     addExtension(FileExtension("ivf", "Inviwo ivf file format"));
 }
 
+IvfVolumeWriter::IvfVolumeWriter(const util::CompressedBrickSettings& compression)
+    : DataWriterType<Volume>(), compression_{compression} {
+    addExtension(FileExtension("ivf", "Inviwo ivf file format, compressed"));
+}
+
 IvfVolumeWriter::IvfVolumeWriter(const IvfVolumeWriter& rhs) = default;
 
 IvfVolumeWriter& IvfVolumeWriter::operator=(const IvfVolumeWriter& that) = default;
@@ -45,26 +50,30 @@ IvfVolumeWriter& IvfVolumeWriter::operator=(const IvfVolumeWriter& that) = defau
 IvfVolumeWriter* IvfVolumeWriter::clone() const { return new IvfVolumeWriter(*this); }
 
 void IvfVolumeWriter::writeData(const Volume* volume, const std::string filePath) const {
-    util::writeIvfVolume(*volume, filePath, getOverwrite());
+    if (compression_) {
+        util::writeCompressedIvfVolume(*volume, filePath, *compression_, getOverwrite());
+    } else {
+        util::writeIvfVolume(*volume, filePath, getOverwrite());
+    }
 }
 
-namespace util {
-void writeIvfVolume(const Volume& data, const std::string filePath, bool overwrite) {
-    std::string rawPath = filesystem::replaceFileExtension(filePath, "raw");
+namespace {
 
+void checkOverwrite(const std::string& filePath, const std::string& dataPath, bool overwrite,
+                    const char* context) {
     if (filesystem::fileExists(filePath) && !overwrite)
         throw DataWriterException("Output file: " + filePath + " already exists",
-                                  IVW_CONTEXT_CUSTOM("util::writeIvfVolume"));
+                                  IVW_CONTEXT_CUSTOM(context));
 
-    if (filesystem::fileExists(rawPath) && !overwrite)
-        throw DataWriterException("Output file: " + rawPath + " already exists",
-                                  IVW_CONTEXT_CUSTOM("util::writeIvfVolume"));
+    if (filesystem::fileExists(dataPath) && !overwrite)
+        throw DataWriterException("Output file: " + dataPath + " already exists",
+                                  IVW_CONTEXT_CUSTOM(context));
+}
 
-    const std::string fileName = filesystem::getFileNameWithoutExtension(filePath);
-    const VolumeRAM* vr = data.getRepresentation<VolumeRAM>();
-    Serializer s(filePath);
-    s.serialize("RawFile", fileName + ".raw");
-    s.serialize("Format", vr->getDataFormatString());
+void serializeHeader(Serializer& s, const Volume& data, const VolumeRAM& vr,
+                     const std::string& dataFile) {
+    s.serialize("RawFile", dataFile);
+    s.serialize("Format", vr.getDataFormatString());
     s.serialize("ByteOffset", 0u);
     s.serialize("BasisAndOffset", data.getModelMatrix());
     s.serialize("WorldTransform", data.getWorldMatrix());
@@ -73,9 +82,22 @@ void writeIvfVolume(const Volume& data, const std::string filePath, bool overwri
     s.serialize("ValueRange", data.dataMap_.valueRange);
     s.serialize("Unit", data.dataMap_.valueUnit);
 
-    s.serialize("SwizzleMask", vr->getSwizzleMask());
-    s.serialize("Interpolation", vr->getInterpolation());
-    s.serialize("Wrapping", vr->getWrapping());
+    s.serialize("SwizzleMask", vr.getSwizzleMask());
+    s.serialize("Interpolation", vr.getInterpolation());
+    s.serialize("Wrapping", vr.getWrapping());
+}
+
+}  // namespace
+
+namespace util {
+void writeIvfVolume(const Volume& data, const std::string filePath, bool overwrite) {
+    std::string rawPath = filesystem::replaceFileExtension(filePath, "raw");
+    checkOverwrite(filePath, rawPath, overwrite, "util::writeIvfVolume");
+
+    const std::string fileName = filesystem::getFileNameWithoutExtension(filePath);
+    const VolumeRAM* vr = data.getRepresentation<VolumeRAM>();
+    Serializer s(filePath);
+    serializeHeader(s, data, *vr, fileName + ".raw");
 
     data.getMetaDataMap()->serialize(s);
     s.writeFile();
@@ -88,6 +110,24 @@ void writeIvfVolume(const Volume& data, const std::string filePath, bool overwri
                                   IVW_CONTEXT_CUSTOM("util::writeIvfVolume"));
     }
 }
+
+void writeCompressedIvfVolume(const Volume& data, const std::string& filePath,
+                              const CompressedBrickSettings& settings, bool overwrite) {
+    const std::string dataPath = filesystem::replaceFileExtension(filePath, "zraw");
+    checkOverwrite(filePath, dataPath, overwrite, "util::writeCompressedIvfVolume");
+
+    const std::string fileName = filesystem::getFileNameWithoutExtension(filePath);
+    const VolumeRAM* vr = data.getRepresentation<VolumeRAM>();
+    util::writeCompressedBrickFile(*vr, dataPath, settings);
+
+    Serializer s(filePath);
+    serializeHeader(s, data, *vr, fileName + ".zraw");
+    s.serialize("Compression", std::string{"zlib"});
+    s.serialize("BrickSize", settings.brickSize);
+
+    data.getMetaDataMap()->serialize(s);
+    s.writeFile();
+}
 }  // namespace util
 
 }  // namespace inviwo
@@ -28,6 +28,9 @@
  *********************************************************************************/
 
 #include <modules/base/processors/volumesequenceelementselectorprocessor.h>
+#include <inviwo/core/util/formatconversion.h>
+
+#include <fmt/format.h>
 
 namespace inviwo {
 
@@ -42,9 +45,42 @@ const ProcessorInfo VolumeSequenceElementSelectorProcessor::getProcessorInfo() c
     return processorInfo_;
 }
 VolumeSequenceElementSelectorProcessor::VolumeSequenceElementSelectorProcessor()
-    : VectorElementSelectorProcessor<Volume>() {
+    : VectorElementSelectorProcessor<Volume>()
+    , streaming_("streaming", "Streaming")
+    , prefetchSteps_("prefetchSteps", "Prefetch Steps", 2, 0, 16, 1, InvalidationLevel::Valid)
+    , memoryBudget_("memoryBudget", "Memory Budget (MB)", 0, 0, 65536, 64,
+                    InvalidationLevel::Valid)
+    , statistics_("statistics", "Statistics", "", InvalidationLevel::Valid) {
     timeStep_.index_.autoLinkToProperty<VolumeSequenceElementSelectorProcessor>(
         "timeStep.selectedSequenceIndex");
+
+    addProperty(streaming_);
+    streaming_.addProperties(prefetchSteps_, memoryBudget_, statistics_);
+    streaming_.setCollapsed(true);
+    statistics_.setReadOnly(true);
+    statistics_.setSerializationMode(PropertySerializationMode::None);
+
+    streamer_.setPrefetchSteps(prefetchSteps_.get());
+    streamer_.setMemoryBudget(memoryBudget_.get() * 1024 * 1024);
+    prefetchSteps_.onChange([this]() { streamer_.setPrefetchSteps(prefetchSteps_.get()); });
+    memoryBudget_.onChange(
+        [this]() { streamer_.setMemoryBudget(memoryBudget_.get() * 1024 * 1024); });
+}
+
+void VolumeSequenceElementSelectorProcessor::process() {
+    VectorElementSelectorProcessor<Volume>::process();
+
+    auto data = inport_.getData();
+    streamer_.setSequence(data);
+    if (!data || data->empty()) return;
+
+    streamer_.select(
+        std::min(data->size() - 1, static_cast<size_t>(timeStep_.index_.get() - 1)));
+
+    const auto& stats = streamer_.getStatistics();
+    statistics_.set(fmt::format("Hits: {}, Waits: {}, Misses: {}, Resident: {}", stats.hits,
+                                stats.waits, stats.misses,
+                                util::formatBytesToString(stats.residentBytes)));
 }
 
 }  // namespace inviwo
@@ -0,0 +1,155 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#ifdef _MSC_VER
+#pragma comment(linker, "/SUBSYSTEM:CONSOLE")
+#endif
+
+#include <modules/base/datastructures/kdtree.h>
+#include <modules/base/datastructures/statickdtree.h>
+
+#include <benchmark/benchmark.h>
+
+#include <random>
+
+#include <warn/push>
+#include <warn/ignore/unused-function>
+
+using namespace inviwo;
+
+static std::vector<vec3> randomPoints(size_t count, unsigned int seed) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> dist(0.0f, 1.0f);
+    std::vector<vec3> points(count);
+    for (auto& p : points) p = vec3{dist(rng), dist(rng), dist(rng)};
+    return points;
+}
+
+static constexpr size_t numQueries = 10000;
+static constexpr int numNeighbors = 8;
+
+static void BuildOld(benchmark::State& state) {
+    const auto points = randomPoints(static_cast<size_t>(state.range(0)), 0);
+    for (auto _ : state) {
+        K3DTree<size_t, float> tree;
+        for (size_t i = 0; i < points.size(); ++i) tree.insert(points[i], i);
+        benchmark::DoNotOptimize(tree.getRoot());
+    }
+    state.counters["Points"] = static_cast<double>(points.size());
+}
+
+static void BuildNew(benchmark::State& state) {
+    const auto points = randomPoints(static_cast<size_t>(state.range(0)), 0);
+    for (auto _ : state) {
+        StaticKDTree<3, float> tree(points);
+        benchmark::DoNotOptimize(tree.size());
+    }
+    state.counters["Points"] = static_cast<double>(points.size());
+}
+
+static void NNearestOld(benchmark::State& state) {
+    const auto points = randomPoints(static_cast<size_t>(state.range(0)), 0);
+    const auto queries = randomPoints(numQueries, 1);
+    K3DTree<size_t, float> tree;
+    for (size_t i = 0; i < points.size(); ++i) tree.insert(points[i], i);
+
+    for (auto _ : state) {
+        for (const auto& q : queries) {
+            auto res = tree.findNNearest(q, numNeighbors);
+            benchmark::DoNotOptimize(res.data());
+        }
+    }
+    state.counters["Queries"] = benchmark::Counter(static_cast<double>(queries.size()),
+                                                   benchmark::Counter::kIsIterationInvariantRate);
+}
+
+static void NNearestNew(benchmark::State& state) {
+    const auto points = randomPoints(static_cast<size_t>(state.range(0)), 0);
+    const auto queries = randomPoints(numQueries, 1);
+    const StaticKDTree<3, float> tree(points);
+
+    for (auto _ : state) {
+        for (const auto& q : queries) {
+            auto res = tree.findNNearest(q, static_cast<size_t>(numNeighbors));
+            benchmark::DoNotOptimize(res.data());
+        }
+    }
+    state.counters["Queries"] = benchmark::Counter(static_cast<double>(queries.size()),
+                                                   benchmark::Counter::kIsIterationInvariantRate);
+}
+
+static void RadiusOld(benchmark::State& state) {
+    const auto points = randomPoints(static_cast<size_t>(state.range(0)), 0);
+    const auto queries = randomPoints(numQueries, 1);
+    K3DTree<size_t, float> tree;
+    for (size_t i = 0; i < points.size(); ++i) tree.insert(points[i], i);
+
+    for (auto _ : state) {
+        for (const auto& q : queries) {
+            auto res = tree.findCloseTo(q, 0.05f);
+            benchmark::DoNotOptimize(res.data());
+        }
+    }
+    state.counters["Queries"] = benchmark::Counter(static_cast<double>(queries.size()),
+                                                   benchmark::Counter::kIsIterationInvariantRate);
+}
+
+static void RadiusNew(benchmark::State& state) {
+    const auto points = randomPoints(static_cast<size_t>(state.range(0)), 0);
+    const auto queries = randomPoints(numQueries, 1);
+    const StaticKDTree<3, float> tree(points);
+
+    for (auto _ : state) {
+        for (const auto& q : queries) {
+            auto res = tree.findCloseTo(q, 0.05f);
+            benchmark::DoNotOptimize(res.data());
+        }
+    }
+    state.counters["Queries"] = benchmark::Counter(static_cast<double>(queries.size()),
+                                                   benchmark::Counter::kIsIterationInvariantRate);
+}
+
+BENCHMARK(BuildOld)->RangeMultiplier(8)->Range(1 << 10, 1 << 19);
+BENCHMARK(BuildNew)->RangeMultiplier(8)->Range(1 << 10, 1 << 22);
+
+BENCHMARK(NNearestOld)->RangeMultiplier(8)->Range(1 << 10, 1 << 19);
+BENCHMARK(NNearestNew)->RangeMultiplier(8)->Range(1 << 10, 1 << 22);
+
+BENCHMARK(RadiusOld)->RangeMultiplier(8)->Range(1 << 10, 1 << 19);
+BENCHMARK(RadiusNew)->RangeMultiplier(8)->Range(1 << 10, 1 << 22);
+
+int main(int argc, char** argv) {
+
+    benchmark::Initialize(&argc, argv);
+    benchmark::RunSpecifiedBenchmarks();
+
+    return 0;
+}
+
+#include <warn/pop>
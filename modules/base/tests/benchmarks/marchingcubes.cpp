@@ -76,6 +76,21 @@ static void SphereNew(benchmark::State& state) {
         static_cast<double>(state.range(0) * state.range(0) * state.range(0));
 }
 
+static void SphereParallel(benchmark::State& state) {
+    auto v = std::shared_ptr<Volume>(
+        util::makeSphericalVolume(size3_t{static_cast<size_t>(state.range(0))}));
+
+    for (auto _ : state) {
+        auto mesh = util::marchingCubesParallel(v, 0.5, {0.5f, 0.0f, 0.0f, 1.0f}, false, false);
+        state.counters["Vertices"] = static_cast<double>(mesh->getBuffer(0)->getSize());
+        state.counters["Indices"] =
+            static_cast<double>(mesh->getIndexBuffers().front().second->getSize());
+        benchmark::ClobberMemory();
+    }
+    state.counters["Voxels"] =
+        static_cast<double>(state.range(0) * state.range(0) * state.range(0));
+}
+
 static void RippleOld(benchmark::State& state) {
     auto v = std::shared_ptr<Volume>(
         util::makeRippleVolume(size3_t{static_cast<size_t>(state.range(0))}));
@@ -106,6 +121,21 @@ static void RippleNew(benchmark::State& state) {
         static_cast<double>(state.range(0) * state.range(0) * state.range(0));
 }
 
+static void RippleParallel(benchmark::State& state) {
+    auto v = std::shared_ptr<Volume>(
+        util::makeRippleVolume(size3_t{static_cast<size_t>(state.range(0))}));
+
+    for (auto _ : state) {
+        auto mesh = util::marchingCubesParallel(v, 0.5, {0.5f, 0.0f, 0.0f, 1.0f}, false, false);
+        state.counters["Vertices"] = static_cast<double>(mesh->getBuffer(0)->getSize());
+        state.counters["Indices"] =
+            static_cast<double>(mesh->getIndexBuffers().front().second->getSize());
+        benchmark::ClobberMemory();
+    }
+    state.counters["Voxels"] =
+        static_cast<double>(state.range(0) * state.range(0) * state.range(0));
+}
+
 static void MiniOld(benchmark::State& state) {
     auto v = std::shared_ptr<Volume>(
         util::makeSingleVoxelVolume(size3_t{static_cast<size_t>(state.range(0))}));
@@ -136,14 +166,34 @@ static void MiniNew(benchmark::State& state) {
         static_cast<double>(state.range(0) * state.range(0) * state.range(0));
 }
 
+static void MiniParallel(benchmark::State& state) {
+    auto v = std::shared_ptr<Volume>(
+        util::makeSingleVoxelVolume(size3_t{static_cast<size_t>(state.range(0))}));
+
+    for (auto _ : state) {
+        auto mesh = util::marchingCubesParallel(v, 0.5, {0.5f, 0.0f, 0.0f, 1.0f}, false, false);
+        state.counters["Vertices"] = static_cast<double>(mesh->getBuffer(0)->getSize());
+        state.counters["Indices"] =
+            static_cast<double>(mesh->getIndexBuffers().front().second->getSize());
+        benchmark::ClobberMemory();
+    }
+    state.counters["Voxels"] =
+        static_cast<double>(state.range(0) * state.range(0) * state.range(0));
+}
+
 BENCHMARK(SphereOld)->RangeMultiplier(2)->Range(8, 8 << 5);
 BENCHMARK(SphereNew)->RangeMultiplier(2)->Range(8, 8 << 6);
+BENCHMARK(SphereParallel)->RangeMultiplier(2)->Range(8, 8 << 6);
 
 BENCHMARK(RippleOld)->RangeMultiplier(2)->Range(8, 8 << 4);
 BENCHMARK(RippleNew)->RangeMultiplier(2)->Range(8, 8 << 5);
+BENCHMARK(RippleParallel)->RangeMultiplier(2)->Range(8, 8 << 5);
+
+// A single voxel in a large volume, where skipping the empty bricks dominates
+BENCHMARK(MiniNew)->RangeMultiplier(2)->Range(64, 8 << 6);
+BENCHMARK(MiniParallel)->RangeMultiplier(2)->Range(64, 8 << 6);
 
 // BENCHMARK(MiniOld)->RangeMultiplier(2)->Range(8, 8 << 5);
-// BENCHMARK(MiniNew)->RangeMultiplier(2)->Range(8, 8 << 5);
 
 // BENCHMARK(MiniOld)->Arg(3);
 // BENCHMARK(MiniNew)->Arg(3);
@@ -0,0 +1,164 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <warn/push>
+#include <warn/ignore/all>
+#include <gtest/gtest.h>
+#include <warn/pop>
+
+#include <modules/base/io/compressedbrickfile.h>
+#include <inviwo/core/datastructures/volume/volumebricked.h>
+#include <inviwo/core/datastructures/volume/volumeramprecision.h>
+#include <inviwo/core/io/bytereaderutil.h>
+#include <inviwo/core/io/datareaderexception.h>
+#include <inviwo/core/io/tempfilehandle.h>
+#include <inviwo/core/util/indexmapper.h>
+
+#include <cstdio>
+#include <cstdint>
+#include <vector>
+
+namespace inviwo {
+
+namespace {
+
+std::uint16_t voxelValue(size3_t pos, size3_t dims) {
+    return static_cast<std::uint16_t>(util::IndexMapper3D{dims}(pos));
+}
+
+std::shared_ptr<VolumeRAMPrecision<std::uint16_t>> makeVolume(size3_t dims) {
+    auto volume = std::make_shared<VolumeRAMPrecision<std::uint16_t>>(dims);
+    auto data = volume->getDataTyped();
+    for (size_t i = 0; i < glm::compMul(dims); ++i) {
+        data[i] = static_cast<std::uint16_t>(i);
+    }
+    return volume;
+}
+
+void expectRegion(const std::uint16_t* data, size3_t offset, size3_t extent, size3_t dims) {
+    const util::IndexMapper3D im{extent};
+    for (size_t z = 0; z < extent.z; ++z) {
+        for (size_t y = 0; y < extent.y; ++y) {
+            for (size_t x = 0; x < extent.x; ++x) {
+                ASSERT_EQ(voxelValue(offset + size3_t{x, y, z}, dims), data[im(x, y, z)])
+                    << "at (" << x << ", " << y << ", " << z << ")";
+            }
+        }
+    }
+}
+
+}  // namespace
+
+TEST(CompressedBrickFile, BricksAndRegions) {
+    const size3_t dims{9, 7, 5};
+    const size3_t brickSize{4, 3, 2};
+
+    util::TempFileHandle tmpFile("", ".zraw");
+    util::writeCompressedBrickFile(*makeVolume(dims), tmpFile.getFileName(),
+                                   {brickSize, 6, true});
+
+    const CompressedBrickFile file(tmpFile.getFileName(), 0, util::isSystemLittleEndian(), dims,
+                                   DataUInt16::get(), brickSize);
+    EXPECT_EQ(size3_t(3, 3, 3), file.getBrickCounts());
+    ASSERT_EQ(27u, file.getNumberOfBricks());
+    ASSERT_TRUE(file.hasBrickMinMax());
+
+    for (size_t brick = 0; brick < file.getNumberOfBricks(); ++brick) {
+        const auto offset = file.getBrickOffset(brick);
+        const auto extent = file.getBrickExtent(brick);
+        std::vector<std::uint16_t> data(glm::compMul(extent));
+        file.readBrick(brick, data.data());
+        expectRegion(data.data(), offset, extent, dims);
+
+        const auto [min, max] = file.getBrickMinMax(brick);
+        EXPECT_EQ(static_cast<double>(voxelValue(offset, dims)), min.x);
+        EXPECT_EQ(static_cast<double>(voxelValue(offset + extent - size3_t{1}, dims)), max.x);
+    }
+
+    std::vector<std::uint16_t> all(glm::compMul(dims));
+    file.readRegion(size3_t{0}, dims, all.data());
+    expectRegion(all.data(), size3_t{0}, dims, dims);
+
+    const size3_t offset{2, 1, 3};
+    const size3_t extent{6, 6, 2};
+    std::vector<std::uint16_t> region(glm::compMul(extent));
+    file.readRegion(offset, extent, region.data());
+    expectRegion(region.data(), offset, extent, dims);
+}
+
+TEST(CompressedBrickFile, VolumeBrickedAndRAMLoaders) {
+    const size3_t dims{10, 6, 7};
+    const size3_t brickSize{4};
+
+    util::TempFileHandle tmpFile("", ".zraw");
+    util::writeCompressedBrickFile(*makeVolume(dims), tmpFile.getFileName(),
+                                   {brickSize, 1, false});
+    const auto file = std::make_shared<const CompressedBrickFile>(
+        tmpFile.getFileName(), 0, util::isSystemLittleEndian(), dims, DataUInt16::get(),
+        brickSize);
+    EXPECT_FALSE(file->hasBrickMinMax());
+
+    const VolumeBricked bricked(std::make_shared<CompressedVolumeBrickLoader>(file), dims,
+                                DataUInt16::get(), brickSize);
+    const auto region = bricked.readRegion({3, 1, 2}, {5, 5, 5});
+    expectRegion(static_cast<const std::uint16_t*>(region->getData()), {3, 1, 2}, {5, 5, 5},
+                 dims);
+
+    const VolumeBricked misaligned(std::make_shared<CompressedVolumeBrickLoader>(file), dims,
+                                   DataUInt16::get(), size3_t{3});
+    EXPECT_THROW(misaligned.getBrick(1), DataReaderException);
+
+    const CompressedVolumeRAMLoader loader(file);
+    const VolumeRAMPrecision<std::uint16_t> src(dims);
+    const auto volume = std::static_pointer_cast<VolumeRAM>(loader.createRepresentation(src));
+    ASSERT_EQ(dims, volume->getDimensions());
+    expectRegion(static_cast<const std::uint16_t*>(volume->getData()), size3_t{0}, dims, dims);
+}
+
+TEST(CompressedBrickFile, InvalidFiles) {
+    const size3_t dims{8, 8, 8};
+    const size3_t brickSize{4};
+
+    util::TempFileHandle rawFile("", ".raw");
+    std::vector<unsigned char> bytes(glm::compMul(dims) * 2, 0);
+    std::fwrite(bytes.data(), sizeof(unsigned char), bytes.size(), rawFile.getHandle());
+    std::fflush(rawFile.getHandle());
+    EXPECT_THROW(CompressedBrickFile(rawFile.getFileName(), 0, true, dims, DataUInt16::get(),
+                                     brickSize),
+                 DataReaderException);
+
+    util::TempFileHandle tmpFile("", ".zraw");
+    util::writeCompressedBrickFile(*makeVolume(dims), tmpFile.getFileName(), {brickSize, 1, true});
+    // The index does not match a different brick size
+    EXPECT_THROW(CompressedBrickFile(tmpFile.getFileName(), 0, true, dims, DataUInt16::get(),
+                                     size3_t{8}),
+                 DataReaderException);
+}
+
+}  // namespace inviwo
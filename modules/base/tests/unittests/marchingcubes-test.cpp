@@ -335,4 +335,50 @@ TEST(Marchingcubes, sphere) {
     */
 }
 
+namespace {
+
+void compareParallel(std::shared_ptr<const Volume> vol, double iso, bool invert) {
+    auto ref = util::marchingCubesOpt(vol, iso, {1.0f, 0.0f, 0.0f, 1.0f}, invert, false);
+    const auto& refPos = getBufferData<vec3>(*ref, 0);
+    const auto& refNormals = getBufferData<vec3>(*ref, 3);
+    const auto& refInd = getBufferIndexData(*ref, 0);
+    ASSERT_FALSE(refInd.empty());
+
+    for (size_t slabs : {1, 3, 4, 7}) {
+        auto mesh = util::marchingCubesParallel(vol, iso, {1.0f, 0.0f, 0.0f, 1.0f}, invert, false,
+                                                nullptr, nullptr, slabs);
+        const auto& pos = getBufferData<vec3>(*mesh, 0);
+        const auto& normals = getBufferData<vec3>(*mesh, 3);
+        const auto& ind = getBufferIndexData(*mesh, 0);
+
+        EXPECT_EQ(refPos, pos) << "slabs: " << slabs;
+        EXPECT_EQ(refInd, ind) << "slabs: " << slabs;
+        // the normals on slab boundaries are summed in a different order
+        ASSERT_EQ(refNormals.size(), normals.size());
+        for (size_t i = 0; i < normals.size(); ++i) {
+            EXPECT_NEAR(glm::distance(refNormals[i], normals[i]), 0.0f, 1.0e-5f)
+                << "slabs: " << slabs << " vertex: " << i;
+        }
+    }
+}
+
+}  // namespace
+
+TEST(Marchingcubes, parallelSphere) {
+    auto vol = std::shared_ptr<Volume>(util::makeSphericalVolume(size3_t{27, 19, 33}));
+    compareParallel(vol, 0.5, false);
+    compareParallel(vol, 0.5, true);
+}
+
+TEST(Marchingcubes, parallelRipple) {
+    auto vol = std::shared_ptr<Volume>(util::makeRippleVolume(size3_t{32}));
+    compareParallel(vol, 0.5, false);
+}
+
+TEST(Marchingcubes, parallelSingleVoxel) {
+    // most of the bricks are empty and skipped
+    auto vol = std::shared_ptr<Volume>(util::makeSingleVoxelVolume(size3_t{40}));
+    compareParallel(vol, 0.5, false);
+}
+
 }  // namespace inviwo
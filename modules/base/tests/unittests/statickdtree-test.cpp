@@ -0,0 +1,157 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <warn/push>
+#include <warn/ignore/all>
+#include <gtest/gtest.h>
+#include <warn/pop>
+
+#include <modules/base/datastructures/statickdtree.h>
+
+#include <random>
+
+namespace inviwo {
+
+namespace {
+
+std::vector<vec3> randomPoints(size_t count, std::mt19937& rng) {
+    std::uniform_real_distribution<float> dist(0.0f, 1.0f);
+    std::vector<vec3> points(count);
+    for (auto& p : points) p = vec3{dist(rng), dist(rng), dist(rng)};
+    return points;
+}
+
+std::vector<std::pair<float, size_t>> sortedByDistance(const std::vector<vec3>& points,
+                                                        const vec3& pos) {
+    std::vector<std::pair<float, size_t>> res;
+    for (size_t i = 0; i < points.size(); ++i) {
+        const auto delta = points[i] - pos;
+        res.emplace_back(glm::dot(delta, delta), i);
+    }
+    std::sort(res.begin(), res.end());
+    return res;
+}
+
+}  // namespace
+
+TEST(StaticKDTreeTests, empty) {
+    StaticKDTree<3, float> tree;
+    EXPECT_TRUE(tree.empty());
+    EXPECT_EQ(0, tree.size());
+    EXPECT_TRUE(tree.findNNearest(vec3{0.0f}, 4).empty());
+    EXPECT_TRUE(tree.findCloseTo(vec3{0.0f}, 1.0f).empty());
+}
+
+TEST(StaticKDTreeTests, findNearest) {
+    std::mt19937 rng(0);
+    const auto points = randomPoints(1000, rng);
+    const StaticKDTree<3, float> tree(points);
+    EXPECT_EQ(points.size(), tree.size());
+
+    for (const auto& pos : randomPoints(100, rng)) {
+        const auto expected = sortedByDistance(points, pos);
+        const auto nearest = tree.findNearest(pos);
+        EXPECT_EQ(expected.front().second, nearest.index);
+        EXPECT_EQ(expected.front().first, nearest.sqDist);
+    }
+    for (size_t i = 0; i < points.size(); ++i) {
+        EXPECT_EQ(i, tree.findNearest(points[i]).index);
+    }
+}
+
+TEST(StaticKDTreeTests, findNNearest) {
+    std::mt19937 rng(0);
+    const auto points = randomPoints(1000, rng);
+    const StaticKDTree<3, float> tree(points);
+
+    for (const auto& pos : randomPoints(100, rng)) {
+        const auto expected = sortedByDistance(points, pos);
+        const auto nearest = tree.findNNearest(pos, 10);
+        ASSERT_EQ(10, nearest.size());
+        for (size_t i = 0; i < nearest.size(); ++i) {
+            EXPECT_EQ(expected[i].second, nearest[i].index);
+        }
+    }
+    EXPECT_EQ(points.size(), tree.findNNearest(vec3{0.5f}, 2000).size());
+}
+
+TEST(StaticKDTreeTests, findCloseTo) {
+    std::mt19937 rng(0);
+    const auto points = randomPoints(1000, rng);
+    const StaticKDTree<3, float> tree(points);
+
+    const float radius = 0.2f;
+    for (const auto& pos : randomPoints(100, rng)) {
+        std::vector<size_t> expected;
+        for (auto& [dist, index] : sortedByDistance(points, pos)) {
+            if (dist <= radius * radius) expected.push_back(index);
+        }
+        std::vector<size_t> found;
+        for (auto& n : tree.findCloseTo(pos, radius)) found.push_back(n.index);
+        std::sort(expected.begin(), expected.end());
+        std::sort(found.begin(), found.end());
+        EXPECT_EQ(expected, found);
+    }
+}
+
+TEST(StaticKDTreeTests, duplicatePoints) {
+    const std::vector<vec3> points(20, vec3{1.0f, 2.0f, 3.0f});
+    const StaticKDTree<3, float> tree(points);
+
+    // ties are resolved in favor of the lower index
+    EXPECT_EQ(0, tree.findNearest(vec3{0.0f}).index);
+    const auto nearest = tree.findNNearest(vec3{0.0f}, 3);
+    ASSERT_EQ(3, nearest.size());
+    EXPECT_EQ(0, nearest[0].index);
+    EXPECT_EQ(1, nearest[1].index);
+    EXPECT_EQ(2, nearest[2].index);
+    EXPECT_EQ(20, tree.findCloseTo(vec3{1.0f, 2.0f, 3.0f}, 0.0f).size());
+}
+
+TEST(StaticKDTreeTests, batchedQueries) {
+    std::mt19937 rng(0);
+    const auto points = randomPoints(1000, rng);
+    const StaticKDTree<3, float> tree(points);
+    const auto positions = randomPoints(100, rng);
+
+    const auto nearest = tree.findNearest(positions);
+    const auto nNearest = tree.findNNearest(positions, 5);
+    const auto closeTo = tree.findCloseTo(positions, 0.1f);
+    ASSERT_EQ(positions.size(), nearest.size());
+    ASSERT_EQ(positions.size(), nNearest.size());
+    ASSERT_EQ(positions.size(), closeTo.size());
+
+    for (size_t i = 0; i < positions.size(); ++i) {
+        EXPECT_EQ(tree.findNearest(positions[i]).index, nearest[i].index);
+        EXPECT_EQ(tree.findNNearest(positions[i], 5).size(), nNearest[i].size());
+        EXPECT_EQ(tree.findCloseTo(positions[i], 0.1f).size(), closeTo[i].size());
+    }
+}
+
+}  // namespace inviwo
@@ -0,0 +1,171 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <warn/push>
+#include <warn/ignore/all>
+#include <gtest/gtest.h>
+#include <warn/pop>
+
+#include <modules/base/algorithm/volume/volumestencil.h>
+#include <inviwo/core/datastructures/volume/volume.h>
+#include <inviwo/core/datastructures/volume/volumeram.h>
+#include <inviwo/core/datastructures/volume/volumeramprecision.h>
+#include <inviwo/core/util/indexmapper.h>
+#include <inviwo/core/util/volumeramutils.h>
+#include <inviwo/core/util/exception.h>
+
+namespace inviwo {
+
+namespace {
+
+// Creates a volume with a voxel spacing of one world space unit
+template <typename T, typename Func>
+std::shared_ptr<Volume> makeVolume(const size3_t& dims, Func func,
+                                   const Wrapping3D& wrapping = wrapping3d::clampAll) {
+    auto ram = std::make_shared<VolumeRAMPrecision<T>>(dims);
+    const util::IndexMapper3D im(dims);
+    auto data = ram->getDataTyped();
+    util::forEachVoxel(dims, [&](const size3_t& pos) { data[im(pos)] = func(vec3(pos)); });
+
+    auto volume = std::make_shared<Volume>(ram);
+    volume->setModelMatrix(glm::scale(vec3(dims - size3_t(1))));
+    volume->setWorldMatrix(mat4(1.0f));
+    volume->setWrapping(wrapping);
+    return volume;
+}
+
+template <typename T>
+const T* getData(const Volume& volume) {
+    return static_cast<const T*>(volume.getRepresentation<VolumeRAM>()->getData());
+}
+
+}  // namespace
+
+TEST(VolumeStencil, SpacingFromBasis) {
+    auto volume = makeVolume<float>(size3_t{5, 6, 7}, [](const vec3&) { return 0.0f; });
+    const auto spacing = util::voxelSpacing(*volume);
+    EXPECT_NEAR(spacing.x, 1.0, 1.0e-6);
+    EXPECT_NEAR(spacing.y, 1.0, 1.0e-6);
+    EXPECT_NEAR(spacing.z, 1.0, 1.0e-6);
+}
+
+TEST(VolumeStencil, GradientOfLinearFunctionIsExactWithClamp) {
+    const size3_t dims{6, 5, 4};
+    auto volume =
+        makeVolume<float>(dims, [](const vec3& p) { return 2.0f * p.x - 3.0f * p.y + 0.5f * p.z; });
+
+    auto res = util::derivativeVolumes(
+        *volume, {util::VolumeDerivative::Gradient, util::VolumeDerivative::GradientMagnitude,
+                  util::VolumeDerivative::Laplacian});
+    ASSERT_EQ(res.size(), 3);
+    EXPECT_EQ(res[0]->getDataFormat(), DataVec3Float32::get());
+    EXPECT_EQ(res[1]->getDataFormat(), DataFloat32::get());
+    EXPECT_EQ(res[2]->getDataFormat(), DataFloat32::get());
+
+    const auto gradient = getData<vec3>(*res[0]);
+    const auto magnitude = getData<float>(*res[1]);
+    const vec3 expected{2.0f, -3.0f, 0.5f};
+    for (size_t i = 0; i < glm::compMul(dims); ++i) {
+        EXPECT_NEAR(glm::distance(gradient[i], expected), 0.0f, 1.0e-5f) << "index " << i;
+        EXPECT_NEAR(magnitude[i], glm::length(expected), 1.0e-5f) << "index " << i;
+    }
+
+    // the one sided differences at the borders see a constant gradient
+    const auto laplacian = getData<float>(*res[2]);
+    const util::IndexMapper3D im(dims);
+    EXPECT_NEAR(laplacian[im(size3_t{2, 2, 2})], 0.0f, 1.0e-5f);
+}
+
+TEST(VolumeStencil, LaplacianOfQuadraticFunction) {
+    const size3_t dims{7, 7, 7};
+    auto volume = makeVolume<double>(dims, [](const vec3& p) {
+        return static_cast<double>(p.x * p.x + 2.0f * p.y * p.y - p.z * p.z);
+    });
+    auto res = util::derivativeVolumes(*volume, {util::VolumeDerivative::Laplacian});
+    const auto laplacian = getData<float>(*res[0]);
+
+    const util::IndexMapper3D im(dims);
+    size3_t pos;
+    for (pos.z = 1; pos.z + 1 < dims.z; ++pos.z) {
+        for (pos.y = 1; pos.y + 1 < dims.y; ++pos.y) {
+            for (pos.x = 1; pos.x + 1 < dims.x; ++pos.x) {
+                EXPECT_NEAR(laplacian[im(pos)], 4.0f, 1.0e-4f);
+            }
+        }
+    }
+}
+
+TEST(VolumeStencil, CurlAndDivergence) {
+    const size3_t dims{5, 5, 5};
+    // rotation around z and expansion in x and y
+    auto volume = makeVolume<vec3>(dims, [](const vec3& p) {
+        return vec3{-p.y + p.x, p.x + p.y, 0.0f};
+    });
+
+    auto res = util::derivativeVolumes(
+        *volume, {util::VolumeDerivative::Curl, util::VolumeDerivative::Divergence});
+    const auto curl = getData<vec3>(*res[0]);
+    const auto divergence = getData<float>(*res[1]);
+    for (size_t i = 0; i < glm::compMul(dims); ++i) {
+        EXPECT_NEAR(glm::distance(curl[i], vec3{0.0f, 0.0f, 2.0f}), 0.0f, 1.0e-5f);
+        EXPECT_NEAR(divergence[i], 2.0f, 1.0e-5f);
+    }
+    EXPECT_NEAR(res[1]->dataMap_.valueRange.x, 2.0, 1.0e-5);
+    EXPECT_NEAR(res[1]->dataMap_.valueRange.y, 2.0, 1.0e-5);
+}
+
+TEST(VolumeStencil, BorderWrapping) {
+    const size3_t dims{8, 3, 3};
+    const auto ramp = [](const vec3& p) { return p.x; };
+    const util::IndexMapper3D im(dims);
+    const auto first = im(size3_t{0, 1, 1});
+    const auto last = im(size3_t{7, 1, 1});
+
+    auto repeat = util::derivativeVolumes(*makeVolume<float>(dims, ramp, wrapping3d::repeatAll),
+                                          {util::VolumeDerivative::Gradient});
+    const auto gr = getData<vec3>(*repeat[0]);
+    EXPECT_NEAR(gr[first].x, (1.0f - 7.0f) / 2.0f, 1.0e-5f);
+    EXPECT_NEAR(gr[last].x, (0.0f - 6.0f) / 2.0f, 1.0e-5f);
+
+    auto mirror = util::derivativeVolumes(*makeVolume<float>(dims, ramp, wrapping3d::mirrorAll),
+                                          {util::VolumeDerivative::Gradient});
+    const auto gm = getData<vec3>(*mirror[0]);
+    EXPECT_NEAR(gm[first].x, 0.0f, 1.0e-5f);
+    EXPECT_NEAR(gm[last].x, 0.0f, 1.0e-5f);
+}
+
+TEST(VolumeStencil, DivergenceOfScalarVolumeThrows) {
+    auto volume = makeVolume<float>(size3_t{3, 3, 3}, [](const vec3& p) { return p.x; });
+    EXPECT_THROW(util::derivativeVolumes(*volume, {util::VolumeDerivative::Divergence}),
+                 Exception);
+    EXPECT_THROW(util::derivativeVolumes(*volume, {util::VolumeDerivative::Gradient}, 1),
+                 Exception);
+}
+
+}  // namespace inviwo
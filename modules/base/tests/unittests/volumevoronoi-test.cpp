@@ -36,6 +36,8 @@
 #include <inviwo/core/datastructures/volume/volumeramprecision.h>
 #include <inviwo/core/util/indexmapper.h>
 
+#include <random>
+
 namespace inviwo {
 
 constexpr auto clamp3D = Wrapping3D{Wrapping::Clamp, Wrapping::Clamp, Wrapping::Clamp};
@@ -206,4 +208,92 @@ TEST(VolumeVoronoi, Voronoi_ThreeSeedPoints_PartitionsVolumeInThree) {
     }
 }
 
+TEST(VolumeVoronoi, Voronoi_RepeatWrapping_UsesPeriodicDistance) {
+    const std::vector<std::pair<uint32_t, vec3>> seedPoints = {{1, vec3{0, 2, 2}},
+                                                               {2, vec3{2, 2, 2}}};
+    const auto dimensions = size3_t{4, 4, 4};
+
+    const auto labels = [&](const Wrapping3D& wrapping) {
+        auto volumeVoronoi = util::voronoiSegmentation(dimensions, mat4{1.0f}, seedPoints,
+                                                       wrapping, /*weights*/ std::nullopt);
+        const auto ramtyped = dynamic_cast<const VolumeRAMPrecision<unsigned short>*>(
+            volumeVoronoi->getRepresentation<VolumeRAM>());
+        EXPECT_TRUE(ramtyped != nullptr);
+        const util::IndexMapper3D im(dimensions);
+        std::vector<unsigned short> row;
+        for (size_t x = 0; x < dimensions.x; x++) {
+            row.push_back(ramtyped->getDataTyped()[im(x, 2, 2)]);
+        }
+        return row;
+    };
+
+    // ties are resolved in favor of the first seed point
+    EXPECT_EQ((std::vector<unsigned short>{1, 1, 2, 2}), labels(clamp3D));
+    EXPECT_EQ((std::vector<unsigned short>{1, 1, 2, 1}),
+              labels(Wrapping3D{Wrapping::Repeat, Wrapping::Clamp, Wrapping::Clamp}));
+}
+
+TEST(VolumeVoronoi, Voronoi_LargeIndices_UsesUInt32Volume) {
+    const std::vector<std::pair<uint32_t, vec3>> seedPoints = {{70000, vec3{0, 1, 1}},
+                                                               {1, vec3{2, 1, 1}}};
+    const auto dimensions = size3_t{3, 3, 3};
+
+    auto volumeVoronoi = util::voronoiSegmentation(dimensions, mat4{1.0f}, seedPoints, clamp3D,
+                                                   /*weights*/ std::nullopt);
+
+    const auto ramtyped = dynamic_cast<const VolumeRAMPrecision<std::uint32_t>*>(
+        volumeVoronoi->getRepresentation<VolumeRAM>());
+    ASSERT_TRUE(ramtyped != nullptr);
+
+    const util::IndexMapper3D im(dimensions);
+    EXPECT_EQ(70000u, ramtyped->getDataTyped()[im(0, 1, 1)]);
+    EXPECT_EQ(1u, ramtyped->getDataTyped()[im(2, 1, 1)]);
+    EXPECT_EQ(70000.0, volumeVoronoi->dataMap_.dataRange.y);
+}
+
+TEST(VolumeVoronoi, WeightedVoronoi_ManySeedPoints_MatchesLinearSearch) {
+    std::mt19937 rng(123);
+    std::uniform_real_distribution<float> posDist(0.0f, 16.0f);
+    std::uniform_real_distribution<float> weightDist(0.0f, 2.0f);
+
+    std::vector<std::pair<uint32_t, vec3>> seedPoints;
+    std::vector<float> weights;
+    for (uint32_t i = 0; i < 300; ++i) {
+        seedPoints.emplace_back(i, vec3{posDist(rng), posDist(rng), posDist(rng)});
+        weights.push_back(weightDist(rng));
+    }
+    const auto dimensions = size3_t{16, 16, 16};
+    const auto size = vec3{dimensions};
+    const auto wrapping = Wrapping3D{Wrapping::Repeat, Wrapping::Clamp, Wrapping::Repeat};
+
+    auto volumeVoronoi =
+        util::voronoiSegmentation(dimensions, mat4{1.0f}, seedPoints, wrapping, weights);
+    const auto ramtyped = dynamic_cast<const VolumeRAMPrecision<unsigned short>*>(
+        volumeVoronoi->getRepresentation<VolumeRAM>());
+    ASSERT_TRUE(ramtyped != nullptr);
+
+    const auto powerDistance = [&](size_t i, const vec3& pos) {
+        auto delta = pos - seedPoints[i].second;
+        for (int dim : {0, 2}) {
+            if (delta[dim] > 0.5f * size[dim]) delta[dim] -= size[dim];
+            if (delta[dim] < -0.5f * size[dim]) delta[dim] += size[dim];
+        }
+        return glm::length2(delta) - weights[i] * weights[i];
+    };
+
+    const util::IndexMapper3D im(dimensions);
+    for (size_t z = 0; z < dimensions.z; z++) {
+        for (size_t y = 0; y < dimensions.y; y++) {
+            for (size_t x = 0; x < dimensions.x; x++) {
+                const vec3 pos{x, y, z};
+                size_t closest = 0;
+                for (size_t i = 1; i < seedPoints.size(); ++i) {
+                    if (powerDistance(i, pos) < powerDistance(closest, pos)) closest = i;
+                }
+                EXPECT_EQ(seedPoints[closest].first, ramtyped->getDataTyped()[im(x, y, z)]);
+            }
+        }
+    }
+}
+
 }  // namespace inviwo
@@ -30,9 +30,11 @@
 #pragma once
 
 #include <modules/brushingandlinking/brushingandlinkingmoduledefine.h>
+#include <modules/brushingandlinking/datastructures/bitset.h>
 #include <modules/brushingandlinking/datastructures/indexlist.h>
 #include <inviwo/core/properties/invalidationlevel.h>
 
+#include <optional>
 #include <unordered_set>
 
 namespace inviwo {
@@ -66,21 +68,35 @@ public:
     bool isColumnSelected(size_t column) const;
 
     void setSelected(const BrushingAndLinkingInport* src, const std::unordered_set<size_t>& idx);
+    void setSelected(const BrushingAndLinkingInport* src, BitSet idx);
     void clearSelected();
 
     void setFiltered(const BrushingAndLinkingInport* src, const std::unordered_set<size_t>& idx);
+    void setFiltered(const BrushingAndLinkingInport* src, BitSet idx);
     void clearFiltered();
 
     void setSelectedColumn(const BrushingAndLinkingInport* src,
                            const std::unordered_set<size_t>& columnIndices);
     void clearColumns();
 
+    /*
+     * Return the selected indices. The std::unordered_set is only created on demand, prefer
+     * getSelectedBitSet() or isSelected() for large selections.
+     */
     const std::unordered_set<size_t>& getSelectedIndices() const;
+    /*
+     * Return the filtered indices. The std::unordered_set is only created on demand, prefer
+     * getFilteredBitSet() or isFiltered() for large selections.
+     */
     const std::unordered_set<size_t>& getFilteredIndices() const;
     const std::unordered_set<size_t>& getSelectedColumns() const;
 
+    const BitSet& getSelectedBitSet() const;
+    const BitSet& getFilteredBitSet() const;
+
 private:
-    std::unordered_set<size_t> selected_;
+    BitSet selected_;
+    mutable std::optional<std::unordered_set<size_t>> selectedCache_;
     std::unordered_set<size_t> selectedColumns_;
     IndexList filtered_;  // Use IndexList to be able to remove filtered rows on port disconnection
     std::shared_ptr<std::function<void()>> onFilteringChangeCallback_;
@@ -92,7 +108,7 @@ private:
 inline bool BrushingAndLinkingManager::isFiltered(size_t idx) const { return filtered_.has(idx); }
 
 inline bool BrushingAndLinkingManager::isSelected(size_t idx) const {
-    return selected_.find(idx) != selected_.end();
+    return selected_.contains(idx);
 }
 
 }  // namespace inviwo
@@ -0,0 +1,206 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#pragma once
+
+#include <modules/brushingandlinking/brushingandlinkingmoduledefine.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <initializer_list>
+#include <iterator>
+#include <unordered_set>
+#include <vector>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace inviwo {
+
+namespace detail {
+
+inline int countTrailingZeros(std::uint64_t word) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctzll(word);
+#elif defined(_MSC_VER) && defined(_M_X64)
+    unsigned long index;
+    _BitScanForward64(&index, word);
+    return static_cast<int>(index);
+#else
+    int count = 0;
+    while ((word & 1) == 0) {
+        word >>= 1;
+        ++count;
+    }
+    return count;
+#endif
+}
+
+}  // namespace detail
+
+/**
+ * \class BitSet
+ * \brief Compressed set of indices, based on the structure of roaring bitmaps.
+ *
+ * The index space is split into blocks of 2^16 consecutive indices. Each non-empty block is
+ * stored either as a sorted array of 16-bit offsets, if it holds at most 4096 indices, or as a
+ * dense bitmap of 8 kB otherwise. Thus, sparse selections only need two bytes per index while
+ * dense selections need at most one bit per index. Membership tests only require a binary search
+ * among the few blocks followed by a bit test or a short binary search within the block.
+ *
+ * Unions and intersections operate block by block and are much faster than the corresponding
+ * operations on a std::unordered_set.
+ */
+class IVW_MODULE_BRUSHINGANDLINKING_API BitSet {
+public:
+    BitSet() = default;
+    BitSet(std::initializer_list<size_t> indices);
+    explicit BitSet(const std::unordered_set<size_t>& indices);
+    explicit BitSet(const std::vector<size_t>& indices);
+    template <typename InputIt>
+    BitSet(InputIt begin, InputIt end);
+
+    bool contains(size_t idx) const;
+    /**
+     * Return the number of indices in the set
+     */
+    size_t size() const;
+    bool empty() const;
+
+    void add(size_t idx);
+    /**
+     * Add all indices in the range [\p begin, \p end)
+     */
+    void addRange(size_t begin, size_t end);
+    void remove(size_t idx);
+    void clear();
+
+    BitSet& operator|=(const BitSet& rhs);
+    BitSet& operator&=(const BitSet& rhs);
+
+    /**
+     * Call \p callback with each index in the set in ascending order.
+     */
+    template <typename Callback>
+    void forEach(Callback&& callback) const;
+
+    std::vector<size_t> toVector() const;
+    std::unordered_set<size_t> toUnorderedSet() const;
+
+    /**
+     * Return the approximate amount of memory used for storing the indices.
+     */
+    size_t getSizeInBytes() const;
+
+    friend bool IVW_MODULE_BRUSHINGANDLINKING_API operator==(const BitSet& lhs, const BitSet& rhs);
+
+private:
+    static constexpr size_t blockBits = 16;
+    static constexpr size_t blockSize = size_t{1} << blockBits;
+    static constexpr size_t blockMask = blockSize - 1;
+    static constexpr size_t bitmapWords = blockSize / 64;
+    static constexpr size_t maxArraySize = 4096;
+
+    struct Block {
+        bool isBitmap() const { return !bitmap.empty(); }
+        bool contains(std::uint16_t offset) const;
+        bool add(std::uint16_t offset);
+        bool remove(std::uint16_t offset);
+        void toBitmap();
+        void toArray();
+        /**
+         * Switch between array and bitmap storage depending on the cardinality
+         */
+        void optimize();
+
+        std::vector<std::uint16_t> array;  //!< sorted offsets, used if bitmap is empty
+        std::vector<std::uint64_t> bitmap;
+        size_t cardinality = 0;
+    };
+
+    void buildFromSorted(const std::vector<size_t>& sorted);
+    Block& getOrCreateBlock(size_t key);
+    static void unite(Block& dst, const Block& src);
+    static void intersect(Block& dst, const Block& src);
+
+    std::vector<size_t> keys_;  //!< sorted block keys, i.e. index >> blockBits
+    std::vector<Block> blocks_;
+};
+
+IVW_MODULE_BRUSHINGANDLINKING_API bool operator!=(const BitSet& lhs, const BitSet& rhs);
+IVW_MODULE_BRUSHINGANDLINKING_API BitSet operator|(BitSet lhs, const BitSet& rhs);
+IVW_MODULE_BRUSHINGANDLINKING_API BitSet operator&(BitSet lhs, const BitSet& rhs);
+
+template <typename InputIt>
+BitSet::BitSet(InputIt begin, InputIt end) {
+    std::vector<size_t> sorted(begin, end);
+    std::sort(sorted.begin(), sorted.end());
+    sorted.erase(std::unique(sorted.begin(), sorted.end()), sorted.end());
+    buildFromSorted(sorted);
+}
+
+inline bool BitSet::Block::contains(std::uint16_t offset) const {
+    if (isBitmap()) {
+        return (bitmap[offset >> 6] >> (offset & 63)) & 1;
+    } else {
+        return std::binary_search(array.begin(), array.end(), offset);
+    }
+}
+
+inline bool BitSet::contains(size_t idx) const {
+    const size_t key = idx >> blockBits;
+    auto it = std::lower_bound(keys_.begin(), keys_.end(), key);
+    if (it == keys_.end() || *it != key) return false;
+    return blocks_[std::distance(keys_.begin(), it)].contains(
+        static_cast<std::uint16_t>(idx & blockMask));
+}
+
+template <typename Callback>
+void BitSet::forEach(Callback&& callback) const {
+    for (size_t i = 0; i < keys_.size(); ++i) {
+        const size_t base = keys_[i] << blockBits;
+        const auto& block = blocks_[i];
+        if (block.isBitmap()) {
+            for (size_t w = 0; w < block.bitmap.size(); ++w) {
+                auto word = block.bitmap[w];
+                while (word != 0) {
+                    callback(base + w * 64 + detail::countTrailingZeros(word));
+                    word &= word - 1;
+                }
+            }
+        } else {
+            for (auto offset : block.array) {
+                callback(base + offset);
+            }
+        }
+    }
+}
+
+}  // namespace inviwo
@@ -30,8 +30,10 @@
 #pragma once
 
 #include <modules/brushingandlinking/brushingandlinkingmoduledefine.h>
+#include <modules/brushingandlinking/datastructures/bitset.h>
 #include <inviwo/core/util/dispatcher.h>
 
+#include <optional>
 #include <unordered_map>
 #include <unordered_set>
 
@@ -39,6 +41,12 @@ namespace inviwo {
 class BrushingAndLinkingInport;
 class BrushingAndLinkingManager;
 
+/**
+ * \class IndexList
+ * \brief Keeps track of indices from multiple sources and provides their union.
+ *
+ * The indices of each source as well as their union are stored in a compressed BitSet.
+ */
 class IVW_MODULE_BRUSHINGANDLINKING_API IndexList {
 public:
     IndexList() = default;
@@ -47,21 +55,27 @@ public:
     bool has(size_t idx) const;
 
     void set(const BrushingAndLinkingInport* src, const std::unordered_set<size_t>& incices);
+    void set(const BrushingAndLinkingInport* src, BitSet indices);
     void remove(const BrushingAndLinkingInport* src);
 
     std::shared_ptr<std::function<void()>> onChange(std::function<void()> V);
 
     void update();
     void clear();
-    const std::unordered_set<size_t>& getIndices() const { return indices_; }
+    /**
+     * Return the union of all indices. The std::unordered_set is only created on demand, prefer
+     * getBitSet() or has() for large index lists.
+     */
+    const std::unordered_set<size_t>& getIndices() const;
+    const BitSet& getBitSet() const { return indices_; }
 
 private:
-    std::unordered_map<const BrushingAndLinkingInport*, std::unordered_set<size_t>>
-        indicesBySource_;
-    std::unordered_set<size_t> indices_;
+    std::unordered_map<const BrushingAndLinkingInport*, BitSet> indicesBySource_;
+    BitSet indices_;
+    mutable std::optional<std::unordered_set<size_t>> indicesCache_;
     Dispatcher<void()> onUpdate_;
 };
 
-inline bool IndexList::has(size_t idx) const { return indices_.find(idx) != indices_.end(); }
+inline bool IndexList::has(size_t idx) const { return indices_.contains(idx); }
 
 }  // namespace inviwo
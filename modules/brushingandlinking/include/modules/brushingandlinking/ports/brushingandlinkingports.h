@@ -64,6 +64,9 @@ public:
     const std::unordered_set<size_t>& getFilteredIndices() const;
     const std::unordered_set<size_t>& getSelectedColumns() const;
 
+    size_t getNumberOfSelected() const;
+    size_t getNumberOfFiltered() const;
+
     virtual std::string getClassIdentifier() const override;
 
     std::unordered_set<size_t> filterCache_;
@@ -60,14 +60,20 @@ bool BrushingAndLinkingManager::isColumnSelected(size_t idx) const {
     return selectedColumns_.find(idx) != selectedColumns_.end();
 }
 
-void BrushingAndLinkingManager::setSelected(const BrushingAndLinkingInport*,
+void BrushingAndLinkingManager::setSelected(const BrushingAndLinkingInport* src,
                                             const std::unordered_set<size_t>& indices) {
-    selected_ = indices;
+    setSelected(src, BitSet(indices));
+}
+
+void BrushingAndLinkingManager::setSelected(const BrushingAndLinkingInport*, BitSet indices) {
+    selected_ = std::move(indices);
+    selectedCache_.reset();
     owner_->invalidate(invalidationLevel_);
 }
 
 void BrushingAndLinkingManager::clearSelected() {
     selected_.clear();
+    selectedCache_.reset();
     owner_->invalidate(invalidationLevel_);
 }
 
@@ -76,6 +82,11 @@ void BrushingAndLinkingManager::setFiltered(const BrushingAndLinkingInport* src,
     filtered_.set(src, indices);
 }
 
+void BrushingAndLinkingManager::setFiltered(const BrushingAndLinkingInport* src,
+                                            BitSet indices) {
+    filtered_.set(src, std::move(indices));
+}
+
 void BrushingAndLinkingManager::clearFiltered() { filtered_.clear(); }
 
 void BrushingAndLinkingManager::setSelectedColumn(const BrushingAndLinkingInport*,
@@ -86,11 +97,15 @@ void BrushingAndLinkingManager::setSelectedColumn(const BrushingAndLinkingInport
 
 void BrushingAndLinkingManager::clearColumns() {
     selected_.clear();
+    selectedCache_.reset();
     owner_->invalidate(invalidationLevel_);
 }
 
 const std::unordered_set<size_t>& BrushingAndLinkingManager::getSelectedIndices() const {
-    return selected_;
+    if (!selectedCache_) {
+        selectedCache_ = selected_.toUnorderedSet();
+    }
+    return *selectedCache_;
 }
 
 const std::unordered_set<size_t>& BrushingAndLinkingManager::getFilteredIndices() const {
@@ -101,4 +116,10 @@ const std::unordered_set<size_t>& BrushingAndLinkingManager::getSelectedColumns(
     return selectedColumns_;
 }
 
+const BitSet& BrushingAndLinkingManager::getSelectedBitSet() const { return selected_; }
+
+const BitSet& BrushingAndLinkingManager::getFilteredBitSet() const {
+    return filtered_.getBitSet();
+}
+
 }  // namespace inviwo
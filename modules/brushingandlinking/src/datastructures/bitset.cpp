@@ -0,0 +1,365 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <modules/brushingandlinking/datastructures/bitset.h>
+
+#include <limits>
+#include <numeric>
+
+namespace inviwo {
+
+namespace {
+
+size_t popcount(std::uint64_t word) {
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<size_t>(__builtin_popcountll(word));
+#elif defined(_MSC_VER) && defined(_M_X64)
+    return static_cast<size_t>(__popcnt64(word));
+#else
+    word = word - ((word >> 1) & 0x5555555555555555ull);
+    word = (word & 0x3333333333333333ull) + ((word >> 2) & 0x3333333333333333ull);
+    word = (word + (word >> 4)) & 0x0f0f0f0f0f0f0f0full;
+    return static_cast<size_t>((word * 0x0101010101010101ull) >> 56);
+#endif
+}
+
+size_t popcount(const std::vector<std::uint64_t>& words) {
+    return std::accumulate(words.begin(), words.end(), size_t{0},
+                           [](size_t sum, std::uint64_t word) { return sum + popcount(word); });
+}
+
+}  // namespace
+
+BitSet::BitSet(std::initializer_list<size_t> indices) : BitSet(indices.begin(), indices.end()) {}
+
+BitSet::BitSet(const std::unordered_set<size_t>& indices)
+    : BitSet(indices.begin(), indices.end()) {}
+
+BitSet::BitSet(const std::vector<size_t>& indices) : BitSet(indices.begin(), indices.end()) {}
+
+void BitSet::buildFromSorted(const std::vector<size_t>& sorted) {
+    keys_.clear();
+    blocks_.clear();
+    auto it = sorted.begin();
+    while (it != sorted.end()) {
+        const size_t key = *it >> blockBits;
+        // find the first index belonging to the next block
+        auto blockEnd = std::lower_bound(it, sorted.end(), (key + 1) << blockBits);
+        if (key == (std::numeric_limits<size_t>::max() >> blockBits)) blockEnd = sorted.end();
+
+        Block block;
+        block.array.reserve(std::distance(it, blockEnd));
+        for (; it != blockEnd; ++it) {
+            block.array.push_back(static_cast<std::uint16_t>(*it & blockMask));
+        }
+        block.cardinality = block.array.size();
+        block.optimize();
+
+        keys_.push_back(key);
+        blocks_.push_back(std::move(block));
+    }
+}
+
+size_t BitSet::size() const {
+    return std::accumulate(blocks_.begin(), blocks_.end(), size_t{0},
+                           [](size_t sum, const Block& block) { return sum + block.cardinality; });
+}
+
+bool BitSet::empty() const { return blocks_.empty(); }
+
+BitSet::Block& BitSet::getOrCreateBlock(size_t key) {
+    auto it = std::lower_bound(keys_.begin(), keys_.end(), key);
+    const auto pos = std::distance(keys_.begin(), it);
+    if (it == keys_.end() || *it != key) {
+        keys_.insert(it, key);
+        blocks_.insert(blocks_.begin() + pos, Block{});
+    }
+    return blocks_[pos];
+}
+
+void BitSet::add(size_t idx) {
+    getOrCreateBlock(idx >> blockBits).add(static_cast<std::uint16_t>(idx & blockMask));
+}
+
+void BitSet::addRange(size_t begin, size_t end) {
+    while (begin < end) {
+        const size_t key = begin >> blockBits;
+        const size_t first = begin & blockMask;
+        const size_t last = std::min(end - (key << blockBits), blockSize);  // exclusive
+
+        auto& block = getOrCreateBlock(key);
+        block.toBitmap();
+        for (size_t i = first; i < last;) {
+            const size_t word = i >> 6;
+            const size_t bit = i & 63;
+            const size_t count = std::min(64 - bit, last - i);
+            const std::uint64_t mask =
+                (count == 64 ? ~std::uint64_t{0} : ((std::uint64_t{1} << count) - 1)) << bit;
+            block.bitmap[word] |= mask;
+            i += count;
+        }
+        block.cardinality = popcount(block.bitmap);
+        block.optimize();
+
+        if (key == (std::numeric_limits<size_t>::max() >> blockBits)) break;  // avoid overflow
+        begin = (key + 1) << blockBits;
+    }
+}
+
+void BitSet::remove(size_t idx) {
+    const size_t key = idx >> blockBits;
+    auto it = std::lower_bound(keys_.begin(), keys_.end(), key);
+    if (it == keys_.end() || *it != key) return;
+    const auto pos = std::distance(keys_.begin(), it);
+    auto& block = blocks_[pos];
+    if (block.remove(static_cast<std::uint16_t>(idx & blockMask)) && block.cardinality == 0) {
+        keys_.erase(it);
+        blocks_.erase(blocks_.begin() + pos);
+    }
+}
+
+void BitSet::clear() {
+    keys_.clear();
+    blocks_.clear();
+}
+
+BitSet& BitSet::operator|=(const BitSet& rhs) {
+    if (this == &rhs || rhs.empty()) return *this;
+
+    std::vector<size_t> keys;
+    std::vector<Block> blocks;
+    keys.reserve(keys_.size() + rhs.keys_.size());
+    blocks.reserve(keys_.size() + rhs.keys_.size());
+
+    size_t i = 0;
+    size_t j = 0;
+    while (i < keys_.size() || j < rhs.keys_.size()) {
+        if (j == rhs.keys_.size() || (i < keys_.size() && keys_[i] < rhs.keys_[j])) {
+            keys.push_back(keys_[i]);
+            blocks.push_back(std::move(blocks_[i]));
+            ++i;
+        } else if (i == keys_.size() || rhs.keys_[j] < keys_[i]) {
+            keys.push_back(rhs.keys_[j]);
+            blocks.push_back(rhs.blocks_[j]);
+            ++j;
+        } else {
+            unite(blocks_[i], rhs.blocks_[j]);
+            keys.push_back(keys_[i]);
+            blocks.push_back(std::move(blocks_[i]));
+            ++i;
+            ++j;
+        }
+    }
+    keys_ = std::move(keys);
+    blocks_ = std::move(blocks);
+    return *this;
+}
+
+BitSet& BitSet::operator&=(const BitSet& rhs) {
+    if (this == &rhs) return *this;
+
+    size_t dst = 0;
+    size_t j = 0;
+    for (size_t i = 0; i < keys_.size(); ++i) {
+        while (j < rhs.keys_.size() && rhs.keys_[j] < keys_[i]) ++j;
+        if (j == rhs.keys_.size()) break;
+        if (rhs.keys_[j] != keys_[i]) continue;
+
+        intersect(blocks_[i], rhs.blocks_[j]);
+        if (blocks_[i].cardinality > 0) {
+            keys_[dst] = keys_[i];
+            if (dst != i) blocks_[dst] = std::move(blocks_[i]);
+            ++dst;
+        }
+    }
+    keys_.resize(dst);
+    blocks_.resize(dst);
+    return *this;
+}
+
+void BitSet::unite(Block& dst, const Block& src) {
+    if (!dst.isBitmap() && !src.isBitmap()) {
+        std::vector<std::uint16_t> merged;
+        merged.reserve(dst.array.size() + src.array.size());
+        std::set_union(dst.array.begin(), dst.array.end(), src.array.begin(), src.array.end(),
+                       std::back_inserter(merged));
+        dst.array = std::move(merged);
+        dst.cardinality = dst.array.size();
+    } else {
+        dst.toBitmap();
+        if (src.isBitmap()) {
+            for (size_t w = 0; w < bitmapWords; ++w) {
+                dst.bitmap[w] |= src.bitmap[w];
+            }
+        } else {
+            for (auto offset : src.array) {
+                dst.bitmap[offset >> 6] |= std::uint64_t{1} << (offset & 63);
+            }
+        }
+        dst.cardinality = popcount(dst.bitmap);
+    }
+    dst.optimize();
+}
+
+void BitSet::intersect(Block& dst, const Block& src) {
+    if (dst.isBitmap() && src.isBitmap()) {
+        for (size_t w = 0; w < bitmapWords; ++w) {
+            dst.bitmap[w] &= src.bitmap[w];
+        }
+        dst.cardinality = popcount(dst.bitmap);
+    } else if (dst.isBitmap()) {
+        std::vector<std::uint16_t> result;
+        std::copy_if(src.array.begin(), src.array.end(), std::back_inserter(result),
+                     [&](std::uint16_t offset) { return dst.contains(offset); });
+        dst.bitmap.clear();
+        dst.array = std::move(result);
+        dst.cardinality = dst.array.size();
+    } else {
+        auto end = std::remove_if(dst.array.begin(), dst.array.end(),
+                                  [&](std::uint16_t offset) { return !src.contains(offset); });
+        dst.array.erase(end, dst.array.end());
+        dst.cardinality = dst.array.size();
+    }
+    dst.optimize();
+}
+
+std::vector<size_t> BitSet::toVector() const {
+    std::vector<size_t> result;
+    result.reserve(size());
+    forEach([&](size_t idx) { result.push_back(idx); });
+    return result;
+}
+
+std::unordered_set<size_t> BitSet::toUnorderedSet() const {
+    std::unordered_set<size_t> result;
+    result.reserve(size());
+    forEach([&](size_t idx) { result.insert(idx); });
+    return result;
+}
+
+size_t BitSet::getSizeInBytes() const {
+    return std::accumulate(blocks_.begin(), blocks_.end(),
+                           keys_.capacity() * sizeof(size_t) + blocks_.capacity() * sizeof(Block),
+                           [](size_t sum, const Block& block) {
+                               return sum + block.array.capacity() * sizeof(std::uint16_t) +
+                                      block.bitmap.capacity() * sizeof(std::uint64_t);
+                           });
+}
+
+bool operator==(const BitSet& lhs, const BitSet& rhs) {
+    if (lhs.keys_ != rhs.keys_) return false;
+    for (size_t i = 0; i < lhs.blocks_.size(); ++i) {
+        const auto& a = lhs.blocks_[i];
+        const auto& b = rhs.blocks_[i];
+        // blocks are always stored in their optimal representation
+        if (a.cardinality != b.cardinality || a.array != b.array || a.bitmap != b.bitmap) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool operator!=(const BitSet& lhs, const BitSet& rhs) { return !(lhs == rhs); }
+
+BitSet operator|(BitSet lhs, const BitSet& rhs) {
+    lhs |= rhs;
+    return lhs;
+}
+
+BitSet operator&(BitSet lhs, const BitSet& rhs) {
+    lhs &= rhs;
+    return lhs;
+}
+
+bool BitSet::Block::add(std::uint16_t offset) {
+    if (isBitmap()) {
+        auto& word = bitmap[offset >> 6];
+        const auto mask = std::uint64_t{1} << (offset & 63);
+        if (word & mask) return false;
+        word |= mask;
+    } else {
+        auto it = std::lower_bound(array.begin(), array.end(), offset);
+        if (it != array.end() && *it == offset) return false;
+        array.insert(it, offset);
+    }
+    ++cardinality;
+    optimize();
+    return true;
+}
+
+bool BitSet::Block::remove(std::uint16_t offset) {
+    if (isBitmap()) {
+        auto& word = bitmap[offset >> 6];
+        const auto mask = std::uint64_t{1} << (offset & 63);
+        if ((word & mask) == 0) return false;
+        word &= ~mask;
+    } else {
+        auto it = std::lower_bound(array.begin(), array.end(), offset);
+        if (it == array.end() || *it != offset) return false;
+        array.erase(it);
+    }
+    --cardinality;
+    optimize();
+    return true;
+}
+
+void BitSet::Block::toBitmap() {
+    if (isBitmap()) return;
+    bitmap.assign(bitmapWords, 0);
+    for (auto offset : array) {
+        bitmap[offset >> 6] |= std::uint64_t{1} << (offset & 63);
+    }
+    array.clear();
+    array.shrink_to_fit();
+}
+
+void BitSet::Block::toArray() {
+    if (!isBitmap()) return;
+    array.clear();
+    array.reserve(cardinality);
+    for (size_t w = 0; w < bitmap.size(); ++w) {
+        auto word = bitmap[w];
+        while (word != 0) {
+            array.push_back(static_cast<std::uint16_t>(w * 64 + detail::countTrailingZeros(word)));
+            word &= word - 1;
+        }
+    }
+    bitmap.clear();
+    bitmap.shrink_to_fit();
+}
+
+void BitSet::Block::optimize() {
+    if (isBitmap() && cardinality <= maxArraySize) {
+        toArray();
+    } else if (!isBitmap() && cardinality > maxArraySize) {
+        toBitmap();
+    }
+}
+
+}  // namespace inviwo
@@ -36,7 +36,11 @@ size_t IndexList::getSize() const { return indices_.size(); }
 
 void IndexList::set(const BrushingAndLinkingInport* src,
                     const std::unordered_set<size_t>& indices) {
-    indicesBySource_[src] = indices;
+    set(src, BitSet(indices));
+}
+
+void IndexList::set(const BrushingAndLinkingInport* src, BitSet indices) {
+    indicesBySource_[src] = std::move(indices);
     update();
 }
 
@@ -51,24 +55,32 @@ std::shared_ptr<std::function<void()>> IndexList::onChange(std::function<void()>
 
 void IndexList::update() {
     indices_.clear();
+    indicesCache_.reset();
 
-    using T =
-        std::unordered_map<const BrushingAndLinkingInport*, std::unordered_set<size_t>>::value_type;
+    using T = std::unordered_map<const BrushingAndLinkingInport*, BitSet>::value_type;
     util::map_erase_remove_if(indicesBySource_, [](const T& p) {
         return !p.first->isConnected() ||
                p.second.empty();  // remove if port is disconnected or if the set is empty
     });
 
-    for (auto p : indicesBySource_) {
-        indices_.insert(p.second.begin(), p.second.end());
+    for (const auto& p : indicesBySource_) {
+        indices_ |= p.second;
     }
     onUpdate_.invoke();
 }
 
 void IndexList::clear() {
     indices_.clear();
+    indicesCache_.reset();
     indicesBySource_.clear();
     onUpdate_.invoke();
 }
 
+const std::unordered_set<size_t>& IndexList::getIndices() const {
+    if (!indicesCache_) {
+        indicesCache_ = indices_.toUnorderedSet();
+    }
+    return *indicesCache_;
+}
+
 }  // namespace inviwo
@@ -51,7 +51,7 @@ void BrushingAndLinkingInport::sendFilterEvent(const std::unordered_set<size_t>&
 void BrushingAndLinkingInport::sendSelectionEvent(const std::unordered_set<size_t>& indices) {
     bool noRemoteSelections = false;
     if (isConnected() && hasData()) {
-        noRemoteSelections = getData()->getSelectedIndices().empty();
+        noRemoteSelections = getData()->getSelectedBitSet().empty();
     }
     if (selectionCache_.empty() && indices.empty() && noRemoteSelections) {
         return;
@@ -106,6 +106,22 @@ const std::unordered_set<size_t>& BrushingAndLinkingInport::getSelectedColumns()
     }
 }
 
+size_t BrushingAndLinkingInport::getNumberOfSelected() const {
+    if (isConnected()) {
+        return getData()->getNumberOfSelected();
+    } else {
+        return selectionCache_.size();
+    }
+}
+
+size_t BrushingAndLinkingInport::getNumberOfFiltered() const {
+    if (isConnected()) {
+        return getData()->getNumberOfFiltered();
+    } else {
+        return filterCache_.size();
+    }
+}
+
 std::string BrushingAndLinkingInport::getClassIdentifier() const {
     return PortTraits<BrushingAndLinkingInport>::classIdentifier();
 }
@@ -0,0 +1,145 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <warn/push>
+#include <warn/ignore/all>
+#include <gtest/gtest.h>
+#include <warn/pop>
+
+#include <modules/brushingandlinking/datastructures/bitset.h>
+
+#include <algorithm>
+#include <iterator>
+#include <random>
+#include <set>
+
+namespace inviwo {
+
+namespace {
+
+std::vector<size_t> toVector(const std::set<size_t>& set) { return {set.begin(), set.end()}; }
+
+}  // namespace
+
+TEST(BitSet, Empty) {
+    BitSet bitset;
+    EXPECT_TRUE(bitset.empty());
+    EXPECT_EQ(0, bitset.size());
+    EXPECT_FALSE(bitset.contains(0));
+    EXPECT_TRUE(bitset.toVector().empty());
+}
+
+TEST(BitSet, AddRemove) {
+    BitSet bitset{5, 1, 70000, 5};
+    EXPECT_EQ(3, bitset.size());
+    EXPECT_TRUE(bitset.contains(1));
+    EXPECT_TRUE(bitset.contains(5));
+    EXPECT_TRUE(bitset.contains(70000));
+    EXPECT_FALSE(bitset.contains(2));
+    EXPECT_FALSE(bitset.contains(70001));
+    EXPECT_EQ((std::vector<size_t>{1, 5, 70000}), bitset.toVector());
+
+    bitset.remove(5);
+    bitset.remove(6);
+    bitset.add(3);
+    EXPECT_EQ((std::vector<size_t>{1, 3, 70000}), bitset.toVector());
+
+    bitset.clear();
+    EXPECT_TRUE(bitset.empty());
+}
+
+TEST(BitSet, Range) {
+    BitSet bitset;
+    bitset.addRange(10, 200000);
+    EXPECT_EQ(199990, bitset.size());
+    EXPECT_FALSE(bitset.contains(9));
+    EXPECT_TRUE(bitset.contains(10));
+    EXPECT_TRUE(bitset.contains(65536));
+    EXPECT_TRUE(bitset.contains(199999));
+    EXPECT_FALSE(bitset.contains(200000));
+
+    // dense blocks use one bit per index, i.e. four blocks of 8 kB
+    EXPECT_LT(bitset.getSizeInBytes(), 4 * 8192 + 1024);
+
+    for (size_t i = 10; i < 200000; i += 2) {
+        bitset.remove(i);
+    }
+    EXPECT_EQ(99995, bitset.size());
+    EXPECT_TRUE(bitset.contains(11));
+    EXPECT_FALSE(bitset.contains(12));
+}
+
+TEST(BitSet, UnorderedSetConversion) {
+    const std::unordered_set<size_t> indices{3, 1, 4, 159, 26535, 8979323846};
+    BitSet bitset(indices);
+    EXPECT_EQ(indices.size(), bitset.size());
+    EXPECT_EQ(indices, bitset.toUnorderedSet());
+}
+
+TEST(BitSet, SetOperations) {
+    std::mt19937 rng(42);
+    for (size_t range : {size_t{20000}, size_t{300000}}) {
+        std::set<size_t> refA;
+        std::set<size_t> refB;
+        BitSet a;
+        std::vector<size_t> b;
+        for (int i = 0; i < 50000; ++i) {
+            const size_t idxA = rng() % range;
+            refA.insert(idxA);
+            a.add(idxA);
+            const size_t idxB = rng() % (range / 2);
+            refB.insert(idxB);
+            b.push_back(idxB);
+        }
+        const BitSet bitsetB(b);
+
+        EXPECT_EQ(toVector(refA), a.toVector());
+        EXPECT_EQ(toVector(refB), bitsetB.toVector());
+
+        std::set<size_t> refUnion;
+        std::set_union(refA.begin(), refA.end(), refB.begin(), refB.end(),
+                       std::inserter(refUnion, refUnion.end()));
+        const auto unionSet = a | bitsetB;
+        EXPECT_EQ(toVector(refUnion), unionSet.toVector());
+        EXPECT_EQ(BitSet(toVector(refUnion)), unionSet);
+
+        std::set<size_t> refIntersection;
+        std::set_intersection(refA.begin(), refA.end(), refB.begin(), refB.end(),
+                              std::inserter(refIntersection, refIntersection.end()));
+        const auto intersection = a & bitsetB;
+        EXPECT_EQ(toVector(refIntersection), intersection.toVector());
+        EXPECT_EQ(BitSet(toVector(refIntersection)), intersection);
+
+        for (size_t i = 0; i < range; i += 7) {
+            EXPECT_EQ(refUnion.count(i) > 0, unionSet.contains(i));
+        }
+    }
+}
+
+}  // namespace inviwo
@@ -0,0 +1,109 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <warn/push>
+#include <warn/ignore/all>
+#include <gtest/gtest.h>
+#include <warn/pop>
+
+#include <modules/brushingandlinking/brushingandlinkingmanager.h>
+#include <modules/brushingandlinking/ports/brushingandlinkingports.h>
+#include <inviwo/core/processors/processor.h>
+
+namespace inviwo {
+
+namespace {
+
+struct TestProcessor : Processor {
+    inline static const ProcessorInfo processorInfo_{
+        "org.inviwo.brushingandlinking.TestProcessor",  // Class identifier
+        "TestProcessor",                                // Display name
+        "Test",                                         // Category
+        CodeState::Stable,                              // Code state
+        Tags::CPU,                                      // Tags
+    };
+
+    virtual const ProcessorInfo getProcessorInfo() const override { return processorInfo_; }
+
+    TestProcessor() : Processor{"test", "Test"} { addPort(outport); }
+
+    BrushingAndLinkingOutport outport{"outport"};
+};
+
+}  // namespace
+
+TEST(BrushingAndLinkingManager, SetSelected) {
+    TestProcessor processor;
+    BrushingAndLinkingManager manager(&processor);
+    BrushingAndLinkingInport inport("inport");
+
+    manager.setSelected(&inport, BitSet{1, 5, 70000});
+    EXPECT_EQ(3, manager.getNumberOfSelected());
+    EXPECT_TRUE(manager.isSelected(5));
+    EXPECT_TRUE(manager.isSelected(70000));
+    EXPECT_FALSE(manager.isSelected(2));
+    EXPECT_EQ((std::unordered_set<size_t>{1, 5, 70000}), manager.getSelectedIndices());
+
+    manager.setSelected(&inport, std::unordered_set<size_t>{2});
+    EXPECT_EQ(BitSet{2}, manager.getSelectedBitSet());
+    EXPECT_EQ((std::unordered_set<size_t>{2}), manager.getSelectedIndices());
+
+    manager.clearSelected();
+    EXPECT_EQ(0, manager.getNumberOfSelected());
+}
+
+TEST(BrushingAndLinkingManager, SetFiltered) {
+    TestProcessor processor;
+    BrushingAndLinkingManager manager(&processor);
+    BrushingAndLinkingInport inport1("inport1");
+    BrushingAndLinkingInport inport2("inport2");
+    inport1.connectTo(&processor.outport);
+    inport2.connectTo(&processor.outport);
+
+    // the filtered indices are the union over all sources
+    manager.setFiltered(&inport1, BitSet{1, 5});
+    manager.setFiltered(&inport2, std::unordered_set<size_t>{5, 70000});
+    EXPECT_EQ(3, manager.getNumberOfFiltered());
+    EXPECT_EQ((BitSet{1, 5, 70000}), manager.getFilteredBitSet());
+    EXPECT_EQ((std::unordered_set<size_t>{1, 5, 70000}), manager.getFilteredIndices());
+
+    manager.setFiltered(&inport1, BitSet{});
+    EXPECT_EQ((BitSet{5, 70000}), manager.getFilteredBitSet());
+    EXPECT_FALSE(manager.isFiltered(1));
+
+    // disconnected sources are dropped
+    manager.setFiltered(&inport1, BitSet{3});
+    inport1.disconnectFrom(&processor.outport);
+    EXPECT_EQ((BitSet{5, 70000}), manager.getFilteredBitSet());
+
+    inport2.disconnectFrom(&processor.outport);
+    EXPECT_EQ(0, manager.getNumberOfFiltered());
+}
+
+}  // namespace inviwo
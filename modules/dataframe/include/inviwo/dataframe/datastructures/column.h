@@ -234,6 +234,16 @@ public:
      */
     void append(const std::vector<std::string>& data);
 
+    /**
+     * \brief append dictionary-encoded categorical values. Each entry in \p ids refers to the
+     * category at the same position in \p categories. Categories not yet present in the column
+     * are added.
+     *
+     * @param ids          indices into \p categories
+     * @param categories   categorical values referred to by \p ids
+     */
+    void append(const std::vector<std::uint32_t>& ids, const std::vector<std::string>& categories);
+
     /**
      * Returns the unique set of categorical values.
      */
@@ -37,6 +37,8 @@
 #include <inviwo/core/io/datareaderexception.h>
 #include <inviwo/dataframe/datastructures/dataframe.h>
 
+#include <string_view>
+
 namespace inviwo {
 
 /**
@@ -59,6 +61,10 @@ public:
  * \brief A reader for comma separated value (CSV) files with customizable delimiters.
  * The default delimiter is ',' and headers are included. Floating point values are stored as
  * float32.
+ *
+ * Files are memory mapped instead of being copied into a stream. After the column types have
+ * been determined from the first rows, large inputs are split into ranges of complete rows
+ * which are parsed concurrently on the application thread pool.
  */
 class IVW_MODULE_DATAFRAME_API CSVReader : public DataReaderType<DataFrame> {
 public:
@@ -105,6 +111,8 @@ public:
     std::shared_ptr<DataFrame> readData(std::istream& stream) const;
 
 private:
+    std::shared_ptr<DataFrame> parse(std::string_view data) const;
+
     std::string delimiters_;
     bool firstRowHeader_;
     bool doublePrecision_;
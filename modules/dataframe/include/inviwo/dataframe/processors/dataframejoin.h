@@ -37,6 +37,7 @@
 
 #include <inviwo/dataframe/datastructures/dataframe.h>
 #include <inviwo/dataframe/properties/dataframeproperty.h>
+#include <inviwo/dataframe/util/dataframeutil.h>
 
 namespace inviwo {
 
@@ -58,6 +59,7 @@ namespace inviwo {
  *
  * ### Properties
  *   * __join__   type of join
+ *   * __algorithm__   algorithm used for matching rows in inner and outer left joins
  */
 class IVW_MODULE_DATAFRAME_API DataFrameJoin : public Processor, public PropertyOwnerObserver {
 public:
@@ -86,6 +88,7 @@ private:
     DataFrameOutport outport_;
 
     TemplateOptionProperty<JoinType> join_;
+    TemplateOptionProperty<dataframe::JoinAlgorithm> algorithm_;
     BoolProperty ignoreDuplicateCols_;
     BoolProperty fillMissingRows_;
     TemplateOptionProperty<ColumnMatch> columnMatching_;
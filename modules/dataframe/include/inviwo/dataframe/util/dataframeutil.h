@@ -76,23 +76,36 @@ std::shared_ptr<DataFrame> IVW_MODULE_DATAFRAME_API appendColumns(const DataFram
 std::shared_ptr<DataFrame> IVW_MODULE_DATAFRAME_API appendRows(const DataFrame& top,
                                                                const DataFrame& bottom,
                                                                bool matchByName = false);
+/**
+ * \brief Algorithm used for finding matching rows in innerJoin and leftJoin
+ */
+enum class JoinAlgorithm {
+    Hash,      ///< Build a hash index over the key columns of the right DataFrame and probe it
+    SortMerge  ///< Sort the rows of both DataFrames by their keys and merge the sorted lists
+};
+
 ///@{
 /**
  * \brief create a new DataFrame by using an inner join of DataFrame \p left and DataFrame \p right.
  * That is only rows with matching keys are kept.
  *
- * It is assumed that the entries in the key columns are unique. Otherwise results are undefined.
+ * It is assumed that the entries in the key columns are unique. Otherwise only the first
+ * matching row of \p right is used. Key columns have to be scalar and categorical columns are
+ * matched by their categories.
  * @param left
  * @param right
  * @param keyColumn   header of the column used as key for the join operation (default: index
  * column)
+ * @param algorithm   algorithm used for matching the rows
  * @return inner join of \p left and \p right DataFrame
  * @throws Exception if keyColumn does not exist in either \p left or \p right
  */
 std::shared_ptr<DataFrame> IVW_MODULE_DATAFRAME_API
-innerJoin(const DataFrame& left, const DataFrame& right, const std::string& keyColumn = "index");
-std::shared_ptr<DataFrame> IVW_MODULE_DATAFRAME_API innerJoin(
-    const DataFrame& left, const DataFrame& right, const std::vector<std::string>& keyColumns);
+innerJoin(const DataFrame& left, const DataFrame& right, const std::string& keyColumn = "index",
+          JoinAlgorithm algorithm = JoinAlgorithm::Hash);
+std::shared_ptr<DataFrame> IVW_MODULE_DATAFRAME_API
+innerJoin(const DataFrame& left, const DataFrame& right, const std::vector<std::string>& keyColumns,
+          JoinAlgorithm algorithm = JoinAlgorithm::Hash);
 ///@}
 
 ///@{
@@ -100,20 +113,24 @@ std::shared_ptr<DataFrame> IVW_MODULE_DATAFRAME_API innerJoin(
  * \brief create a new DataFrame by using an outer left join of DataFrame \p left and DataFrame \p
  * right. That is all rows of \p left are augmented with matching rows from \p right.
  *
- * It is assumed that the entries in the key columns of \p right are unique. Otherwise results are
- * undefined.
+ * It is assumed that the entries in the key columns of \p right are unique. Otherwise only the
+ * first matching row of \p right is used. Key columns have to be scalar and categorical columns
+ * are matched by their categories.
  *
  * @param left
  * @param right
  * @param keyColumn   header of the column used as key for the join operation (default: index
  * column)
+ * @param algorithm   algorithm used for matching the rows
  * @return left join of \p left and \p right DataFrame
  * @throws Exception if keyColumn does not exist in either \p left or \p right
  */
 std::shared_ptr<DataFrame> IVW_MODULE_DATAFRAME_API
-leftJoin(const DataFrame& left, const DataFrame& right, const std::string& keyColumn = "index");
+leftJoin(const DataFrame& left, const DataFrame& right, const std::string& keyColumn = "index",
+         JoinAlgorithm algorithm = JoinAlgorithm::Hash);
 std::shared_ptr<DataFrame> IVW_MODULE_DATAFRAME_API
-leftJoin(const DataFrame& left, const DataFrame& right, const std::vector<std::string>& keyColumns);
+leftJoin(const DataFrame& left, const DataFrame& right, const std::vector<std::string>& keyColumns,
+         JoinAlgorithm algorithm = JoinAlgorithm::Hash);
 ///@}
 
 std::shared_ptr<DataFrame> IVW_MODULE_DATAFRAME_API
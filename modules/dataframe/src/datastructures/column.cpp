@@ -33,6 +33,7 @@
 #include <inviwo/core/util/stdextensions.h>
 
 #include <unordered_map>
+#include <string_view>
 
 namespace inviwo {
 
@@ -124,6 +125,33 @@ void CategoricalColumn::append(const std::vector<std::string>& data) {
     buffer_->getEditableRAMRepresentation()->append(helper.data);
 }
 
+void CategoricalColumn::append(const std::vector<std::uint32_t>& ids,
+                               const std::vector<std::string>& categories) {
+    if (ids.empty()) return;
+
+    std::unordered_map<std::string_view, std::uint32_t> dict;
+    for (auto&& [idx, str] : util::enumerate(lookUpTable_)) {
+        dict.emplace(str, static_cast<std::uint32_t>(idx));
+    }
+    std::vector<std::uint32_t> remap(categories.size());
+    std::vector<size_t> added;
+    auto next = static_cast<std::uint32_t>(lookUpTable_.size());
+    for (auto&& [idx, str] : util::enumerate(categories)) {
+        auto [it, inserted] = dict.try_emplace(str, next);
+        if (inserted) {
+            added.push_back(idx);
+            ++next;
+        }
+        remap[idx] = it->second;
+    }
+    // dict refers to the strings in lookUpTable_, do not use it after adding new categories
+    for (auto idx : added) {
+        lookUpTable_.push_back(categories[idx]);
+    }
+    buffer_->getEditableRAMRepresentation()->append(
+        util::transform(ids, [&](std::uint32_t id) { return remap[id]; }));
+}
+
 std::uint32_t CategoricalColumn::addCategory(const std::string& cat) { return addOrGetID(cat); }
 
 glm::uint32_t CategoricalColumn::addOrGetID(const std::string& str) {
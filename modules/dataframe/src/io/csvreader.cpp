@@ -31,11 +31,25 @@
 
 #include <inviwo/dataframe/datastructures/column.h>
 #include <inviwo/dataframe/datastructures/dataframe.h>
+#include <inviwo/core/common/inviwoapplication.h>
 #include <inviwo/core/util/filesystem.h>
+#include <inviwo/core/util/memorymappedfile.h>
 #include <inviwo/core/util/stringconversion.h>
+#include <inviwo/core/util/stdextensions.h>
 
-#include <fstream>
 #include <algorithm>
+#include <array>
+#include <cctype>
+#include <charconv>
+#include <deque>
+#include <future>
+#include <iterator>
+#include <limits>
+#include <sstream>
+#include <string_view>
+#include <unordered_map>
+
+#include <fmt/format.h>
 
 namespace inviwo {
 
@@ -59,39 +73,19 @@ void CSVReader::setFirstRowHeader(bool hasHeader) { firstRowHeader_ = hasHeader;
 void CSVReader::setEnableDoublePrecision(bool doubleprec) { doublePrecision_ = doubleprec; }
 
 std::shared_ptr<DataFrame> CSVReader::readData(const std::string& fileName) {
-    auto file = filesystem::ifstream(fileName);
-
-    if (!file.is_open()) {
-        throw FileException(std::string("CSVReader: Could not open file \"" + fileName + "\"."),
-                            IVW_CONTEXT);
-    }
-    file.seekg(0, std::ios::end);
-    std::streampos len = file.tellg();
-    file.seekg(0, std::ios::beg);
-
-    if (len == std::streampos(0)) {
+    const util::MemoryMappedFile file(fileName, util::MemoryMappedFile::Access::Sequential);
+    if (file.empty()) {
         throw CSVDataReaderException("Empty file, no data", IVW_CONTEXT);
     }
 
-    return readData(file);
-}
-
-namespace detail {
-
-bool isLineBreak(const char ch, std::istream& stream) {
-    if (ch == '\r') {
-        // consume potential LF (\n) following CR (\r)
-        if (stream.peek() == '\n') {
-            stream.get();
-        }
-        return true;
-    } else {
-        return (ch == '\n');
+    auto data = file.view();
+    // Skip BOM if it exists. Added by for example Excel when saving csv files.
+    if (data.substr(0, 3) == "\xef\xbb\xbf") {
+        data.remove_prefix(3);
     }
+    return parse(data);
 }
 
-}  // namespace detail
-
 std::shared_ptr<DataFrame> CSVReader::readData(std::istream& stream) const {
     // Skip BOM if it exists. Added by for example Excel when saving csv files.
     filesystem::skipByteOrderMark(stream);
@@ -100,125 +94,384 @@ std::shared_ptr<DataFrame> CSVReader::readData(std::istream& stream) const {
         throw CSVDataReaderException("Input stream in a bad state", IVW_CONTEXT);
     }
 
-    // create a string stream from input stream for buffering
-    std::stringstream in;
-    in << stream.rdbuf();
-    if (in.fail()) {
+    const std::string data{std::istreambuf_iterator<char>{stream},
+                           std::istreambuf_iterator<char>{}};
+    if (data.empty()) {
         throw CSVDataReaderException("No data", IVW_CONTEXT);
     }
+    return parse(data);
+}
+
+namespace detail {
+
+namespace {
+
+enum CharClass : std::uint8_t { Other = 0, LineBreak = 1, Quote = 2, Delimiter = 4 };
+using CharClasses = std::array<std::uint8_t, 256>;
+
+CharClasses classify(std::string_view delimiters) {
+    CharClasses classes{};
+    for (auto ch : delimiters) {
+        classes[static_cast<unsigned char>(ch)] |= Delimiter;
+    }
+    classes[static_cast<unsigned char>('"')] |= Quote;
+    classes[static_cast<unsigned char>('\r')] |= LineBreak;
+    classes[static_cast<unsigned char>('\n')] |= LineBreak;
+    return classes;
+}
+
+/**
+ * Converts a field to a string. Line breaks within quoted fields are normalized to '\n'.
+ */
+std::string toFieldString(std::string_view value) {
+    if (value.find('\r') == std::string_view::npos) return std::string{value};
+
+    std::string result;
+    result.reserve(value.size());
+    for (size_t i = 0; i < value.size(); ++i) {
+        if (value[i] == '\r') {
+            if (i + 1 < value.size() && value[i + 1] == '\n') ++i;
+            result.push_back('\n');
+        } else {
+            result.push_back(value[i]);
+        }
+    }
+    return result;
+}
+
+/**
+ * Splits CSV data held in memory into fields and rows. Fields are returned as views into the
+ * data. Quotes are kept as part of the field and delimiters and line breaks enclosed by quotes do
+ * not terminate a field.
+ */
+class Tokenizer {
+public:
+    struct Field {
+        std::string_view value;
+        bool lineBreak;  //!< true if the field was terminated by a line break
+    };
+    enum class Row { Values, EmptyLine, End };
 
-    // current line
-    size_t lineNumber = 1u;
+    Tokenizer(std::string_view data, const CharClasses& classes, size_t lineNumber)
+        : data_{data}, classes_{classes}, pos_{0}, lineNumber_{lineNumber}, eof_{false} {}
 
-    // extract exactly one field from the current stream position, the bool return value indicates
-    // whether a line break was detected following the field
-    auto extractField = [&in, &lineNumber, delims = delimiters_]() -> std::pair<std::string, bool> {
-        std::string value;
+    size_t pos() const { return pos_; }
+    size_t lineNumber() const { return lineNumber_; }
+    bool eof() const { return eof_; }
+
+    Field nextField() {
+        const size_t begin = pos_;
         size_t quoteCount = 0;
         size_t quoteBeginLine = 0;
         char prev = 0;
 
-        char ch;
-        while (in.get(ch) && in.good()) {
-            bool linebreak = detail::isLineBreak(ch, in);
-            if (linebreak) {
-                ++lineNumber;  // increase line counter
-                // ensure that ch is equal to '\n'
-                ch = '\n';
-                // consume line break, if inside quotes
-                if ((quoteCount & 1) != 0) {
-                    value += ch;
-                    prev = ch;
-                    continue;
-                }
+        while (pos_ < data_.size()) {
+            const size_t current = pos_;
+            const char ch = data_[pos_++];
+            const auto cls = classes_[static_cast<unsigned char>(ch)];
+            if (cls == Other) {
+                prev = ch;
+                continue;
             }
-            if (ch == '"') {  // found a quote
-                if (quoteCount == 0) quoteBeginLine = lineNumber;
+            // found a delimiter/newline, ensure that it isn't enclosed by quotes,
+            // i.e. a quote count of 0 or an even count of quotes if the previous
+            // character was a quote
+            const bool terminates =
+                (quoteCount == 0) || ((prev == '"') && ((quoteCount & 1) == 0));
+            if (cls & LineBreak) {
+                // consume potential LF (\n) following CR (\r)
+                if (ch == '\r' && pos_ < data_.size() && data_[pos_] == '\n') ++pos_;
+                ++lineNumber_;
+                if (terminates) return {data_.substr(begin, current - begin), true};
+                prev = '\n';
+                continue;
+            } else if (cls & Quote) {
+                if (quoteCount == 0) quoteBeginLine = lineNumber_;
                 ++quoteCount;
-            } else if (util::contains(delims, ch) || linebreak) {
-                // found a delimiter/newline, ensure that it isn't enclosed by quotes,
-                // i.e. a quote count of 0 or an even count of quotes if the previous
-                // character was a quote
-                if ((quoteCount == 0) || ((prev == '"') && ((quoteCount & 1) == 0))) {
-                    return {value, linebreak};
-                }
+            } else if (terminates) {
+                return {data_.substr(begin, current - begin), false};
             }
             prev = ch;
-            value += ch;
         }
-        if (((quoteCount & 1) != 0) && in.eof()) {
-            throw CSVDataReaderException("Unmatched quotes (starting in line " +
-                                         std::to_string(quoteBeginLine) + ")");
+        eof_ = true;
+        if ((quoteCount & 1) != 0) {
+            throw CSVDataReaderException(
+                fmt::format("Unmatched quotes (starting in line {})", quoteBeginLine));
         }
-        return {trim(value), false};
-    };
+        return {util::trim(data_.substr(begin)), false};
+    }
 
-    // extract one row from the current stream position, the bool return value indicates whether
-    // the end-of-file was detected
-    auto extractRow = [&in, extractField,
-                       &lineNumber](size_t maxColCount = std::numeric_limits<size_t>::max())
-        -> std::pair<std::vector<std::string>, bool> {
-        auto val = extractField();
-        if (in.eof() && val.first.empty()) {
+    /**
+     * Extract the fields of the next row into \p values. If the row holds one more column than
+     * \p maxColCount and the last field is empty, that field is ignored.
+     * @throws CSVDataReaderException if the number of fields does not match \p maxColCount
+     */
+    Row nextRow(std::vector<std::string_view>& values,
+                size_t maxColCount = std::numeric_limits<size_t>::max()) {
+        values.clear();
+        auto field = nextField();
+        if (eof_ && field.value.empty()) {
             // reached end of file, no more data
-            return {{}, true};
-        } else if (val.first.empty() && val.second) {
+            return Row::End;
+        } else if (field.value.empty() && field.lineBreak) {
             // empty line, ignore
-            return {{}, false};
+            return Row::EmptyLine;
         }
-        std::vector<std::string> values;
-        values.push_back(val.first);
-        while (!val.second && !in.eof()) {
-            val = extractField();
-            values.push_back(val.first);
+        values.push_back(field.value);
+        while (!field.lineBreak && !eof_) {
+            field = nextField();
+            values.push_back(field.value);
         }
         // ignore last field _if_ it is empty and would be inserted in the maxColCount+1 column
         if (values.back().empty() && (values.size() - 1 == maxColCount)) {
-            values.resize(values.size() - 1);
+            values.pop_back();
         } else if ((values.size() != maxColCount) &&
                    (maxColCount != std::numeric_limits<size_t>::max())) {
             // mismatch in the number of columns
-            throw CSVDataReaderException("Column counts do not match (line " +
-                                         std::to_string(lineNumber) + ": " +
-                                         std::to_string(values.size()) + " fields; DataFrame has " +
-                                         std::to_string(maxColCount) + " columns)");
+            throw CSVDataReaderException(
+                fmt::format("Column counts do not match (line {}: {} fields; DataFrame has {} "
+                            "columns)",
+                            lineNumber_, values.size(), maxColCount));
         }
-        return {values, false};
-    };
+        return Row::Values;
+    }
+
+    /**
+     * Advance to the start of the next row without extracting any values.
+     * @return false if the end of the data was reached
+     */
+    bool skipRow() {
+        while (!nextField().lineBreak && !eof_) {
+        }
+        return !eof_ && pos_ < data_.size();
+    }
+
+private:
+    std::string_view data_;
+    const CharClasses& classes_;
+    size_t pos_;
+    size_t lineNumber_;
+    bool eof_;
+};
+
+/**
+ * Parse a number with the same leniency as reading it from a std::istream, i.e. leading
+ * whitespace and trailing characters are ignored. Like std::istream, and unlike std::from_chars,
+ * "inf" and "nan" are not accepted as floating point values.
+ */
+template <typename T>
+bool parseNumber(std::string_view str, T& result) {
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+    auto first = std::find_if_not(str.begin(), str.end(),
+                                  [](char c) { return std::isspace(static_cast<unsigned char>(c)); });
+    if (first != str.end() && *first == '+') {
+        ++first;
+        if (first != str.end() && *first == '-') return false;
+    }
+    if constexpr (std::is_floating_point_v<T>) {
+        auto digits = (first != str.end() && *first == '-') ? std::next(first) : first;
+        if (digits == str.end() ||
+            !(std::isdigit(static_cast<unsigned char>(*digits)) || *digits == '.')) {
+            return false;
+        }
+    }
+    const auto begin = str.data() + std::distance(str.begin(), first);
+    auto [ptr, ec] = std::from_chars(begin, str.data() + str.size(), result);
+    return ec == std::errc{};
+#else
+    std::istringstream stream{std::string{str}};
+    stream >> result;
+    return !stream.fail();
+#endif
+}
+
+/**
+ * Column values of a consecutive range of rows, parsed independently of other ranges and
+ * appended to the final column afterwards.
+ */
+class ColumnChunk {
+public:
+    virtual ~ColumnChunk() = default;
+    /**
+     * @return false if \p value cannot be converted to the column type
+     */
+    virtual bool add(std::string_view value) = 0;
+    virtual void appendTo(Column& column) const = 0;
+};
+
+template <typename T>
+class NumericChunk : public ColumnChunk {
+public:
+    virtual bool add(std::string_view value) override {
+        T result;
+        if constexpr (std::is_integral_v<T>) {
+            if (value.empty()) {
+                // no special value indicating missing data for integral types
+                data_.push_back(T{0});
+            } else if (parseNumber(value, result)) {
+                data_.push_back(result);
+            } else {
+                return false;
+            }
+        } else {
+            data_.push_back(parseNumber(value, result) ? result
+                                                       : std::numeric_limits<T>::quiet_NaN());
+        }
+        return true;
+    }
+    virtual void appendTo(Column& column) const override {
+        static_cast<TemplateColumn<T>&>(column)
+            .getTypedBuffer()
+            ->getEditableRAMRepresentation()
+            ->append(data_);
+    }
+
+private:
+    std::vector<T> data_;
+};
+
+class CategoricalChunk : public ColumnChunk {
+public:
+    virtual bool add(std::string_view value) override {
+        if (value.find('\r') != std::string_view::npos) {
+            value = normalized_.emplace_back(toFieldString(value));
+        }
+        auto [it, inserted] =
+            dict_.try_emplace(value, static_cast<std::uint32_t>(categories_.size()));
+        if (inserted) categories_.push_back(value);
+        ids_.push_back(it->second);
+        return true;
+    }
+    virtual void appendTo(Column& column) const override {
+        static_cast<CategoricalColumn&>(column).append(
+            ids_, util::transform(categories_, [](std::string_view v) { return std::string{v}; }));
+    }
+
+private:
+    std::vector<std::uint32_t> ids_;
+    std::vector<std::string_view> categories_;
+    std::unordered_map<std::string_view, std::uint32_t> dict_;
+    std::deque<std::string> normalized_;  // storage for values with normalized line breaks
+};
+
+std::unique_ptr<ColumnChunk> createChunk(const Column& column) {
+    if (dynamic_cast<const CategoricalColumn*>(&column)) {
+        return std::make_unique<CategoricalChunk>();
+    } else if (dynamic_cast<const TemplateColumn<int>*>(&column)) {
+        return std::make_unique<NumericChunk<int>>();
+    } else if (dynamic_cast<const TemplateColumn<float>*>(&column)) {
+        return std::make_unique<NumericChunk<float>>();
+    } else if (dynamic_cast<const TemplateColumn<double>*>(&column)) {
+        return std::make_unique<NumericChunk<double>>();
+    }
+    throw CSVDataReaderException(
+        fmt::format("Unsupported column type for column '{}'", column.getHeader()));
+}
+
+struct RowRange {
+    std::string_view data;
+    size_t lineNumber;
+};
+
+/**
+ * Split \p data into ranges of complete rows of roughly \p chunkSize bytes. This requires a
+ * sequential pass over the data since line breaks enclosed in quotes do not end a row.
+ */
+std::vector<RowRange> splitRows(std::string_view data, const CharClasses& classes,
+                                size_t lineNumber, size_t chunkSize) {
+    std::vector<RowRange> ranges;
+    Tokenizer scanner(data, classes, lineNumber);
+    size_t begin = 0;
+    size_t line = lineNumber;
+    bool more = true;
+    while (more) {
+        more = scanner.skipRow();
+        if (!more || scanner.pos() - begin >= chunkSize) {
+            const auto end = more ? scanner.pos() : data.size();
+            if (end > begin) ranges.push_back({data.substr(begin, end - begin), line});
+            begin = end;
+            line = scanner.lineNumber();
+        }
+    }
+    return ranges;
+}
+
+std::vector<std::unique_ptr<ColumnChunk>> parseRows(const RowRange& range,
+                                                    const CharClasses& classes,
+                                                    const DataFrame& dataFrame) {
+    std::vector<std::unique_ptr<ColumnChunk>> columns;
+    // skip index column
+    for (size_t i = 1; i < dataFrame.getNumberOfColumns(); ++i) {
+        columns.push_back(createChunk(*dataFrame.getColumn(i)));
+    }
+    const size_t colCount = columns.size();
+
+    Tokenizer tokenizer(range.data, classes, range.lineNumber);
+    std::vector<std::string_view> values;
+    std::vector<size_t> columnIdForDataTypeErrors;
+    for (;;) {
+        const size_t line = tokenizer.lineNumber();
+        const auto row = tokenizer.nextRow(values, colCount);
+        if (row == Tokenizer::Row::End) break;
+
+        // Do not add empty rows, i.e. rows with only delimiters (,,,,) or newline
+        if (row == Tokenizer::Row::EmptyLine ||
+            std::all_of(values.begin(), values.end(), [](auto v) { return v.empty(); })) {
+            continue;
+        }
+        for (size_t i = 0; i < colCount; ++i) {
+            if (!columns[i]->add(values[i])) columnIdForDataTypeErrors.push_back(i + 1);
+        }
+        if (!columnIdForDataTypeErrors.empty()) {
+            throw DataTypeMismatch(
+                fmt::format("Data type mismatch for columns: ({}) with values: ({}) (line {})",
+                            joinString(columnIdForDataTypeErrors, ", "),
+                            joinString(values, ", "), line),
+                IVW_CONTEXT_CUSTOM("CSVReader"));
+        }
+    }
+    return columns;
+}
+
+}  // namespace
+
+}  // namespace detail
+
+std::shared_ptr<DataFrame> CSVReader::parse(std::string_view data) const {
+    const auto classes = detail::classify(delimiters_);
+    detail::Tokenizer tokenizer(data, classes, 1u);
+    std::vector<std::string_view> values;
 
     std::vector<std::string> headers;
     size_t maxColCount = std::numeric_limits<size_t>::max();
     if (firstRowHeader_) {
         // read headers
-        auto row = extractRow();
-        if (row.second || row.first.empty()) {
+        if (tokenizer.nextRow(values) != detail::Tokenizer::Row::Values) {
             throw CSVDataReaderException("Empty file, column headers not found");
         }
-        headers = row.first;
+        headers = util::transform(values, &detail::toFieldString);
         maxColCount = headers.size();
     }
 
+    const size_t dataBegin = tokenizer.pos();
+    const size_t dataLineNumber = tokenizer.lineNumber();
+
     std::vector<std::vector<std::string>> exampleRows;
     std::vector<size_t> exampleLineNumbers;  // line numbers matching the example rows
-    std::streampos streamPos = in.tellg();
     for (auto exampleRow = 0u; exampleRow < 50u; ++exampleRow) {
-        size_t currentLine = lineNumber;
-        auto row = extractRow(maxColCount);
-        if (row.second) {
-            // reached end-of-file
-            if (exampleRow == 0) {
-                throw CSVDataReaderException("Empty file, no data");
-            }
-            in.clear();  // clear eof-bit
+        const size_t currentLine = tokenizer.lineNumber();
+        const auto row = tokenizer.nextRow(values, maxColCount);
+        if (row == detail::Tokenizer::Row::End) {
             break;
-        } else if (!row.first.empty()) {  // ignore empty lines
-            exampleRows.emplace_back(row.first);
+        } else if (row == detail::Tokenizer::Row::Values) {  // ignore empty lines
+            exampleRows.emplace_back(util::transform(values, &detail::toFieldString));
             exampleLineNumbers.emplace_back(currentLine);
         }
     }
+    if (exampleRows.empty()) {
+        throw CSVDataReaderException("Empty file, no data");
+    }
 
-    // Rewind to start position
-    in.seekg(streamPos, std::ios::beg);
     if (!firstRowHeader_) {
         // assign default column headers
         for (size_t i = 0; i < exampleRows.front().size(); ++i) {
@@ -239,20 +492,48 @@ std::shared_ptr<DataFrame> CSVReader::readData(std::istream& stream) const {
         }
     }
 
-    auto dataFrame = createDataFrame(exampleRows, headers);
+    auto dataFrame = createDataFrame(exampleRows, headers, doublePrecision_);
 
-    size_t rowIndex = firstRowHeader_ ? 1 : 0;
-    auto row = extractRow(maxColCount);
-    while (!row.second) {
-        // Do not add empty rows, i.e. rows with only delimiters (,,,,) or newline
-        if (std::any_of(std::begin(row.first), std::end(row.first),
-                        [](const auto& a) { return !a.empty(); })) {
-            // May throw DataTypeMismatch, but do not catch it here since it indicates
-            // that the DataFrame is in an invalid state
-            dataFrame->addRow(row.first);
+    // Split the remaining data into ranges of complete rows which are then parsed concurrently
+    // on the thread pool, if available. Each range is converted into separate column chunks,
+    // which are appended to the DataFrame in order.
+    const auto rows = data.substr(dataBegin);
+    const size_t jobs = InviwoApplication::isInitialized()
+                            ? InviwoApplication::getPtr()->getPoolSize()
+                            : size_t{0};
+    constexpr size_t minChunkSize = 1u << 20;
+    const auto ranges =
+        (jobs > 0 && rows.size() > 2 * minChunkSize)
+            ? detail::splitRows(rows, classes, dataLineNumber,
+                                std::max(minChunkSize, rows.size() / (4 * jobs)))
+            : std::vector<detail::RowRange>{{rows, dataLineNumber}};
+
+    std::vector<std::vector<std::unique_ptr<detail::ColumnChunk>>> chunks;
+    if (ranges.size() == 1) {
+        chunks.push_back(detail::parseRows(ranges.front(), classes, *dataFrame));
+    } else {
+        std::vector<std::future<std::vector<std::unique_ptr<detail::ColumnChunk>>>> futures;
+        for (const auto& range : ranges) {
+            futures.push_back(dispatchPool([&classes, &dataFrame, range]() {
+                return detail::parseRows(range, classes, *dataFrame);
+            }));
+        }
+        // wait for all jobs before rethrowing potential exceptions since the jobs refer to data
+        // local to this function
+        auto& pool = InviwoApplication::getPtr()->getThreadPool();
+        for (const auto& f : futures) {
+            pool.wait(f);
+        }
+        for (auto& f : futures) {
+            chunks.push_back(f.get());
+        }
+    }
+
+    for (const auto& columns : chunks) {
+        for (auto&& [i, chunk] : util::enumerate(columns)) {
+            // skip index column
+            chunk->appendTo(*dataFrame->getColumn(i + 1));
         }
-        row = extractRow(maxColCount);
-        ++rowIndex;
     }
     dataFrame->updateIndexBuffer();
     return dataFrame;
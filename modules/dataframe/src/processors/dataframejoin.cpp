@@ -59,6 +59,9 @@ DataFrameJoin::DataFrameJoin()
              {"appendRows", "Append Rows", JoinType::AppendRows},
              {"inner", "Inner Join", JoinType::Inner},
              {"outerleft", "Outer Left Join", JoinType::OuterLeft}})
+    , algorithm_("algorithm", "Join Algorithm",
+                 {{"hash", "Hash Join", dataframe::JoinAlgorithm::Hash},
+                  {"sortMerge", "Sort-Merge Join", dataframe::JoinAlgorithm::SortMerge}})
     , ignoreDuplicateCols_("ignoreDuplicateCols", "Ignore Duplicate Columns", false)
     , fillMissingRows_("fillMissingRows", "Fill Missing Rows", false)
     , columnMatching_("columnMatching", "Match Columns",
@@ -82,10 +85,11 @@ DataFrameJoin::DataFrameJoin()
     auto keyVisible = [](const auto& p) {
         return (p == JoinType::Inner || p == JoinType::OuterLeft);
     };
+    algorithm_.visibilityDependsOn(join_, keyVisible);
     key_.visibilityDependsOn(join_, keyVisible);
     secondaryKeys_.visibilityDependsOn(join_, keyVisible);
 
-    addProperties(join_, ignoreDuplicateCols_, fillMissingRows_, columnMatching_, key_,
+    addProperties(join_, algorithm_, ignoreDuplicateCols_, fillMissingRows_, columnMatching_, key_,
                   secondaryKeys_);
 
     inportLeft_.onChange([&]() {
@@ -119,10 +123,12 @@ void DataFrameJoin::process() {
                                               columnMatching_ == ColumnMatch::ByName);
             break;
         case JoinType::Inner:
-            dataframe = dataframe::innerJoin(*inportLeft_.getData(), *inportRight_.getData(), keys);
+            dataframe = dataframe::innerJoin(*inportLeft_.getData(), *inportRight_.getData(), keys,
+                                             algorithm_);
             break;
         case JoinType::OuterLeft:
-            dataframe = dataframe::leftJoin(*inportLeft_.getData(), *inportRight_.getData(), keys);
+            dataframe = dataframe::leftJoin(*inportLeft_.getData(), *inportRight_.getData(), keys,
+                                            algorithm_);
             break;
         default:
             throw Exception("unsupported join operation", IVW_CONTEXT);
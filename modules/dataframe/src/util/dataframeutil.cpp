@@ -36,6 +36,11 @@
 #include <fmt/format.h>
 
 #include <optional>
+#include <unordered_map>
+#include <numeric>
+#include <algorithm>
+#include <limits>
+#include <cmath>
 
 namespace inviwo {
 
@@ -180,6 +185,12 @@ void columnCheck(const DataFrame& left, const DataFrame& right,
                 IVW_CONTEXT_CUSTOM(context));
         }
 
+        if (indexCol1->getBuffer()->getDataFormat()->getComponents() != 1) {
+            throw Exception(fmt::format("key column '{}' is not scalar ({})", col,
+                                        indexCol1->getBuffer()->getDataFormat()->getString()),
+                            IVW_CONTEXT_CUSTOM(context));
+        }
+
         if (indexCol1->getBuffer()->getDataFormat()->getId() !=
             indexCol2->getBuffer()->getDataFormat()->getId()) {
             throw Exception(
@@ -191,100 +202,293 @@ void columnCheck(const DataFrame& left, const DataFrame& right,
     }
 }
 
+constexpr std::uint32_t noMatch = std::numeric_limits<std::uint32_t>::max();
+
 /**
- * \brief for each row in leftCol return a list of matching row indices in rightCol
+ * Dense integer codes of the key values of the left and right DataFrame. Equal keys are mapped to
+ * the same code, keys of the left DataFrame which do not exist in the right one are mapped to
+ * noMatch. All codes are smaller than \p count.
  */
-template <bool firstMatchOnly = false>
-std::vector<std::vector<size_t>> getMatchingRows(std::shared_ptr<const Column> leftCol,
-                                                 std::shared_ptr<const Column> rightCol) {
-    std::vector<std::vector<size_t>> rows(leftCol->getSize());
-
-    if (auto catCol1 = dynamic_cast<const CategoricalColumn*>(leftCol.get())) {
-        // need to match values of categorical columns instead of indices stored in buffer
-        auto catCol2 = dynamic_cast<const CategoricalColumn*>(rightCol.get());
+struct KeyCodes {
+    std::vector<std::uint32_t> left;
+    std::vector<std::uint32_t> right;
+    size_t count = 0;
+};
+
+/**
+ * Remap the category ids of the left column to the ones of the right column. This only
+ * requires string comparisons per category and not per row.
+ */
+KeyCodes encodeCategorical(const CategoricalColumn& leftCol, const CategoricalColumn& rightCol) {
+    std::unordered_map<std::string_view, std::uint32_t> rightIds;
+    for (auto&& [id, cat] : util::enumerate(rightCol.getCategories())) {
+        rightIds.try_emplace(cat, static_cast<std::uint32_t>(id));
+    }
+    const auto remap = util::transform(leftCol.getCategories(), [&](const std::string& cat) {
+        auto it = rightIds.find(cat);
+        return it != rightIds.end() ? it->second : noMatch;
+    });
+
+    KeyCodes codes;
+    codes.left = util::transform(
+        leftCol.getTypedBuffer()->getRAMRepresentation()->getDataContainer(),
+        [&](std::uint32_t id) { return remap[id]; });
+    codes.right = rightCol.getTypedBuffer()->getRAMRepresentation()->getDataContainer();
+    codes.count = rightCol.getCategories().size();
+    return codes;
+}
+
+template <typename T>
+KeyCodes encodeValues(const std::vector<T>& left, const std::vector<T>& right) {
+    std::unordered_map<T, std::uint32_t> dict;
+    dict.reserve(right.size());
+
+    KeyCodes codes;
+    codes.right = util::transform(right, [&](const T& value) {
+        return dict.try_emplace(value, static_cast<std::uint32_t>(dict.size())).first->second;
+    });
+    codes.left = util::transform(left, [&](const T& value) {
+        auto it = dict.find(value);
+        return it != dict.end() ? it->second : noMatch;
+    });
+    codes.count = dict.size();
+    return codes;
+}
+
+KeyCodes encodeColumn(const Column& leftCol, const Column& rightCol) {
+    if (auto catCol1 = dynamic_cast<const CategoricalColumn*>(&leftCol)) {
+        auto catCol2 = dynamic_cast<const CategoricalColumn*>(&rightCol);
         IVW_ASSERT(catCol2, "right column is not categorical");
+        return encodeCategorical(*catCol1, *catCol2);
+    } else {
+        return leftCol.getBuffer()
+            ->getRepresentation<BufferRAM>()
+            ->dispatch<KeyCodes, dispatching::filter::Scalars>(
+                [rightBuffer = rightCol.getBuffer()](auto typedBuf) {
+                    using ValueType = util::PrecisionValueType<decltype(typedBuf)>;
+                    const auto& right = static_cast<const BufferRAMPrecision<ValueType>*>(
+                                            rightBuffer->getRepresentation<BufferRAM>())
+                                            ->getDataContainer();
+                    return encodeValues(typedBuf->getDataContainer(), right);
+                });
+    }
+}
 
-        auto valuesRight = catCol2->getValues();
-        for (auto&& [i, key] : util::enumerate(catCol1->getValues())) {
-            // find all matching rows in right column
-            std::vector<size_t> matches;
-            for (auto&& [r, value] : util::enumerate(valuesRight)) {
-                if (key == value) {
-                    matches.emplace_back(r);
-                    if constexpr (firstMatchOnly) break;
-                }
-            }
-            rows[i] = std::move(matches);
+/**
+ * Combine the codes of two key columns into new dense codes of the composite key
+ */
+KeyCodes combine(const KeyCodes& a, const KeyCodes& b) {
+    const auto pack = [](std::uint32_t x, std::uint32_t y) {
+        return (static_cast<std::uint64_t>(x) << 32) | static_cast<std::uint64_t>(y);
+    };
+
+    std::unordered_map<std::uint64_t, std::uint32_t> dict;
+    dict.reserve(a.right.size());
+
+    KeyCodes codes;
+    codes.right.resize(a.right.size());
+    for (size_t i = 0; i < a.right.size(); ++i) {
+        codes.right[i] =
+            dict.try_emplace(pack(a.right[i], b.right[i]), static_cast<std::uint32_t>(dict.size()))
+                .first->second;
+    }
+    codes.left.resize(a.left.size());
+    for (size_t i = 0; i < a.left.size(); ++i) {
+        if (a.left[i] == noMatch || b.left[i] == noMatch) {
+            codes.left[i] = noMatch;
+        } else {
+            auto it = dict.find(pack(a.left[i], b.left[i]));
+            codes.left[i] = it != dict.end() ? it->second : noMatch;
         }
-    } else {
-        leftCol->getBuffer()->getRepresentation<BufferRAM>()->dispatch<void>(
-            [rightBuffer = rightCol->getBuffer(), &rows](auto typedBuf) {
-                using ValueType = util::PrecisionValueType<decltype(typedBuf)>;
+    }
+    codes.count = dict.size();
+    return codes;
+}
 
-                const auto& left = typedBuf->getDataContainer();
-                const auto& right = static_cast<const BufferRAMPrecision<ValueType>*>(
-                                        rightBuffer->getRepresentation<BufferRAM>())
-                                        ->getDataContainer();
-
-                for (auto&& [i, key] : util::enumerate(left)) {
-                    // find all matching rows in right
-                    std::vector<size_t> matches;
-                    for (auto&& [r, value] : util::enumerate(right)) {
-                        if (key == value) {
-                            matches.emplace_back(r);
-                            if constexpr (firstMatchOnly) break;
-                        }
-                    }
-                    rows[i] = std::move(matches);
-                }
-            });
+std::vector<std::optional<size_t>> hashJoinRows(const DataFrame& left, const DataFrame& right,
+                                                const std::vector<std::string>& keyColumns) {
+    auto codes = encodeColumn(*left.getColumn(keyColumns.front()),
+                              *right.getColumn(keyColumns.front()));
+    for (const auto& keyColName : util::as_range(keyColumns.begin() + 1, keyColumns.end())) {
+        codes = combine(codes,
+                        encodeColumn(*left.getColumn(keyColName), *right.getColumn(keyColName)));
     }
-    return rows;
+
+    // codes are dense, hence a plain vector serves as the index of the first matching row
+    constexpr auto npos = std::numeric_limits<size_t>::max();
+    std::vector<size_t> firstRow(codes.count, npos);
+    for (auto&& [row, code] : util::enumerate(codes.right)) {
+        if (firstRow[code] == npos) firstRow[code] = row;
+    }
+
+    return util::transform(codes.left, [&](std::uint32_t code) -> std::optional<size_t> {
+        if (code == noMatch || firstRow[code] == npos) {
+            return std::nullopt;
+        } else {
+            return firstRow[code];
+        }
+    });
 }
 
-std::vector<std::vector<size_t>> getMatchingRows(const DataFrame& left, const DataFrame& right,
-                                                 const std::vector<std::string>& keyColumns) {
-    auto indexCol1 = left.getColumn(keyColumns.front());
-    auto indexCol2 = right.getColumn(keyColumns.front());
-
-    auto rows = detail::getMatchingRows(indexCol1, indexCol2);
-    // narrow down row selection by filtering with remaining keys
-    for (auto keyColName : util::as_range(keyColumns.begin() + 1, keyColumns.end())) {
-        auto leftCol = left.getColumn(keyColName);
-        auto rightCol = right.getColumn(keyColName);
-
-        if (auto catCol1 = dynamic_cast<const CategoricalColumn*>(leftCol.get())) {
-            auto catCol2 = dynamic_cast<const CategoricalColumn*>(rightCol.get());
-            IVW_ASSERT(catCol2, "right column is not categorical");
-
-            auto valuesLeft = catCol1->getValues();
-            auto valuesRight = catCol2->getValues();
-            for (auto&& [i, rowMatches] : util::enumerate(rows)) {
-                util::erase_remove_if(rowMatches, [key = valuesLeft[i], &valuesRight](auto row) {
-                    return key != valuesRight[row];
-                });
-            }
+template <typename T>
+int compareKeys(const T& a, const T& b) {
+    if constexpr (std::is_floating_point_v<T>) {
+        // order NaNs last to get a strict weak ordering
+        const bool nanA = std::isnan(a);
+        const bool nanB = std::isnan(b);
+        if (nanA || nanB) return nanA == nanB ? 0 : (nanA ? 1 : -1);
+    }
+    return a < b ? -1 : (b < a ? 1 : 0);
+}
+
+/**
+ * Three-way comparisons of the key values of one column given row indices into the left and
+ * right DataFrame.
+ */
+class SortKey {
+public:
+    virtual ~SortKey() = default;
+    virtual int compareLeft(size_t a, size_t b) const = 0;
+    virtual int compareRight(size_t a, size_t b) const = 0;
+    virtual int compare(size_t leftRow, size_t rightRow) const = 0;
+    /// Returns false for keys that never match anything, i.e. NaN
+    virtual bool matchable(size_t leftRow) const = 0;
+};
+
+template <typename T>
+class TypedSortKey : public SortKey {
+public:
+    TypedSortKey(const std::vector<T>& left, const std::vector<T>& right)
+        : left_{left}, right_{right} {}
+
+    virtual int compareLeft(size_t a, size_t b) const override {
+        return compareKeys(left_[a], left_[b]);
+    }
+    virtual int compareRight(size_t a, size_t b) const override {
+        return compareKeys(right_[a], right_[b]);
+    }
+    virtual int compare(size_t leftRow, size_t rightRow) const override {
+        return compareKeys(left_[leftRow], right_[rightRow]);
+    }
+    virtual bool matchable(size_t leftRow) const override {
+        if constexpr (std::is_floating_point_v<T>) {
+            return !std::isnan(left_[leftRow]);
         } else {
-            leftCol->getBuffer()->getRepresentation<BufferRAM>()->dispatch<void>(
-                [&rows, rightBuffer = rightCol->getBuffer()](auto typedBuf) {
-                    using ValueType = util::PrecisionValueType<decltype(typedBuf)>;
+            return true;
+        }
+    }
+
+private:
+    const std::vector<T>& left_;
+    const std::vector<T>& right_;
+};
 
-                    const auto& left = typedBuf->getDataContainer();
+/**
+ * Compares categorical columns by the category ids of the right column. Categories only present
+ * in the left column are mapped to noMatch, which is larger than all ids of the right column.
+ */
+class CategoricalSortKey : public SortKey {
+public:
+    CategoricalSortKey(const CategoricalColumn& left, const CategoricalColumn& right)
+        : codes_{encodeCategorical(left, right)} {}
+
+    virtual int compareLeft(size_t a, size_t b) const override {
+        return compareKeys(codes_.left[a], codes_.left[b]);
+    }
+    virtual int compareRight(size_t a, size_t b) const override {
+        return compareKeys(codes_.right[a], codes_.right[b]);
+    }
+    virtual int compare(size_t leftRow, size_t rightRow) const override {
+        return compareKeys(codes_.left[leftRow], codes_.right[rightRow]);
+    }
+    virtual bool matchable(size_t leftRow) const override {
+        return codes_.left[leftRow] != noMatch;
+    }
+
+private:
+    KeyCodes codes_;
+};
+
+std::unique_ptr<SortKey> createSortKey(const Column& leftCol, const Column& rightCol) {
+    if (auto catCol1 = dynamic_cast<const CategoricalColumn*>(&leftCol)) {
+        auto catCol2 = dynamic_cast<const CategoricalColumn*>(&rightCol);
+        IVW_ASSERT(catCol2, "right column is not categorical");
+        return std::make_unique<CategoricalSortKey>(*catCol1, *catCol2);
+    } else {
+        return leftCol.getBuffer()
+            ->getRepresentation<BufferRAM>()
+            ->dispatch<std::unique_ptr<SortKey>, dispatching::filter::Scalars>(
+                [rightBuffer = rightCol.getBuffer()](auto typedBuf) -> std::unique_ptr<SortKey> {
+                    using ValueType = util::PrecisionValueType<decltype(typedBuf)>;
                     const auto& right = static_cast<const BufferRAMPrecision<ValueType>*>(
                                             rightBuffer->getRepresentation<BufferRAM>())
                                             ->getDataContainer();
-
-                    for (auto&& [i, rowMatches] : util::enumerate(rows)) {
-                        util::erase_remove_if(rowMatches, [key = left[i], &right](auto row) {
-                            return key != right[row];
-                        });
-                    }
+                    return std::make_unique<TypedSortKey<ValueType>>(
+                        typedBuf->getDataContainer(), right);
                 });
+    }
+}
+
+std::vector<std::optional<size_t>> sortMergeJoinRows(const DataFrame& left,
+                                                     const DataFrame& right,
+                                                     const std::vector<std::string>& keyColumns) {
+    const auto keys = util::transform(keyColumns, [&](const std::string& keyColName) {
+        return createSortKey(*left.getColumn(keyColName), *right.getColumn(keyColName));
+    });
+
+    const auto lexicographic = [&keys](auto cmp) {
+        for (const auto& key : keys) {
+            if (const auto res = cmp(*key); res != 0) return res;
+        }
+        return 0;
+    };
+
+    std::vector<size_t> leftRows(left.getNumberOfRows());
+    std::iota(leftRows.begin(), leftRows.end(), size_t{0});
+    std::sort(leftRows.begin(), leftRows.end(), [&](size_t a, size_t b) {
+        return lexicographic([&](const SortKey& key) { return key.compareLeft(a, b); }) < 0;
+    });
+
+    // stable sort such that the first row of a set of equal keys is the first match
+    std::vector<size_t> rightRows(right.getNumberOfRows());
+    std::iota(rightRows.begin(), rightRows.end(), size_t{0});
+    std::stable_sort(rightRows.begin(), rightRows.end(), [&](size_t a, size_t b) {
+        return lexicographic([&](const SortKey& key) { return key.compareRight(a, b); }) < 0;
+    });
+
+    std::vector<std::optional<size_t>> rows(leftRows.size());
+    auto rightIt = rightRows.begin();
+    for (const auto leftRow : leftRows) {
+        const auto compareTo = [&](size_t rightRow) {
+            return lexicographic([&](const SortKey& key) { return key.compare(leftRow, rightRow); });
+        };
+        while (rightIt != rightRows.end() && compareTo(*rightIt) > 0) ++rightIt;
+        if (rightIt == rightRows.end()) break;
+
+        if (compareTo(*rightIt) == 0 &&
+            std::all_of(keys.begin(), keys.end(),
+                        [&](const auto& key) { return key->matchable(leftRow); })) {
+            rows[leftRow] = *rightIt;
         }
     }
     return rows;
 }
 
+/**
+ * \brief for each row in \p left return the index of the first matching row in \p right, if any.
+ */
+std::vector<std::optional<size_t>> getMatchingRows(const DataFrame& left, const DataFrame& right,
+                                                   const std::vector<std::string>& keyColumns,
+                                                   JoinAlgorithm algorithm) {
+    switch (algorithm) {
+        case JoinAlgorithm::SortMerge:
+            return sortMergeJoinRows(left, right, keyColumns);
+        case JoinAlgorithm::Hash:
+        default:
+            return hashJoinRows(left, right, keyColumns);
+    }
+}
+
 void addColumns(std::shared_ptr<DataFrame> dst, const DataFrame& srcDataFrame,
                 const std::vector<std::string>& keyColumns, bool skipKeyCol) {
     for (auto srcCol : srcDataFrame) {
@@ -350,34 +554,13 @@ void addColumns(std::shared_ptr<DataFrame> dst, const DataFrame& srcDataFrame,
 }  // namespace detail
 
 std::shared_ptr<DataFrame> innerJoin(const DataFrame& left, const DataFrame& right,
-                                     const std::string& keyColumn) {
-    detail::columnCheck(left, right, {keyColumn}, "dataframe::innerJoin");
-
-    auto indexCol1 = left.getColumn(keyColumn);
-    auto indexCol2 = right.getColumn(keyColumn);
-
-    std::vector<size_t> rowsLeft;
-    std::vector<size_t> rowsRight;
-    for (auto&& [i, rowIndices] :
-         util::enumerate(detail::getMatchingRows<true>(indexCol1, indexCol2))) {
-        if (!rowIndices.empty()) {
-            rowsLeft.push_back(i);
-            rowsRight.push_back(rowIndices.front());
-        }
-    }
-
-    IVW_ASSERT(rowsLeft.size() == rowsRight.size(), "incorrect number of matching row indices");
-
-    auto dataframe = std::make_shared<DataFrame>();
-    detail::addColumns(dataframe, left, rowsLeft, {keyColumn}, false);
-    detail::addColumns(dataframe, right, rowsRight, {keyColumn}, true);
-
-    dataframe->updateIndexBuffer();
-    return dataframe;
+                                     const std::string& keyColumn, JoinAlgorithm algorithm) {
+    return innerJoin(left, right, std::vector<std::string>{keyColumn}, algorithm);
 }
 
 std::shared_ptr<DataFrame> innerJoin(const DataFrame& left, const DataFrame& right,
-                                     const std::vector<std::string>& keyColumns) {
+                                     const std::vector<std::string>& keyColumns,
+                                     JoinAlgorithm algorithm) {
     if (keyColumns.empty()) {
         throw Exception("no key columns given", IVW_CONTEXT_CUSTOM("dataframe::innerJoin"));
     }
@@ -386,11 +569,11 @@ std::shared_ptr<DataFrame> innerJoin(const DataFrame& left, const DataFrame& rig
 
     std::vector<size_t> rowsLeft;
     std::vector<size_t> rowsRight;
-    for (auto&& [i, rowIndices] :
-         util::enumerate(detail::getMatchingRows(left, right, keyColumns))) {
-        if (!rowIndices.empty()) {
+    for (auto&& [i, match] :
+         util::enumerate(detail::getMatchingRows(left, right, keyColumns, algorithm))) {
+        if (match) {
             rowsLeft.push_back(i);
-            rowsRight.push_back(rowIndices.front());
+            rowsRight.push_back(*match);
         }
     }
 
@@ -405,47 +588,22 @@ std::shared_ptr<DataFrame> innerJoin(const DataFrame& left, const DataFrame& rig
 }
 
 std::shared_ptr<DataFrame> leftJoin(const DataFrame& left, const DataFrame& right,
-                                    const std::string& keyColumn) {
-    detail::columnCheck(left, right, {keyColumn}, "dataframe::leftJoin");
-
-    auto indexCol1 = left.getColumn(keyColumn);
-    auto indexCol2 = right.getColumn(keyColumn);
-
-    auto rows = util::transform(detail::getMatchingRows<true>(indexCol1, indexCol2),
-                                [](const std::vector<size_t>& rowIndices) -> std::optional<size_t> {
-                                    if (rowIndices.empty()) {
-                                        return {};
-                                    } else {
-                                        return rowIndices.front();
-                                    }
-                                });
-
-    IVW_ASSERT(indexCol1->getSize() == rows.size(), "incorrect number of matching row indices");
-
-    auto dataframe = std::make_shared<DataFrame>();
-    detail::addColumns(dataframe, left, {keyColumn}, false);
-    detail::addColumns(dataframe, right, rows, {keyColumn}, true);
-
-    dataframe->updateIndexBuffer();
-    return dataframe;
+                                    const std::string& keyColumn, JoinAlgorithm algorithm) {
+    return leftJoin(left, right, std::vector<std::string>{keyColumn}, algorithm);
 }
 
 std::shared_ptr<DataFrame> leftJoin(const DataFrame& left, const DataFrame& right,
-                                    const std::vector<std::string>& keyColumns) {
+                                    const std::vector<std::string>& keyColumns,
+                                    JoinAlgorithm algorithm) {
     if (keyColumns.empty()) {
         throw Exception("no key columns given", IVW_CONTEXT_CUSTOM("dataframe::leftJoin"));
     }
 
     detail::columnCheck(left, right, keyColumns, "dataframe::leftJoin");
 
-    auto rows = util::transform(detail::getMatchingRows(left, right, keyColumns),
-                                [](const std::vector<size_t>& rowIndices) -> std::optional<size_t> {
-                                    if (rowIndices.empty()) {
-                                        return {};
-                                    } else {
-                                        return rowIndices.front();
-                                    }
-                                });
+    auto rows = detail::getMatchingRows(left, right, keyColumns, algorithm);
+
+    IVW_ASSERT(left.getNumberOfRows() == rows.size(), "incorrect number of matching row indices");
 
     auto dataframe = std::make_shared<DataFrame>();
     detail::addColumns(dataframe, left, keyColumns, false);
@@ -0,0 +1,107 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#ifdef _MSC_VER
+#pragma comment(linker, "/SUBSYSTEM:CONSOLE")
+#endif
+
+#include <inviwo/core/common/inviwo.h>
+#include <inviwo/core/ports/dataoutport.h>
+#include <inviwo/core/properties/ordinalproperty.h>
+#include <inviwo/dataframe/datastructures/dataframe.h>
+#include <inviwo/dataframe/processors/syntheticdataframe.h>
+#include <inviwo/dataframe/util/dataframeutil.h>
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+
+#include <warn/push>
+#include <warn/ignore/unused-function>
+
+using namespace inviwo;
+
+namespace {
+
+std::shared_ptr<const DataFrame> createDataFrame(size_t rows) {
+    SyntheticDataFrame synthetic;
+    if (auto numRows =
+            dynamic_cast<IntSizeTProperty*>(synthetic.getPropertyByIdentifier("numRow"))) {
+        numRows->setMaxValue(std::max(rows, numRows->getMaxValue()));
+        numRows->set(rows);
+    }
+    synthetic.process();
+    return static_cast<DataOutport<DataFrame>*>(synthetic.getOutports().front())->getData();
+}
+
+void join(benchmark::State& state, std::vector<std::string> keys,
+          dataframe::JoinAlgorithm algorithm) {
+    const auto rows = static_cast<size_t>(state.range(0));
+    // same seed, hence all keys match
+    auto left = createDataFrame(rows);
+    auto right = createDataFrame(rows);
+
+    for (auto _ : state) {
+        auto result = dataframe::innerJoin(*left, *right, keys, algorithm);
+        state.counters["Matches"] = static_cast<double>(result->getNumberOfRows());
+        benchmark::ClobberMemory();
+    }
+    state.counters["Rows"] = static_cast<double>(rows);
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+}  // namespace
+
+static void HashJoinIndex(benchmark::State& state) {
+    join(state, {"index"}, dataframe::JoinAlgorithm::Hash);
+}
+static void SortMergeJoinIndex(benchmark::State& state) {
+    join(state, {"index"}, dataframe::JoinAlgorithm::SortMerge);
+}
+static void HashJoinComposite(benchmark::State& state) {
+    join(state, {"Column 1", "Column 2"}, dataframe::JoinAlgorithm::Hash);
+}
+static void SortMergeJoinComposite(benchmark::State& state) {
+    join(state, {"Column 1", "Column 2"}, dataframe::JoinAlgorithm::SortMerge);
+}
+
+BENCHMARK(HashJoinIndex)->RangeMultiplier(10)->Range(1000, 1000000);
+BENCHMARK(SortMergeJoinIndex)->RangeMultiplier(10)->Range(1000, 1000000);
+BENCHMARK(HashJoinComposite)->RangeMultiplier(10)->Range(1000, 1000000);
+BENCHMARK(SortMergeJoinComposite)->RangeMultiplier(10)->Range(1000, 1000000);
+
+int main(int argc, char** argv) {
+
+    benchmark::Initialize(&argc, argv);
+    benchmark::RunSpecifiedBenchmarks();
+
+    return 0;
+}
+
+#include <warn/pop>
@@ -36,6 +36,9 @@
 #include <inviwo/dataframe/io/csvreader.h>
 
 #include <sstream>
+#include <cstdio>
+
+#include <fmt/format.h>
 
 namespace inviwo {
 
@@ -465,4 +468,89 @@ TEST(CSVlinebreaks, mixed) {
     ASSERT_EQ(4, dataframe->getNumberOfRows()) << "row count does not match";
 }
 
+namespace {
+
+std::string writeTempFile(util::TempFileHandle& file, const std::string& contents) {
+    std::fwrite(contents.data(), sizeof(char), contents.size(), file.getHandle());
+    std::fflush(file.getHandle());
+    return file.getFileName();
+}
+
+}  // namespace
+
+TEST(CSVfile, byteOrderMark) {
+    util::TempFileHandle tmpFile("", ".csv");
+    const auto filename = writeTempFile(tmpFile, "\xef\xbb\xbf" "1,2,3");
+
+    CSVReader reader;
+    reader.setFirstRowHeader(false);
+    auto dataframe = reader.readData(filename);
+
+    ASSERT_EQ(4, dataframe->getNumberOfColumns()) << "column count does not match";
+    ASSERT_EQ(1, dataframe->getNumberOfRows()) << "row count does not match";
+    EXPECT_EQ("1", dataframe->getColumn(1)->get(0, true)->toString()) << "Column 1";
+}
+
+TEST(CSVfile, matchesStream) {
+    std::string contents = "int,float,category,\"quoted\"\r\n";
+    for (int i = 0; i < 20000; ++i) {
+        contents += fmt::format("{},{},cat {},\"multi\r\nline, {}\"\r\n", i - 1000, i * 0.25,
+                                i % 7, i % 3);
+        if (i % 1000 == 0) contents += "\r\n,,,\n";
+    }
+
+    util::TempFileHandle tmpFile("", ".csv");
+    const auto filename = writeTempFile(tmpFile, contents);
+
+    CSVReader reader;
+    reader.setEnableDoublePrecision(true);
+    auto fromFile = reader.readData(filename);
+    std::istringstream ss(contents);
+    auto fromStream = reader.readData(ss);
+
+    ASSERT_EQ(5, fromFile->getNumberOfColumns()) << "column count does not match";
+    ASSERT_EQ(20000, fromFile->getNumberOfRows()) << "row count does not match";
+    ASSERT_EQ(fromStream->getNumberOfColumns(), fromFile->getNumberOfColumns());
+    ASSERT_EQ(fromStream->getNumberOfRows(), fromFile->getNumberOfRows());
+
+    EXPECT_EQ(DataFormatId::Int32, fromFile->getColumn(1)->getBuffer()->getDataFormat()->getId());
+    EXPECT_EQ(DataFormatId::Float64,
+              fromFile->getColumn(2)->getBuffer()->getDataFormat()->getId());
+    for (size_t row = 0; row < fromFile->getNumberOfRows(); row += 997) {
+        for (size_t col = 1; col < fromFile->getNumberOfColumns(); ++col) {
+            EXPECT_EQ(fromStream->getColumn(col)->getAsString(row),
+                      fromFile->getColumn(col)->getAsString(row))
+                << "row " << row << ", column " << col;
+        }
+    }
+    EXPECT_EQ("\"multi\nline, 1\"", fromFile->getColumn(4)->getAsString(1));
+    EXPECT_EQ(-1000.0, fromFile->getColumn(1)->getAsDouble(0));
+    EXPECT_EQ(0.25 * 19999, fromFile->getColumn(2)->getAsDouble(19999));
+}
+
+TEST(CSVdata, dataTypeMismatch) {
+    std::istringstream ss("1,2\n3,4\nfive,6");
+
+    CSVReader reader;
+    reader.setFirstRowHeader(false);
+    EXPECT_THROW(reader.readData(ss), inviwo::DataTypeMismatch);
+}
+
+TEST(CSVdata, dataTypeMismatchAfterExampleRows) {
+    // the column types are derived from the first 50 rows, the mismatch is on line 57
+    std::string data;
+    for (int i = 0; i < 55; ++i) data += std::to_string(i) + ".5," + std::to_string(i) + "\n";
+    data += "\n56.5,x56\n";
+    std::istringstream ss(data);
+
+    CSVReader reader;
+    reader.setFirstRowHeader(false);
+    try {
+        reader.readData(ss);
+        FAIL() << "Expected DataTypeMismatch, x56 is not a valid integer";
+    } catch (const DataTypeMismatch& e) {
+        EXPECT_NE(std::string::npos, e.getMessage().find("(line 57)")) << e.getMessage();
+    }
+}
+
 }  // namespace inviwo
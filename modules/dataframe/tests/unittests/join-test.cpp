@@ -385,4 +385,46 @@ TEST(LeftJoin, MultipleKeyColumns) {
                                {4.0f, 3.0f, 0.0f, 0.0f, 5.0f, 0.0f, 6.0f, 7.0f});
 }
 
+TEST(LeftJoin, MultipleKeyColumnsSortMerge) {
+    DataFrame left;
+    left.addColumnFromBuffer("int", util::makeBuffer(std::vector<int>{1, 1, 1, 2, 2, 4, 3, 1}));
+    left.addCategoricalColumn("cat", {"b", "a", "c", "b", "c", "a", "a", "d"});
+    left.updateIndexBuffer();
+
+    DataFrame right;
+    right.addColumnFromBuffer("float",
+                              util::makeBuffer(std::vector<float>{3.0f, 4.0f, 5.0f, 6.0f, 7.0f}));
+    right.addCategoricalColumn("cat", {"a", "b", "c", "a", "d"});
+    right.addColumnFromBuffer("int", util::makeBuffer(std::vector<int>{1, 1, 2, 3, 1}));
+    right.updateIndexBuffer();
+
+    auto dataframe = dataframe::leftJoin(left, right, std::vector<std::string>{"int", "cat"},
+                                         dataframe::JoinAlgorithm::SortMerge);
+    EXPECT_EQ(8, dataframe->getNumberOfRows()) << "left join should result in 8 rows";
+
+    checkColumnContents<float>(*dataframe->getColumn("float"),
+                               {4.0f, 3.0f, 0.0f, 0.0f, 5.0f, 0.0f, 6.0f, 7.0f});
+}
+
+TEST(InnerJoin, DuplicateKeys) {
+    DataFrame left;
+    left.addColumnFromBuffer("key", util::makeBuffer(std::vector<float>{2.0f, 7.0f, 1.0f, 2.0f}));
+    left.updateIndexBuffer();
+
+    DataFrame right;
+    right.addColumnFromBuffer("key",
+                              util::makeBuffer(std::vector<float>{1.0f, 2.0f, 1.0f, 2.0f, 3.0f}));
+    right.addColumnFromBuffer("int", util::makeBuffer(std::vector<int>{1, 2, 3, 4, 5}));
+    right.updateIndexBuffer();
+
+    for (auto algorithm : {dataframe::JoinAlgorithm::Hash, dataframe::JoinAlgorithm::SortMerge}) {
+        auto dataframe = dataframe::innerJoin(left, right, "key", algorithm);
+        EXPECT_EQ(3, dataframe->getNumberOfRows()) << "inner join should result in 3 rows";
+
+        // the first matching row of right is used
+        checkColumnContents<float>(*dataframe->getColumn("key"), {2.0f, 1.0f, 2.0f});
+        checkColumnContents<int>(*dataframe->getColumn("int"), {2, 1, 2});
+    }
+}
+
 }  // namespace inviwo
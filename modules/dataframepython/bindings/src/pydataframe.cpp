@@ -209,6 +209,10 @@ void exposeDataFrame(pybind11::module& m) {
 
     util::for_each_type<Scalars>{}(DataFrameAddColumnReg{}, dataframe);
 
+    py::enum_<dataframe::JoinAlgorithm>(m, "JoinAlgorithm")
+        .value("Hash", dataframe::JoinAlgorithm::Hash)
+        .value("SortMerge", dataframe::JoinAlgorithm::SortMerge);
+
     m.def("createDataFrame", createDataFrame, py::arg("exampleRows"),
           py::arg("colheaders") = std::vector<std::string>{}, py::arg("doubleprecision") = false,
           R"delim(
@@ -242,9 +246,10 @@ matchByName    if true, column headers are used for matching columns. Otherwise
                are matched by order (default)
 )delim")
         .def("innerJoin",
-             py::overload_cast<const DataFrame&, const DataFrame&, const std::string&>(
-                 dataframe::innerJoin),
+             py::overload_cast<const DataFrame&, const DataFrame&, const std::string&,
+                               dataframe::JoinAlgorithm>(dataframe::innerJoin),
              py::arg("left"), py::arg("right"), py::arg("keycolumn") = "index",
+             py::arg("algorithm") = dataframe::JoinAlgorithm::Hash,
              R"delim(
 Create a new DataFrame by using an inner join of DataFrame left and DataFrame right.
 That is only rows with matching keys are kept.
@@ -254,11 +259,13 @@ It is assumed that the entries in the key columns are unique. Otherwise results
 Parameters
 ----------
 keycolumn    header of the column used as key for the join operation (default: index column)
+algorithm    algorithm used for matching rows (default: JoinAlgorithm.Hash)
 )delim")
         .def("innerJoin",
-             py::overload_cast<const DataFrame&, const DataFrame&, const std::vector<std::string>&>(
-                 dataframe::innerJoin),
+             py::overload_cast<const DataFrame&, const DataFrame&, const std::vector<std::string>&,
+                               dataframe::JoinAlgorithm>(dataframe::innerJoin),
              py::arg("left"), py::arg("right"), py::arg("keycolumns"),
+             py::arg("algorithm") = dataframe::JoinAlgorithm::Hash,
              R"delim(
 Create a new DataFrame by using an inner join of DataFrame left and DataFrame right.
 That is only rows with matching all keys are kept.
@@ -268,11 +275,13 @@ It is assumed that the entries in the key columns are unique. Otherwise results
 Parameters
 ----------
 keycolumns    list of headers of the columns used as key for the join operation
+algorithm     algorithm used for matching rows (default: JoinAlgorithm.Hash)
 )delim")
         .def("innerJoin",
-             py::overload_cast<const DataFrame&, const DataFrame&, const std::string&>(
-                 dataframe::leftJoin),
+             py::overload_cast<const DataFrame&, const DataFrame&, const std::string&,
+                               dataframe::JoinAlgorithm>(dataframe::leftJoin),
              py::arg("left"), py::arg("right"), py::arg("keycolumn") = "index",
+             py::arg("algorithm") = dataframe::JoinAlgorithm::Hash,
              R"delim(
 Create a new DataFrame by using an outer left join of DataFrame left and DataFrame right.
 That is all rows of left are augmented with matching rows from right.
@@ -283,11 +292,13 @@ are undefined.
 Parameters
 ----------
 keycolumn    header of the column used as key for the join operation (default: index column)
+algorithm    algorithm used for matching rows (default: JoinAlgorithm.Hash)
 )delim")
         .def("leftJoin",
-             py::overload_cast<const DataFrame&, const DataFrame&, const std::vector<std::string>&>(
-                 dataframe::leftJoin),
+             py::overload_cast<const DataFrame&, const DataFrame&, const std::vector<std::string>&,
+                               dataframe::JoinAlgorithm>(dataframe::leftJoin),
              py::arg("left"), py::arg("right"), py::arg("keycolumns"),
+             py::arg("algorithm") = dataframe::JoinAlgorithm::Hash,
              R"delim(
 Create a new DataFrame by using an outer left join of DataFrame left and DataFrame right.
 That is all rows of left are augmented with matching rows from right.
@@ -298,6 +309,7 @@ are undefined.
 Parameters
 ----------
 keycolumns    list of headers of the columns used as key for the join operation
+algorithm     algorithm used for matching rows (default: JoinAlgorithm.Hash)
 )delim");
 
     exposeStandardDataPorts<DataFrame>(m, "DataFrame");
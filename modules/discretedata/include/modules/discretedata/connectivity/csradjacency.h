@@ -0,0 +1,102 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#pragma once
+
+#include <modules/discretedata/discretedatamoduledefine.h>
+#include <modules/discretedata/discretedatatypes.h>
+
+#include <vector>
+
+namespace inviwo {
+namespace discretedata {
+
+/**
+ * \brief Contiguous range of element indices, e.g. the row of a CSRAdjacency
+ * Only valid as long as the table it points into is.
+ */
+class IndexRange {
+public:
+    IndexRange() = default;
+    IndexRange(const ind* begin, const ind* end) : begin_(begin), end_(end) {}
+
+    const ind* begin() const { return begin_; }
+    const ind* end() const { return end_; }
+    ind size() const { return static_cast<ind>(end_ - begin_); }
+    bool empty() const { return begin_ == end_; }
+    ind operator[](ind i) const { return begin_[i]; }
+
+private:
+    const ind* begin_ = nullptr;
+    const ind* end_ = nullptr;
+};
+
+/**
+ * \brief Adjacency table in compressed sparse row form
+ * The elements adjacent to element i are indices[offsets[i]] up to indices[offsets[i + 1]]. All
+ * rows are stored in one contiguous array, iterating them does not allocate.
+ */
+struct CSRAdjacency {
+    std::vector<ind> offsets{0};
+    std::vector<ind> indices;
+
+    ind numRows() const { return static_cast<ind>(offsets.size()) - 1; }
+    ind rowSize(ind row) const { return offsets[row + 1] - offsets[row]; }
+    IndexRange operator[](ind row) const {
+        return {indices.data() + offsets[row], indices.data() + offsets[row + 1]};
+    }
+
+    template <typename It>
+    void addRow(It begin, It end) {
+        indices.insert(indices.end(), begin, end);
+        offsets.push_back(static_cast<ind>(indices.size()));
+    }
+
+    /**
+     * \brief The inverse relation, row j lists all rows that contain j, in increasing order
+     * @param numColumns Number of rows of the result, has to be larger than all indices
+     */
+    CSRAdjacency transposed(ind numColumns) const {
+        CSRAdjacency result;
+        result.offsets.assign(numColumns + 1, 0);
+        for (auto col : indices) ++result.offsets[col + 1];
+        for (ind col = 0; col < numColumns; ++col) {
+            result.offsets[col + 1] += result.offsets[col];
+        }
+        result.indices.resize(indices.size());
+        std::vector<ind> fill(result.offsets.begin(), result.offsets.end() - 1);
+        for (ind row = 0; row < numRows(); ++row) {
+            for (auto col : (*this)[row]) result.indices[fill[col]++] = row;
+        }
+        return result;
+    }
+};
+
+}  // namespace discretedata
+}  // namespace inviwo
@@ -0,0 +1,150 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#pragma once
+
+#include <modules/discretedata/discretedatamoduledefine.h>
+#include <modules/discretedata/connectivity/connectivity.h>
+#include <modules/discretedata/connectivity/csradjacency.h>
+
+#include <array>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace inviwo {
+
+class BufferRAM;
+class Mesh;
+
+namespace discretedata {
+
+/**
+ * \brief Explicit grid of linear cells, possibly of mixed type
+ * The cells are given by their vertex indices in VTK ordering, stored in compressed sparse row
+ * form. Supported are lines in 1D, triangles, quads and pixels in 2D and tetrahedra, hexahedra,
+ * voxels, wedges (prisms) and pyramids in 3D, all cells need to have the grid dimension.
+ *
+ * The edges and faces between cells, and the adjacency tables between all GridPrimitives, are
+ * created on first use and cached. This is thread safe. Use getAdjacency or getConnectionRange to
+ * iterate over neighborhoods without the copying done by getConnections.
+ */
+class IVW_MODULE_DISCRETEDATA_API UnstructuredGrid : public Connectivity {
+public:
+    /**
+     * \brief Create a grid of mixed cell types
+     * @param gridDimension Dimension of the cells
+     * @param numVertices Number of vertices, all vertex indices need to be smaller
+     * @param cellTypes Type of each cell
+     * @param cellOffsets Vertices of cell i start at cellOffsets[i], size numCells + 1
+     * @param cellVertices Vertex indices of all cells
+     * @throws Exception if the cells are not consistent
+     */
+    UnstructuredGrid(GridPrimitive gridDimension, ind numVertices, std::vector<CellType> cellTypes,
+                     std::vector<ind> cellOffsets, std::vector<ind> cellVertices);
+
+    /**
+     * \brief Create a grid with all cells of the same type
+     * @param cellType Type of all cells, defines the grid dimension
+     * @param numVertices Number of vertices, all vertex indices need to be smaller
+     * @param cellVertices Vertex indices of all cells, without gaps
+     * @throws Exception if the cells are not consistent
+     */
+    UnstructuredGrid(CellType cellType, ind numVertices, std::vector<ind> cellVertices);
+
+    virtual ~UnstructuredGrid() = default;
+
+    /**
+     * \brief Create a grid with all cells of the same type from an index buffer
+     * @param cellType Type of all cells
+     * @param indices Scalar integer buffer of vertex indices
+     * @param numVertices Number of vertices, all indices need to be smaller
+     */
+    static std::shared_ptr<UnstructuredGrid> fromBuffer(CellType cellType, const BufferRAM& indices,
+                                                        ind numVertices);
+
+    /**
+     * \brief Create a grid from the index buffers of a mesh
+     * Triangles become a 2D grid, lines a 1D grid. If the mesh has both, only the triangles are
+     * used. Strips, fans, loops and adjacency information are resolved.
+     * @throws Exception if the mesh has no lines or triangles
+     */
+    static std::shared_ptr<UnstructuredGrid> fromMesh(const Mesh& mesh);
+
+    virtual ind getNumElements(GridPrimitive elementType) const override;
+
+    virtual CellType getCellType(GridPrimitive dim, ind index) const override;
+
+    virtual void getConnections(std::vector<ind>& result, ind index, GridPrimitive from,
+                                GridPrimitive to, bool isPosition = false) const override;
+
+    /**
+     * \brief Table of all elements of dimension 'to' connected to the elements of dimension 'from'
+     * Cells are connected to other cells through a shared facet, vertices to other vertices
+     * through a shared edge, other elements to elements of the same dimension through shared
+     * elements one dimension lower.
+     */
+    const CSRAdjacency& getAdjacency(GridPrimitive from, GridPrimitive to) const;
+
+    //! Indices of the elements of dimension 'to' connected to element 'index' of dimension 'from'
+    IndexRange getConnectionRange(ind index, GridPrimitive from, GridPrimitive to) const {
+        return getAdjacency(from, to)[index];
+    }
+
+    //! Vertex indices of a cell
+    IndexRange getCellVertices(ind cell) const {
+        return getConnectionRange(cell, gridDimension_, GridPrimitive::Vertex);
+    }
+
+    //! Number of vertices of a linear cell of the given type, -1 if not supported
+    static ind numCellVertices(CellType type);
+
+    //! Dimension of a linear cell of the given type, GridPrimitive::Undef if not supported
+    static GridPrimitive cellDimension(CellType type);
+
+private:
+    static constexpr size_t maxDim = static_cast<size_t>(GridPrimitive::Volume) + 1;
+
+    void setCells(ind numVertices, std::vector<ind> cellOffsets, std::vector<ind> cellVertices);
+    void createElements(ind dim) const;
+    CSRAdjacency createAdjacency(ind from, ind to) const;
+    CSRAdjacency neighbors(ind dim, ind through) const;
+    CSRAdjacency incidentByVertices(ind from, ind to) const;
+
+    std::vector<CellType> cellTypes_;
+
+    // tables_[from * maxDim + to]. The cell vertices, the element vertices and the cell elements
+    // are filled by the constructor and createElements, the others with their tableFlags_.
+    mutable std::array<CSRAdjacency, maxDim * maxDim> tables_;
+    mutable std::array<std::once_flag, maxDim * maxDim> tableFlags_;
+    mutable std::array<std::once_flag, maxDim> elementFlags_;
+};
+
+}  // namespace discretedata
+}  // namespace inviwo
@@ -0,0 +1,324 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#pragma once
+
+#include <modules/discretedata/discretedatamoduledefine.h>
+#include <inviwo/core/common/inviwo.h>
+
+#include <modules/discretedata/channels/datachannel.h>
+#include <modules/discretedata/connectivity/cell.h>
+#include <modules/discretedata/connectivity/connectivity.h>
+#include <modules/discretedata/connectivity/csradjacency.h>
+#include <modules/discretedata/connectivity/structuredgrid.h>
+#include <inviwo/core/util/exception.h>
+#include <inviwo/core/util/formatdispatching.h>
+#include <inviwo/core/util/glm.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include <fmt/format.h>
+
+namespace inviwo {
+namespace discretedata {
+
+/**
+ * \brief Split of a linear cell into triangles (2D) or tetrahedra (3D)
+ * Lists the local vertex indices of each simplex, VTK vertex ordering is assumed for all cells but
+ * Pixel and Voxel. Empty for unsupported cell types.
+ */
+IVW_MODULE_DISCRETEDATA_API const std::vector<std::vector<ind>>& simplexDecomposition(
+    CellType type);
+
+/**
+ * \brief Copy a channel with N components into vectors of doubles
+ * @throws Exception if the channel does not have N components or is not scalar
+ */
+template <unsigned int N>
+std::vector<Vector<N, double>> channelToVectors(const Channel& channel);
+
+/**
+ * \brief Point location in the cells of a Connectivity
+ * The cells are split into simplices and sorted into a uniform grid over their bounding boxes,
+ * with about one cell per grid bin. A query first tests the hint cell and its neighbors, which
+ * makes coherent queries, e.g. along an integral line, independent of the size of the grid.
+ * Supports the cells of StructuredGrid and of UnstructuredGrid in 2D and 3D.
+ */
+template <unsigned int N>
+class CellLocator {
+public:
+    static_assert(N == 2 || N == 3, "CellLocator supports 2D and 3D grids");
+    using Vec = Vector<N, double>;
+
+    struct Location {
+        ind cell = -1;
+        //! Vertices of the simplex containing the point
+        std::array<ind, N + 1> vertices{};
+        //! Barycentric coordinates of the point in the simplex
+        std::array<double, N + 1> weights{};
+
+        explicit operator bool() const { return cell >= 0; }
+    };
+
+    /**
+     * \brief Build the locator, the grid is only used during construction
+     * @param grid Connectivity of dimension N
+     * @param positions Position of each vertex of the grid
+     */
+    CellLocator(const Connectivity& grid, std::vector<Vec> positions);
+
+    /**
+     * \brief Find the cell containing pos
+     * @param pos Position to locate
+     * @param hint Cell to test first, usually the cell of the previous query
+     * @return Location with cell -1 if pos is outside of the grid
+     */
+    Location locate(const Vec& pos, ind hint = -1) const;
+
+    ind getNumCells() const { return static_cast<ind>(cellSimplices_.size()) - 1; }
+    ind getNumVertices() const { return static_cast<ind>(positions_.size()); }
+    const Vec& getMin() const { return min_; }
+    const Vec& getMax() const { return max_; }
+
+private:
+    bool testCell(ind cell, const Vec& pos, Location& location) const;
+
+    std::vector<Vec> positions_;
+    std::vector<std::array<ind, N + 1>> simplices_;
+    std::vector<ind> cellSimplices_{0};  // offsets into simplices_
+    CSRAdjacency cellNeighbors_;
+    CSRAdjacency bins_;  // cells overlapping each bin
+    Vector<N, ind> numBins_;
+    Vec min_;
+    Vec max_;
+    Vec binScale_;
+};
+
+namespace detail {
+
+template <unsigned int N>
+struct ChannelToVectors {
+    template <typename R, typename Format>
+    R operator()(const Channel& channel, std::vector<Vector<N, double>>& result) {
+        using T = typename Format::type;
+        const auto* typed = dynamic_cast<const DataChannel<T, N>*>(&channel);
+        if (!typed) {
+            throw Exception(fmt::format("Channel '{}' does not have {} components",
+                                        channel.getName(), N),
+                            IVW_CONTEXT_CUSTOM("discretedata::channelToVectors"));
+        }
+        result.resize(typed->size());
+        std::array<T, N> value;
+        for (ind i = 0; i < typed->size(); ++i) {
+            typed->fill(value, i);
+            for (unsigned int d = 0; d < N; ++d) {
+                util::glmcomp(result[i], d) = static_cast<double>(value[d]);
+            }
+        }
+    }
+};
+
+}  // namespace detail
+
+template <unsigned int N>
+std::vector<Vector<N, double>> channelToVectors(const Channel& channel) {
+    std::vector<Vector<N, double>> result;
+    dispatching::dispatch<void, dispatching::filter::Scalars>(
+        channel.getDataFormatId(), detail::ChannelToVectors<N>{}, channel, result);
+    return result;
+}
+
+template <unsigned int N>
+CellLocator<N>::CellLocator(const Connectivity& grid, std::vector<Vec> positions)
+    : positions_(std::move(positions)), min_{0.0}, max_{0.0}, binScale_{0.0} {
+    const auto dim = static_cast<GridPrimitive>(N);
+    if (grid.getDimension() != dim) {
+        throw Exception(fmt::format("Expected a {}D grid", N),
+                        IVW_CONTEXT_CUSTOM("CellLocator"));
+    }
+    // The vertices of the cells of a StructuredGrid are ordered like Voxels, not Hexahedra
+    const bool structured = dynamic_cast<const StructuredGrid*>(&grid) != nullptr;
+    const auto numCells = grid.getNumElements(dim);
+
+    std::vector<ind> vertices;
+    std::vector<std::pair<Vec, Vec>> bounds(numCells);
+    min_ = Vec{std::numeric_limits<double>::max()};
+    max_ = Vec{std::numeric_limits<double>::lowest()};
+    cellSimplices_.reserve(numCells + 1);
+    for (ind cell = 0; cell < numCells; ++cell) {
+        const auto type = structured ? (N == 3 ? CellType::Voxel : CellType::Pixel)
+                                     : grid.getCellType(dim, cell);
+        const auto& split = simplexDecomposition(type);
+        if (split.empty()) {
+            throw Exception(fmt::format("Unsupported cell type {}", static_cast<int>(type)),
+                            IVW_CONTEXT_CUSTOM("CellLocator"));
+        }
+        grid.getConnections(vertices, cell, dim, GridPrimitive::Vertex);
+        for (const auto& local : split) {
+            std::array<ind, N + 1> simplex;
+            for (unsigned int i = 0; i <= N; ++i) simplex[i] = vertices[local[i]];
+            simplices_.push_back(simplex);
+        }
+        cellSimplices_.push_back(static_cast<ind>(simplices_.size()));
+
+        auto& [cellMin, cellMax] = bounds[cell];
+        cellMin = cellMax = positions_[vertices[0]];
+        for (auto v : vertices) {
+            cellMin = glm::min(cellMin, positions_[v]);
+            cellMax = glm::max(cellMax, positions_[v]);
+        }
+        min_ = glm::min(min_, cellMin);
+        max_ = glm::max(max_, cellMax);
+
+        vertices.clear();
+        grid.getConnections(vertices, cell, dim, dim);
+        cellNeighbors_.addRow(vertices.begin(), vertices.end());
+        vertices.clear();
+    }
+    if (numCells == 0) return;
+
+    // Bins of about the size of the average cell, ignoring flat dimensions
+    const auto extent = max_ - min_;
+    double binVolume = 1.0;
+    int binDims = 0;
+    for (unsigned int d = 0; d < N; ++d) {
+        if (extent[d] > 0.0) {
+            binVolume *= extent[d];
+            ++binDims;
+        }
+    }
+    const double binSize =
+        binDims > 0 ? std::pow(binVolume / static_cast<double>(numCells), 1.0 / binDims) : 1.0;
+    for (unsigned int d = 0; d < N; ++d) {
+        numBins_[d] =
+            extent[d] > 0.0
+                ? std::clamp<ind>(static_cast<ind>(std::ceil(extent[d] / binSize)), 1, numCells)
+                : 1;
+        binScale_[d] = extent[d] > 0.0 ? static_cast<double>(numBins_[d]) / extent[d] : 0.0;
+    }
+
+    auto binIndex = [&](const Vec& pos) {
+        Vector<N, ind> bin;
+        for (unsigned int d = 0; d < N; ++d) {
+            bin[d] = std::clamp<ind>(static_cast<ind>((pos[d] - min_[d]) * binScale_[d]), 0,
+                                     numBins_[d] - 1);
+        }
+        return bin;
+    };
+    auto forEachBin = [&](ind cell, auto&& callback) {
+        const auto lo = binIndex(bounds[cell].first);
+        const auto hi = binIndex(bounds[cell].second);
+        Vector<N, ind> bin = lo;
+        while (true) {
+            ind linear = 0;
+            for (int d = N - 1; d >= 0; --d) linear = linear * numBins_[d] + bin[d];
+            callback(linear);
+            unsigned int d = 0;
+            for (; d < N; ++d) {
+                if (++bin[d] <= hi[d]) break;
+                bin[d] = lo[d];
+            }
+            if (d == N) break;
+        }
+    };
+
+    ind totalBins = 1;
+    for (unsigned int d = 0; d < N; ++d) totalBins *= numBins_[d];
+    bins_.offsets.assign(totalBins + 1, 0);
+    for (ind cell = 0; cell < numCells; ++cell) {
+        forEachBin(cell, [&](ind bin) { ++bins_.offsets[bin + 1]; });
+    }
+    for (ind bin = 0; bin < totalBins; ++bin) bins_.offsets[bin + 1] += bins_.offsets[bin];
+    bins_.indices.resize(bins_.offsets.back());
+    std::vector<ind> fill(bins_.offsets.begin(), bins_.offsets.end() - 1);
+    for (ind cell = 0; cell < numCells; ++cell) {
+        forEachBin(cell, [&](ind bin) { bins_.indices[fill[bin]++] = cell; });
+    }
+}
+
+template <unsigned int N>
+bool CellLocator<N>::testCell(ind cell, const Vec& pos, Location& location) const {
+    // Allow for rounding errors on shared faces
+    constexpr double eps = 1e-9;
+    for (auto s = cellSimplices_[cell]; s < cellSimplices_[cell + 1]; ++s) {
+        const auto& simplex = simplices_[s];
+        const auto& origin = positions_[simplex[0]];
+        Matrix<N, double> m;
+        for (unsigned int i = 0; i < N; ++i) m[i] = positions_[simplex[i + 1]] - origin;
+        const auto det = glm::determinant(m);
+        if (std::abs(det) <= std::numeric_limits<double>::min()) continue;
+
+        const auto lambda = glm::inverse(m) * (pos - origin);
+        double first = 1.0;
+        bool inside = true;
+        for (unsigned int i = 0; i < N; ++i) {
+            inside = inside && lambda[i] >= -eps;
+            first -= lambda[i];
+        }
+        if (inside && first >= -eps) {
+            location.cell = cell;
+            location.vertices = simplex;
+            location.weights[0] = first;
+            for (unsigned int i = 0; i < N; ++i) location.weights[i + 1] = lambda[i];
+            return true;
+        }
+    }
+    return false;
+}
+
+template <unsigned int N>
+auto CellLocator<N>::locate(const Vec& pos, ind hint) const -> Location {
+    Location location;
+    if (hint >= 0 && hint < getNumCells()) {
+        if (testCell(hint, pos, location)) return location;
+        for (auto neighbor : cellNeighbors_[hint]) {
+            if (testCell(neighbor, pos, location)) return location;
+        }
+    }
+
+    if (getNumCells() == 0) return location;
+    ind linear = 0;
+    for (int d = N - 1; d >= 0; --d) {
+        if (pos[d] < min_[d] || pos[d] > max_[d]) return location;
+        const auto bin = std::min(static_cast<ind>((pos[d] - min_[d]) * binScale_[d]),
+                                  numBins_[d] - 1);
+        linear = linear * numBins_[d] + bin;
+    }
+    for (auto cell : bins_[linear]) {
+        if (testCell(cell, pos, location)) return location;
+    }
+    return location;
+}
+
+}  // namespace discretedata
+}  // namespace inviwo
@@ -0,0 +1,219 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#pragma once
+
+#include <modules/discretedata/discretedatamoduledefine.h>
+#include <inviwo/core/common/inviwo.h>
+
+#include <modules/discretedata/dataset.h>
+#include <modules/discretedata/sampling/celllocator.h>
+#include <inviwo/core/datastructures/spatialdata.h>
+#include <inviwo/core/util/spatialsampler.h>
+
+#include <atomic>
+#include <memory>
+
+namespace inviwo {
+namespace discretedata {
+
+namespace detail {
+
+template <unsigned int N>
+class DataSetSpatialEntity : public SpatialEntity<N> {
+public:
+    using SpatialEntity<N>::SpatialEntity;
+    virtual DataSetSpatialEntity<N>* clone() const override {
+        return new DataSetSpatialEntity<N>(*this);
+    }
+};
+
+// Constructed before the SpatialSampler base, which keeps a reference to the entity
+template <unsigned int N>
+struct DataSetEntityHolder {
+    DataSetSpatialEntity<N> entity_;
+};
+
+}  // namespace detail
+
+/**
+ * \brief SpatialSampler for a channel of a DataSet
+ * Locates the cell containing a position using a CellLocator. Channels defined on vertices are
+ * interpolated linearly in the triangles or tetrahedra of the cell, channels defined on cells are
+ * constant per cell. Data space is the unit cube spanned by the bounding box of the vertex
+ * positions, like the texture space of a volume, the model matrix maps it to the positions.
+ *
+ * The cell of the last sample is used as the starting point of the next search, coherent samples,
+ * e.g. along an integral line, are thus found in constant time. The sampler can be used from
+ * several threads, the shared starting point is then just less effective.
+ */
+template <unsigned int SpatialDims, unsigned int DataDims, typename T = double>
+class DataSetSampler : private detail::DataSetEntityHolder<SpatialDims>,
+                       public SpatialSampler<SpatialDims, DataDims, T> {
+public:
+    using Vec = Vector<SpatialDims, double>;
+
+    /**
+     * \brief Build a locator for the grid of the data set and sample a channel of it
+     * @param dataSet Data set with an UnstructuredGrid or StructuredGrid of dimension SpatialDims
+     * @param positions Name of the vertex channel with SpatialDims components holding positions
+     * @param data Name of the channel with DataDims components to sample
+     * @param dataDefinedOn Either vertices or cells
+     * @throws Exception if a channel is missing or does not fit the grid
+     */
+    DataSetSampler(std::shared_ptr<const DataSet> dataSet, const std::string& positions,
+                   const std::string& data, GridPrimitive dataDefinedOn = GridPrimitive::Vertex);
+
+    /**
+     * \brief Sample a channel using an existing locator, e.g. to sample several channels of a
+     * data set while building the locator only once
+     */
+    DataSetSampler(std::shared_ptr<const CellLocator<SpatialDims>> locator, const Channel& data);
+
+    virtual ~DataSetSampler() = default;
+
+    const std::shared_ptr<const CellLocator<SpatialDims>>& getLocator() const { return locator_; }
+
+protected:
+    virtual Vector<DataDims, T> sampleDataSpace(const Vec& pos) const override;
+    virtual bool withinBoundsDataSpace(const Vec& pos) const override;
+
+private:
+    static std::shared_ptr<const CellLocator<SpatialDims>> createLocator(const DataSet& dataSet,
+                                                                          const std::string& name);
+    static const Channel& getChannel(const DataSet& dataSet, const std::string& name,
+                                     GridPrimitive definedOn);
+    static Matrix<SpatialDims + 1, float> modelMatrix(const CellLocator<SpatialDims>& locator);
+
+    typename CellLocator<SpatialDims>::Location locate(const Vec& pos) const;
+
+    std::shared_ptr<const DataSet> dataSet_;
+    std::shared_ptr<const CellLocator<SpatialDims>> locator_;
+    std::vector<Vector<DataDims, double>> data_;
+    bool perCell_;
+    Vec extent_;
+    mutable std::atomic<ind> lastCell_{-1};
+};
+
+template <unsigned int SpatialDims, unsigned int DataDims, typename T>
+DataSetSampler<SpatialDims, DataDims, T>::DataSetSampler(std::shared_ptr<const DataSet> dataSet,
+                                                         const std::string& positions,
+                                                         const std::string& data,
+                                                         GridPrimitive dataDefinedOn)
+    : DataSetSampler(createLocator(*dataSet, positions),
+                     getChannel(*dataSet, data, dataDefinedOn)) {
+    dataSet_ = std::move(dataSet);
+}
+
+template <unsigned int SpatialDims, unsigned int DataDims, typename T>
+DataSetSampler<SpatialDims, DataDims, T>::DataSetSampler(
+    std::shared_ptr<const CellLocator<SpatialDims>> locator, const Channel& data)
+    : detail::DataSetEntityHolder<SpatialDims>{
+          detail::DataSetSpatialEntity<SpatialDims>{modelMatrix(*locator)}}
+    , SpatialSampler<SpatialDims, DataDims, T>(this->entity_)
+    , locator_(std::move(locator))
+    , data_(channelToVectors<DataDims>(data))
+    , perCell_(data.getGridPrimitiveType() != GridPrimitive::Vertex)
+    , extent_(locator_->getMax() - locator_->getMin()) {
+
+    const auto expected = perCell_ ? locator_->getNumCells() : locator_->getNumVertices();
+    if (data.getGridPrimitiveType() != GridPrimitive::Vertex &&
+        data.getGridPrimitiveType() != static_cast<GridPrimitive>(SpatialDims)) {
+        throw Exception(fmt::format("Channel '{}' is neither defined on vertices nor on cells",
+                                    data.getName()),
+                        IVW_CONTEXT_CUSTOM("DataSetSampler"));
+    }
+    if (static_cast<ind>(data_.size()) != expected) {
+        throw Exception(fmt::format("Channel '{}' has {} elements, expected {}", data.getName(),
+                                    data_.size(), expected),
+                        IVW_CONTEXT_CUSTOM("DataSetSampler"));
+    }
+}
+
+template <unsigned int SpatialDims, unsigned int DataDims, typename T>
+auto DataSetSampler<SpatialDims, DataDims, T>::createLocator(const DataSet& dataSet,
+                                                             const std::string& name)
+    -> std::shared_ptr<const CellLocator<SpatialDims>> {
+    const auto& positions = getChannel(dataSet, name, GridPrimitive::Vertex);
+    return std::make_shared<CellLocator<SpatialDims>>(*dataSet.grid,
+                                                      channelToVectors<SpatialDims>(positions));
+}
+
+template <unsigned int SpatialDims, unsigned int DataDims, typename T>
+const Channel& DataSetSampler<SpatialDims, DataDims, T>::getChannel(const DataSet& dataSet,
+                                                                   const std::string& name,
+                                                                   GridPrimitive definedOn) {
+    if (auto channel = dataSet.getChannel(name, definedOn)) return *channel;
+    throw Exception(fmt::format("Data set has no channel '{}' on {}D elements", name,
+                                static_cast<ind>(definedOn)),
+                    IVW_CONTEXT_CUSTOM("DataSetSampler"));
+}
+
+template <unsigned int SpatialDims, unsigned int DataDims, typename T>
+Matrix<SpatialDims + 1, float> DataSetSampler<SpatialDims, DataDims, T>::modelMatrix(
+    const CellLocator<SpatialDims>& locator) {
+    Matrix<SpatialDims + 1, float> model{1.0f};
+    const auto extent = locator.getMax() - locator.getMin();
+    for (unsigned int d = 0; d < SpatialDims; ++d) {
+        model[d][d] = extent[d] > 0.0 ? static_cast<float>(extent[d]) : 1.0f;
+        model[SpatialDims][d] = static_cast<float>(locator.getMin()[d]);
+    }
+    return model;
+}
+
+template <unsigned int SpatialDims, unsigned int DataDims, typename T>
+auto DataSetSampler<SpatialDims, DataDims, T>::locate(const Vec& pos) const ->
+    typename CellLocator<SpatialDims>::Location {
+    const Vec position = locator_->getMin() + pos * extent_;
+    const auto location = locator_->locate(position, lastCell_.load(std::memory_order_relaxed));
+    if (location) lastCell_.store(location.cell, std::memory_order_relaxed);
+    return location;
+}
+
+template <unsigned int SpatialDims, unsigned int DataDims, typename T>
+Vector<DataDims, T> DataSetSampler<SpatialDims, DataDims, T>::sampleDataSpace(
+    const Vec& pos) const {
+    const auto location = locate(pos);
+    if (!location) return Vector<DataDims, T>{0};
+    if (perCell_) return static_cast<Vector<DataDims, T>>(data_[location.cell]);
+
+    Vector<DataDims, double> value{0.0};
+    for (unsigned int i = 0; i <= SpatialDims; ++i) {
+        value += location.weights[i] * data_[location.vertices[i]];
+    }
+    return static_cast<Vector<DataDims, T>>(value);
+}
+
+template <unsigned int SpatialDims, unsigned int DataDims, typename T>
+bool DataSetSampler<SpatialDims, DataDims, T>::withinBoundsDataSpace(const Vec& pos) const {
+    return static_cast<bool>(locate(pos));
+}
+
+}  // namespace discretedata
+}  // namespace inviwo
@@ -0,0 +1,465 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <modules/discretedata/connectivity/unstructuredgrid.h>
+
+#include <inviwo/core/datastructures/buffer/bufferram.h>
+#include <inviwo/core/datastructures/geometry/mesh.h>
+#include <inviwo/core/util/exception.h>
+#include <inviwo/core/util/formatdispatching.h>
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
+
+#include <fmt/format.h>
+#include <fmt/ostream.h>
+
+namespace inviwo {
+namespace discretedata {
+
+namespace {
+
+using LocalElements = std::vector<std::vector<ind>>;
+
+// Edges and faces of the linear cells, with the local vertex numbering of VTK
+struct CellTopology {
+    GridPrimitive dimension;
+    ind numVertices;
+    LocalElements edges;
+    LocalElements faces;
+};
+
+const CellTopology* cellTopology(CellType type) {
+    static const CellTopology line{GridPrimitive::Edge, 2, {}, {}};
+    static const CellTopology triangle{GridPrimitive::Face, 3, {{0, 1}, {1, 2}, {2, 0}}, {}};
+    static const CellTopology quad{
+        GridPrimitive::Face, 4, {{0, 1}, {1, 2}, {2, 3}, {3, 0}}, {}};
+    static const CellTopology pixel{
+        GridPrimitive::Face, 4, {{0, 1}, {1, 3}, {3, 2}, {2, 0}}, {}};
+    static const CellTopology tetra{GridPrimitive::Volume,
+                                    4,
+                                    {{0, 1}, {1, 2}, {2, 0}, {0, 3}, {1, 3}, {2, 3}},
+                                    {{0, 1, 3}, {1, 2, 3}, {2, 0, 3}, {0, 2, 1}}};
+    static const CellTopology hexahedron{
+        GridPrimitive::Volume,
+        8,
+        {{0, 1}, {1, 2}, {2, 3}, {3, 0}, {4, 5}, {5, 6}, {6, 7}, {7, 4}, {0, 4}, {1, 5}, {2, 6},
+         {3, 7}},
+        {{0, 4, 7, 3}, {1, 2, 6, 5}, {0, 1, 5, 4}, {3, 7, 6, 2}, {0, 3, 2, 1}, {4, 5, 6, 7}}};
+    static const CellTopology voxel{
+        GridPrimitive::Volume,
+        8,
+        {{0, 1}, {1, 3}, {3, 2}, {2, 0}, {4, 5}, {5, 7}, {7, 6}, {6, 4}, {0, 4}, {1, 5}, {2, 6},
+         {3, 7}},
+        {{0, 4, 6, 2}, {1, 3, 7, 5}, {0, 1, 5, 4}, {2, 6, 7, 3}, {0, 2, 3, 1}, {4, 5, 7, 6}}};
+    static const CellTopology wedge{
+        GridPrimitive::Volume,
+        6,
+        {{0, 1}, {1, 2}, {2, 0}, {3, 4}, {4, 5}, {5, 3}, {0, 3}, {1, 4}, {2, 5}},
+        {{0, 1, 2}, {3, 5, 4}, {0, 3, 4, 1}, {1, 4, 5, 2}, {2, 5, 3, 0}}};
+    static const CellTopology pyramid{
+        GridPrimitive::Volume,
+        5,
+        {{0, 1}, {1, 2}, {2, 3}, {3, 0}, {0, 4}, {1, 4}, {2, 4}, {3, 4}},
+        {{0, 3, 2, 1}, {0, 1, 4}, {1, 2, 4}, {2, 3, 4}, {3, 0, 4}}};
+
+    switch (type) {
+        case CellType::Line:
+            return &line;
+        case CellType::Triangle:
+            return &triangle;
+        case CellType::Quad:
+            return &quad;
+        case CellType::Pixel:
+            return &pixel;
+        case CellType::Tetra:
+            return &tetra;
+        case CellType::Hexahedron:
+            return &hexahedron;
+        case CellType::Voxel:
+            return &voxel;
+        case CellType::Wedge:
+            return &wedge;
+        case CellType::Pyramid:
+            return &pyramid;
+        default:
+            return nullptr;
+    }
+}
+
+const LocalElements& localElements(CellType type, ind dim) {
+    const auto* topology = cellTopology(type);
+    return dim == static_cast<ind>(GridPrimitive::Edge) ? topology->edges : topology->faces;
+}
+
+std::vector<ind> toIndices(const BufferRAM& buffer) {
+    return buffer.dispatch<std::vector<ind>, dispatching::filter::IntegerScalars>([](auto br) {
+        const auto& data = br->getDataContainer();
+        return std::vector<ind>(data.begin(), data.end());
+    });
+}
+
+// Resolve the connectivity of a mesh index buffer into separate lines or triangles
+void appendCells(std::vector<ind>& cells, const std::vector<std::uint32_t>& indices,
+                 Mesh::MeshInfo info) {
+    const auto n = indices.size();
+    if (info.dt == DrawType::Triangles) {
+        switch (info.ct) {
+            case ConnectivityType::None:
+                cells.insert(cells.end(), indices.begin(), indices.begin() + n / 3 * 3);
+                return;
+            case ConnectivityType::Strip:
+                for (size_t i = 0; i + 2 < n; ++i) {
+                    const size_t odd = i % 2;
+                    cells.insert(cells.end(), {indices[i + odd], indices[i + 1 - odd],
+                                               indices[i + 2]});
+                }
+                return;
+            case ConnectivityType::Fan:
+                for (size_t i = 1; i + 1 < n; ++i) {
+                    cells.insert(cells.end(), {indices[0], indices[i], indices[i + 1]});
+                }
+                return;
+            case ConnectivityType::Adjacency:
+                for (size_t i = 0; i + 5 < n; i += 6) {
+                    cells.insert(cells.end(), {indices[i], indices[i + 2], indices[i + 4]});
+                }
+                return;
+            default:
+                break;
+        }
+    } else if (info.dt == DrawType::Lines) {
+        switch (info.ct) {
+            case ConnectivityType::None:
+                cells.insert(cells.end(), indices.begin(), indices.begin() + n / 2 * 2);
+                return;
+            case ConnectivityType::Strip:
+            case ConnectivityType::Loop:
+                for (size_t i = 0; i + 1 < n; ++i) {
+                    cells.insert(cells.end(), {indices[i], indices[i + 1]});
+                }
+                if (info.ct == ConnectivityType::Loop && n > 2) {
+                    cells.insert(cells.end(), {indices[n - 1], indices[0]});
+                }
+                return;
+            case ConnectivityType::Adjacency:
+                for (size_t i = 0; i + 3 < n; i += 4) {
+                    cells.insert(cells.end(), {indices[i + 1], indices[i + 2]});
+                }
+                return;
+            case ConnectivityType::StripAdjacency:
+                for (size_t i = 1; i + 2 < n; ++i) {
+                    cells.insert(cells.end(), {indices[i], indices[i + 1]});
+                }
+                return;
+            default:
+                break;
+        }
+    }
+    throw Exception(fmt::format("Unsupported mesh connectivity {}", info.ct),
+                    IVW_CONTEXT_CUSTOM("UnstructuredGrid::fromMesh"));
+}
+
+}  // namespace
+
+ind UnstructuredGrid::numCellVertices(CellType type) {
+    const auto* topology = cellTopology(type);
+    return topology ? topology->numVertices : -1;
+}
+
+GridPrimitive UnstructuredGrid::cellDimension(CellType type) {
+    const auto* topology = cellTopology(type);
+    return topology ? topology->dimension : GridPrimitive::Undef;
+}
+
+UnstructuredGrid::UnstructuredGrid(GridPrimitive gridDimension, ind numVertices,
+                                   std::vector<CellType> cellTypes, std::vector<ind> cellOffsets,
+                                   std::vector<ind> cellVertices)
+    : Connectivity(gridDimension), cellTypes_(std::move(cellTypes)) {
+    setCells(numVertices, std::move(cellOffsets), std::move(cellVertices));
+}
+
+UnstructuredGrid::UnstructuredGrid(CellType cellType, ind numVertices,
+                                   std::vector<ind> cellVertices)
+    : Connectivity(cellDimension(cellType)) {
+    const auto n = numCellVertices(cellType);
+    if (n <= 0 || static_cast<ind>(cellVertices.size()) % n != 0) {
+        throw Exception(fmt::format("Number of vertices does not match cell type {}",
+                                    static_cast<int>(cellType)),
+                        IVW_CONTEXT_CUSTOM("UnstructuredGrid"));
+    }
+    const auto numCells = static_cast<ind>(cellVertices.size()) / n;
+    cellTypes_.assign(numCells, cellType);
+    std::vector<ind> offsets(numCells + 1);
+    for (ind i = 0; i <= numCells; ++i) offsets[i] = i * n;
+    setCells(numVertices, std::move(offsets), std::move(cellVertices));
+}
+
+void UnstructuredGrid::setCells(ind numVertices, std::vector<ind> cellOffsets,
+                                std::vector<ind> cellVertices) {
+    if (gridDimension_ < GridPrimitive::Edge || gridDimension_ > GridPrimitive::Volume) {
+        throw Exception("UnstructuredGrid supports 1D, 2D and 3D cells",
+                        IVW_CONTEXT_CUSTOM("UnstructuredGrid"));
+    }
+    if (cellOffsets.size() != cellTypes_.size() + 1 || cellOffsets.front() != 0 ||
+        cellOffsets.back() != static_cast<ind>(cellVertices.size())) {
+        throw Exception("Cell offsets do not match the cell types and vertices",
+                        IVW_CONTEXT_CUSTOM("UnstructuredGrid"));
+    }
+    for (size_t cell = 0; cell < cellTypes_.size(); ++cell) {
+        const auto size = cellOffsets[cell + 1] - cellOffsets[cell];
+        if (cellDimension(cellTypes_[cell]) != gridDimension_ ||
+            size != numCellVertices(cellTypes_[cell])) {
+            throw Exception(
+                fmt::format("Cell {} of type {} with {} vertices does not fit a {}D grid", cell,
+                            static_cast<int>(cellTypes_[cell]), size,
+                            static_cast<ind>(gridDimension_)),
+                IVW_CONTEXT_CUSTOM("UnstructuredGrid"));
+        }
+    }
+    if (std::any_of(cellVertices.begin(), cellVertices.end(),
+                    [&](ind v) { return v < 0 || v >= numVertices; })) {
+        throw Exception(fmt::format("Vertex index out of range [0, {})", numVertices),
+                        IVW_CONTEXT_CUSTOM("UnstructuredGrid"));
+    }
+
+    const auto dim = static_cast<size_t>(gridDimension_);
+    auto& cells = tables_[dim * maxDim];
+    cells.offsets = std::move(cellOffsets);
+    cells.indices = std::move(cellVertices);
+
+    numGridPrimitives_[static_cast<ind>(GridPrimitive::Vertex)] = numVertices;
+    numGridPrimitives_[dim] = static_cast<ind>(cellTypes_.size());
+}
+
+std::shared_ptr<UnstructuredGrid> UnstructuredGrid::fromBuffer(CellType cellType,
+                                                               const BufferRAM& indices,
+                                                               ind numVertices) {
+    return std::make_shared<UnstructuredGrid>(cellType, numVertices, toIndices(indices));
+}
+
+std::shared_ptr<UnstructuredGrid> UnstructuredGrid::fromMesh(const Mesh& mesh) {
+    std::vector<ind> triangles;
+    std::vector<ind> lines;
+    ind maxIndex = -1;
+    for (const auto& [info, buffer] : mesh.getIndexBuffers()) {
+        if (info.dt != DrawType::Triangles && info.dt != DrawType::Lines) continue;
+        const auto& indices = buffer->getRAMRepresentation()->getDataContainer();
+        appendCells(info.dt == DrawType::Triangles ? triangles : lines, indices, info);
+        if (!indices.empty()) {
+            maxIndex = std::max<ind>(maxIndex, *std::max_element(indices.begin(), indices.end()));
+        }
+    }
+    if (triangles.empty() && lines.empty()) {
+        throw Exception("Mesh has no triangles or lines",
+                        IVW_CONTEXT_CUSTOM("UnstructuredGrid::fromMesh"));
+    }
+    const ind numVertices = mesh.getNumberOfBuffers() > 0
+                                ? static_cast<ind>(mesh.getBuffer(0)->getSize())
+                                : maxIndex + 1;
+    if (!triangles.empty()) {
+        return std::make_shared<UnstructuredGrid>(CellType::Triangle, numVertices,
+                                                  std::move(triangles));
+    } else {
+        return std::make_shared<UnstructuredGrid>(CellType::Line, numVertices, std::move(lines));
+    }
+}
+
+ind UnstructuredGrid::getNumElements(GridPrimitive elementType) const {
+    const auto dim = static_cast<ind>(elementType);
+    if (dim > static_cast<ind>(GridPrimitive::Vertex) && dim < static_cast<ind>(gridDimension_)) {
+        createElements(dim);
+    }
+    return Connectivity::getNumElements(elementType);
+}
+
+CellType UnstructuredGrid::getCellType(GridPrimitive dim, ind index) const {
+    if (dim == gridDimension_) return cellTypes_[index];
+    switch (dim) {
+        case GridPrimitive::Vertex:
+            return CellType::Vertex;
+        case GridPrimitive::Edge:
+            return CellType::Line;
+        case GridPrimitive::Face:
+            return getAdjacency(dim, GridPrimitive::Vertex).rowSize(index) == 3 ? CellType::Triangle
+                                                                                : CellType::Quad;
+        default:
+            return CellType::EmptyCell;
+    }
+}
+
+void UnstructuredGrid::getConnections(std::vector<ind>& result, ind index, GridPrimitive from,
+                                      GridPrimitive to, bool) const {
+    const auto range = getConnectionRange(index, from, to);
+    result.assign(range.begin(), range.end());
+}
+
+const CSRAdjacency& UnstructuredGrid::getAdjacency(GridPrimitive from, GridPrimitive to) const {
+    const auto f = static_cast<ind>(from);
+    const auto t = static_cast<ind>(to);
+    const auto d = static_cast<ind>(gridDimension_);
+    if (f < 0 || t < 0 || f > d || t > d) {
+        throw Exception(fmt::format("No {}D elements in a {}D grid", std::max(f, t), d),
+                        IVW_CONTEXT_CUSTOM("UnstructuredGrid::getAdjacency"));
+    }
+
+    const auto index = static_cast<size_t>(f) * maxDim + static_cast<size_t>(t);
+    if (f == d && t == 0) return tables_[index];
+    if (f != t && (t == 0 || f == d) && f > 0 && t < d) {
+        // element vertices and cell elements
+        createElements(std::max(f, t) == d ? t : f);
+        return tables_[index];
+    }
+    std::call_once(tableFlags_[index], [&]() { tables_[index] = createAdjacency(f, t); });
+    return tables_[index];
+}
+
+void UnstructuredGrid::createElements(ind dim) const {
+    std::call_once(elementFlags_[static_cast<size_t>(dim)], [&]() {
+        const auto d = static_cast<size_t>(gridDimension_);
+        const auto& cells = tables_[d * maxDim];
+        const auto numCells = cells.numRows();
+
+        // Every local element of every cell, identified by its sorted vertices
+        struct Entry {
+            std::array<ind, 4> key;
+            ind slot;  // position in the cell elements table
+            ind cell;
+            ind local;
+        };
+        CSRAdjacency cellElements;
+        cellElements.offsets.resize(numCells + 1);
+        std::vector<Entry> entries;
+        for (ind cell = 0; cell < numCells; ++cell) {
+            const auto vertices = cells[cell];
+            const auto& locals = localElements(cellTypes_[cell], dim);
+            for (ind local = 0; local < static_cast<ind>(locals.size()); ++local) {
+                Entry entry{{}, static_cast<ind>(entries.size()), cell, local};
+                entry.key.fill(std::numeric_limits<ind>::max());
+                std::transform(locals[local].begin(), locals[local].end(), entry.key.begin(),
+                               [&](ind i) { return vertices[i]; });
+                std::sort(entry.key.begin(), entry.key.begin() + locals[local].size());
+                entries.push_back(entry);
+            }
+            cellElements.offsets[cell + 1] = static_cast<ind>(entries.size());
+        }
+        cellElements.indices.resize(entries.size());
+
+        std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) {
+            return a.key < b.key || (a.key == b.key && a.slot < b.slot);
+        });
+
+        // Elements are numbered in the order of their sorted vertices, the vertex order of an
+        // element is given by the first cell it appears in.
+        CSRAdjacency elementVertices;
+        ind numElements = 0;
+        for (size_t i = 0; i < entries.size(); ++i) {
+            const auto& entry = entries[i];
+            if (i == 0 || entry.key != entries[i - 1].key) {
+                const auto vertices = cells[entry.cell];
+                const auto& local = localElements(cellTypes_[entry.cell], dim)[entry.local];
+                for (auto v : local) elementVertices.indices.push_back(vertices[v]);
+                elementVertices.offsets.push_back(static_cast<ind>(elementVertices.indices.size()));
+                ++numElements;
+            }
+            cellElements.indices[entry.slot] = numElements - 1;
+        }
+
+        tables_[static_cast<size_t>(dim) * maxDim] = std::move(elementVertices);
+        tables_[d * maxDim + static_cast<size_t>(dim)] = std::move(cellElements);
+        numGridPrimitives_[dim] = numElements;
+    });
+}
+
+CSRAdjacency UnstructuredGrid::createAdjacency(ind from, ind to) const {
+    const auto d = static_cast<ind>(gridDimension_);
+    if (from == to) {
+        // vertices are neighbors through edges, all other elements through their facets
+        return neighbors(from, from == 0 ? 1 : from - 1);
+    } else if (from == 0 || to == d) {
+        // inverse of the element vertices or the cell elements
+        const auto& table = getAdjacency(GridPrimitive(to), GridPrimitive(from));
+        return table.transposed(getNumElements(GridPrimitive(from)));
+    } else {
+        // edges and faces in a 3D grid
+        return incidentByVertices(from, to);
+    }
+}
+
+CSRAdjacency UnstructuredGrid::neighbors(ind dim, ind through) const {
+    const auto& toShared = getAdjacency(GridPrimitive(dim), GridPrimitive(through));
+    const auto& fromShared = getAdjacency(GridPrimitive(through), GridPrimitive(dim));
+
+    CSRAdjacency result;
+    result.offsets.reserve(toShared.offsets.size());
+    result.indices.reserve(toShared.indices.size());
+    std::vector<ind> lastSeen(toShared.numRows(), -1);
+    for (ind elem = 0; elem < toShared.numRows(); ++elem) {
+        lastSeen[elem] = elem;
+        for (auto shared : toShared[elem]) {
+            for (auto neighbor : fromShared[shared]) {
+                if (lastSeen[neighbor] == elem) continue;
+                lastSeen[neighbor] = elem;
+                result.indices.push_back(neighbor);
+            }
+        }
+        result.offsets.push_back(static_cast<ind>(result.indices.size()));
+    }
+    return result;
+}
+
+CSRAdjacency UnstructuredGrid::incidentByVertices(ind from, ind to) const {
+    // An element is incident to another of lower dimension if it contains all of its vertices
+    const auto& fromVertices = getAdjacency(GridPrimitive(from), GridPrimitive::Vertex);
+    const auto& toVertices = getAdjacency(GridPrimitive(to), GridPrimitive::Vertex);
+    const auto& vertexTo = getAdjacency(GridPrimitive::Vertex, GridPrimitive(to));
+
+    CSRAdjacency result;
+    std::vector<ind> lastSeen(toVertices.numRows(), -1);
+    std::vector<ind> count(toVertices.numRows(), 0);
+    for (ind elem = 0; elem < fromVertices.numRows(); ++elem) {
+        const auto vertices = fromVertices[elem];
+        for (auto v : vertices) {
+            for (auto other : vertexTo[v]) {
+                if (lastSeen[other] != elem) {
+                    lastSeen[other] = elem;
+                    count[other] = 0;
+                }
+                const auto required = from > to ? toVertices.rowSize(other) : vertices.size();
+                if (++count[other] == required) result.indices.push_back(other);
+            }
+        }
+        result.offsets.push_back(static_cast<ind>(result.indices.size()));
+    }
+    return result;
+}
+
+}  // namespace discretedata
+}  // namespace inviwo
@@ -0,0 +1,72 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <modules/discretedata/sampling/celllocator.h>
+
+namespace inviwo {
+namespace discretedata {
+
+const std::vector<std::vector<ind>>& simplexDecomposition(CellType type) {
+    static const std::vector<std::vector<ind>> none{};
+    static const std::vector<std::vector<ind>> triangle{{0, 1, 2}};
+    static const std::vector<std::vector<ind>> quad{{0, 1, 2}, {0, 2, 3}};
+    static const std::vector<std::vector<ind>> pixel{{0, 1, 3}, {0, 3, 2}};
+    static const std::vector<std::vector<ind>> tetra{{0, 1, 2, 3}};
+    // Same split as used by euclidean::getMeasure, a central tetrahedron and four corners
+    static const std::vector<std::vector<ind>> voxel{
+        {0, 3, 5, 6}, {1, 0, 3, 5}, {0, 2, 6, 3}, {5, 3, 6, 7}, {4, 5, 6, 0}};
+    static const std::vector<std::vector<ind>> hexahedron{
+        {0, 2, 5, 7}, {1, 0, 2, 5}, {0, 3, 7, 2}, {5, 2, 7, 6}, {4, 5, 7, 0}};
+    static const std::vector<std::vector<ind>> wedge{{0, 1, 2, 3}, {1, 2, 3, 4}, {2, 3, 4, 5}};
+    static const std::vector<std::vector<ind>> pyramid{{0, 1, 2, 4}, {0, 2, 3, 4}};
+
+    switch (type) {
+        case CellType::Triangle:
+            return triangle;
+        case CellType::Quad:
+            return quad;
+        case CellType::Pixel:
+            return pixel;
+        case CellType::Tetra:
+            return tetra;
+        case CellType::Voxel:
+            return voxel;
+        case CellType::Hexahedron:
+            return hexahedron;
+        case CellType::Wedge:
+            return wedge;
+        case CellType::Pyramid:
+            return pyramid;
+        default:
+            return none;
+    }
+}
+
+}  // namespace discretedata
+}  // namespace inviwo
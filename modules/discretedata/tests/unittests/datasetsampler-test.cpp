@@ -0,0 +1,163 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <warn/push>
+#include <warn/ignore/all>
+#include <gtest/gtest.h>
+#include <warn/pop>
+
+#include <modules/discretedata/dataset.h>
+#include <modules/discretedata/channels/bufferchannel.h>
+#include <modules/discretedata/connectivity/structuredgrid.h>
+#include <modules/discretedata/connectivity/unstructuredgrid.h>
+#include <modules/discretedata/sampling/celllocator.h>
+#include <modules/discretedata/sampling/datasetsampler.h>
+
+#include <random>
+
+namespace inviwo {
+namespace discretedata {
+
+namespace {
+
+// A sheared box of n^3 hexahedra in VTK ordering
+std::shared_ptr<UnstructuredGrid> hexGrid(ind n, std::vector<dvec3>& positions) {
+    const auto vertex = [n](ind x, ind y, ind z) { return x + (n + 1) * (y + (n + 1) * z); };
+    for (ind z = 0; z <= n; ++z) {
+        for (ind y = 0; y <= n; ++y) {
+            for (ind x = 0; x <= n; ++x) {
+                const dvec3 p{x, y, z};
+                positions.push_back(dvec3{p.x + 0.3 * p.z, p.y, p.z + 0.2 * p.x} / double(n));
+            }
+        }
+    }
+    std::vector<ind> cells;
+    for (ind z = 0; z < n; ++z) {
+        for (ind y = 0; y < n; ++y) {
+            for (ind x = 0; x < n; ++x) {
+                cells.insert(cells.end(),
+                             {vertex(x, y, z), vertex(x + 1, y, z), vertex(x + 1, y + 1, z),
+                              vertex(x, y + 1, z), vertex(x, y, z + 1), vertex(x + 1, y, z + 1),
+                              vertex(x + 1, y + 1, z + 1), vertex(x, y + 1, z + 1)});
+            }
+        }
+    }
+    return std::make_shared<UnstructuredGrid>(CellType::Hexahedron,
+                                              static_cast<ind>(positions.size()), cells);
+}
+
+dvec3 linearField(const dvec3& p) { return {p.x + 2.0 * p.y - p.z, 3.0 * p.z, 1.0 - p.y}; }
+
+}  // namespace
+
+TEST(CellLocator, LocatesAllCellCenters) {
+    std::vector<dvec3> positions;
+    auto grid = hexGrid(4, positions);
+    CellLocator<3> locator(*grid, positions);
+    ASSERT_EQ(64, locator.getNumCells());
+
+    ind previous = -1;
+    for (ind cell = 0; cell < grid->getNumElements(GridPrimitive::Volume); ++cell) {
+        dvec3 center{0.0};
+        for (auto v : grid->getCellVertices(cell)) center += positions[v] / 8.0;
+
+        const auto location = locator.locate(center, previous);
+        ASSERT_TRUE(location);
+        EXPECT_EQ(cell, location.cell);
+        EXPECT_EQ(location.cell, locator.locate(center).cell);
+        previous = location.cell;
+
+        dvec3 interpolated{0.0};
+        for (size_t i = 0; i < 4; ++i) {
+            EXPECT_GE(location.weights[i], -1e-9);
+            interpolated += location.weights[i] * positions[location.vertices[i]];
+        }
+        EXPECT_NEAR(0.0, glm::distance(center, interpolated), 1e-9);
+    }
+
+    EXPECT_FALSE(locator.locate(dvec3{-0.1, 0.5, 0.5}));
+    EXPECT_FALSE(locator.locate(dvec3{0.05, 0.5, 0.9}));  // inside the bounds, outside the grid
+}
+
+TEST(DataSetSampler, ReproducesLinearField) {
+    std::vector<dvec3> positions;
+    auto grid = hexGrid(3, positions);
+
+    std::vector<double> rawPositions;
+    std::vector<double> rawData;
+    for (const auto& p : positions) {
+        const auto f = linearField(p);
+        rawPositions.insert(rawPositions.end(), {p.x, p.y, p.z});
+        rawData.insert(rawData.end(), {f.x, f.y, f.z});
+    }
+    auto dataSet = std::make_shared<DataSet>(grid);
+    dataSet->addChannel(std::make_shared<BufferChannel<double, 3>>(rawPositions, "Position"));
+    dataSet->addChannel(std::make_shared<BufferChannel<double, 3>>(rawData, "Velocity"));
+
+    DataSetSampler<3, 3, double> sampler(dataSet, "Position", "Velocity");
+    const auto model = dmat4{sampler.getModelMatrix()};
+
+    std::mt19937 gen(3);
+    std::uniform_real_distribution<double> dist(0.0, 1.0);
+    size_t inside = 0;
+    for (size_t i = 0; i < 200; ++i) {
+        const dvec3 pos{dist(gen), dist(gen), dist(gen)};
+        const dvec3 world{model * dvec4{pos, 1.0}};
+        if (!sampler.withinBounds(pos)) continue;
+        ++inside;
+        const auto value = sampler.sample(pos);
+        const auto expected = linearField(world);
+        EXPECT_NEAR(0.0, glm::distance(expected, value), 1e-4) << "at " << i;
+    }
+    EXPECT_GT(inside, 100);
+    EXPECT_FALSE(sampler.withinBounds(dvec3{0.5, 0.5, 1.5}));
+}
+
+TEST(DataSetSampler, CellData) {
+    auto grid = std::make_shared<StructuredGrid>(GridPrimitive::Face, std::vector<ind>{2, 2});
+    std::vector<double> rawPositions;
+    for (ind y = 0; y <= 2; ++y) {
+        for (ind x = 0; x <= 2; ++x) {
+            rawPositions.insert(rawPositions.end(), {double(x), double(y)});
+        }
+    }
+    auto dataSet = std::make_shared<DataSet>(grid);
+    dataSet->addChannel(std::make_shared<BufferChannel<double, 2>>(rawPositions, "Position"));
+    dataSet->addChannel(std::make_shared<BufferChannel<float, 1>>(
+        std::vector<float>{1.0f, 2.0f, 3.0f, 4.0f}, "Cell", GridPrimitive::Face));
+
+    DataSetSampler<2, 1, double> sampler(dataSet, "Position", "Cell", GridPrimitive::Face);
+    EXPECT_DOUBLE_EQ(1.0, sampler.sample(dvec2{0.2, 0.3}));
+    EXPECT_DOUBLE_EQ(2.0, sampler.sample(dvec2{0.7, 0.3}));
+    EXPECT_DOUBLE_EQ(3.0, sampler.sample(dvec2{0.2, 0.8}));
+    EXPECT_DOUBLE_EQ(4.0, sampler.sample(dvec2{0.7, 0.8}));
+}
+
+}  // namespace discretedata
+}  // namespace inviwo
@@ -0,0 +1,175 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <warn/push>
+#include <warn/ignore/all>
+#include <gtest/gtest.h>
+#include <warn/pop>
+
+#include <modules/discretedata/connectivity/structuredgrid.h>
+#include <modules/discretedata/connectivity/unstructuredgrid.h>
+
+#include <inviwo/core/datastructures/buffer/buffer.h>
+#include <inviwo/core/datastructures/buffer/bufferramprecision.h>
+#include <inviwo/core/datastructures/geometry/mesh.h>
+#include <inviwo/core/util/exception.h>
+
+#include <algorithm>
+
+namespace inviwo {
+namespace discretedata {
+
+namespace {
+
+std::vector<ind> sorted(IndexRange range) {
+    std::vector<ind> result(range.begin(), range.end());
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+}  // namespace
+
+TEST(UnstructuredGrid, TwoTetrahedra) {
+    UnstructuredGrid grid(CellType::Tetra, 5, {0, 1, 2, 3, 1, 2, 3, 4});
+
+    EXPECT_EQ(5, grid.getNumElements(GridPrimitive::Vertex));
+    EXPECT_EQ(9, grid.getNumElements(GridPrimitive::Edge));
+    EXPECT_EQ(7, grid.getNumElements(GridPrimitive::Face));
+    EXPECT_EQ(2, grid.getNumElements(GridPrimitive::Volume));
+
+    EXPECT_EQ(std::vector<ind>{1}, sorted(grid.getConnectionRange(0, GridPrimitive::Volume,
+                                                                   GridPrimitive::Volume)));
+    EXPECT_EQ((std::vector<ind>{0, 1}),
+              sorted(grid.getConnectionRange(2, GridPrimitive::Vertex, GridPrimitive::Volume)));
+    EXPECT_EQ((std::vector<ind>{1, 2, 3}),
+              sorted(grid.getConnectionRange(0, GridPrimitive::Vertex, GridPrimitive::Vertex)));
+
+    // exactly one face is shared by both cells
+    const auto& faceCells = grid.getAdjacency(GridPrimitive::Face, GridPrimitive::Volume);
+    ind shared = 0;
+    for (ind face = 0; face < faceCells.numRows(); ++face) {
+        const auto edges = grid.getConnectionRange(face, GridPrimitive::Face, GridPrimitive::Edge);
+        EXPECT_EQ(3, edges.size());
+        EXPECT_EQ(CellType::Triangle, grid.getCellType(GridPrimitive::Face, face));
+        if (faceCells.rowSize(face) == 2) ++shared;
+    }
+    EXPECT_EQ(1, shared);
+
+    std::vector<ind> vertices;
+    grid.getConnections(vertices, 1, GridPrimitive::Volume, GridPrimitive::Vertex);
+    EXPECT_EQ((std::vector<ind>{1, 2, 3, 4}), vertices);
+}
+
+TEST(UnstructuredGrid, MixedCells) {
+    // a unit cube hexahedron with a wedge on top, sharing the quad 4, 5, 6, 7
+    UnstructuredGrid grid(GridPrimitive::Volume, 10, {CellType::Hexahedron, CellType::Wedge},
+                          {0, 8, 14}, {0, 1, 2, 3, 4, 5, 6, 7, 4, 5, 8, 7, 6, 9});
+
+    const auto numEdges = grid.getNumElements(GridPrimitive::Edge);
+    const auto numFaces = grid.getNumElements(GridPrimitive::Face);
+    EXPECT_EQ(12 + 9 - 4, numEdges);
+    EXPECT_EQ(6 + 5 - 1, numFaces);
+    EXPECT_EQ(1, 10 - numEdges + numFaces - 2);  // Euler characteristic of a ball
+
+    EXPECT_EQ(CellType::Wedge, grid.getCellType(GridPrimitive::Volume, 1));
+    EXPECT_EQ(std::vector<ind>{0}, sorted(grid.getConnectionRange(1, GridPrimitive::Volume,
+                                                                   GridPrimitive::Volume)));
+    EXPECT_EQ(5, grid.getConnectionRange(1, GridPrimitive::Volume, GridPrimitive::Face).size());
+
+    // the edges of the shared face belong to three faces
+    const auto& edgeFaces = grid.getAdjacency(GridPrimitive::Edge, GridPrimitive::Face);
+    const auto& edgeVertices = grid.getAdjacency(GridPrimitive::Edge, GridPrimitive::Vertex);
+    for (ind edge = 0; edge < numEdges; ++edge) {
+        const auto v = sorted(edgeVertices[edge]);
+        const bool onShared =
+            std::all_of(v.begin(), v.end(), [](ind i) { return i >= 4 && i < 8; });
+        EXPECT_EQ(onShared ? 3 : 2, edgeFaces.rowSize(edge)) << "edge " << v[0] << ", " << v[1];
+    }
+}
+
+TEST(UnstructuredGrid, MatchesStructuredGrid) {
+    StructuredGrid structured(GridPrimitive::Volume, {3, 4, 2});
+    const auto numCells = structured.getNumElements(GridPrimitive::Volume);
+    const auto numVertices = structured.getNumElements(GridPrimitive::Vertex);
+
+    std::vector<ind> cellVertices;
+    std::vector<ind> connections;
+    for (ind cell = 0; cell < numCells; ++cell) {
+        structured.getConnections(connections, cell, GridPrimitive::Volume, GridPrimitive::Vertex);
+        cellVertices.insert(cellVertices.end(), connections.begin(), connections.end());
+    }
+    UnstructuredGrid grid(CellType::Voxel, numVertices, cellVertices);
+
+    for (auto [from, to, num] : {std::tuple{GridPrimitive::Volume, GridPrimitive::Volume, numCells},
+                                 {GridPrimitive::Vertex, GridPrimitive::Volume, numVertices},
+                                 {GridPrimitive::Vertex, GridPrimitive::Vertex, numVertices}}) {
+        for (ind i = 0; i < num; ++i) {
+            connections.clear();
+            structured.getConnections(connections, i, from, to);
+            std::sort(connections.begin(), connections.end());
+            EXPECT_EQ(connections, sorted(grid.getConnectionRange(i, from, to)))
+                << "from " << static_cast<ind>(from) << " to " << static_cast<ind>(to) << " index "
+                << i;
+        }
+    }
+}
+
+TEST(UnstructuredGrid, Import) {
+    auto buffer = std::make_shared<BufferRAMPrecision<std::uint16_t>>(
+        std::vector<std::uint16_t>{0, 1, 2, 2, 1, 3});
+    auto fromBuffer = UnstructuredGrid::fromBuffer(CellType::Triangle, *buffer, 4);
+    EXPECT_EQ(GridPrimitive::Face, fromBuffer->getDimension());
+    EXPECT_EQ(2, fromBuffer->getNumElements(GridPrimitive::Face));
+    EXPECT_EQ(5, fromBuffer->getNumElements(GridPrimitive::Edge));
+
+    Mesh mesh;
+    mesh.addBuffer(BufferType::PositionAttrib, util::makeBuffer(std::vector<vec3>(5)));
+    mesh.addIndices(Mesh::MeshInfo(DrawType::Triangles, ConnectivityType::Strip),
+                    util::makeIndexBuffer({0, 1, 2, 3, 4}));
+    mesh.addIndices(Mesh::MeshInfo(DrawType::Lines, ConnectivityType::None),
+                    util::makeIndexBuffer({0, 4}));
+    auto fromMesh = UnstructuredGrid::fromMesh(mesh);
+    EXPECT_EQ(5, fromMesh->getNumElements(GridPrimitive::Vertex));
+    EXPECT_EQ(3, fromMesh->getNumElements(GridPrimitive::Face));
+    // the second triangle of the strip has its winding flipped
+    const auto triangle = fromMesh->getCellVertices(1);
+    EXPECT_EQ((std::vector<ind>{2, 1, 3}), std::vector<ind>(triangle.begin(), triangle.end()));
+}
+
+TEST(UnstructuredGrid, InvalidCells) {
+    EXPECT_THROW(UnstructuredGrid(CellType::Tetra, 4, {0, 1, 2}), Exception);
+    EXPECT_THROW(UnstructuredGrid(CellType::Tetra, 3, {0, 1, 2, 3}), Exception);
+    EXPECT_THROW(UnstructuredGrid(CellType::Polyhedron, 4, {0, 1, 2, 3}), Exception);
+    EXPECT_THROW(UnstructuredGrid(GridPrimitive::Volume, 4, {CellType::Triangle}, {0, 3},
+                                  {0, 1, 2}),
+                 Exception);
+}
+
+}  // namespace discretedata
+}  // namespace inviwo
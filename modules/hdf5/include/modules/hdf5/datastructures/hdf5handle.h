@@ -47,6 +47,8 @@
 
 #include <limits>
 #include <functional>
+#include <mutex>
+#include <optional>
 #include <type_traits>
 #include <string>
 #include <vector>
@@ -79,13 +81,28 @@ public:
 
     Document getInfo() const;
 
+    /**
+     * The group of the handle. Hold hdf5::libraryMutex() while using it, and while using or
+     * destroying any HDF5 objects obtained from it.
+     */
     const H5::Group& getGroup() const;
 
     Handle* getHandleForPath(const std::string& path) const;
 
-    std::shared_ptr<Volume> getVolumeAtPathAsType(const Path& path,
-                                                  std::vector<Selection> selection,
-                                                  const DataFormatBase* type) const;
+    /**
+     * Create a volume of the \p selection of the data set at \p path. The volume only has a
+     * VolumeDisk representation, the data is read by a VolumeRAMLoader when it is first accessed.
+     * Until then the data range of the volume is the range of \p type.
+     * @param path absolute path of the data set
+     * @param selection the start, end and stride of each dimension of the data set, the
+     * fastest changing dimension first, see VolumeRAMLoader
+     * @param type the data format of the volume, if nullptr the format of the data set is used
+     * @param dataRange optional callback that is called with the range of the data after it has
+     * been read. Might be called from any thread.
+     */
+    std::shared_ptr<Volume> getVolumeAtPathAsType(
+        const Path& path, std::vector<Selection> selection, const DataFormatBase* type,
+        std::function<void(dvec2)> dataRange = nullptr) const;
 
     template <typename T>
     std::vector<T> getVectorAtPath(const Path& path) const;
@@ -103,12 +120,14 @@ private:
 
     std::string filename_;
     Path path_;
-    H5::Group data_;
+    // Always set, optional such that the group can be destroyed while holding the library lock
+    std::optional<H5::Group> data_;
 };
 
 template <typename T>
 std::vector<T> Handle::getVectorAtPath(const Path& path) const {
-    H5::DataSet ds = data_.openDataSet(path);
+    std::scoped_lock lock{libraryMutex()};
+    H5::DataSet ds = data_->openDataSet(path);
     size_t rank = ds.getSpace().getSimpleExtentNdims();
 
     hsize_t* dims = new hsize_t[rank];
@@ -131,7 +150,8 @@ std::vector<T> Handle::getVectorAtPath(const Path& path) const {
 
 template <typename T>
 std::vector<glm::tvec3<T, glm::defaultp>> Handle::getVectorOfVec3AtPath(const Path& path) const {
-    H5::DataSet ds = data_.openDataSet(path);
+    std::scoped_lock lock{libraryMutex()};
+    H5::DataSet ds = data_->openDataSet(path);
     size_t rank = ds.getSpace().getSimpleExtentNdims();
 
     if (rank != 2) throw Exception("Trying to read data with invalid rank");
@@ -39,6 +39,7 @@
 #include <H5Cpp.h>
 #include <warn/pop>
 
+#include <mutex>
 #include <vector>
 
 namespace inviwo {
@@ -59,6 +60,15 @@ IVW_MODULE_HDF5_API Paths findpaths(const H5::Group& grp, const Path& path,
 IVW_MODULE_HDF5_API bool isOfType(const H5::Group& grp, const std::string& type);
 IVW_MODULE_HDF5_API VolumeInfos getVolumeInfo(const H5::DataSet& ds, const Path& path);
 
+/**
+ * The HDF5 library is not thread safe, and VolumeRAMLoader reads data from any thread requesting
+ * it. All calls into HDF5, including creating, copying and destroying HDF5 objects, have to hold
+ * this lock. The functions of this module, like the ones above and the members of Handle, take
+ * the lock themselves, code using HDF5 directly, e.g. through Handle::getGroup, has to take it.
+ * The mutex is recursive such that the lock can be held while calling those functions.
+ */
+IVW_MODULE_HDF5_API std::recursive_mutex& libraryMutex();
+
 }  // namespace hdf5
 
 }  // namespace inviwo
@@ -0,0 +1,159 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#pragma once
+
+#include <modules/hdf5/hdf5moduledefine.h>
+#include <modules/hdf5/datastructures/hdf5handle.h>
+#include <modules/hdf5/datastructures/hdf5path.h>
+
+#include <inviwo/core/datastructures/diskrepresentation.h>
+#include <inviwo/core/datastructures/volume/volumerepresentation.h>
+#include <inviwo/core/util/glmvec.h>
+
+#include <array>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace inviwo {
+
+namespace hdf5 {
+
+/**
+ * \class VolumeRAMLoader
+ * \brief Loads a selection of a HDF5 data set into a VolumeRAM when it is first accessed.
+ *
+ * Used by Handle::getVolumeAtPathAsType for the VolumeDisk of the returned volume, hence no data
+ * is read until the VolumeRAM, or a representation converted from it, is requested. The
+ * selection is read in blocks of z-slices that are aligned with the chunks of the data set, such
+ * that every chunk is read and decompressed only once. The blocks are read one at a time on the
+ * calling thread while holding hdf5::libraryMutex(), since the HDF5 library is not thread safe.
+ *
+ * Use loadRegion to read a part of the selection, optionally with a stride, e.g. for a fast
+ * preview with reduced resolution before loading all of the data.
+ */
+class IVW_MODULE_HDF5_API VolumeRAMLoader : public DiskRepresentationLoader<VolumeRepresentation> {
+public:
+    /**
+     * @param filename the HDF5 file
+     * @param dataSet the absolute path of the data set in the file
+     * @param selection the start, end and stride of every dimension of the data set, the
+     * fastest changing dimension first. At most three dimensions can contain more than one
+     * element, starting from the slowest changing one they become the z, y, and x axis of the
+     * volume.
+     * @throws Exception if more than three dimensions contain more than one element
+     */
+    VolumeRAMLoader(std::string filename, Path dataSet, std::vector<Handle::Selection> selection);
+    virtual VolumeRAMLoader* clone() const override;
+    virtual ~VolumeRAMLoader() = default;
+
+    virtual std::shared_ptr<VolumeRepresentation> createRepresentation(
+        const VolumeRepresentation& src) const override;
+    virtual void updateRepresentation(std::shared_ptr<VolumeRepresentation> dest,
+                                      const VolumeRepresentation& src) const override;
+
+    /**
+     * The dimensions of the volume given by the selection
+     */
+    size3_t getDimensions() const;
+
+    /**
+     * Read the voxels of the selection in the box starting at \p offset with the size \p extent,
+     * taking every \p stride voxel along each axis. The result is converted to \p format and
+     * written to \p dest, which needs room for glm::compMul((extent + stride - 1) / stride) voxels
+     * linearized in x, then y, then z.
+     * @throws Exception if the region is outside of the selection or could not be read
+     */
+    void loadRegion(size3_t offset, size3_t extent, size3_t stride, const DataFormatBase* format,
+                    void* dest) const;
+
+    /**
+     * Set a callback that is called with the fraction of the data loaded while creating or
+     * updating a representation. Might be called from any thread.
+     */
+    void setProgressCallback(std::function<void(float)> progress);
+
+    /**
+     * Set a callback that is called with the minimum and maximum value of the data after a
+     * representation has been created or updated. The range is calculated while reading, hence
+     * this is cheap compared to a separate pass over the data. Might be called from any thread.
+     */
+    void setDataRangeCallback(std::function<void(dvec2)> dataRange);
+
+    /**
+     * A hyperslab of the data set in the order of HDF5, i.e. the slowest changing dimension
+     * first, and the dimension of the data set used for each axis of the volume, or -1.
+     */
+    struct Hyperslab {
+        std::vector<hsize_t> start;
+        std::vector<hsize_t> count;
+        std::vector<hsize_t> stride;
+        std::array<int, 3> axes;
+    };
+
+private:
+    void read(const Hyperslab& slab, const DataFormatBase* format, void* dest,
+              bool reportProgress) const;
+
+    std::string filename_;
+    Path dataSet_;
+    Hyperslab slab_;
+    std::function<void(float)> progress_;
+    std::function<void(dvec2)> dataRange_;
+};
+
+namespace detail {
+
+/**
+ * A part of a hyperslab along its slowest changing selected dimension
+ */
+struct Block {
+    hsize_t first;  ///< first element along the split dimension
+    hsize_t count;  ///< number of elements along the split dimension
+    size_t offset;  ///< offset into the destination in elements
+};
+
+/**
+ * Split \p slab along the slowest changing selected dimension into blocks of whole chunks of
+ * about \p bytesPerBlock bytes. Every block is a contiguous part of the destination.
+ * @param slab the hyperslab to split
+ * @param chunk the chunk size of the data set for each dimension, ones for contiguous data sets
+ * @param elementSize the size of one element in the destination
+ * @param bytesPerBlock the approximate size of a block, at least one slice is used per block
+ */
+IVW_MODULE_HDF5_API std::vector<Block> split(const VolumeRAMLoader::Hyperslab& slab,
+                                             const std::vector<hsize_t>& chunk,
+                                             size_t elementSize, size_t bytesPerBlock);
+
+}  // namespace detail
+
+}  // namespace hdf5
+
+}  // namespace inviwo
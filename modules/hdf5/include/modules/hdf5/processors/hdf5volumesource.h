@@ -44,6 +44,9 @@
 #include <inviwo/core/properties/compositeproperty.h>
 #include <inviwo/core/properties/stringproperty.h>
 
+#include <functional>
+#include <memory>
+
 namespace inviwo {
 
 namespace hdf5 {
@@ -51,7 +54,8 @@ namespace hdf5 {
 /** \docpage{org.inviwo.hdf5.ToVolume, HDF5 To Volume}
  * ![](org.inviwo.hdf5.ToVolume.png?classIdentifier=org.inviwo.hdf5.ToVolume)
  *
- * Load a volume from a HTF5 file handle
+ * Load a volume from a HTF5 file handle. The data is read when the volume is first used, in
+ * blocks aligned with the chunks of the data set, and the data range is updated once it is known.
  *
  * ### Inports
  *   * __inport__ HDF5 file handle
@@ -142,6 +146,7 @@ private:
     Inport inport_;
     VolumeOutport outport_;
     std::shared_ptr<Volume> volume_;
+    std::shared_ptr<std::function<void(dvec2)>> dataRangeLoaded_;
 
     OptionPropertyString volumeSelection_;
 
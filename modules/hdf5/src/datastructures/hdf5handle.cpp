@@ -30,23 +30,25 @@
  *********************************************************************************/
 
 #include <modules/hdf5/datastructures/hdf5handle.h>
+#include <modules/hdf5/io/hdf5volumeramloader.h>
 #include <inviwo/core/util/stdextensions.h>
 #include <inviwo/core/util/formatdispatching.h>
 #include <inviwo/core/util/raiiutils.h>
-#include <inviwo/core/datastructures/volume/volumeramprecision.h>
-
-#include <modules/base/algorithm/dataminmax.h>
+#include <inviwo/core/datastructures/volume/volumedisk.h>
 
 #include <algorithm>
+#include <mutex>
+#include <tuple>
 
 namespace inviwo {
 
 namespace hdf5 {
 
 namespace {
-H5::Group load(const std::string& filename, const std::string& path) {
+std::optional<H5::Group> load(const std::string& filename, const std::string& path) {
+    std::scoped_lock lock{libraryMutex()};
     H5::H5File hdfFile(filename, H5F_ACC_RDONLY);
-    return hdfFile.openGroup(path);
+    return std::optional<H5::Group>{hdfFile.openGroup(path)};
 }
 }  // namespace
 
@@ -66,9 +68,9 @@ Handle& Handle::operator=(Handle&& that) {
     if (this != &that) {
         filename_ = that.filename_;
         path_ = that.path_;
-        data_.close();
-        H5::H5File hdfFile(filename_, H5F_ACC_RDONLY);
-        data_ = hdfFile.openGroup(path_);
+        std::scoped_lock lock{libraryMutex()};
+        data_.reset();
+        data_ = load(filename_, path_);
     }
     return *this;
 }
@@ -77,14 +79,17 @@ Handle& Handle::operator=(const Handle& that) {
     if (this != &that) {
         filename_ = that.filename_;
         path_ = that.path_;
-        data_.close();
-        H5::H5File hdfFile(filename_, H5F_ACC_RDONLY);
-        data_ = hdfFile.openGroup(path_);
+        std::scoped_lock lock{libraryMutex()};
+        data_.reset();
+        data_ = load(filename_, path_);
     }
     return *this;
 }
 
-Handle::~Handle() { data_.close(); }
+Handle::~Handle() {
+    std::scoped_lock lock{libraryMutex()};
+    data_.reset();
+}
 
 Handle* Handle::getHandleForPath(const std::string& path) const {
     return new Handle(this->filename_, path_ + path);
@@ -125,101 +130,41 @@ double Handle::getMax(const DataFormatBase* type) const {
 
 std::shared_ptr<Volume> Handle::getVolumeAtPathAsType(const Path& path,
                                                       std::vector<Selection> selection,
-                                                      const DataFormatBase* type) const {
-
-    auto dataset = data_.openDataSet(path);
-    ::inviwo::util::OnScopeExit closedataset{[&]() { dataset.close(); }};
-
-    const H5::DataSpace dataSpace = dataset.getSpace();
-    const size_t rank = dataSpace.getSimpleExtentNdims();
-    if (selection.size() != rank) {
-        throw Exception("Selection not of the same rank as the data", IVW_CONTEXT);
-    }
-
-    std::vector<hsize_t> dataDimensions(rank);
-    dataSpace.getSimpleExtentDims(dataDimensions.data());
-    const hsize_t dataSize = dataSpace.getSelectNpoints();
-
-    std::vector<hsize_t> start(rank);
-    std::vector<hsize_t> count(rank);
-    std::vector<hsize_t> stride(rank);
-
-    /*
-     * Column major, i.e. the FIRST listed dimension is the fasted changing
-     * Inviwo, OpenGL, matlab, Fortran
-     *
-     * Row major, i.e. the LAST listed dimension is the fasted changing
-     * HDF, C/C++, Mathematica, Python
-     *
-     * Solution reverse all the dimension lists.
-     * Row major version of the selection to match the hdf row major dataDimensions.
-     */
-    std::reverse(selection.begin(), selection.end());
-
-    size3_t volumeDimensions(1);
-    int resRank = 0;
-    std::vector<hsize_t> memoryDimensions{1, 1, 1};
-
-    for (size_t i = 0; i < rank; ++i) {
-        start[i] = selection[i].start;
-        count[i] =
-            static_cast<hsize_t>((selection[i].end - selection[i].start) / selection[i].stride);
-        stride[i] = selection[i].stride;
-
-        if (count[i] > 1) {
-            if (resRank > 2) throw Exception("Invalid selection, resulting rank > 3", IVW_CONTEXT);
-            memoryDimensions[resRank] = count[i];
-            volumeDimensions[resRank] = count[i];
-            resRank++;
+                                                      const DataFormatBase* type,
+                                                      std::function<void(dvec2)> dataRange) const {
+    const auto [dataSetName, format, rank] = [&]() {
+        std::scoped_lock lock{libraryMutex()};
+        auto dataset = data_->openDataSet(path);
+        ::inviwo::util::OnScopeExit closedataset{[&]() { dataset.close(); }};
+
+        const size_t rank = dataset.getSpace().getSimpleExtentNdims();
+        if (selection.size() != rank) {
+            throw Exception("Selection not of the same rank as the data", IVW_CONTEXT);
         }
-    }
-
-    dataSpace.selectHyperslab(H5S_SELECT_SET, count.data(), start.data(), stride.data(), nullptr);
-
-    H5::DataSpace memorySpace(3, memoryDimensions.data());
-    memorySpace.selectAll();
-
-    hsize_t selectionSize = memorySpace.getSelectNpoints();
-
-    LogInfo("Data rank: " << rank << " dims " << joinString(dataDimensions, " x ") << " size "
-                          << dataSize << " selection " << dataSpace.getSelectNpoints()
-                          << " memory size " << memorySpace.getSelectNpoints() << " memory dim "
-                          << volumeDimensions);
-
-    const DataFormatBase* format = type ? type : util::getDataFormatFromDataSet(dataset);
-
-    // Reverse back the Column major
-    std::reverse(&volumeDimensions[0], &volumeDimensions[0] + volumeDimensions.length());
-    auto volumeram = createVolumeRAM(volumeDimensions, format);
-
-    auto minmax = volumeram->dispatch<std::pair<dvec4, dvec4>, dispatching::filter::Scalars>(
-        [&](auto vrprecision) {
-            using ValueType = ::inviwo::util::PrecisionValueType<decltype(vrprecision)>;
-
-            ValueType* data = vrprecision->getDataTyped();
-
-            try {
-                dataset.read(data, TypeMap<ValueType>::getType(), memorySpace, dataSpace);
-            } catch (H5::DataSetIException& e) {
-                throw Exception("HDF: unable to read data: " + e.getDetailMsg(), IVW_CONTEXT);
-            }
+        const DataFormatBase* format = type ? type : util::getDataFormatFromDataSet(dataset);
+        if (!format) {
+            throw Exception("Unsupported data type of " + path.toString(), IVW_CONTEXT);
+        }
+        return std::make_tuple(dataset.getObjName(), format, rank);
+    }();
 
-            auto res = ::inviwo::util::dataMinMax(data, selectionSize);
+    // Nothing is read until the data is accessed
+    auto loader = std::make_unique<VolumeRAMLoader>(filename_, Path(dataSetName),
+                                                    std::move(selection));
+    loader->setDataRangeCallback(std::move(dataRange));
+    const auto volumeDimensions = loader->getDimensions();
 
-            LogInfo("Read HDF volume type: " << DataFormat<ValueType>::str()
-                                             << " data range: " << res.first << ", " << res.second
-                                             << " file: " << dataset.getFileName());
+    LogInfo("Data rank: " << rank << " memory dim " << volumeDimensions << " type "
+                          << format->getString() << " file: " << filename_);
 
-            return res;
-        });
+    auto volumeDisk = std::make_shared<VolumeDisk>(filename_, volumeDimensions, format);
+    volumeDisk->setLoader(loader.release());
 
-    auto volume = std::make_shared<Volume>(volumeDimensions, format);
-    volume->dataMap_.dataRange.x = glm::compMin(minmax.first);
-    volume->dataMap_.dataRange.y = glm::compMax(minmax.second);
+    // The data range is not known until the data is read, use the range of the type until then
+    auto volume = std::make_shared<Volume>(volumeDisk);
+    volume->dataMap_.dataRange = dvec2{getMin(format), getMax(format)};
     volume->dataMap_.valueRange = volume->dataMap_.dataRange;
 
-    volume->addRepresentation(volumeram);
-
     return volume;
 }
 
@@ -229,7 +174,7 @@ const std::string Handle::classIdentifier = "org.inviwo.hdf5.handle";
 
 const std::string Handle::dataName = "HDF";
 
-const H5::Group& Handle::getGroup() const { return data_; }
+const H5::Group& Handle::getGroup() const { return *data_; }
 
 }  // namespace hdf5
 
@@ -35,6 +35,7 @@ namespace inviwo {
 namespace hdf5 {
 
 Paths findpaths(const H5::Group& grp, const Path& path, const std::string& type) {
+    std::scoped_lock lock{libraryMutex()};
     Paths paths;
 
     if (isOfType(grp, type)) {
@@ -53,6 +54,7 @@ Paths findpaths(const H5::Group& grp, const Path& path, const std::string& type)
 }
 
 VolumeInfos getVolumeInfo(const H5::DataSet& ds, const Path& path) {
+    std::scoped_lock lock{libraryMutex()};
     auto size = std::make_unique<hsize_t[]>(ds.getSpace().getSimpleExtentNdims());
     ds.getSpace().getSimpleExtentDims(size.get());
     int sub_densities = (int)size[0];
@@ -73,7 +75,13 @@ VolumeInfos getVolumeInfo(const H5::DataSet& ds, const Path& path) {
     return paths;
 }
 
+std::recursive_mutex& libraryMutex() {
+    static std::recursive_mutex mutex;
+    return mutex;
+}
+
 bool isOfType(const H5::Group& grp, const std::string& type) {
+    std::scoped_lock lock{libraryMutex()};
     bool result = false;
     try {
         if (grp.attrExists("type")) {
@@ -0,0 +1,321 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <modules/hdf5/io/hdf5volumeramloader.h>
+#include <modules/hdf5/hdf5types.h>
+#include <modules/hdf5/hdf5utils.h>
+
+#include <inviwo/core/datastructures/volume/volumeramprecision.h>
+#include <inviwo/core/util/formatdispatching.h>
+#include <inviwo/core/util/raiiutils.h>
+
+#include <modules/base/algorithm/dataminmax.h>
+
+#include <algorithm>
+#include <limits>
+#include <mutex>
+#include <numeric>
+
+#include <fmt/format.h>
+#include <fmt/ostream.h>
+
+namespace inviwo {
+
+namespace hdf5 {
+
+namespace {
+
+// Approximate size of the blocks read at once
+constexpr size_t blockSize = 16 * 1024 * 1024;
+
+// The open data set, has to be destroyed while holding the library lock
+struct Source {
+    H5::H5File file;
+    H5::DataSet dataSet;
+    std::vector<hsize_t> chunk;
+};
+
+std::unique_ptr<Source> open(const std::string& filename, const Path& path,
+                             const VolumeRAMLoader::Hyperslab& slab) {
+    std::scoped_lock lock{libraryMutex()};
+    try {
+        auto source = std::make_unique<Source>();
+        source->file = H5::H5File(filename, H5F_ACC_RDONLY);
+        source->dataSet = source->file.openDataSet(path);
+
+        const auto space = source->dataSet.getSpace();
+        const auto rank = static_cast<size_t>(space.getSimpleExtentNdims());
+        if (rank != slab.start.size()) {
+            throw Exception(fmt::format("Data set '{}' in '{}' has rank {}, expected {}",
+                                        path.toString(), filename, rank, slab.start.size()),
+                            IVW_CONTEXT_CUSTOM("hdf5::VolumeRAMLoader"));
+        }
+        std::vector<hsize_t> dims(rank);
+        space.getSimpleExtentDims(dims.data());
+        for (size_t i = 0; i < rank; ++i) {
+            if (slab.count[i] > 0 &&
+                slab.start[i] + (slab.count[i] - 1) * slab.stride[i] >= dims[i]) {
+                throw Exception(
+                    fmt::format("Selection is outside of data set '{}' in '{}'", path.toString(),
+                                filename),
+                    IVW_CONTEXT_CUSTOM("hdf5::VolumeRAMLoader"));
+            }
+        }
+
+        // Contiguous data sets have no alignment constraints, i.e. chunks of one element
+        source->chunk.assign(rank, 1);
+        const auto plist = source->dataSet.getCreatePlist();
+        if (plist.getLayout() == H5D_CHUNKED) {
+            plist.getChunk(static_cast<int>(rank), source->chunk.data());
+        }
+        return source;
+    } catch (const H5::Exception& e) {
+        throw Exception(fmt::format("HDF: unable to open '{}' in '{}': {}", path.toString(),
+                                    filename, e.getDetailMsg()),
+                        IVW_CONTEXT_CUSTOM("hdf5::VolumeRAMLoader"));
+    }
+}
+
+template <typename T>
+std::pair<dvec4, dvec4> readBlock(const Source& source, const VolumeRAMLoader::Hyperslab& slab,
+                                  const detail::Block& block, T* dest, bool calcMinMax) {
+    auto count = slab.count;
+    auto start = slab.start;
+    if (slab.axes[2] >= 0) {
+        count[slab.axes[2]] = block.count;
+        start[slab.axes[2]] += block.first * slab.stride[slab.axes[2]];
+    }
+    const auto elements =
+        std::accumulate(count.begin(), count.end(), hsize_t{1}, std::multiplies<hsize_t>());
+    if (elements == 0) {
+        return {dvec4{std::numeric_limits<double>::max()},
+                dvec4{std::numeric_limits<double>::lowest()}};
+    }
+
+    {
+        std::scoped_lock lock{libraryMutex()};
+        try {
+            H5::DataSpace fileSpace = source.dataSet.getSpace();
+            fileSpace.selectHyperslab(H5S_SELECT_SET, count.data(), start.data(),
+                                      slab.stride.data());
+            H5::DataSpace memorySpace(1, &elements);
+            source.dataSet.read(dest + block.offset, TypeMap<T>::getType(), memorySpace,
+                                fileSpace);
+        } catch (const H5::Exception& e) {
+            throw Exception("HDF: unable to read data: " + e.getDetailMsg(),
+                            IVW_CONTEXT_CUSTOM("hdf5::VolumeRAMLoader"));
+        }
+    }
+
+    if (!calcMinMax) return {dvec4{0.0}, dvec4{0.0}};
+    return ::inviwo::util::dataMinMax(dest + block.offset, static_cast<size_t>(elements));
+}
+
+struct Reader {
+    template <typename Result, typename Format>
+    Result operator()(const Source& source, const VolumeRAMLoader::Hyperslab& slab, void* dest,
+                      const std::function<void(float)>& progress,
+                      const std::function<void(dvec2)>& dataRange) {
+        using T = typename Format::type;
+        const auto data = static_cast<T*>(dest);
+        const auto blocks = detail::split(slab, source.chunk, sizeof(T), blockSize);
+        const bool calcMinMax = static_cast<bool>(dataRange);
+
+        // Read serially on the calling thread. This is called while the volume is locked, and
+        // the reads are serialized by the library lock anyway.
+        // Only scalar formats are supported, i.e. only the first component is used
+        dvec2 range{std::numeric_limits<double>::max(), std::numeric_limits<double>::lowest()};
+        for (size_t i = 0; i < blocks.size(); ++i) {
+            const auto res = readBlock(source, slab, blocks[i], data, calcMinMax);
+            range.x = std::min(range.x, res.first.x);
+            range.y = std::max(range.y, res.second.x);
+            if (progress) {
+                progress(static_cast<float>(i + 1) / static_cast<float>(blocks.size()));
+            }
+        }
+
+        if (calcMinMax && range.x <= range.y) dataRange(range);
+        return Result();
+    }
+};
+
+struct Creator {
+    template <typename Result, typename Format>
+    Result operator()(const VolumeRepresentation& src) {
+        return std::make_shared<VolumeRAMPrecision<typename Format::type>>(
+            src.getDimensions(), DataInit::Uninitialized, src.getSwizzleMask(),
+            src.getInterpolation(), src.getWrapping());
+    }
+};
+
+}  // namespace
+
+std::vector<detail::Block> detail::split(const VolumeRAMLoader::Hyperslab& slab,
+                                         const std::vector<hsize_t>& chunk, size_t elementSize,
+                                         size_t bytesPerBlock) {
+    const auto elements = std::accumulate(slab.count.begin(), slab.count.end(), hsize_t{1},
+                                          std::multiplies<hsize_t>());
+    const auto dim = slab.axes[2];
+    if (dim < 0 || elements == 0) return {Block{0, 0, 0}};
+
+    const auto n = slab.count[dim];
+    const auto sliceElements = elements / n;
+    const auto target = std::max<hsize_t>(1, bytesPerBlock / (sliceElements * elementSize));
+    const auto chunkOf = [&](hsize_t k) {
+        return (slab.start[dim] + k * slab.stride[dim]) / chunk[dim];
+    };
+
+    std::vector<Block> blocks;
+    for (hsize_t first = 0; first < n;) {
+        auto last = std::min(n, first + target);
+        while (last < n && chunkOf(last) == chunkOf(last - 1)) ++last;
+        blocks.push_back(Block{first, last - first, static_cast<size_t>(first * sliceElements)});
+        first = last;
+    }
+    return blocks;
+}
+
+VolumeRAMLoader::VolumeRAMLoader(std::string filename, Path dataSet,
+                                 std::vector<Handle::Selection> selection)
+    : filename_{std::move(filename)}, dataSet_{std::move(dataSet)}, slab_{} {
+
+    /*
+     * The selection is column major, i.e. the FIRST listed dimension is the fastest changing,
+     * like Inviwo, OpenGL, matlab and Fortran. HDF5 is row major, i.e. the LAST listed dimension
+     * is the fastest changing, like C/C++, Mathematica and Python. Hence reverse the selection.
+     */
+    std::reverse(selection.begin(), selection.end());
+
+    const auto rank = selection.size();
+    slab_.start.resize(rank);
+    slab_.count.resize(rank);
+    slab_.stride.resize(rank);
+    slab_.axes = {-1, -1, -1};
+
+    int resRank = 0;
+    for (size_t i = 0; i < rank; ++i) {
+        slab_.start[i] = selection[i].start;
+        slab_.count[i] =
+            static_cast<hsize_t>((selection[i].end - selection[i].start) / selection[i].stride);
+        slab_.stride[i] = selection[i].stride;
+
+        if (slab_.count[i] > 1) {
+            if (resRank > 2) throw Exception("Invalid selection, resulting rank > 3", IVW_CONTEXT);
+            slab_.axes[2 - resRank] = static_cast<int>(i);
+            resRank++;
+        }
+    }
+}
+
+VolumeRAMLoader* VolumeRAMLoader::clone() const { return new VolumeRAMLoader(*this); }
+
+size3_t VolumeRAMLoader::getDimensions() const {
+    size3_t dims{1};
+    for (size_t i = 0; i < 3; ++i) {
+        if (slab_.axes[i] >= 0) dims[i] = static_cast<size_t>(slab_.count[slab_.axes[i]]);
+    }
+    return dims;
+}
+
+void VolumeRAMLoader::setProgressCallback(std::function<void(float)> progress) {
+    progress_ = std::move(progress);
+}
+
+void VolumeRAMLoader::setDataRangeCallback(std::function<void(dvec2)> dataRange) {
+    dataRange_ = std::move(dataRange);
+}
+
+std::shared_ptr<VolumeRepresentation> VolumeRAMLoader::createRepresentation(
+    const VolumeRepresentation& src) const {
+    // All voxels will be overwritten, hence skip the initialization
+    auto volumeRAM =
+        dispatching::dispatch<std::shared_ptr<VolumeRAM>, dispatching::filter::Scalars>(
+            src.getDataFormat()->getId(), Creator{}, src);
+    updateRepresentation(volumeRAM, src);
+    return volumeRAM;
+}
+
+void VolumeRAMLoader::updateRepresentation(std::shared_ptr<VolumeRepresentation> dest,
+                                           const VolumeRepresentation& src) const {
+    auto volumeDst = std::static_pointer_cast<VolumeRAM>(dest);
+    if (getDimensions() != src.getDimensions()) {
+        throw Exception(fmt::format("The selection of '{}' has dimensions {} but the volume {}",
+                                    dataSet_.toString(), getDimensions(), src.getDimensions()),
+                        IVW_CONTEXT);
+    }
+    if (src.getDimensions() != volumeDst->getDimensions()) {
+        volumeDst->setDimensions(src.getDimensions());
+    }
+
+    read(slab_, src.getDataFormat(), volumeDst->getData(), true);
+
+    volumeDst->setSwizzleMask(src.getSwizzleMask());
+    volumeDst->setInterpolation(src.getInterpolation());
+    volumeDst->setWrapping(src.getWrapping());
+}
+
+void VolumeRAMLoader::loadRegion(size3_t offset, size3_t extent, size3_t stride,
+                                 const DataFormatBase* format, void* dest) const {
+    const auto dims = getDimensions();
+    if (glm::any(glm::equal(stride, size3_t{0})) ||
+        glm::any(glm::greaterThan(offset + extent, dims))) {
+        throw Exception(fmt::format("Invalid region, offset {} extent {} stride {} of a volume "
+                                    "with dimensions {}",
+                                    offset, extent, stride, dims),
+                        IVW_CONTEXT);
+    }
+
+    auto slab = slab_;
+    for (size_t i = 0; i < 3; ++i) {
+        const auto dim = slab.axes[i];
+        if (dim < 0) continue;
+        slab.start[dim] += offset[i] * slab.stride[dim];
+        slab.count[dim] = (extent[i] + stride[i] - 1) / stride[i];
+        slab.stride[dim] *= stride[i];
+    }
+    read(slab, format, dest, false);
+}
+
+void VolumeRAMLoader::read(const Hyperslab& slab, const DataFormatBase* format, void* dest,
+                           bool reportProgress) const {
+    auto source = open(filename_, dataSet_, slab);
+    ::inviwo::util::OnScopeExit close{[&source]() {
+        std::scoped_lock lock{libraryMutex()};
+        source.reset();
+    }};
+
+    dispatching::dispatch<void, dispatching::filter::Scalars>(
+        format->getId(), Reader{}, *source, slab, dest,
+        reportProgress ? progress_ : std::function<void(float)>{},
+        reportProgress ? dataRange_ : std::function<void(dvec2)>{});
+}
+
+}  // namespace hdf5
+
+}  // namespace inviwo
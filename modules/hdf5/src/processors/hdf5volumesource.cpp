@@ -30,11 +30,13 @@
 #include <modules/hdf5/processors/hdf5volumesource.h>
 #include <modules/hdf5/datastructures/hdf5handle.h>
 #include <modules/hdf5/datastructures/hdf5path.h>
+#include <inviwo/core/common/inviwoapplication.h>
 #include <inviwo/core/io/datareader.h>
 #include <inviwo/core/io/datareaderexception.h>
 #include <functional>
 #include <numeric>
 #include <limits>
+#include <mutex>
 
 namespace inviwo {
 
@@ -193,6 +195,7 @@ mat4 HDF5ToVolume::getBasisFromMeta(MetaData meta) {
 
     if (inport_.hasData()) {
         const auto data = inport_.getData();
+        std::scoped_lock lock{libraryMutex()};
         H5::DataSet dataset = data->getGroup().openDataSet(meta.path_);
         H5::DataSpace space = dataset.getSpace();
         int rank = space.getSimpleExtentNdims();
@@ -332,9 +335,22 @@ void HDF5ToVolume::makeVolume() {
                 }
             }();
 
-            volume_ = std::shared_ptr<Volume>(
-                data->getVolumeAtPathAsType(Path(data->getGroup().getObjName()) + volumeMeta.path_,
-                                            selection_.getSelection(), format));
+            // The volume is loaded when first accessed, update the data range once it is known.
+            // Volumes created earlier can not update the range since the callback is replaced.
+            dataRangeLoaded_ = std::make_shared<std::function<void(dvec2)>>(
+                [this](dvec2 range) { dataRange_.set(range); });
+            const auto groupName = [&]() {
+                std::scoped_lock lock{libraryMutex()};
+                return data->getGroup().getObjName();
+            }();
+            volume_ = data->getVolumeAtPathAsType(
+                Path(groupName) + volumeMeta.path_, selection_.getSelection(), format,
+                [callback = std::weak_ptr<std::function<void(dvec2)>>(dataRangeLoaded_)](
+                    dvec2 range) {
+                    dispatchFrontAndForget([callback, range]() {
+                        if (auto f = callback.lock()) (*f)(range);
+                    });
+                });
 
             dataRange_.set(volume_->dataMap_.dataRange);
             outport_.setData(volume_);
@@ -0,0 +1,197 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <warn/push>
+#include <warn/ignore/all>
+#include <gtest/gtest.h>
+#include <warn/pop>
+
+#include <modules/hdf5/io/hdf5volumeramloader.h>
+#include <modules/hdf5/hdf5types.h>
+#include <modules/hdf5/hdf5utils.h>
+
+#include <inviwo/core/datastructures/volume/volumedisk.h>
+#include <inviwo/core/datastructures/volume/volumeram.h>
+#include <inviwo/core/io/tempfilehandle.h>
+#include <inviwo/core/util/exception.h>
+#include <inviwo/core/util/formats.h>
+#include <inviwo/core/util/indexmapper.h>
+
+#include <cstdint>
+#include <mutex>
+#include <numeric>
+#include <vector>
+
+namespace inviwo {
+
+namespace {
+
+// A data set of 4 x 5 x 7 voxels, in HDF5 order 7 x 5 x 4, chunked in blocks of 3 z-slices. The
+// value of each voxel is its linear index.
+const size3_t fixtureDims{4, 5, 7};
+
+void writeFixture(const std::string& filename) {
+    std::scoped_lock lock{hdf5::libraryMutex()};
+    H5::H5File file(filename, H5F_ACC_TRUNC);
+    const hsize_t dims[3] = {7, 5, 4};
+    const hsize_t chunk[3] = {3, 5, 4};
+    H5::DataSpace space(3, dims);
+    H5::DSetCreatPropList plist;
+    plist.setChunk(3, chunk);
+    auto dataSet = file.createDataSet("data", H5::PredType::NATIVE_INT32, space, plist);
+    std::vector<std::int32_t> values(glm::compMul(fixtureDims));
+    std::iota(values.begin(), values.end(), 0);
+    dataSet.write(values.data(), H5::PredType::NATIVE_INT32);
+}
+
+std::vector<hdf5::Handle::Selection> fullSelection() {
+    return {{0, fixtureDims.x, 1}, {0, fixtureDims.y, 1}, {0, fixtureDims.z, 1}};
+}
+
+// A hyperslab of a 7 x 5 x 4 data set, in HDF5 order, with the given selection along z
+hdf5::VolumeRAMLoader::Hyperslab slabZ(hsize_t start, hsize_t count, hsize_t stride) {
+    return {{start, 0, 0}, {count, 5, 4}, {stride, 1, 1}, {2, 1, 0}};
+}
+
+void expectBlock(const hdf5::detail::Block& block, hsize_t first, hsize_t count, size_t offset) {
+    EXPECT_EQ(first, block.first);
+    EXPECT_EQ(count, block.count);
+    EXPECT_EQ(offset, block.offset);
+}
+
+}  // namespace
+
+TEST(HDF5VolumeRAMLoader, SplitAlignsBlocksWithChunks) {
+    // Two slices per block, extended to the end of the chunk of 3 slices
+    const auto blocks = hdf5::detail::split(slabZ(0, 7, 1), {3, 5, 4}, 4, 2 * 20 * 4);
+    ASSERT_EQ(3, blocks.size());
+    expectBlock(blocks[0], 0, 3, 0);
+    expectBlock(blocks[1], 3, 3, 60);
+    expectBlock(blocks[2], 6, 1, 120);
+}
+
+TEST(HDF5VolumeRAMLoader, SplitContiguous) {
+    const auto blocks = hdf5::detail::split(slabZ(0, 7, 1), {1, 1, 1}, 4, 2 * 20 * 4);
+    ASSERT_EQ(4, blocks.size());
+    expectBlock(blocks[0], 0, 2, 0);
+    expectBlock(blocks[1], 2, 2, 40);
+    expectBlock(blocks[2], 4, 2, 80);
+    expectBlock(blocks[3], 6, 1, 120);
+}
+
+TEST(HDF5VolumeRAMLoader, SplitStrided) {
+    // Slices 1, 3 and 5, where 3 and 5 are in the same chunk
+    const auto blocks = hdf5::detail::split(slabZ(1, 3, 2), {3, 5, 4}, 4, 1);
+    ASSERT_EQ(2, blocks.size());
+    expectBlock(blocks[0], 0, 1, 0);
+    expectBlock(blocks[1], 1, 2, 20);
+}
+
+TEST(HDF5VolumeRAMLoader, CreateRepresentation) {
+    util::TempFileHandle tmpFile("", ".h5");
+    writeFixture(tmpFile.getFileName());
+
+    hdf5::VolumeRAMLoader loader(tmpFile.getFileName(), hdf5::Path("/data"), fullSelection());
+    EXPECT_EQ(fixtureDims, loader.getDimensions());
+
+    float progress = 0.0f;
+    dvec2 range{0.0};
+    loader.setProgressCallback([&](float p) { progress = p; });
+    loader.setDataRangeCallback([&](dvec2 r) { range = r; });
+
+    VolumeDisk disk(fixtureDims, DataInt32::get());
+    auto rep = std::dynamic_pointer_cast<VolumeRAM>(loader.createRepresentation(disk));
+    ASSERT_TRUE(rep);
+    EXPECT_EQ(fixtureDims, rep->getDimensions());
+    EXPECT_EQ(1.0f, progress);
+    EXPECT_EQ(dvec2(0.0, 139.0), range);
+
+    const auto data = static_cast<const std::int32_t*>(rep->getData());
+    for (size_t i = 0; i < glm::compMul(fixtureDims); ++i) {
+        EXPECT_EQ(static_cast<std::int32_t>(i), data[i]) << "index: " << i;
+    }
+}
+
+TEST(HDF5VolumeRAMLoader, LoadStridedRegion) {
+    util::TempFileHandle tmpFile("", ".h5");
+    writeFixture(tmpFile.getFileName());
+
+    hdf5::VolumeRAMLoader loader(tmpFile.getFileName(), hdf5::Path("/data"), fullSelection());
+
+    const size3_t offset{1, 0, 1};
+    const size3_t extent{3, 5, 6};
+    const size3_t stride{2, 2, 3};
+    const size3_t dims{2, 3, 2};
+    std::vector<std::int32_t> region(glm::compMul(dims), -1);
+    loader.loadRegion(offset, extent, stride, DataInt32::get(), region.data());
+
+    const util::IndexMapper3D fixture(fixtureDims);
+    const util::IndexMapper3D im(dims);
+    for (size_t z = 0; z < dims.z; ++z) {
+        for (size_t y = 0; y < dims.y; ++y) {
+            for (size_t x = 0; x < dims.x; ++x) {
+                const auto pos = offset + size3_t{x, y, z} * stride;
+                EXPECT_EQ(static_cast<std::int32_t>(fixture(pos)), region[im(x, y, z)])
+                    << "voxel: " << x << ", " << y << ", " << z;
+            }
+        }
+    }
+
+    EXPECT_THROW(loader.loadRegion(offset, size3_t{4, 5, 6}, stride, DataInt32::get(),
+                                   region.data()),
+                 Exception);
+}
+
+TEST(HDF5VolumeRAMLoader, StridedSelection) {
+    util::TempFileHandle tmpFile("", ".h5");
+    writeFixture(tmpFile.getFileName());
+
+    // Every other voxel along x and z, starting at z = 1
+    hdf5::VolumeRAMLoader loader(tmpFile.getFileName(), hdf5::Path("/data"),
+                                 {{0, 4, 2}, {0, 5, 1}, {1, 7, 2}});
+    const size3_t dims{2, 5, 3};
+    EXPECT_EQ(dims, loader.getDimensions());
+
+    std::vector<std::int32_t> region(glm::compMul(dims), -1);
+    loader.loadRegion(size3_t{0}, dims, size3_t{1}, DataInt32::get(), region.data());
+
+    const util::IndexMapper3D fixture(fixtureDims);
+    const util::IndexMapper3D im(dims);
+    for (size_t z = 0; z < dims.z; ++z) {
+        for (size_t y = 0; y < dims.y; ++y) {
+            for (size_t x = 0; x < dims.x; ++x) {
+                const size3_t pos{2 * x, y, 1 + 2 * z};
+                EXPECT_EQ(static_cast<std::int32_t>(fixture(pos)), region[im(x, y, z)])
+                    << "voxel: " << x << ", " << y << ", " << z;
+            }
+        }
+    }
+}
+
+}  // namespace inviwo
@@ -112,10 +112,9 @@ void PersistenceDiagramPlotProcessor::process() {
         auto iCol = dataframe->getIndexColumn();
         auto& indexCol = iCol->getTypedBuffer()->getRAMRepresentation()->getDataContainer();
 
-        auto filteredIndicies = brushingPort_.getFilteredIndices();
         IndexBuffer indicies;
         auto& vec = indicies.getEditableRAMRepresentation()->getDataContainer();
-        vec.reserve(dfSize - filteredIndicies.size());
+        vec.reserve(dfSize - brushingPort_.getNumberOfFiltered());
 
         auto seq = util::sequence<uint32_t>(0, static_cast<uint32_t>(dfSize), 1);
         std::copy_if(seq.begin(), seq.end(), std::back_inserter(vec),
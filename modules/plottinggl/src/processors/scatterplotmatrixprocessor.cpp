@@ -201,10 +201,9 @@ void ScatterPlotMatrixProcessor::process() {
         auto iCol = dataframe->getIndexColumn();
         auto& indexCol = iCol->getTypedBuffer()->getRAMRepresentation()->getDataContainer();
 
-        auto brushedIndicies = brushing_.getFilteredIndices();
         indicies = std::make_unique<IndexBuffer>();
         auto& vec = indicies->getEditableRAMRepresentation()->getDataContainer();
-        vec.reserve(dfSize - brushedIndicies.size());
+        vec.reserve(dfSize - brushing_.getNumberOfFiltered());
 
         auto seq = util::sequence<uint32_t>(0, static_cast<uint32_t>(dfSize), 1);
         std::copy_if(seq.begin(), seq.end(), std::back_inserter(vec),
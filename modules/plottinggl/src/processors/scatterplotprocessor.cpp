@@ -141,10 +141,9 @@ void ScatterPlotProcessor::process() {
         auto iCol = dataframe->getIndexColumn();
         auto& indexCol = iCol->getTypedBuffer()->getRAMRepresentation()->getDataContainer();
 
-        auto brushedIndicies = brushingPort_.getFilteredIndices();
         IndexBuffer indicies;
         auto& vec = indicies.getEditableRAMRepresentation()->getDataContainer();
-        vec.reserve(dfSize - brushedIndicies.size());
+        vec.reserve(dfSize - brushingPort_.getNumberOfFiltered());
 
         auto seq = util::sequence<uint32_t>(0, static_cast<uint32_t>(dfSize), 1);
         std::copy_if(seq.begin(), seq.end(), std::back_inserter(vec),
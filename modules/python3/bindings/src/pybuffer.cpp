@@ -66,9 +66,10 @@ struct BufferRAMHelper {
                  py::arg("usage") = BufferUsage::Static)
             .def(py::init([](py::array data, BufferUsage usage) {
                      pyutil::checkDataFormat<1>(DataFormat::get(), data.shape(0), data);
+                     auto contiguous = py::array::ensure(data, py::array::c_style);
+                     auto begin = static_cast<const T*>(contiguous.data());
                      auto ram = std::make_shared<BufferRAMPrecision<T, BufferTarget::Data>>(
-                         data.shape(0), usage);
-                     memcpy(ram->getData(), data.data(0), data.nbytes());
+                         std::vector<T>(begin, begin + data.shape(0)), usage);
                      return new Buffer<T, BufferTarget::Data>(ram);
                  }),
                  py::arg("data"), py::arg("usage") = BufferUsage::Static);
@@ -80,9 +81,10 @@ struct BufferRAMHelper {
             .def(py::init<size_t, BufferUsage>())
             .def(py::init([](py::array data, BufferUsage usage) {
                      pyutil::checkDataFormat<1>(DataFormat::get(), data.shape(0), data);
+                     auto contiguous = py::array::ensure(data, py::array::c_style);
+                     auto begin = static_cast<const T*>(contiguous.data());
                      auto ram = std::make_shared<BufferRAMPrecision<T, BufferTarget::Index>>(
-                         data.shape(0), usage);
-                     memcpy(ram->getData(), data.data(0), data.nbytes());
+                         std::vector<T>(begin, begin + data.shape(0)), usage);
                      return new Buffer<T, BufferTarget::Index>(ram);
                  }),
                  py::arg("data"), py::arg("usage") = BufferUsage::Static);
@@ -132,25 +134,27 @@ void exposeBuffer(pybind11::module& m) {
         .def_property("size", &BufferBase::getSize, &BufferBase::setSize)
         .def_property(
             "data",
-            [&](BufferBase* buffer) -> py::array {
-                auto df = buffer->getDataFormat();
-                std::vector<size_t> shape = {buffer->getSize()};
-                std::vector<size_t> strides = {df->getSize()};
-
-                if (df->getComponents() > 1) {
-                    shape.push_back(df->getComponents());
-                    strides.push_back(df->getSize() / df->getComponents());
-                }
-
-                auto data = buffer->getEditableRepresentation<BufferRAM>()->getData();
-                return py::array(pyutil::toNumPyFormat(df), shape, strides, data, py::cast<>(1));
+            [](py::object self) -> py::array {
+                auto buffer = self.cast<BufferBase*>();
+                auto rep = buffer->getEditableRepresentation<BufferRAM>();
+                return pyutil::createArrayView(rep->getDataFormat(), {rep->getSize()},
+                                               rep->getData(), false, self);
             },
             [](BufferBase* buffer, py::array data) {
                 auto rep = buffer->getEditableRepresentation<BufferRAM>();
                 pyutil::checkDataFormat<1>(rep->getDataFormat(), rep->getSize(), data);
 
-                memcpy(rep->getData(), data.data(0), data.nbytes());
+                auto contiguous = py::array::ensure(data, py::array::c_style);
+                memcpy(rep->getData(), contiguous.data(), contiguous.nbytes());
             })
+        .def_property_readonly("readonlyData",
+                               [](py::object self) -> py::array {
+                                   auto buffer = self.cast<const BufferBase*>();
+                                   auto rep = buffer->getRepresentation<BufferRAM>();
+                                   return pyutil::createArrayView(rep->getDataFormat(),
+                                                                  {rep->getSize()},
+                                                                  rep->getData(), true, self);
+                               })
         .def("__repr__", [](const BufferBase& self) {
             return fmt::format("<Buffer: target = {} usage = {} format = {} size = {}>",
                                toString(self.getBufferTarget()), toString(self.getBufferUsage()),
@@ -161,27 +161,41 @@ void exposeImage(py::module& m) {
              })
         .def_property(
             "data",
-            [&](Layer* layer) -> py::array {
-                auto df = layer->getDataFormat();
-                auto dims = layer->getDimensions();
-
-                std::vector<size_t> shape = {dims.x, dims.y};
-                std::vector<size_t> strides = {df->getSize(), df->getSize() * dims.x};
-
-                if (df->getComponents() > 1) {
-                    shape.push_back(df->getComponents());
-                    strides.push_back(df->getSize() / df->getComponents());
-                }
-
-                auto data = layer->getEditableRepresentation<LayerRAM>()->getData();
-                return py::array(pyutil::toNumPyFormat(df), shape, strides, data, py::cast<>(1));
+            [](py::object self) -> py::array {
+                auto layer = self.cast<Layer*>();
+                auto rep = layer->getEditableRepresentation<LayerRAM>();
+                const auto dims = rep->getDimensions();
+                return pyutil::createArrayView(rep->getDataFormat(), {dims.x, dims.y},
+                                               rep->getData(), false, self);
             },
             [](Layer* layer, py::array data) {
-                auto rep = layer->getEditableRepresentation<LayerRAM>();
-                pyutil::checkDataFormat<2>(rep->getDataFormat(), rep->getDimensions(), data);
+                pyutil::checkDataFormat<2>(layer->getDataFormat(), layer->getDimensions(), data);
+
+                // Write into an existing RAM representation, arrays from the data getter might
+                // still view its memory
+                if (layer->hasRepresentation<LayerRAM>()) {
+                    auto rep = layer->getEditableRepresentation<LayerRAM>();
+                    pyutil::copyToRAM(data, 2, rep->getData());
+                    return;
+                }
 
-                memcpy(rep->getData(), data.data(0), data.nbytes());
+                // Otherwise use the data of the array directly if possible instead of copying it
+                auto ram = pyutil::createLayerRAM(data, layer->getLayerType());
+                ram->setSwizzleMask(layer->getSwizzleMask());
+                ram->setInterpolation(layer->getInterpolation());
+                ram->setWrapping(layer->getWrapping());
+                layer->addRepresentation(ram);
+                layer->removeOtherRepresentations(ram.get());
             })
+        .def_property_readonly("readonlyData",
+                               [](py::object self) -> py::array {
+                                   auto layer = self.cast<const Layer*>();
+                                   auto rep = layer->getRepresentation<LayerRAM>();
+                                   const auto dims = rep->getDimensions();
+                                   return pyutil::createArrayView(rep->getDataFormat(),
+                                                                  {dims.x, dims.y},
+                                                                  rep->getData(), true, self);
+                               })
         .def("__repr__", [](const Layer& self) {
             return fmt::format(
                 "<Layer:\n  type = {}\n  format = {}\n  dimensions = {}\n  swizzlemask = {}>",
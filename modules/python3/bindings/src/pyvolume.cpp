@@ -74,28 +74,41 @@ void exposeVolume(pybind11::module& m) {
         .def_readwrite("dataMap", &Volume::dataMap_)
         .def_property(
             "data",
-            [&](Volume* volume) -> py::array {
-                auto df = volume->getDataFormat();
-                auto dims = volume->getDimensions();
-
-                std::vector<size_t> shape = {dims.x, dims.y, dims.z};
-                std::vector<size_t> strides = {df->getSize(), df->getSize() * dims.x,
-                                               df->getSize() * dims.x * dims.y};
-
-                if (df->getComponents() > 1) {
-                    shape.push_back(df->getComponents());
-                    strides.push_back(df->getSize() / df->getComponents());
-                }
-
-                auto data = volume->getEditableRepresentation<VolumeRAM>()->getData();
-                return py::array(pyutil::toNumPyFormat(df), shape, strides, data, py::cast<>(1));
+            [](py::object self) -> py::array {
+                auto volume = self.cast<Volume*>();
+                auto rep = volume->getEditableRepresentation<VolumeRAM>();
+                const auto dims = rep->getDimensions();
+                return pyutil::createArrayView(rep->getDataFormat(), {dims.x, dims.y, dims.z},
+                                               rep->getData(), false, self);
             },
             [](Volume* volume, py::array data) {
-                auto rep = volume->getEditableRepresentation<VolumeRAM>();
-                pyutil::checkDataFormat<3>(rep->getDataFormat(), rep->getDimensions(), data);
+                pyutil::checkDataFormat<3>(volume->getDataFormat(), volume->getDimensions(), data);
+
+                // Write into an existing RAM representation, arrays from the data getter might
+                // still view its memory
+                if (volume->hasRepresentation<VolumeRAM>()) {
+                    auto rep = volume->getEditableRepresentation<VolumeRAM>();
+                    pyutil::copyToRAM(data, 3, rep->getData());
+                    return;
+                }
 
-                memcpy(rep->getData(), data.data(0), data.nbytes());
+                // Otherwise use the data of the array directly if possible instead of copying it
+                auto ram = pyutil::createVolumeRAM(data);
+                ram->setSwizzleMask(volume->getSwizzleMask());
+                ram->setInterpolation(volume->getInterpolation());
+                ram->setWrapping(volume->getWrapping());
+                volume->addRepresentation(ram);
+                volume->removeOtherRepresentations(ram.get());
             })
+        .def_property_readonly("readonlyData",
+                               [](py::object self) -> py::array {
+                                   auto volume = self.cast<const Volume*>();
+                                   auto rep = volume->getRepresentation<VolumeRAM>();
+                                   const auto dims = rep->getDimensions();
+                                   return pyutil::createArrayView(rep->getDataFormat(),
+                                                                  {dims.x, dims.y, dims.z},
+                                                                  rep->getData(), true, self);
+                               })
         .def("__repr__", [](const Volume& volume) {
             std::ostringstream oss;
             oss << "<Volume:\n  dimensions = " << volume.getDimensions()
@@ -41,6 +41,7 @@
 #include <warn/pop>
 
 #include <inviwo/core/common/inviwoapplication.h>
+#include <inviwo/core/datastructures/image/imagetypes.h>
 #include <inviwo/core/network/processornetwork.h>
 #include <inviwo/core/processors/processor.h>
 #include <inviwo/core/util/formats.h>
@@ -50,16 +51,61 @@ namespace inviwo {
 
 class BufferBase;
 class Layer;
+class LayerRAM;
 class Volume;
+class VolumeRAM;
 
 namespace pyutil {
 
 IVW_MODULE_PYTHON3_API pybind11::dtype toNumPyFormat(const DataFormatBase* df);
 IVW_MODULE_PYTHON3_API const DataFormatBase* getDataFormat(size_t components, pybind11::array& arr);
 IVW_MODULE_PYTHON3_API std::unique_ptr<BufferBase> createBuffer(pybind11::array& arr);
+
+/**
+ * Returns arr if its memory can be used as is for the data of a representation, otherwise a C
+ * contiguous copy. The memory of C contiguous arrays, and of arrays laid out like the ones
+ * returned by createArrayView, is used as is. Note that Inviwo stores the first dimension
+ * fastest, so for a C contiguous array arr[i, j, k] is not voxel (i, j, k). Use a Fortran ordered
+ * array, e.g. from numpy.asfortranarray, for that.
+ */
+IVW_MODULE_PYTHON3_API pybind11::array toContiguous(pybind11::array arr, size_t spatialDims);
+
+/**
+ * Copy the data of arr into dest, see toContiguous for how the data is laid out. Nothing is
+ * copied if arr already views dest. dest has to have room for all the data of arr.
+ */
+IVW_MODULE_PYTHON3_API void copyToRAM(pybind11::array arr, size_t spatialDims, void* dest);
+
+/**
+ * Create a LayerRAM with the dimensions given by the first two axes of arr, see toContiguous for
+ * how the data is laid out. The data of writeable and aligned arrays that can be used as is, is
+ * used without copying, in which case the layer and the array share the same memory and the
+ * array is kept alive by the layer. Other arrays are copied.
+ */
+IVW_MODULE_PYTHON3_API std::shared_ptr<LayerRAM> createLayerRAM(
+    pybind11::array& arr, LayerType layerType = LayerType::Color);
 IVW_MODULE_PYTHON3_API std::unique_ptr<Layer> createLayer(pybind11::array& arr);
+
+/**
+ * Create a VolumeRAM with the dimensions given by the first three axes of arr, see toContiguous
+ * for how the data is laid out. The data of writeable and aligned arrays that can be used as is,
+ * is used without copying, in which case the volume and the array share the same memory and the
+ * array is kept alive by the volume. Other arrays are copied.
+ */
+IVW_MODULE_PYTHON3_API std::shared_ptr<VolumeRAM> createVolumeRAM(pybind11::array& arr);
 IVW_MODULE_PYTHON3_API std::unique_ptr<Volume> createVolume(pybind11::array& arr);
 
+/**
+ * Create a NumPy array viewing data without copying. dims are the dimensions of the data with the
+ * first dimension varying fastest, for formats with more than one component an extra last
+ * dimension is added for the components. The array keeps owner alive, which should be the python
+ * object owning the data. If readOnly is true, the array is marked as not writeable.
+ */
+IVW_MODULE_PYTHON3_API pybind11::array createArrayView(const DataFormatBase* format,
+                                                       const std::vector<size_t>& dims,
+                                                       const void* data, bool readOnly,
+                                                       pybind11::handle owner);
+
 template <int Dim>
 void checkDataFormat(const DataFormatBase* format, const Vector<Dim, size_t>& dim,
                      const pybind11::array& data) {
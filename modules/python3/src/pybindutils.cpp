@@ -46,8 +46,12 @@
 #include <inviwo/core/datastructures/volume/volumeram.h>
 #include <inviwo/core/datastructures/volume/volumeramprecision.h>
 
+#include <inviwo/core/datastructures/ramallocator.h>
 #include <inviwo/core/util/stdextensions.h>
 
+#include <cstdint>
+#include <cstring>
+
 namespace inviwo {
 
 namespace pyutil {
@@ -90,44 +94,127 @@ const DataFormatBase* getDataFormat(size_t components, pybind11::array& arr) {
     return format;
 }
 
+namespace {
+
+// True if arr has the strides of the arrays returned by createArrayView, i.e. the first dimension
+// varies fastest and the components are innermost
+bool hasViewLayout(const pybind11::array& arr, size_t spatialDims) {
+    const auto ndim = static_cast<size_t>(arr.ndim());
+    auto stride = arr.itemsize();
+    const auto check = [&](size_t axis) {
+        // the stride of an axis of extent one does not matter
+        const bool match = arr.shape(axis) < 2 || arr.strides(axis) == stride;
+        stride *= arr.shape(axis);
+        return match;
+    };
+    for (size_t i = spatialDims; i < ndim; ++i) {
+        if (!check(i)) return false;
+    }
+    for (size_t i = 0; i < spatialDims; ++i) {
+        if (!check(i)) return false;
+    }
+    return true;
+}
+
+/**
+ * Returns arr, or a converted copy, with the native dtype for T and a memory layout that can be
+ * used as is, see toContiguous.
+ */
+template <typename T>
+pybind11::array asContiguous(pybind11::array arr, size_t spatialDims) {
+    namespace py = pybind11;
+    const auto dtype = toNumPyFormat(DataFormat<T>::get());
+    if (!arr.dtype().is(dtype)) {
+        // Byte order or similar, the kind and size are already checked by getDataFormat
+        arr = arr.attr("astype")(dtype).cast<py::array>();
+    }
+    return toContiguous(std::move(arr), spatialDims);
+}
+
+/**
+ * Make the data of arr available as RAMData<T>, without copying if possible. The data of a
+ * writeable and aligned array of the right dtype that is C contiguous, or laid out like the arrays
+ * returned by createArrayView, is adopted, and the array is kept alive by the returned data.
+ * Otherwise NumPy makes a converted copy first, which is then adopted, or, for read-only arrays,
+ * the data is copied.
+ */
+template <typename T>
+RAMData<T> toRAMData(pybind11::array arr, size_t spatialDims, size_t size) {
+    namespace py = pybind11;
+    arr = asContiguous<T>(std::move(arr), spatialDims);
+    if (arr.writeable() && reinterpret_cast<std::uintptr_t>(arr.data()) % alignof(T) == 0) {
+        auto data = static_cast<T*>(arr.mutable_data());
+        auto owner = std::shared_ptr<void>(new py::array(std::move(arr)), [](void* ptr) {
+            // The last reference might be dropped from any thread, and after the interpreter
+            // is gone, in which case the array is leaked.
+            if (Py_IsInitialized()) {
+                py::gil_scoped_acquire gil;
+                delete static_cast<py::array*>(ptr);
+            }
+        });
+        return adoptRAMData(data, std::move(owner));
+    }
+    auto data = allocateRAMData<T>(size, DataInit::Uninitialized);
+    std::memcpy(data.get(), arr.data(), size * sizeof(T));
+    return data;
+}
+
 struct BufferFromArrayDispatcher {
     using type = std::unique_ptr<BufferBase>;
 
     template <typename Result, typename T>
     std::unique_ptr<BufferBase> operator()(pybind11::array& arr) {
         using Type = typename T::type;
-        auto buf = std::make_unique<Buffer<Type>>(arr.shape(0));
-        memcpy(buf->getEditableRAMRepresentation()->getData(), arr.data(0), arr.nbytes());
-        return buf;
+        // Buffers store their data in a std::vector, copy straight into it
+        auto contiguous = asContiguous<Type>(arr, 1);
+        auto begin = static_cast<const Type*>(contiguous.data());
+        auto ram = std::make_shared<BufferRAMPrecision<Type>>(
+            std::vector<Type>(begin, begin + arr.shape(0)));
+        return std::make_unique<Buffer<Type>>(ram);
     }
 };
 
-struct LayerFromArrayDispatcher {
-    using type = std::unique_ptr<Layer>;
+struct LayerRAMFromArrayDispatcher {
+    using type = std::shared_ptr<LayerRAM>;
 
     template <typename Result, typename T>
-    std::unique_ptr<Layer> operator()(pybind11::array& arr) {
+    std::shared_ptr<LayerRAM> operator()(pybind11::array& arr, LayerType layerType) {
         using Type = typename T::type;
-        size2_t dims(arr.shape(0), arr.shape(1));
-        auto layerRAM = std::make_shared<LayerRAMPrecision<Type>>(dims);
-        memcpy(layerRAM->getData(), arr.data(0), arr.nbytes());
-        return std::make_unique<Layer>(layerRAM);
+        const size2_t dims(arr.shape(0), arr.shape(1));
+        return std::make_shared<LayerRAMPrecision<Type>>(
+            toRAMData<Type>(arr, 2, glm::compMul(dims)), dims, layerType);
     }
 };
 
-struct VolumeFromArrayDispatcher {
-    using type = std::unique_ptr<Volume>;
+struct VolumeRAMFromArrayDispatcher {
+    using type = std::shared_ptr<VolumeRAM>;
 
     template <typename Result, typename T>
-    std::unique_ptr<Volume> operator()(pybind11::array& arr) {
+    std::shared_ptr<VolumeRAM> operator()(pybind11::array& arr) {
         using Type = typename T::type;
-        size3_t dims(arr.shape(0), arr.shape(1), arr.shape(2));
-        auto volumeRAM = std::make_shared<VolumeRAMPrecision<Type>>(dims);
-        memcpy(volumeRAM->getData(), arr.data(0), arr.nbytes());
-        return std::make_unique<Volume>(volumeRAM);
+        const size3_t dims(arr.shape(0), arr.shape(1), arr.shape(2));
+        return std::make_shared<VolumeRAMPrecision<Type>>(
+            toRAMData<Type>(arr, 3, glm::compMul(dims)), dims);
     }
 };
 
+}  // namespace
+
+pybind11::array toContiguous(pybind11::array arr, size_t spatialDims) {
+    namespace py = pybind11;
+    if ((arr.flags() & py::array::c_style) || hasViewLayout(arr, spatialDims)) {
+        return arr;
+    }
+    return py::array::ensure(arr, py::array::c_style);
+}
+
+void copyToRAM(pybind11::array arr, size_t spatialDims, void* dest) {
+    const auto src = toContiguous(std::move(arr), spatialDims);
+    // Nothing to do if arr is a view of dest, like the arrays returned by the data getters
+    if (src.data() == dest) return;
+    std::memcpy(dest, src.data(), src.nbytes());
+}
+
 std::unique_ptr<BufferBase> createBuffer(pybind11::array& arr) {
     auto ndim = arr.ndim();
     ivwAssert(ndim == 1 || ndim == 2, "ndims must be either 1 or 2");
@@ -137,23 +224,52 @@ std::unique_ptr<BufferBase> createBuffer(pybind11::array& arr) {
         df->getId(), dispatcher, arr);
 }
 
-std::unique_ptr<Layer> createLayer(pybind11::array& arr) {
+std::shared_ptr<LayerRAM> createLayerRAM(pybind11::array& arr, LayerType layerType) {
     auto ndim = arr.ndim();
     ivwAssert(ndim == 2 || ndim == 3, "Ndims must be either 2 or 3");
     auto df = pyutil::getDataFormat(ndim == 2 ? 1 : arr.shape(2), arr);
-    LayerFromArrayDispatcher dispatcher;
-    return dispatching::dispatch<std::unique_ptr<Layer>, dispatching::filter::All>(df->getId(),
-                                                                                   dispatcher, arr);
+    LayerRAMFromArrayDispatcher dispatcher;
+    return dispatching::dispatch<std::shared_ptr<LayerRAM>, dispatching::filter::All>(
+        df->getId(), dispatcher, arr, layerType);
 }
 
-std::unique_ptr<Volume> createVolume(pybind11::array& arr) {
+std::unique_ptr<Layer> createLayer(pybind11::array& arr) {
+    return std::make_unique<Layer>(createLayerRAM(arr));
+}
+
+std::shared_ptr<VolumeRAM> createVolumeRAM(pybind11::array& arr) {
     auto ndim = arr.ndim();
     ivwAssert(ndim == 3 || ndim == 4, "Ndims must be either 3 or 4");
     auto df = pyutil::getDataFormat(ndim == 3 ? 1 : arr.shape(3), arr);
-    VolumeFromArrayDispatcher dispatcher;
-    return dispatching::dispatch<std::unique_ptr<Volume>, dispatching::filter::All>(
+    VolumeRAMFromArrayDispatcher dispatcher;
+    return dispatching::dispatch<std::shared_ptr<VolumeRAM>, dispatching::filter::All>(
         df->getId(), dispatcher, arr);
 }
 
+std::unique_ptr<Volume> createVolume(pybind11::array& arr) {
+    return std::make_unique<Volume>(createVolumeRAM(arr));
+}
+
+pybind11::array createArrayView(const DataFormatBase* format, const std::vector<size_t>& dims,
+                                const void* data, bool readOnly, pybind11::handle owner) {
+    std::vector<size_t> shape{dims};
+    std::vector<size_t> strides;
+    size_t stride = format->getSize();
+    for (auto dim : dims) {
+        strides.push_back(stride);
+        stride *= dim;
+    }
+    if (format->getComponents() > 1) {
+        shape.push_back(format->getComponents());
+        strides.push_back(format->getSize() / format->getComponents());
+    }
+
+    pybind11::array view(toNumPyFormat(format), shape, strides, data, owner);
+    if (readOnly) {
+        view.attr("setflags")(pybind11::arg("write") = false);
+    }
+    return view;
+}
+
 }  // namespace pyutil
 }  // namespace inviwo
@@ -57,6 +57,8 @@
 
 #include <glm/gtc/epsilon.hpp>
 
+#include <cstring>
+
 namespace inviwo {
 
 namespace {
@@ -241,6 +243,112 @@ TEST_P(DTypeTest, VolumeTypeVec4Tests) {
         "(2,2,2,4)", 4);
 }
 
+TEST(NumPyInterop, VolumeUsesArrayData) {
+    PythonScript s;
+    s.setSource(
+        "import numpy as np\n"
+        "a = np.arange(24, dtype=np.float32).reshape((2, 3, 4))\n"
+        "b = a.transpose()\n"
+        "c = np.arange(8, dtype=np.uint8).reshape((2, 2, 2))\n"
+        "c.setflags(write=False)\n"
+        "d = a[:, :, ::2]\n");
+    bool status = false;
+    s.run([&](pybind11::dict dict) {
+        // C contiguous arrays are used directly, with the memory as is
+        auto a = pybind11::cast<pybind11::array>(dict["a"]);
+        auto ramA = pyutil::createVolumeRAM(a);
+        EXPECT_EQ(size3_t(2, 3, 4), ramA->getDimensions());
+        EXPECT_EQ(a.data(), ramA->getData());
+
+        // So are arrays laid out like Inviwo data, first dimension fastest
+        auto b = pybind11::cast<pybind11::array>(dict["b"]);
+        auto ramB = pyutil::createVolumeRAM(b);
+        EXPECT_EQ(size3_t(4, 3, 2), ramB->getDimensions());
+        EXPECT_EQ(b.data(), ramB->getData());
+
+        // Read-only arrays are copied
+        auto c = pybind11::cast<pybind11::array>(dict["c"]);
+        auto ramC = pyutil::createVolumeRAM(c);
+        EXPECT_NE(c.data(), ramC->getData());
+        EXPECT_EQ(0, std::memcmp(c.data(), ramC->getData(), 8));
+
+        // Other arrays are copied in C order
+        auto d = pybind11::cast<pybind11::array>(dict["d"]);
+        auto ramD = pyutil::createVolumeRAM(d);
+        EXPECT_EQ(size3_t(2, 3, 2), ramD->getDimensions());
+        auto dataD = static_cast<const float*>(ramD->getData());
+        for (size_t i = 0; i < 12; ++i) {
+            EXPECT_EQ(static_cast<float>(2 * i), dataD[i]) << "index: " << i;
+        }
+
+        status = true;
+    });
+    EXPECT_TRUE(status);
+}
+
+TEST(NumPyInterop, VolumeDataRoundTrip) {
+    auto ram = std::make_shared<VolumeRAMPrecision<float>>(size3_t(2, 3, 4));
+    auto data = ram->getDataTyped();
+    for (size_t i = 0; i < 24; ++i) data[i] = static_cast<float>(i);
+    Volume volume(ram);
+    const std::unordered_map<std::string, pybind11::object> locals{
+        {"volume", pybind11::cast(&volume, pybind11::return_value_policy::reference)}};
+
+    PythonScript s;
+    s.setSource(
+        "import numpy as np\n"
+        "view = volume.data\n"
+        "before = view.copy()\n"
+        "volume.data = volume.data\n"
+        "roundTrip = bool((volume.data == before).all())\n"
+        "volume.data = np.asfortranarray(before * 2)\n"
+        "fromCopy = bool((volume.data == before * 2).all())\n"
+        "viewUpdated = bool((view == before * 2).all())\n");
+    bool status = false;
+    s.run(locals, [&](pybind11::dict dict) {
+        EXPECT_TRUE(pybind11::cast<bool>(dict["roundTrip"]));
+        EXPECT_TRUE(pybind11::cast<bool>(dict["fromCopy"]));
+        // The data is written into the existing representation, earlier views stay valid
+        EXPECT_TRUE(pybind11::cast<bool>(dict["viewUpdated"]));
+        status = true;
+    });
+    EXPECT_TRUE(status);
+
+    auto result = volume.getRepresentation<VolumeRAM>();
+    EXPECT_EQ(ram.get(), result);
+    auto resultData = static_cast<const float*>(result->getData());
+    for (size_t i = 0; i < 24; ++i) {
+        EXPECT_EQ(2.0f * static_cast<float>(i), resultData[i]) << "index: " << i;
+    }
+
+    // The memory of C contiguous arrays is copied as is
+    PythonScript s2;
+    s2.setSource(
+        "import numpy as np\n"
+        "volume.data = np.arange(24, dtype=np.float32).reshape((2, 3, 4))\n");
+    EXPECT_TRUE(s2.run(locals));
+    for (size_t i = 0; i < 24; ++i) {
+        EXPECT_EQ(static_cast<float>(i), resultData[i]) << "index: " << i;
+    }
+}
+
+TEST(NumPyInterop, ReadOnlyView) {
+    Buffer<int> intBuffer(4);
+    auto rep = intBuffer.getEditableRAMRepresentation();
+    auto owner = pybind11::cast(static_cast<BufferBase*>(&intBuffer),
+                                pybind11::return_value_policy::reference);
+
+    auto view = pyutil::createArrayView(rep->getDataFormat(), {rep->getSize()}, rep->getData(),
+                                        true, owner);
+    EXPECT_FALSE(view.writeable());
+    EXPECT_EQ(rep->getData(), view.data());
+    EXPECT_EQ(4, view.shape(0));
+
+    auto editable = pyutil::createArrayView(rep->getDataFormat(), {rep->getSize()},
+                                            rep->getData(), false, owner);
+    EXPECT_TRUE(editable.writeable());
+}
+
 const static std::vector<std::string> dtypes = {{"float16"}, {"float32"}, {"float64"}, {"int8"},
                                                 {"int16"},   {"int32"},   {"int64"},   {"uint8"},
                                                 {"uint16"},  {"uint32"},  {"uint64"}};
@@ -37,6 +37,10 @@
 #include <modules/vectorfieldvisualization/datastructures/integralline.h>
 
 #include <unordered_map>
+#include <vector>
+#include <array>
+#include <memory>
+#include <numeric>
 
 namespace inviwo {
 
@@ -69,16 +73,53 @@ public:
 
     Result traceFrom(const SpatialVector& pIn) const;
 
+    /**
+     * Trace integral lines from all \p seeds, advancing them in lockstep. Each integration stage
+     * samples the positions of all active lines with a single call to Sampler::sampleBatch,
+     * instead of one virtual call per line and stage. The resulting lines are identical to
+     * calling traceFrom for each seed separately.
+     */
+    std::vector<Result> traceFrom(const std::vector<SpatialVector>& seeds) const;
+
     void addMetaDataSampler(const std::string& name, std::shared_ptr<const Sampler> sampler);
 
     const DataHomogenouSpatialMatrixrix& getSeedTransformationMatrix() const;
 
 private:
+    /**
+     * Scratch buffers for batched sampling, positions are stored as a structure of arrays.
+     * The Runge-Kutta stages are kept here as well to be reused between steps.
+     */
+    struct Batch {
+        std::array<const double*, SpatialSampler::SpatialDimensions> set(
+            const std::vector<SpatialVector>& positions);
+
+        std::array<std::vector<double>, SpatialSampler::SpatialDimensions> pos;
+        std::vector<typename Sampler::ReturnType> samples;
+        std::unique_ptr<bool[]> inside;
+        size_t insideSize = 0;
+        std::vector<DataVector> k2, k3, k4;
+    };
+
     inline SpatialVector seedTransform(const SpatialVector& seed) const;
 
+    std::pair<size_t, size_t> initLine(IntegralLine& line) const;
+
+    static DataVector normalize(const DataVector& v);
+    SpatialVector move(const SpatialVector& pos, DataVector v, const double stepSize) const;
+
     std::pair<SpatialVector, DataVector> step(const SpatialVector& oldPos,
                                               const double stepSize) const;
 
+    void sampleBatch(const std::vector<SpatialVector>& positions, std::vector<DataVector>& result,
+                     Batch& batch) const;
+    void stepBatch(const std::vector<SpatialVector>& oldPos, const double stepSize,
+                   std::vector<SpatialVector>& newPos, std::vector<DataVector>& velocity,
+                   Batch& batch) const;
+    std::vector<IntegralLine::TerminationReason> integrateBatch(
+        size_t steps, const std::vector<SpatialVector>& seeds,
+        const std::vector<IntegralLine*>& lines, bool fwd) const;
+
     bool addPoint(IntegralLine& line, const SpatialVector& pos) const;
     bool addPoint(IntegralLine& line, const SpatialVector& pos,
                   const DataVector& worldVelocity) const;
@@ -120,32 +161,7 @@ IntegralLineTracer<SpatialSampler, TimeDependent>::traceFrom(const SpatialVector
     Result res;
     IntegralLine& line = res.line;
 
-    const auto [stepsBWD, stepsFWD] = [dir = dir_, steps = steps_,
-                                       &line]() -> std::pair<size_t, size_t> {
-        switch (dir) {
-            case inviwo::IntegralLineProperties::Direction::FWD:
-                line.setBackwardTerminationReason(IntegralLine::TerminationReason::StartPoint);
-                return {1, steps + 1};
-            case inviwo::IntegralLineProperties::Direction::BWD:
-                line.setForwardTerminationReason(IntegralLine::TerminationReason::StartPoint);
-                return {steps + 1, 1};
-            default:
-            case inviwo::IntegralLineProperties::Direction::BOTH: {
-                return {steps / 2 + 1, steps - (steps / 2) + 1};
-            }
-        }
-    }();
-
-    line.getPositions().reserve(steps_ + 2);
-    line.getMetaData<dvec3>("velocity", true).reserve(steps_ + 2);
-
-    if constexpr (TimeDependent) {
-        line.getMetaData<double>("timestamp", true).reserve(steps_ + 2);
-    }
-
-    for (auto& m : metaSamplers_) {
-        line.getMetaData<typename Sampler::ReturnType>(m.first, true).reserve(steps_ + 2);
-    }
+    const auto [stepsBWD, stepsFWD] = initLine(line);
 
     if (!addPoint(line, p)) {
         return res;  // Zero velocity at seed point
@@ -162,6 +178,55 @@ IntegralLineTracer<SpatialSampler, TimeDependent>::traceFrom(const SpatialVector
     return res;
 }
 
+template <typename SpatialSampler, bool TimeDependent>
+std::vector<typename IntegralLineTracer<SpatialSampler, TimeDependent>::Result>
+IntegralLineTracer<SpatialSampler, TimeDependent>::traceFrom(
+    const std::vector<SpatialVector>& seeds) const {
+    std::vector<Result> results(seeds.size());
+    if (seeds.empty()) return results;
+
+    std::vector<SpatialVector> positions;
+    positions.reserve(seeds.size());
+    for (const auto& seed : seeds) positions.push_back(seedTransform(seed));
+
+    std::pair<size_t, size_t> steps;
+    for (auto& res : results) steps = initLine(res.line);
+    const auto [stepsBWD, stepsFWD] = steps;
+
+    Batch batch;
+    std::vector<DataVector> velocities;
+    sampleBatch(positions, velocities, batch);
+
+    // Lines with zero velocity at the seed point are left empty
+    std::vector<SpatialVector> starts;
+    std::vector<IntegralLine*> lines;
+    std::vector<Result*> traced;
+    for (size_t i = 0; i < results.size(); ++i) {
+        if (addPoint(results[i].line, positions[i], velocities[i])) {
+            starts.push_back(positions[i]);
+            lines.push_back(&results[i].line);
+            traced.push_back(&results[i]);
+        }
+    }
+
+    const auto bwd = integrateBatch(stepsBWD, starts, lines, false);
+    for (size_t i = 0; i < traced.size(); ++i) {
+        auto& line = traced[i]->line;
+        line.setBackwardTerminationReason(bwd[i]);
+        if (line.getPositions().size() > 1) {
+            line.reverse();
+            traced[i]->seedIndex = line.getPositions().size() - 1;
+        }
+    }
+
+    const auto fwd = integrateBatch(stepsFWD, starts, lines, true);
+    for (size_t i = 0; i < traced.size(); ++i) {
+        traced[i]->line.setForwardTerminationReason(fwd[i]);
+    }
+
+    return results;
+}
+
 template <typename SpatialSampler, bool TimeDependent>
 void IntegralLineTracer<SpatialSampler, TimeDependent>::addMetaDataSampler(
     const std::string& name, std::shared_ptr<const Sampler> sampler) {
@@ -189,29 +254,66 @@ IntegralLineTracer<SpatialSampler, TimeDependent>::seedTransform(const SpatialVe
     }
 }
 
+template <typename SpatialSampler, bool TimeDependent>
+std::pair<size_t, size_t> IntegralLineTracer<SpatialSampler, TimeDependent>::initLine(
+    IntegralLine& line) const {
+    const auto bwdFwdSteps = [dir = dir_, steps = steps_, &line]() -> std::pair<size_t, size_t> {
+        switch (dir) {
+            case inviwo::IntegralLineProperties::Direction::FWD:
+                line.setBackwardTerminationReason(IntegralLine::TerminationReason::StartPoint);
+                return {1, steps + 1};
+            case inviwo::IntegralLineProperties::Direction::BWD:
+                line.setForwardTerminationReason(IntegralLine::TerminationReason::StartPoint);
+                return {steps + 1, 1};
+            default:
+            case inviwo::IntegralLineProperties::Direction::BOTH: {
+                return {steps / 2 + 1, steps - (steps / 2) + 1};
+            }
+        }
+    }();
+
+    line.getPositions().reserve(steps_ + 2);
+    line.getMetaData<dvec3>("velocity", true).reserve(steps_ + 2);
+
+    if constexpr (TimeDependent) {
+        line.getMetaData<double>("timestamp", true).reserve(steps_ + 2);
+    }
+
+    for (auto& m : metaSamplers_) {
+        line.getMetaData<typename Sampler::ReturnType>(m.first, true).reserve(steps_ + 2);
+    }
+
+    return bwdFwdSteps;
+}
+
+template <typename SpatialSampler, bool TimeDependent>
+typename IntegralLineTracer<SpatialSampler, TimeDependent>::DataVector
+IntegralLineTracer<SpatialSampler, TimeDependent>::normalize(const DataVector& v) {
+    auto l = glm::length(v);
+    if (l == 0) return v;
+    return v / l;
+}
+
+template <typename SpatialSampler, bool TimeDependent>
+typename IntegralLineTracer<SpatialSampler, TimeDependent>::SpatialVector
+IntegralLineTracer<SpatialSampler, TimeDependent>::move(const SpatialVector& pos, DataVector v,
+                                                        const double stepSize) const {
+    if (normalizeSamples_) {
+        v = normalize(v);
+    }
+    auto offset = (invBasis_ * (v * stepSize));
+    if constexpr (TimeDependent) {
+        return pos + SpatialVector(offset, stepSize);
+    } else {
+        return pos + offset;
+    }
+}
+
 template <typename SpatialSampler, bool TimeDependent>
 std::pair<typename IntegralLineTracer<SpatialSampler, TimeDependent>::SpatialVector,
           typename IntegralLineTracer<SpatialSampler, TimeDependent>::DataVector>
 IntegralLineTracer<SpatialSampler, TimeDependent>::step(const SpatialVector& oldPos,
                                                         const double stepSize) const {
-    auto normalize = [](const auto v) {
-        auto l = glm::length(v);
-        if (l == 0) return v;
-        return v / l;
-    };
-
-    auto move = [&](const auto& pos, auto v, const auto stepsize) {
-        if (normalizeSamples_) {
-            v = normalize(v);
-        }
-        auto offset = (invBasis_ * (v * stepsize));
-        if constexpr (TimeDependent) {
-            return pos + SpatialVector(offset, stepsize);
-        } else {
-            return pos + offset;
-        }
-    };
-
     auto k1 = sampler_->sample(oldPos);
 
     switch (integrationScheme_) {
@@ -223,7 +325,7 @@ IntegralLineTracer<SpatialSampler, TimeDependent>::step(const SpatialVector& old
             const auto k2 = sampler_->sample(move(oldPos, k1, stepSize / 2));
             const auto k3 = sampler_->sample(move(oldPos, k2, stepSize / 2));
             const auto k4 = sampler_->sample(move(oldPos, k3, stepSize));
-            const auto&& K = [n = normalizeSamples_, normalize, &k1, &k2, &k3, &k4]() {
+            const auto&& K = [n = normalizeSamples_, &k1, &k2, &k3, &k4]() {
                 if (n) {
                     return normalize(k1 + k2 + k2 + k3 + k3 + k4);
                 } else {
@@ -235,6 +337,69 @@ IntegralLineTracer<SpatialSampler, TimeDependent>::step(const SpatialVector& old
     }
 }
 
+template <typename SpatialSampler, bool TimeDependent>
+std::array<const double*, SpatialSampler::SpatialDimensions>
+IntegralLineTracer<SpatialSampler, TimeDependent>::Batch::set(
+    const std::vector<SpatialVector>& positions) {
+    std::array<const double*, SpatialSampler::SpatialDimensions> res;
+    for (size_t d = 0; d < SpatialSampler::SpatialDimensions; ++d) {
+        pos[d].resize(positions.size());
+        for (size_t i = 0; i < positions.size(); ++i) {
+            pos[d][i] = positions[i][static_cast<glm::length_t>(d)];
+        }
+        res[d] = pos[d].data();
+    }
+    return res;
+}
+
+template <typename SpatialSampler, bool TimeDependent>
+void IntegralLineTracer<SpatialSampler, TimeDependent>::sampleBatch(
+    const std::vector<SpatialVector>& positions, std::vector<DataVector>& result,
+    Batch& batch) const {
+    batch.samples.resize(positions.size());
+    sampler_->sampleBatch(batch.set(positions), batch.samples.data(), positions.size());
+    result.assign(batch.samples.begin(), batch.samples.end());
+}
+
+template <typename SpatialSampler, bool TimeDependent>
+void IntegralLineTracer<SpatialSampler, TimeDependent>::stepBatch(
+    const std::vector<SpatialVector>& oldPos, const double stepSize,
+    std::vector<SpatialVector>& newPos, std::vector<DataVector>& velocity, Batch& batch) const {
+    const size_t size = oldPos.size();
+    newPos.resize(size);
+    sampleBatch(oldPos, velocity, batch);
+
+    switch (integrationScheme_) {
+        case inviwo::IntegralLineProperties::IntegrationScheme::Euler:
+            for (size_t i = 0; i < size; ++i) {
+                newPos[i] = move(oldPos[i], velocity[i], stepSize);
+            }
+            return;
+        default:
+            [[fallthrough]];
+        case inviwo::IntegralLineProperties::IntegrationScheme::RK4: {
+            const auto& k1 = velocity;
+            auto& k2 = batch.k2;
+            auto& k3 = batch.k3;
+            auto& k4 = batch.k4;
+            for (size_t i = 0; i < size; ++i) newPos[i] = move(oldPos[i], k1[i], stepSize / 2);
+            sampleBatch(newPos, k2, batch);
+            for (size_t i = 0; i < size; ++i) newPos[i] = move(oldPos[i], k2[i], stepSize / 2);
+            sampleBatch(newPos, k3, batch);
+            for (size_t i = 0; i < size; ++i) newPos[i] = move(oldPos[i], k3[i], stepSize);
+            sampleBatch(newPos, k4, batch);
+
+            for (size_t i = 0; i < size; ++i) {
+                const auto K = normalizeSamples_
+                                   ? normalize(k1[i] + k2[i] + k2[i] + k3[i] + k3[i] + k4[i])
+                                   : (k1[i] + k2[i] + k2[i] + k3[i] + k3[i] + k4[i]) * (1.0 / 6.0);
+                newPos[i] = move(oldPos[i], K, stepSize);
+            }
+            return;
+        }
+    }
+}
+
 template <typename SpatialSampler, bool TimeDependent>
 bool IntegralLineTracer<SpatialSampler, TimeDependent>::addPoint(IntegralLine& line,
                                                                  const SpatialVector& pos) const {
@@ -281,6 +446,66 @@ IntegralLine::TerminationReason IntegralLineTracer<SpatialSampler, TimeDependent
     return IntegralLine::TerminationReason::Steps;
 }
 
+template <typename SpatialSampler, bool TimeDependent>
+std::vector<IntegralLine::TerminationReason>
+IntegralLineTracer<SpatialSampler, TimeDependent>::integrateBatch(
+    size_t steps, const std::vector<SpatialVector>& seeds, const std::vector<IntegralLine*>& lines,
+    bool fwd) const {
+    if (steps == 0) {
+        return std::vector<IntegralLine::TerminationReason>(
+            lines.size(), IntegralLine::TerminationReason::StartPoint);
+    }
+    std::vector<IntegralLine::TerminationReason> reasons(lines.size(),
+                                                         IntegralLine::TerminationReason::Steps);
+
+    // Indices into lines of the lines still being integrated, and their current positions
+    std::vector<size_t> active(lines.size());
+    std::iota(active.begin(), active.end(), size_t{0});
+    std::vector<SpatialVector> pos = seeds;
+    std::vector<SpatialVector> newPos;
+    std::vector<DataVector> velocity;
+    Batch batch;
+
+    const double stepSize = stepSize_ * (fwd ? 1.0 : -1.0);
+    for (size_t i = 0; i < steps && !active.empty(); i++) {
+        if (batch.insideSize < pos.size()) {
+            batch.inside = std::make_unique<bool[]>(pos.size());
+            batch.insideSize = pos.size();
+        }
+        sampler_->withinBoundsBatch(batch.set(pos), batch.inside.get(), pos.size());
+
+        size_t n = 0;
+        for (size_t j = 0; j < active.size(); ++j) {
+            if (batch.inside[j]) {
+                active[n] = active[j];
+                pos[n] = pos[j];
+                ++n;
+            } else {
+                reasons[active[j]] = IntegralLine::TerminationReason::OutOfBounds;
+            }
+        }
+        active.resize(n);
+        pos.resize(n);
+        if (active.empty()) break;
+
+        stepBatch(pos, stepSize, newPos, velocity, batch);
+
+        n = 0;
+        for (size_t j = 0; j < active.size(); ++j) {
+            if (addPoint(*lines[active[j]], newPos[j], velocity[j])) {
+                active[n] = active[j];
+                pos[n] = newPos[j];
+                ++n;
+            } else {
+                reasons[active[j]] = IntegralLine::TerminationReason::ZeroVelocity;
+            }
+        }
+        active.resize(n);
+        pos.resize(n);
+    }
+    return reasons;
+}
+
 using StreamLine2DTracer = IntegralLineTracer<SpatialSampler<2, 2, double>>;
 using StreamLine3DTracer = IntegralLineTracer<SpatialSampler<3, 3, double>>;
 using PathLine3DTracer = IntegralLineTracer<Spatial4DSampler<3, double>>;
@@ -113,15 +113,31 @@ void IntegralLineTracerProcessor<Tracer>::process() {
         tracer.addMetaDataSampler(key, meta.second);
     }
 
+    // Seeds are traced in batches, the lines of a batch are advanced in lockstep by the tracer
+    constexpr size_t batchSize = 64;
+    using SpatialVector = typename Tracer::SpatialVector;
+
     std::mutex mutex;
     size_t startID = 0;
     for (const auto& seeds : seeds_) {
-        util::forEachParallel(*seeds, [&](const auto& p, size_t i) {
-            IntegralLine line = tracer.traceFrom(p);
-            auto size = line.getPositions().size();
-            if (size > 1) {
-                std::lock_guard<std::mutex> lock(mutex);
-                lines->push_back(std::move(line), startID + i);
+        std::vector<size_t> batches;
+        for (size_t start = 0; start < seeds->size(); start += batchSize) {
+            batches.push_back(start);
+        }
+        util::forEachParallel(batches, [&](size_t start) {
+            const auto end = std::min(start + batchSize, seeds->size());
+            std::vector<SpatialVector> batch;
+            batch.reserve(end - start);
+            for (size_t i = start; i < end; ++i) {
+                batch.emplace_back((*seeds)[i]);
+            }
+
+            auto results = tracer.traceFrom(batch);
+            std::lock_guard<std::mutex> lock(mutex);
+            for (size_t i = 0; i < results.size(); ++i) {
+                if (results[i].line.getPositions().size() > 1) {
+                    lines->push_back(std::move(results[i].line), startID + start + i);
+                }
             }
         });
         startID += seeds->size();
@@ -0,0 +1,104 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <warn/push>
+#include <warn/ignore/all>
+#include <gtest/gtest.h>
+#include <warn/pop>
+
+#include <modules/vectorfieldvisualization/integrallinetracer.h>
+#include <inviwo/core/datastructures/geometry/mesh.h>
+
+namespace inviwo {
+
+namespace {
+
+/**
+ * Analytic vector field rotating around the center of the unit cube while drifting along z
+ */
+class RotationSampler : public SpatialSampler<3, 3, double> {
+public:
+    RotationSampler(const SpatialEntity<3>& entity) : SpatialSampler<3, 3, double>(entity) {}
+
+protected:
+    virtual dvec3 sampleDataSpace(const dvec3& pos) const override {
+        const auto c = pos - dvec3{0.5};
+        return {-c.y, c.x, 0.1};
+    }
+    virtual bool withinBoundsDataSpace(const dvec3& pos) const override {
+        return glm::all(glm::greaterThanEqual(pos, dvec3{0.0})) &&
+               glm::all(glm::lessThanEqual(pos, dvec3{1.0}));
+    }
+};
+
+void expectSameLines(IntegralLineProperties::IntegrationScheme scheme) {
+    Mesh entity;
+    auto sampler = std::make_shared<RotationSampler>(entity);
+
+    IntegralLineProperties properties("properties", "Properties");
+    properties.integrationScheme_.set(scheme);
+    properties.stepDirection_.set(IntegralLineProperties::Direction::BOTH);
+    properties.numberOfSteps_.set(200);
+    properties.stepSize_.set(0.01f);
+
+    StreamLine3DTracer tracer(sampler, properties);
+
+    // Include a seed with zero velocity and one outside the volume
+    std::vector<dvec3> seeds{{0.5, 0.5, 0.5}, {0.7, 0.5, 0.1}, {0.2, 0.3, 0.9},
+                             {0.9, 0.9, 0.5}, {1.5, 0.5, 0.5}, {0.4, 0.6, 0.02}};
+    const auto batched = tracer.traceFrom(seeds);
+    ASSERT_EQ(seeds.size(), batched.size());
+
+    for (size_t i = 0; i < seeds.size(); ++i) {
+        const auto single = tracer.traceFrom(seeds[i]);
+        const auto& a = single.line;
+        const auto& b = batched[i].line;
+
+        EXPECT_EQ(single.seedIndex, batched[i].seedIndex) << "seed " << i;
+        EXPECT_EQ(a.getBackwardTerminationReason(), b.getBackwardTerminationReason())
+            << "seed " << i;
+        EXPECT_EQ(a.getForwardTerminationReason(), b.getForwardTerminationReason())
+            << "seed " << i;
+        EXPECT_EQ(a.getPositions(), b.getPositions()) << "seed " << i;
+        EXPECT_EQ(a.getMetaData<dvec3>("velocity"), b.getMetaData<dvec3>("velocity"))
+            << "seed " << i;
+    }
+}
+
+}  // namespace
+
+TEST(IntegralLineTracer, BatchedEuler) {
+    expectSameLines(IntegralLineProperties::IntegrationScheme::Euler);
+}
+
+TEST(IntegralLineTracer, BatchedRK4) {
+    expectSameLines(IntegralLineProperties::IntegrationScheme::RK4);
+}
+
+}  // namespace inviwo
@@ -69,6 +69,7 @@
 #include <inviwo/core/util/timer.h>
 #include <inviwo/core/util/settings/systemsettings.h>
 #include <inviwo/core/util/commandlineparser.h>
+#include <inviwo/core/util/evaluationprofiler.h>
 
 #include <inviwo/core/resourcemanager/resourcemanagerobserver.h>
 
@@ -89,6 +90,28 @@ struct AppResourceManagerObserver : ResourceManagerObserver {
     ResourceManager* manager = nullptr;
 };
 
+namespace {
+
+// Relative file names given on the command line are relative to the output path if given,
+// otherwise to the working directory
+std::string outputFileName(const CommandLineParser& parser, std::string filename) {
+    if (!filesystem::isAbsolutePath(filename)) {
+        auto outputDir = parser.getOutputPath();
+        if (!outputDir.empty()) {
+            filename = outputDir + "/" + filename;
+        } else {
+            filename = filesystem::getWorkingDirectory() + "/" + filename;
+        }
+    }
+    auto dir = filesystem::getFileDirectory(filename);
+    if (!filesystem::directoryExists(dir)) {
+        filesystem::createDirectoryRecursively(dir);
+    }
+    return filename;
+}
+
+}  // namespace
+
 InviwoApplication* InviwoApplication::instance_ = nullptr;
 
 InviwoApplication::InviwoApplication(int argc, char** argv, std::string displayName)
@@ -105,19 +128,8 @@ InviwoApplication::InviwoApplication(int argc, char** argv, std::string displayN
     }()}
     , filelogger_{[&]() {
         if (commandLineParser_->getLogToFile()) {
-            auto filename = commandLineParser_->getLogToFileFileName();
-            if (!filesystem::isAbsolutePath(filename)) {
-                auto outputDir = commandLineParser_->getOutputPath();
-                if (!outputDir.empty()) {
-                    filename = outputDir + "/" + filename;
-                } else {
-                    filename = filesystem::getWorkingDirectory() + "/" + filename;
-                }
-            }
-            auto dir = filesystem::getFileDirectory(filename);
-            if (!filesystem::directoryExists(dir)) {
-                filesystem::createDirectoryRecursively(dir);
-            }
+            auto filename = outputFileName(*commandLineParser_,
+                                           commandLineParser_->getLogToFileFileName());
             auto flog = std::make_shared<FileLogger>(filename);
             LogCentral::getPtr()->registerLogger(flog);
             return flog;
@@ -171,6 +183,14 @@ InviwoApplication::InviwoApplication(int argc, char** argv, std::string displayN
         systemSettings_->poolSize_.onChange([this]() { resizePool(systemSettings_->poolSize_); });
     }
 
+    const auto updateEvaluationMode = [this]() {
+        processorNetworkEvaluator_->setEvaluationMode(systemSettings_->parallelEvaluation_
+                                                          ? EvaluationMode::Parallel
+                                                          : EvaluationMode::Serial);
+    };
+    updateEvaluationMode();
+    systemSettings_->parallelEvaluation_.onChange(updateEvaluationMode);
+
     resourceManager_->setEnabled(systemSettings_->enableResourceManager_.get());
     systemSettings_->enableResourceManager_.onChange(
         [this]() { resourceManager_->setEnabled(systemSettings_->enableResourceManager_.get()); });
@@ -224,6 +244,10 @@ InviwoApplication::InviwoApplication(int argc, char** argv, std::string displayN
     // data format may be used first in one of the loaded libraries
     // but will not be cleaned up when the module is unloaded.
     DataFormatBase::get();
+
+    if (!commandLineParser_->getTraceFileName().empty()) {
+        EvaluationProfiler::get().setEnabled(true);
+    }
 }
 
 InviwoApplication::InviwoApplication() : InviwoApplication(0, nullptr, "Inviwo") {}
@@ -231,7 +255,21 @@ InviwoApplication::InviwoApplication() : InviwoApplication(0, nullptr, "Inviwo")
 InviwoApplication::InviwoApplication(std::string displayName)
     : InviwoApplication(0, nullptr, displayName) {}
 
-InviwoApplication::~InviwoApplication() { resizePool(0); }
+InviwoApplication::~InviwoApplication() {
+    resizePool(0);
+
+    const auto trace = commandLineParser_->getTraceFileName();
+    if (!trace.empty()) {
+        auto& profiler = EvaluationProfiler::get();
+        profiler.setEnabled(false);
+        auto filename = outputFileName(*commandLineParser_, trace);
+        if (auto out = filesystem::ofstream(filename)) {
+            profiler.writeChromeTrace(out);
+        } else {
+            LogErrorCustom("InviwoApplication", "Could not write trace to " << filename);
+        }
+    }
+}
 
 void InviwoApplication::registerModules(
     std::vector<std::unique_ptr<InviwoModuleFactoryObject>> moduleFactories) {
@@ -31,6 +31,7 @@
 #include <algorithm>
 #include <numeric>
 #include <functional>
+#include <cmath>
 
 namespace inviwo {
 
@@ -102,6 +103,86 @@ double& NormalizedHistogram::operator[](size_t i) { return data_[i]; }
 
 const double& NormalizedHistogram::operator[](size_t i) const { return data_[i]; }
 
+namespace util {
+
+HistogramAccumulator::HistogramAccumulator(dvec2 dataRange, size_t bins, size_t extent,
+                                           bool integral)
+    : dataRange_{dataRange}, bins_{bins}, extent_{extent}, integral_{integral} {
+    for (size_t i = 0; i < extent_; ++i) {
+        counts_[i].resize(bins_, 0);
+    }
+    min_.fill(std::numeric_limits<double>::max());
+    max_.fill(std::numeric_limits<double>::lowest());
+    sum_.fill(0.0);
+    sum2_.fill(0.0);
+}
+
+void HistogramAccumulator::merge(const HistogramAccumulator& other) {
+    if (other.extent_ == 0) return;
+    if (extent_ == 0) {
+        *this = other;
+        return;
+    }
+    for (size_t i = 0; i < extent_; ++i) {
+        std::transform(counts_[i].begin(), counts_[i].end(), other.counts_[i].begin(),
+                       counts_[i].begin(), std::plus<>{});
+        min_[i] = std::min(min_[i], other.min_[i]);
+        max_[i] = std::max(max_[i], other.max_[i]);
+        sum_[i] += other.sum_[i];
+        sum2_[i] += other.sum2_[i];
+    }
+    count_ += other.count_;
+}
+
+HistogramAccumulator HistogramAccumulator::rebin(dvec2 dataRange, size_t bins) const {
+    if (integral_) {
+        bins = std::min(bins, static_cast<std::size_t>(dataRange.y - dataRange.x + 1));
+    }
+    HistogramAccumulator res(dataRange, bins, extent_, integral_);
+    res.min_ = min_;
+    res.max_ = max_;
+    res.sum_ = sum_;
+    res.sum2_ = sum2_;
+    res.count_ = count_;
+
+    const double binWidth =
+        bins_ > 1 ? (dataRange_.y - dataRange_.x) / static_cast<double>(bins_ - 1) : 0.0;
+    const double binOffset = integral_ ? 0.0 : 0.5 * binWidth;
+    const double rangeScaleFactor =
+        static_cast<double>(bins - 1) / (dataRange.y - dataRange.x);
+
+    for (size_t j = 0; j < bins_; ++j) {
+        const double val = dataRange_.x + static_cast<double>(j) * binWidth + binOffset;
+        // truncate like the direct binning does, values just below the range end up in bin 0
+        const double ind = (val - dataRange.x) * rangeScaleFactor;
+        if (ind <= -1.0 || ind >= static_cast<double>(bins)) continue;
+        for (size_t i = 0; i < extent_; ++i) {
+            res.counts_[i][static_cast<size_t>(ind)] += counts_[i][j];
+        }
+    }
+    return res;
+}
+
+HistogramContainer HistogramAccumulator::toContainer() const {
+    const auto count = static_cast<double>(count_);
+
+    std::vector<NormalizedHistogram> histograms;
+    for (size_t i = 0; i < extent_; ++i) {
+        const auto mean = sum_[i] / count;
+        const auto stddev =
+            std::sqrt((count * sum2_[i] - sum_[i] * sum_[i]) / (count * (count - 1.0)));
+        histograms.emplace_back(dataRange_,
+                                std::vector<double>(counts_[i].begin(), counts_[i].end()),
+                                min_[i], max_[i], mean, stddev);
+    }
+    return HistogramContainer{std::move(histograms)};
+}
+
+}  // namespace util
+
+HistogramContainer::HistogramContainer(std::vector<NormalizedHistogram> histograms)
+    : histograms_{std::move(histograms)} {}
+
 size_t HistogramContainer::size() const { return histograms_.size(); }
 
 bool HistogramContainer::empty() const { return histograms_.empty(); }
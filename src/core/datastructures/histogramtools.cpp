@@ -29,10 +29,35 @@
 
 #include <inviwo/core/datastructures/histogramtools.h>
 #include <inviwo/core/datastructures/volume/volumeramprecision.h>
+#include <inviwo/core/datastructures/volume/volumebricked.h>
 #include <inviwo/core/common/inviwoapplication.h>
 
+#include <algorithm>
+
 namespace inviwo {
 
+namespace {
+
+/**
+ * The number of bins of the fine base histogram for a request of \p bins bins. The base bins are
+ * chosen such that each requested bin is covered by a whole number of base bins, which makes
+ * rebinning to the requested bins exact.
+ */
+size_t baseBinsFor(size_t bins) {
+    if (bins <= 1) return HistogramSupplier::baseBins;
+    const size_t factor = (HistogramSupplier::baseBins - 1 + bins - 2) / (bins - 1);
+    return std::max(factor, size_t{1}) * (bins - 1) + 1;
+}
+
+// A few parts per thread, each part is accumulated into its own histogram
+size_t maxParts() { return std::max(size_t{1}, 4 * InviwoApplication::getPtr()->getPoolSize()); }
+
+size_t partsFor(size_t size) {
+    return std::clamp(size / HistogramSupplier::minPartSize, size_t{1}, maxParts());
+}
+
+}  // namespace
+
 void HistogramCalculationState::whenDone(std::function<void(const HistogramContainer&)> callback) {
     if (auto container = container_.lock(); container && done) {
         callback(*container);
@@ -41,6 +66,15 @@ void HistogramCalculationState::whenDone(std::function<void(const HistogramConta
     }
 }
 
+void HistogramCalculationState::whenUpdated(
+    std::function<void(const HistogramContainer&)> callback) {
+    if (auto container = container_.lock(); container && done) {
+        callback(*container);
+    } else {
+        callbackHandles_.push_back(updateCallbacks_.add(callback));
+    }
+}
+
 HistogramSupplier::HistogramSupplier() : histograms_{std::make_shared<HistogramContainer>()} {}
 
 HistogramSupplier::HistogramSupplier(const HistogramSupplier& rhs)
@@ -55,31 +89,158 @@ HistogramSupplier& HistogramSupplier::operator=(const HistogramSupplier& that) {
 
 std::shared_ptr<HistogramCalculationState> HistogramSupplier::startCalculation(
     std::shared_ptr<const VolumeRAM> volumeRam, dvec2 dataRange, size_t bins) const {
-    if (!calculation_ || calculation_->getBins() != bins ||
-        calculation_->getDataRange() != dataRange) {
+    const size_t size = glm::compMul(volumeRam->getDimensions());
+    const size_t parts = partsFor(size);
 
-        histograms_ = std::make_shared<HistogramContainer>();
-        calculation_ = std::make_shared<HistogramCalculationState>(histograms_, bins, dataRange);
+    Calculation calculation;
+    calculation.parts = parts;
+    calculation.accumulate = [volumeRam, size, parts](size_t part, dvec2 range, size_t nBins) {
+        return volumeRam->dispatch<util::HistogramAccumulator>([&](auto vr) {
+            using T = util::PrecisionValueType<decltype(vr)>;
+            auto acc = util::HistogramAccumulator::create<T>(range, nBins);
+            const T* data = vr->getDataTyped();
+            acc.add(data + size * part / parts, data + size * (part + 1) / parts);
+            return acc;
+        });
+    };
+    calculation.estimate = [volumeRam, size](dvec2 range, size_t nBins) {
+        // use an odd stride to avoid sampling the same rows over and over again
+        const size_t stride = (size / estimateSamples) | 1;
+        if (stride < 3) return util::HistogramAccumulator{};
 
-        dispatchPool([weakState = std::weak_ptr<HistogramCalculationState>(calculation_),
-                      stop = calculation_->stop_, volumeRam, dataRange, bins]() {
-            auto histograms = volumeRam->dispatch<HistogramContainer>([&](auto vr) {
-                return HistogramContainer(dataRange, bins, vr->getDataTyped(),
-                                          vr->getDataTyped() + glm::compMul(vr->getDimensions()));
-            });
+        return volumeRam->dispatch<util::HistogramAccumulator>([&](auto vr) {
+            using T = util::PrecisionValueType<decltype(vr)>;
+            auto acc = util::HistogramAccumulator::create<T>(range, nBins);
+            acc.add(vr->getDataTyped(), vr->getDataTyped() + size, stride);
+            return acc;
+        });
+    };
+    return dispatchCalculation(std::move(calculation), dataRange, bins);
+}
+
+std::shared_ptr<HistogramCalculationState> HistogramSupplier::startCalculation(
+    std::shared_ptr<const VolumeBricked> volumeBricked, dvec2 dataRange, size_t bins) const {
+
+    const auto accumulateBrick = [volumeBricked](util::HistogramAccumulator& acc, size_t brick,
+                                                 dvec2 range, size_t nBins) {
+        const auto data = volumeBricked->getBrick(brick);
+        data->dispatch<void>([&](auto vr) {
+            using T = util::PrecisionValueType<decltype(vr)>;
+            if (acc.getComponents() == 0) {
+                acc = util::HistogramAccumulator::create<T>(range, nBins);
+            }
+            acc.add(vr->getDataTyped(), vr->getDataTyped() + glm::compMul(vr->getDimensions()));
+        });
+    };
+
+    // Each part covers a range of bricks, such that the number of accumulators, and their memory,
+    // does not grow with the number of bricks
+    const size_t bricks = volumeBricked->getNumberOfBricks();
+    const size_t parts = std::clamp(bricks, size_t{1}, maxParts());
+
+    Calculation calculation;
+    calculation.parts = parts;
+    calculation.accumulate = [accumulateBrick, bricks, parts](size_t part, dvec2 range,
+                                                              size_t nBins) {
+        util::HistogramAccumulator acc;
+        for (size_t brick = bricks * part / parts; brick < bricks * (part + 1) / parts; ++brick) {
+            accumulateBrick(acc, brick, range, nBins);
+        }
+        return acc;
+    };
+    calculation.estimate = [volumeBricked, accumulateBrick](dvec2 range, size_t nBins) {
+        // use a subset of the bricks, a brick is only loaded as a whole
+        const size_t bricks = volumeBricked->getNumberOfBricks();
+        const size_t brickSize = glm::compMul(volumeBricked->getBrickSize());
+        const size_t stride = bricks * brickSize / std::max(estimateSamples, brickSize);
+
+        util::HistogramAccumulator acc;
+        if (stride < 2) return acc;
+        for (size_t brick = stride / 2; brick < bricks; brick += stride) {
+            accumulateBrick(acc, brick, range, nBins);
+        }
+        return acc;
+    };
+    return dispatchCalculation(std::move(calculation), dataRange, bins);
+}
+
+std::shared_ptr<HistogramCalculationState> HistogramSupplier::dispatchCalculation(
+    Calculation calculation, dvec2 dataRange, size_t bins) const {
+    if (calculation_ && calculation_->getBins() == bins &&
+        calculation_->getDataRange() == dataRange) {
+        return calculation_;
+    }
+
+    auto base = calculation_ ? calculation_->base_ : nullptr;
+
+    histograms_ = std::make_shared<HistogramContainer>();
+    calculation_ = std::make_shared<HistogramCalculationState>(histograms_, bins, dataRange);
+
+    // If the previous calculation covers the new range we only have to rebin it
+    if (base && base->getDataRange().x <= dataRange.x && dataRange.y <= base->getDataRange().y) {
+        calculation_->base_ = base;
+        done(calculation_, base->rebin(dataRange, bins).toContainer());
+        return calculation_;
+    }
+
+    dispatchPool([weakState = std::weak_ptr<HistogramCalculationState>(calculation_),
+                  stop = calculation_->stop_, calculation = std::move(calculation), dataRange,
+                  bins]() {
+        // A quick estimate first
+        if (auto estimate = calculation.estimate(dataRange, bins); estimate.getComponents() > 0) {
             if (*stop) return;
-            dispatchFrontAndForget([hist = std::move(histograms), weakState]() {
+            dispatchFrontAndForget([hist = estimate.toContainer(), weakState]() {
                 if (auto s = weakState.lock()) {
+                    update(s, hist);
+                }
+            });
+        }
+
+        // The full calculation, each part accumulates into its own bins
+        auto& pool = InviwoApplication::getPtr()->getThreadPool();
+        const size_t nBaseBins = baseBinsFor(bins);
+        const auto accumulate = std::make_shared<const decltype(calculation.accumulate)>(
+            calculation.accumulate);
+
+        std::vector<std::future<util::HistogramAccumulator>> parts;
+        parts.reserve(calculation.parts);
+        for (size_t part = 0; part < calculation.parts; ++part) {
+            parts.push_back(pool.enqueue([accumulate, stop, part, dataRange, nBaseBins]() {
+                if (*stop) return util::HistogramAccumulator{};
+                return (*accumulate)(part, dataRange, nBaseBins);
+            }));
+        }
+
+        util::HistogramAccumulator merged;
+        for (auto& part : parts) {
+            pool.wait(part);
+            merged.merge(part.get());
+        }
+        if (*stop) return;
+
+        auto base = std::make_shared<const util::HistogramAccumulator>(std::move(merged));
+        dispatchFrontAndForget(
+            [hist = base->rebin(dataRange, bins).toContainer(), base, weakState]() {
+                if (auto s = weakState.lock()) {
+                    s->base_ = base;
                     done(s, std::move(hist));
                 }
             });
-        });
-    }
+    });
+
     return calculation_;
 }
 
+void HistogramSupplier::update(std::shared_ptr<HistogramCalculationState> state,
+                               const HistogramContainer& histograms) {
+    if (!state->done) {
+        state->updateCallbacks_.invoke(histograms);
+    }
+}
+
 void HistogramSupplier::done(std::shared_ptr<HistogramCalculationState> state,
                              HistogramContainer histograms) {
+    state->updateCallbacks_.invoke(histograms);
     state->callbacks_.invoke(histograms);
     state->done = true;
     if (auto container = state->container_.lock()) {
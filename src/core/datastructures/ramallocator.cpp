@@ -0,0 +1,288 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <inviwo/core/datastructures/ramallocator.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <list>
+#include <mutex>
+#include <new>
+#include <unordered_map>
+#include <vector>
+
+#ifdef WIN32
+#include <malloc.h>
+#else
+#include <sys/mman.h>
+#endif
+
+namespace inviwo {
+
+namespace {
+
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+constexpr bool useHugePages = true;
+#else
+constexpr bool useHugePages = false;
+#endif
+
+void* systemAllocate(size_t size) {
+    const size_t align = size >= PooledRAMAllocator::hugePageSize
+                             ? PooledRAMAllocator::hugePageSize
+                             : RAMAllocator::alignment;
+#ifdef WIN32
+    void* ptr = _aligned_malloc(size, align);
+#else
+    void* ptr = nullptr;
+    if (posix_memalign(&ptr, align, size) != 0) ptr = nullptr;
+#endif
+    if (!ptr) throw std::bad_alloc();
+
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+    // only a hint, the memory is usable either way
+    if (size >= PooledRAMAllocator::hugePageSize) madvise(ptr, size, MADV_HUGEPAGE);
+#endif
+    return ptr;
+}
+
+void systemFree(void* ptr) noexcept {
+#ifdef WIN32
+    _aligned_free(ptr);
+#else
+    std::free(ptr);
+#endif
+}
+
+}  // namespace
+
+class PooledRAMAllocator::Pool {
+public:
+    explicit Pool(size_t capacity) : capacity_{capacity} {}
+    ~Pool() { trim(); }
+
+    void* allocate(size_t size) {
+        const auto sizeClass = PooledRAMAllocator::sizeClass(size);
+        {
+            std::scoped_lock lock{mutex_};
+            ++stats_.allocations;
+            addInUse(sizeClass);
+            if (auto it = byClass_.find(sizeClass); it != byClass_.end() && !it->second.empty()) {
+                // reuse the most recently released block of the size class
+                auto block = it->second.back();
+                it->second.pop_back();
+                void* ptr = block->ptr;
+                released_.erase(block);
+                stats_.bytesPooled -= sizeClass;
+                --stats_.buffersPooled;
+                ++stats_.reused;
+                return ptr;
+            }
+        }
+        try {
+            return systemAllocate(sizeClass);
+        } catch (...) {
+            std::scoped_lock lock{mutex_};
+            removeInUse(sizeClass);
+            throw;
+        }
+    }
+
+    void deallocate(void* ptr, size_t size) noexcept {
+        if (!ptr) return;
+        const auto sizeClass = PooledRAMAllocator::sizeClass(size);
+        std::vector<void*> toFree;
+        {
+            std::scoped_lock lock{mutex_};
+            removeInUse(sizeClass);
+            if (size >= PooledRAMAllocator::minPoolSize && sizeClass <= capacity_) {
+                try {
+                    auto& blocks = byClass_[sizeClass];
+                    released_.push_back(Block{sizeClass, ptr});
+                    try {
+                        blocks.push_back(std::prev(released_.end()));
+                    } catch (...) {
+                        released_.pop_back();
+                        throw;
+                    }
+                    stats_.bytesPooled += sizeClass;
+                    ++stats_.buffersPooled;
+                    ptr = nullptr;
+                } catch (...) {
+                    // fall through and free the memory
+                }
+            }
+            toFree = evict(capacity_);
+            if (ptr) stats_.bytesFreed += sizeClass;
+        }
+        for (auto p : toFree) systemFree(p);
+        if (ptr) systemFree(ptr);
+    }
+
+    void setCapacity(size_t capacity) {
+        std::vector<void*> toFree;
+        {
+            std::scoped_lock lock{mutex_};
+            capacity_ = capacity;
+            toFree = evict(capacity_);
+        }
+        for (auto p : toFree) systemFree(p);
+    }
+
+    size_t getCapacity() {
+        std::scoped_lock lock{mutex_};
+        return capacity_;
+    }
+
+    void trim() {
+        std::vector<void*> toFree;
+        {
+            std::scoped_lock lock{mutex_};
+            toFree = evict(0);
+        }
+        for (auto p : toFree) systemFree(p);
+    }
+
+    RAMAllocator::Stats getStats() {
+        std::scoped_lock lock{mutex_};
+        return stats_;
+    }
+
+private:
+    struct Block {
+        size_t sizeClass;
+        void* ptr;
+    };
+
+    void addInUse(size_t sizeClass) {
+        stats_.bytesInUse += sizeClass;
+        stats_.peakBytesInUse = std::max(stats_.peakBytesInUse, stats_.bytesInUse);
+        if (useHugePages && sizeClass >= PooledRAMAllocator::hugePageSize) {
+            stats_.hugePageBytes += sizeClass;
+        }
+    }
+    void removeInUse(size_t sizeClass) {
+        stats_.bytesInUse -= sizeClass;
+        if (useHugePages && sizeClass >= PooledRAMAllocator::hugePageSize) {
+            stats_.hugePageBytes -= sizeClass;
+        }
+    }
+
+    // Remove the least recently released blocks until at most capacity bytes are pooled, returns
+    // the memory to free once the lock is released.
+    std::vector<void*> evict(size_t capacity) {
+        std::vector<void*> toFree;
+        while (stats_.bytesPooled > capacity && !released_.empty()) {
+            const auto& block = released_.front();
+            auto& blocks = byClass_[block.sizeClass];
+            // blocks are added in the order they are released, the oldest is first
+            blocks.erase(blocks.begin());
+            stats_.bytesPooled -= block.sizeClass;
+            stats_.bytesFreed += block.sizeClass;
+            --stats_.buffersPooled;
+            toFree.push_back(block.ptr);
+            released_.pop_front();
+        }
+        return toFree;
+    }
+
+    std::mutex mutex_;
+    size_t capacity_;
+    std::list<Block> released_;  // least recently released first
+    std::unordered_map<size_t, std::vector<std::list<Block>::iterator>> byClass_;
+    RAMAllocator::Stats stats_;
+};
+
+namespace {
+
+struct Current {
+    std::mutex mutex;
+    std::shared_ptr<RAMAllocator> allocator = PooledRAMAllocator::getDefault();
+};
+
+// Never destroyed, representations might be released during static destruction.
+Current& current() {
+    static Current* instance = new Current();
+    return *instance;
+}
+
+}  // namespace
+
+std::shared_ptr<RAMAllocator> RAMAllocator::get() {
+    auto& c = current();
+    std::scoped_lock lock{c.mutex};
+    return c.allocator;
+}
+
+void RAMAllocator::set(std::shared_ptr<RAMAllocator> allocator) {
+    if (!allocator) allocator = PooledRAMAllocator::getDefault();
+    auto& c = current();
+    std::scoped_lock lock{c.mutex};
+    std::swap(c.allocator, allocator);
+}
+
+PooledRAMAllocator::PooledRAMAllocator(size_t capacity)
+    : pool_{std::make_unique<Pool>(capacity)} {}
+
+PooledRAMAllocator::~PooledRAMAllocator() = default;
+
+void* PooledRAMAllocator::allocate(size_t size) {
+    return pool_->allocate(std::max(size, size_t{1}));
+}
+
+void PooledRAMAllocator::deallocate(void* ptr, size_t size) noexcept {
+    pool_->deallocate(ptr, std::max(size, size_t{1}));
+}
+
+RAMAllocator::Stats PooledRAMAllocator::getStats() const { return pool_->getStats(); }
+
+void PooledRAMAllocator::setCapacity(size_t bytes) { pool_->setCapacity(bytes); }
+
+size_t PooledRAMAllocator::getCapacity() const { return pool_->getCapacity(); }
+
+void PooledRAMAllocator::trim() { pool_->trim(); }
+
+std::shared_ptr<PooledRAMAllocator> PooledRAMAllocator::getDefault() {
+    // Never destroyed, representations might be released during static destruction.
+    static auto* instance =
+        new std::shared_ptr<PooledRAMAllocator>(std::make_shared<PooledRAMAllocator>());
+    return *instance;
+}
+
+size_t PooledRAMAllocator::sizeClass(size_t size) {
+    if (size < minPoolSize) {
+        return (size + alignment - 1) / alignment * alignment;
+    }
+    size_t pow2 = minPoolSize;
+    while (pow2 <= size / 2) pow2 *= 2;
+    const size_t step = pow2 / 8;
+    return (size + step - 1) / step * step;
+}
+
+}  // namespace inviwo
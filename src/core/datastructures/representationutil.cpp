@@ -153,6 +153,8 @@ void registerCoreRepresentationsHelper(T& obj) {
     // Register Converters
     obj.template registerRepresentationConverter<VolumeRepresentation>(
         std::make_unique<VolumeDisk2RAMConverter>());
+    obj.template registerRepresentationConverter<VolumeRepresentation>(
+        std::make_unique<VolumeBricked2RAMConverter>());
     obj.template registerRepresentationConverter<LayerRepresentation>(
         std::make_unique<LayerDisk2RAMConverter>());
 }
@@ -29,6 +29,8 @@
 
 #include <inviwo/core/datastructures/volume/volume.h>
 #include <inviwo/core/datastructures/volume/volumeram.h>
+#include <inviwo/core/datastructures/volume/volumebricked.h>
+#include <inviwo/core/util/volumeutils.h>
 #include <inviwo/core/util/document.h>
 
 namespace inviwo {
@@ -222,6 +224,13 @@ const StructuredCameraCoordinateTransformer<3>& Volume::getCoordinateTransformer
 
 std::shared_ptr<HistogramCalculationState> Volume::calculateHistograms(size_t bins) const {
 
+    if (util::getBrickedRepresentation(*this)) {
+        // lastValidRepresentation_ is now VolumeBricked
+        return HistogramSupplier::startCalculation(
+            std::static_pointer_cast<VolumeBricked>(lastValidRepresentation_), dataMap_.dataRange,
+            bins);
+    }
+
     getRepresentation<VolumeRAM>();  // make sure lastValidRepresentation_ is VolumeRAM
     return HistogramSupplier::startCalculation(
         std::static_pointer_cast<VolumeRAM>(lastValidRepresentation_), dataMap_.dataRange, bins);
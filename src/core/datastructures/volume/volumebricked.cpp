@@ -0,0 +1,312 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <inviwo/core/datastructures/volume/volumebricked.h>
+#include <inviwo/core/datastructures/volume/volumeramprecision.h>
+#include <inviwo/core/common/inviwoapplication.h>
+#include <inviwo/core/util/indexmapper.h>
+#include <inviwo/core/util/lrucache.h>
+
+#include <cstring>
+#include <future>
+#include <mutex>
+#include <numeric>
+#include <string>
+
+namespace inviwo {
+
+namespace {
+
+size3_t validBrickSize(size3_t brickSize, size3_t dimensions) {
+    for (size_t i = 0; i < 3; ++i) {
+        if (brickSize[i] == 0) brickSize[i] = dimensions[i];
+    }
+    return glm::max(brickSize, size3_t{1});
+}
+
+}  // namespace
+
+class VolumeBricked::Bricks {
+public:
+    Bricks(std::shared_ptr<const VolumeBrickLoader> aLoader, size3_t aDimensions,
+           const DataFormatBase* aFormat, size3_t aBrickSize, size_t cacheSize)
+        : loader{std::move(aLoader)}
+        , dimensions{aDimensions}
+        , format{aFormat}
+        , brickSize{validBrickSize(aBrickSize, aDimensions)}
+        , counts{(dimensions + brickSize - size3_t{1}) / brickSize}
+        , cache{cacheSize} {}
+
+    size3_t offset(size_t brick) const { return util::IndexMapper3D{counts}(brick) * brickSize; }
+    size3_t extent(size_t brick) const { return glm::min(brickSize, dimensions - offset(brick)); }
+    size_t bytes(size_t brick) const { return glm::compMul(extent(brick)) * format->getSize(); }
+
+    std::shared_ptr<const VolumeRAM> get(size_t brick, bool waitForLoading = true) {
+        std::unique_lock<std::mutex> lock{mutex};
+        if (auto loading = cache.get(brick)) {
+            lock.unlock();
+            if (!waitForLoading) return nullptr;
+            return (*loading)->get();
+        }
+
+        std::promise<std::shared_ptr<const VolumeRAM>> promise;
+        auto loading = std::make_shared<const Loading>(promise.get_future().share());
+        cache.put(brick, loading, bytes(brick));
+        lock.unlock();
+
+        try {
+            auto volumeRAM = load(brick);
+            promise.set_value(volumeRAM);
+            return volumeRAM;
+        } catch (...) {
+            {
+                // The entry might have been evicted and the brick requested again meanwhile, only
+                // remove our own entry.
+                std::scoped_lock<std::mutex> eraseLock{mutex};
+                if (auto entry = cache.peek(brick); entry && *entry == loading) cache.erase(brick);
+            }
+            promise.set_exception(std::current_exception());
+            throw;
+        }
+    }
+
+    std::shared_ptr<const VolumeRAM> load(size_t brick) const {
+        const auto brickExtent = extent(brick);
+        auto data = std::make_unique<char[]>(bytes(brick));
+        loader->loadBrick(offset(brick), brickExtent, data.get());
+        auto volumeRAM = createVolumeRAM(brickExtent, format, data.get());
+        data.release();
+        return volumeRAM;
+    }
+
+    const std::shared_ptr<const VolumeBrickLoader> loader;
+    const size3_t dimensions;
+    const DataFormatBase* const format;
+    const size3_t brickSize;
+    const size3_t counts;
+
+    using Loading = std::shared_future<std::shared_ptr<const VolumeRAM>>;
+
+    std::mutex mutex;
+    // Bricks that are loaded or being loaded, the pointer identifies the load
+    util::LRUCache<size_t, std::shared_ptr<const Loading>> cache;
+};
+
+VolumeBricked::VolumeBricked(std::shared_ptr<const VolumeBrickLoader> loader, size3_t dimensions,
+                             const DataFormatBase* format, size3_t brickSize, size_t cacheSize,
+                             const SwizzleMask& swizzleMask, InterpolationType interpolation,
+                             const Wrapping3D& wrapping)
+    : VolumeRepresentation(format)
+    , bricks_{std::make_shared<Bricks>(std::move(loader), dimensions, format, brickSize,
+                                       cacheSize)}
+    , swizzleMask_{swizzleMask}
+    , interpolation_{interpolation}
+    , wrapping_{wrapping} {}
+
+VolumeBricked* VolumeBricked::clone() const { return new VolumeBricked(*this); }
+
+std::type_index VolumeBricked::getTypeIndex() const {
+    return std::type_index(typeid(VolumeBricked));
+}
+
+void VolumeBricked::setDimensions(size3_t) {
+    throw Exception("Can not set dimension of a Volume Bricked", IVW_CONTEXT);
+}
+
+const size3_t& VolumeBricked::getDimensions() const { return bricks_->dimensions; }
+
+void VolumeBricked::setSwizzleMask(const SwizzleMask& mask) { swizzleMask_ = mask; }
+
+SwizzleMask VolumeBricked::getSwizzleMask() const { return swizzleMask_; }
+
+void VolumeBricked::setInterpolation(InterpolationType interpolation) {
+    interpolation_ = interpolation;
+}
+
+InterpolationType VolumeBricked::getInterpolation() const { return interpolation_; }
+
+void VolumeBricked::setWrapping(const Wrapping3D& wrapping) { wrapping_ = wrapping; }
+
+Wrapping3D VolumeBricked::getWrapping() const { return wrapping_; }
+
+size3_t VolumeBricked::getBrickSize() const { return bricks_->brickSize; }
+
+size3_t VolumeBricked::getBrickCounts() const { return bricks_->counts; }
+
+size_t VolumeBricked::getNumberOfBricks() const { return glm::compMul(bricks_->counts); }
+
+size3_t VolumeBricked::getBrickOffset(size_t brick) const { return bricks_->offset(brick); }
+
+size3_t VolumeBricked::getBrickExtent(size_t brick) const { return bricks_->extent(brick); }
+
+std::vector<size_t> VolumeBricked::getBricks(size3_t offset, size3_t extent) const {
+    std::vector<size_t> result;
+    const auto end = glm::min(offset + extent, getDimensions());
+    if (glm::any(glm::greaterThanEqual(offset, end))) return result;
+
+    const auto first = offset / bricks_->brickSize;
+    const auto last = (end - size3_t{1}) / bricks_->brickSize;
+    const util::IndexMapper3D im{bricks_->counts};
+    result.reserve(glm::compMul(last - first + size3_t{1}));
+    for (auto z = first.z; z <= last.z; ++z) {
+        for (auto y = first.y; y <= last.y; ++y) {
+            for (auto x = first.x; x <= last.x; ++x) {
+                result.push_back(im(x, y, z));
+            }
+        }
+    }
+    return result;
+}
+
+std::shared_ptr<const VolumeRAM> VolumeBricked::getBrick(size_t brick) const {
+    if (brick >= getNumberOfBricks()) {
+        throw RangeException(
+            "Brick " + std::to_string(brick) + " is out of range, the volume has " +
+                std::to_string(getNumberOfBricks()) + " bricks",
+            IVW_CONTEXT);
+    }
+    return bricks_->get(brick);
+}
+
+void VolumeBricked::prefetch(size_t brick) const {
+    if (brick >= getNumberOfBricks() || !InviwoApplication::isInitialized() ||
+        InviwoApplication::getPtr()->getPoolSize() == 0) {
+        return;
+    }
+    {
+        std::scoped_lock<std::mutex> lock{bricks_->mutex};
+        if (bricks_->cache.contains(brick)) return;
+    }
+    InviwoApplication::getPtr()->getThreadPool().enqueueRaw(
+        [bricks = bricks_, brick]() {
+            try {
+                bricks->get(brick, false);
+            } catch (...) {
+                // The error is reported when the brick is requested
+            }
+        },
+        ThreadPool::Priority::Background);
+}
+
+namespace {
+
+void visitBricks(const VolumeBricked& volume, const std::vector<size_t>& bricks,
+                 const std::function<void(const VolumeRAM& brick, size3_t offset)>& callback,
+                 size_t prefetch) {
+    // Prefetching more bricks than fit in the cache would evict bricks before they are used
+    if (!bricks.empty()) {
+        const auto brickBytes =
+            glm::compMul(volume.getBrickSize()) * volume.getDataFormat()->getSize();
+        prefetch = std::min(prefetch, std::max(volume.getCacheSize() / brickBytes, size_t{1}) - 1);
+    }
+
+    for (size_t i = 1; i <= prefetch && i < bricks.size(); ++i) {
+        volume.prefetch(bricks[i]);
+    }
+    for (size_t i = 0; i < bricks.size(); ++i) {
+        if (i > 0 && i + prefetch < bricks.size()) {
+            volume.prefetch(bricks[i + prefetch]);
+        }
+        const auto brick = volume.getBrick(bricks[i]);
+        callback(*brick, volume.getBrickOffset(bricks[i]));
+    }
+}
+
+}  // namespace
+
+void VolumeBricked::forEachBrick(
+    const std::function<void(const VolumeRAM& brick, size3_t offset)>& callback,
+    size_t prefetch) const {
+    std::vector<size_t> bricks(getNumberOfBricks());
+    std::iota(bricks.begin(), bricks.end(), size_t{0});
+    visitBricks(*this, bricks, callback, prefetch);
+}
+
+std::shared_ptr<VolumeRAM> VolumeBricked::readRegion(size3_t offset, size3_t extent) const {
+    auto volumeRAM = createVolumeRAM(extent, getDataFormat(), nullptr, swizzleMask_,
+                                     interpolation_, wrapping_);
+    readRegion(offset, *volumeRAM);
+    return volumeRAM;
+}
+
+void VolumeBricked::readRegion(size3_t offset, VolumeRAM& dest) const {
+    const auto extent = dest.getDimensions();
+    if (glm::any(glm::greaterThan(offset + extent, getDimensions()))) {
+        throw RangeException("Region is outside of the volume", IVW_CONTEXT);
+    }
+    if (dest.getDataFormat() != getDataFormat()) {
+        throw Exception("Can not read region into a volume of format " +
+                            dest.getDataFormatString() + ", expected " + getDataFormatString(),
+                        IVW_CONTEXT);
+    }
+
+    const auto voxelSize = getDataFormat()->getSize();
+    const util::IndexMapper3D destIm{extent};
+    auto destData = static_cast<char*>(dest.getData());
+
+    visitBricks(
+        *this, getBricks(offset, extent),
+        [&](const VolumeRAM& brick, size3_t brickOffset) {
+            const auto begin = glm::max(offset, brickOffset);
+            const auto end = glm::min(offset + extent, brickOffset + brick.getDimensions());
+            const util::IndexMapper3D brickIm{brick.getDimensions()};
+            const auto brickData = static_cast<const char*>(brick.getData());
+            const auto rowSize = (end.x - begin.x) * voxelSize;
+
+            for (auto z = begin.z; z < end.z; ++z) {
+                for (auto y = begin.y; y < end.y; ++y) {
+                    std::memcpy(
+                        destData + destIm(begin.x - offset.x, y - offset.y, z - offset.z) *
+                                       voxelSize,
+                        brickData + brickIm(begin.x - brickOffset.x, y - brickOffset.y,
+                                            z - brickOffset.z) *
+                                        voxelSize,
+                        rowSize);
+                }
+            }
+        },
+        4);
+}
+
+size_t VolumeBricked::getCacheSize() const {
+    std::scoped_lock<std::mutex> lock{bricks_->mutex};
+    return bricks_->cache.getCapacity();
+}
+
+void VolumeBricked::setCacheSize(size_t bytes) {
+    std::scoped_lock<std::mutex> lock{bricks_->mutex};
+    bricks_->cache.setCapacity(bytes);
+}
+
+void VolumeBricked::clearCache() const {
+    std::scoped_lock<std::mutex> lock{bricks_->mutex};
+    bricks_->cache.clear();
+}
+
+}  // namespace inviwo
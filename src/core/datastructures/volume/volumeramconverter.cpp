@@ -42,4 +42,20 @@ void VolumeDisk2RAMConverter::update(std::shared_ptr<const VolumeDisk> source,
     source->updateRepresentation(destination);
 }
 
+std::shared_ptr<VolumeRAM> VolumeBricked2RAMConverter::createFrom(
+    std::shared_ptr<const VolumeBricked> source) const {
+    return source->readRegion(size3_t{0}, source->getDimensions());
+}
+
+void VolumeBricked2RAMConverter::update(std::shared_ptr<const VolumeBricked> source,
+                                        std::shared_ptr<VolumeRAM> destination) const {
+    if (source->getDimensions() != destination->getDimensions()) {
+        destination->setDimensions(source->getDimensions());
+    }
+    source->readRegion(size3_t{0}, *destination);
+    destination->setSwizzleMask(source->getSwizzleMask());
+    destination->setInterpolation(source->getInterpolation());
+    destination->setWrapping(source->getWrapping());
+}
+
 }  // namespace inviwo
@@ -31,30 +31,69 @@
 #include <inviwo/core/io/datareaderexception.h>
 #include <inviwo/core/util/raiiutils.h>
 #include <inviwo/core/util/filesystem.h>
+#include <inviwo/core/util/foreach.h>
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <thread>
 
 namespace inviwo {
 
+namespace {
+
+// Size of the chunks used for reading, i.e. the granularity of the progress
+constexpr size_t chunkSize = 16 * 1024 * 1024;
+// Size of the chunks that are copied and byte swapped in parallel
+constexpr size_t copyChunkSize = 4 * 1024 * 1024;
+
+void reverseBytes(char* data, size_t bytes, size_t elementSize) {
+    for (size_t i = 0; i + elementSize <= bytes; i += elementSize) {
+        std::reverse(data + i, data + i + elementSize);
+    }
+}
+
+void copyChunk(const char* source, size_t bytes, bool swap, size_t elementSize, char* dest) {
+    if (source != dest) std::memcpy(dest, source, bytes);
+    if (swap) reverseBytes(dest, bytes, elementSize);
+}
+
+}  // namespace
+
+bool util::isSystemLittleEndian() {
+    const std::uint16_t value = 1;
+    unsigned char first;
+    std::memcpy(&first, &value, 1);
+    return first == 1;
+}
+
 void util::readBytesIntoBuffer(const std::string& file, size_t offset, size_t bytes,
-                               bool littleEndian, size_t elementSize, void* dest) {
+                               bool littleEndian, size_t elementSize, void* dest,
+                               const std::function<void(float)>& progress) {
     auto fin = filesystem::ifstream(file, std::ios::in | std::ios::binary);
     OnScopeExit close([&fin]() { fin.close(); });
 
     if (fin.good()) {
         fin.seekg(offset);
-        fin.read(static_cast<char*>(dest), bytes);
-
-        if (!littleEndian && elementSize > 1) {
-            char* temp = new char[elementSize];
-
-            for (std::size_t i = 0; i < bytes; i += elementSize) {
-                for (std::size_t j = 0; j < elementSize; j++)
-                    temp[j] = static_cast<char*>(dest)[i + j];
-
-                for (std::size_t j = 0; j < elementSize; j++)
-                    static_cast<char*>(dest)[i + j] = temp[elementSize - j - 1];
+        auto data = static_cast<char*>(dest);
+        for (size_t read = 0; read < bytes;) {
+            const auto count = std::min(chunkSize, bytes - read);
+            fin.read(data + read, count);
+            if (!fin || static_cast<size_t>(fin.gcount()) != count) {
+                throw DataReaderException(
+                    fmt::format("Error: Could only read {} of {} bytes at offset {} from file: {}",
+                                read + static_cast<size_t>(fin.gcount()), bytes, offset, file),
+                    IVW_CONTEXT_CUSTOM("readBytesIntoBuffer"));
             }
+            read += count;
+            if (progress) progress(static_cast<float>(read) / static_cast<float>(bytes));
+        }
 
-            delete[] temp;
+        if (littleEndian != isSystemLittleEndian() && elementSize > 1) {
+            copyBytesIntoBuffer(dest, bytes, littleEndian, elementSize, dest);
         }
     } else {
         throw DataReaderException("Error: Could not read from file: " + file,
@@ -62,4 +101,30 @@ void util::readBytesIntoBuffer(const std::string& file, size_t offset, size_t by
     }
 }
 
+void util::copyBytesIntoBuffer(const void* source, size_t bytes, bool littleEndian,
+                               size_t elementSize, void* dest,
+                               const std::function<void(float)>& progress) {
+    const bool swap = littleEndian != isSystemLittleEndian() && elementSize > 1;
+    const auto src = static_cast<const char*>(source);
+    const auto dst = static_cast<char*>(dest);
+
+    // Chunks have to contain whole elements for the byte swapping. The calling thread takes part
+    // in the copy, it does not wait on the pool, since loaders call this while the Data is locked.
+    const auto chunk = std::max(copyChunkSize - copyChunkSize % elementSize, elementSize);
+    const auto chunks = (bytes + chunk - 1) / chunk;
+    const auto caller = std::this_thread::get_id();
+    std::atomic<size_t> copied{0};
+    util::forEachIndexParallel(chunks, [&](size_t i) {
+        const auto start = i * chunk;
+        const auto count = std::min(chunk, bytes - start);
+        copyChunk(src + start, count, swap, elementSize, dst + start);
+        const auto done = copied += count;
+        // Only report progress from the calling thread
+        if (progress && std::this_thread::get_id() == caller) {
+            progress(static_cast<float>(done) / static_cast<float>(bytes));
+        }
+    });
+    if (progress) progress(1.0f);
+}
+
 }  // namespace inviwo
@@ -41,24 +41,26 @@ namespace inviwo {
 
 namespace util {
 
-void saveLayer(const Layer& layer, std::string_view path, const FileExtension& extension) {
+std::unique_ptr<DataWriterType<Layer>> getLayerWriter(std::string_view path,
+                                                      const FileExtension& extension) {
     auto factory = InviwoApplication::getPtr()->getDataWriterFactory();
 
-    auto writer = std::shared_ptr<DataWriterType<Layer>>(
-        factory->getWriterForTypeAndExtension<Layer>(extension));
+    if (auto writer = factory->getWriterForTypeAndExtension<Layer>(extension)) {
+        return writer;
+    }
+    // could not find a writer for the given extension, extension might be invalid
+    // try to get writer for the extension extracted from the file name, i.e. path
+    return factory->getWriterForTypeAndExtension<Layer>(filesystem::getFileExtension(path));
+}
 
+void saveLayer(const Layer& layer, std::string_view path, const FileExtension& extension) {
+    auto writer = getLayerWriter(path, extension);
     if (!writer) {
-        // could not find a reader for the given extension, extension might be invalid
-        // try to get reader for the extension extracted from the file name, i.e. path
         const auto ext = filesystem::getFileExtension(path);
-        writer = std::shared_ptr<DataWriterType<Layer>>(
-            factory->getWriterForTypeAndExtension<Layer>(ext));
-        if (!writer) {
-            LogInfoCustom(
-                "ImageWriterUtil",
-                "Could not find a writer for the specified file extension (\"" << ext << "\")");
-            return;
-        }
+        LogInfoCustom("ImageWriterUtil",
+                      "Could not find a writer for the specified file extension (\""
+                          << ext << "\")");
+        return;
     }
 
     try {
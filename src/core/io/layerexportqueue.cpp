@@ -0,0 +1,202 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <inviwo/core/io/layerexportqueue.h>
+#include <inviwo/core/common/inviwoapplication.h>
+#include <inviwo/core/datastructures/image/layer.h>
+#include <inviwo/core/datastructures/image/layerram.h>
+#include <inviwo/core/datastructures/image/layerramprecision.h>
+#include <inviwo/core/io/imagewriterutil.h>
+#include <inviwo/core/util/evaluationprofiler.h>
+#include <inviwo/core/util/exception.h>
+#include <inviwo/core/util/filesystem.h>
+#include <inviwo/core/util/logcentral.h>
+
+#include <algorithm>
+#include <cstring>
+
+namespace inviwo {
+
+using Clock = std::chrono::steady_clock;
+
+struct LayerExportQueue::State {
+    std::mutex mutex;
+    std::vector<std::shared_ptr<LayerRAM>> buffers;
+    Statistics stats;
+    std::optional<Clock::time_point> start;
+};
+
+double LayerExportQueue::Statistics::framesPerSecond() const {
+    return elapsed.count() > 0.0 ? static_cast<double>(written) / elapsed.count() : 0.0;
+}
+
+LayerExportQueue::LayerExportQueue(size_t capacity)
+    : capacity_{capacity}, state_{std::make_shared<State>()} {
+    if (capacity_ == 0) {
+        const auto threads =
+            InviwoApplication::isInitialized() ? InviwoApplication::getPtr()->getPoolSize() : 0;
+        capacity_ = std::max(size_t{2}, 2 * threads);
+    }
+}
+
+LayerExportQueue::~LayerExportQueue() { wait(); }
+
+bool LayerExportQueue::enqueue(const Layer& layer, std::string_view path,
+                               const FileExtension& extension) {
+    std::shared_ptr<DataWriterType<Layer>> writer = util::getLayerWriter(path, extension);
+    if (!writer) {
+        const auto ext = filesystem::getFileExtension(path);
+        LogErrorCustom("LayerExportQueue",
+                       "Could not find a writer for the specified file extension (\"" << ext
+                                                                                       << "\")");
+        return false;
+    }
+    writer->setOverwrite(true);
+
+    const bool usePool =
+        InviwoApplication::isInitialized() && InviwoApplication::getPtr()->getPoolSize() > 0;
+
+    // Remove the written frames, and wait for the oldest ones while the queue is full
+    pending_.erase(std::remove_if(pending_.begin(), pending_.end(),
+                                  [](std::future<void>& future) {
+                                      return future.wait_for(std::chrono::seconds(0)) ==
+                                             std::future_status::ready;
+                                  }),
+                   pending_.end());
+    if (pending_.size() >= capacity_) {
+        const auto blockStart = Clock::now();
+        auto& pool = InviwoApplication::getPtr()->getThreadPool();
+        while (pending_.size() >= capacity_) {
+            pool.wait(pending_.front());
+            pending_.pop_front();
+        }
+        std::scoped_lock lock{state_->mutex};
+        ++state_->stats.blocked;
+        state_->stats.blockedTime += Clock::now() - blockStart;
+    }
+
+    {
+        std::scoped_lock lock{state_->mutex};
+        if (!state_->start) state_->start = Clock::now();
+    }
+
+    // Copy the layer, such that the next frame can be rendered into it while this one is written
+    const auto src = layer.getRepresentation<LayerRAM>();
+    auto buffer = acquireBuffer(*src);
+    std::memcpy(buffer->getData(), src->getData(),
+                glm::compMul(src->getDimensions()) * src->getDataFormat()->getSize());
+    auto frame = std::make_shared<Layer>(buffer);
+
+    auto write = [state = state_, writer, frame, buffer, path = std::string{path}]() mutable {
+        const auto start = Clock::now();
+        bool success = true;
+        try {
+            EvaluationProfiler::Scope scope("export", typeid(*writer));
+            writer->writeData(frame.get(), path);
+        } catch (const Exception& e) {
+            success = false;
+            LogErrorCustom("LayerExportQueue", e.getMessage());
+        } catch (const std::exception& e) {
+            success = false;
+            LogErrorCustom("LayerExportQueue", e.what());
+        }
+        frame.reset();
+        const auto end = Clock::now();
+
+        std::scoped_lock lock{state->mutex};
+        if (success) {
+            ++state->stats.written;
+        } else {
+            ++state->stats.failed;
+        }
+        state->stats.writeTime += end - start;
+        if (state->start) state->stats.elapsed = end - *state->start;
+        state->buffers.push_back(std::move(buffer));
+    };
+
+    if (usePool) {
+        pending_.push_back(dispatchPool(std::move(write)));
+    } else {
+        write();
+    }
+    return true;
+}
+
+void LayerExportQueue::wait() {
+    if (pending_.empty()) return;
+    auto& pool = InviwoApplication::getPtr()->getThreadPool();
+    for (auto& future : pending_) pool.wait(future);
+    pending_.clear();
+}
+
+size_t LayerExportQueue::getCapacity() const { return capacity_; }
+
+size_t LayerExportQueue::getPending() const {
+    return std::count_if(pending_.begin(), pending_.end(), [](const std::future<void>& future) {
+        return future.wait_for(std::chrono::seconds(0)) != std::future_status::ready;
+    });
+}
+
+LayerExportQueue::Statistics LayerExportQueue::getStatistics() const {
+    std::scoped_lock lock{state_->mutex};
+    return state_->stats;
+}
+
+void LayerExportQueue::resetStatistics() {
+    std::scoped_lock lock{state_->mutex};
+    state_->stats = Statistics{};
+    state_->start.reset();
+}
+
+std::shared_ptr<LayerRAM> LayerExportQueue::acquireBuffer(const LayerRAM& src) {
+    {
+        std::scoped_lock lock{state_->mutex};
+        auto& buffers = state_->buffers;
+        // Buffers of frames with a different size or format are not needed anymore
+        buffers.erase(std::remove_if(buffers.begin(), buffers.end(),
+                                     [&](const std::shared_ptr<LayerRAM>& buffer) {
+                                         return buffer->getDimensions() != src.getDimensions() ||
+                                                buffer->getDataFormat() != src.getDataFormat() ||
+                                                buffer->getLayerType() != src.getLayerType();
+                                     }),
+                      buffers.end());
+        if (!buffers.empty()) {
+            auto buffer = std::move(buffers.back());
+            buffers.pop_back();
+            buffer->setSwizzleMask(src.getSwizzleMask());
+            buffer->setInterpolation(src.getInterpolation());
+            buffer->setWrapping(src.getWrapping());
+            return buffer;
+        }
+    }
+    return createLayerRAM(src.getDimensions(), src.getLayerType(), src.getDataFormat(),
+                          src.getSwizzleMask(), src.getInterpolation(), src.getWrapping());
+}
+
+}  // namespace inviwo
@@ -0,0 +1,133 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <inviwo/core/io/rawvolumebrickloader.h>
+#include <inviwo/core/io/bytereaderutil.h>
+#include <inviwo/core/io/datareaderexception.h>
+#include <inviwo/core/io/datawriterexception.h>
+#include <inviwo/core/datastructures/volume/volumeram.h>
+#include <inviwo/core/util/filesystem.h>
+#include <inviwo/core/util/memorymappedfile.h>
+
+#include <cstring>
+
+#include <fmt/format.h>
+
+namespace inviwo {
+
+RawVolumeBrickLoader::RawVolumeBrickLoader(const std::string& rawFile, size_t offset,
+                                           bool littleEndian, size3_t dimensions,
+                                           const DataFormatBase* format, Layout layout,
+                                           size3_t brickSize)
+    : offset_{offset}
+    , littleEndian_{littleEndian}
+    , dimensions_{dimensions}
+    , format_{format}
+    , layout_{layout}
+    , brickSize_{brickSize} {
+
+    try {
+        file_ = std::make_unique<util::MemoryMappedFile>(
+            rawFile, layout == Layout::Linear ? util::MemoryMappedFile::Access::Random
+                                              : util::MemoryMappedFile::Access::Normal);
+    } catch (const FileException& e) {
+        throw DataReaderException(e.getMessage(), IVW_CONTEXT);
+    }
+
+    const auto size = glm::compMul(dimensions_) * format_->getSize();
+    if (offset_ > file_->size() || size > file_->size() - offset_) {
+        throw DataReaderException(
+            fmt::format("Error: File '{}' is too small, expected {} bytes from offset {} but the "
+                        "file has {} bytes",
+                        rawFile, size, offset_, file_->size()),
+            IVW_CONTEXT);
+    }
+    if (layout_ == Layout::Bricked && glm::any(glm::equal(brickSize_, size3_t{0}))) {
+        throw DataReaderException(
+            fmt::format("Error: Invalid brick size for bricked raw file '{}'", rawFile),
+            IVW_CONTEXT);
+    }
+}
+
+RawVolumeBrickLoader::~RawVolumeBrickLoader() = default;
+
+void RawVolumeBrickLoader::loadBrick(size3_t offset, size3_t extent, void* dest) const {
+    const auto voxelSize = format_->getSize();
+    const auto bytes = glm::compMul(extent) * voxelSize;
+    const auto src = file_->data() + offset_;
+    auto dst = static_cast<char*>(dest);
+
+    if (layout_ == Layout::Linear) {
+        const auto rowSize = extent.x * voxelSize;
+        for (size_t z = 0; z < extent.z; ++z) {
+            for (size_t y = 0; y < extent.y; ++y) {
+                const auto pos = offset + size3_t{0, y, z};
+                const auto index = (pos.z * dimensions_.y + pos.y) * dimensions_.x + pos.x;
+                std::memcpy(dst + (z * extent.y + y) * rowSize, src + index * voxelSize, rowSize);
+            }
+        }
+    } else {
+        const auto expected = glm::min(brickSize_, dimensions_ - offset);
+        if (offset % brickSize_ != size3_t{0} || extent != expected) {
+            throw DataReaderException(
+                fmt::format("Error: Brick at ({}, {}, {}) does not match the bricks of the file "
+                            "'{}'",
+                            offset.x, offset.y, offset.z, file_->getFilePath()),
+                IVW_CONTEXT);
+        }
+        // All bricks before the brick's slab and row are of full size in z and y respectively
+        const auto index = dimensions_.x * dimensions_.y * offset.z +
+                           dimensions_.x * offset.y * extent.z + offset.x * extent.y * extent.z;
+        std::memcpy(dst, src + index * voxelSize, bytes);
+    }
+
+    const auto componentSize = voxelSize / format_->getComponents();
+    if (littleEndian_ != util::isSystemLittleEndian() && componentSize > 1) {
+        util::copyBytesIntoBuffer(dst, bytes, littleEndian_, componentSize, dst);
+    }
+}
+
+void util::writeBrickedRawFile(const VolumeBricked& volume, const std::string& filePath) {
+    auto out = filesystem::ofstream(filePath, std::ios::out | std::ios::binary);
+    if (!out.good()) {
+        throw DataWriterException("Error: Could not write to raw file: " + filePath,
+                                  IVW_CONTEXT_CUSTOM("writeBrickedRawFile"));
+    }
+    const auto voxelSize = volume.getDataFormat()->getSize();
+    volume.forEachBrick([&](const VolumeRAM& brick, size3_t) {
+        out.write(static_cast<const char*>(brick.getData()),
+                  glm::compMul(brick.getDimensions()) * voxelSize);
+    });
+    if (!out.good()) {
+        throw DataWriterException("Error: Could not write to raw file: " + filePath,
+                                  IVW_CONTEXT_CUSTOM("writeBrickedRawFile"));
+    }
+}
+
+}  // namespace inviwo
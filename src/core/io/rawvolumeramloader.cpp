@@ -30,24 +30,93 @@
 #include <inviwo/core/io/rawvolumeramloader.h>
 
 #include <inviwo/core/datastructures/volume/volumeramprecision.h>
+#include <inviwo/core/util/memorymappedfile.h>
+
+#include <fmt/format.h>
 
 namespace inviwo {
 
-RawVolumeRAMLoader::RawVolumeRAMLoader(const std::string& rawFile, size_t offset, bool littleEndian)
-    : rawFile_(rawFile), offset_(offset), littleEndian_(littleEndian) {}
+namespace {
+
+std::shared_ptr<util::MemoryMappedFile> mapFile(const std::string& rawFile, size_t offset,
+                                                size_t size) {
+    auto file = [&]() {
+        try {
+            return std::make_shared<util::MemoryMappedFile>(
+                rawFile, util::MemoryMappedFile::Access::Sequential,
+                util::MemoryMappedFile::Mode::CopyOnWrite);
+        } catch (const FileException& e) {
+            throw DataReaderException(e.getMessage(), IVW_CONTEXT_CUSTOM("RawVolumeRAMLoader"));
+        }
+    }();
+    if (offset > file->size() || size > file->size() - offset) {
+        throw DataReaderException(
+            fmt::format("Error: File '{}' is too small, expected {} bytes from offset {} but the "
+                        "file has {} bytes",
+                        rawFile, size, offset, file->size()),
+            IVW_CONTEXT_CUSTOM("RawVolumeRAMLoader"));
+    }
+    return file;
+}
+
+}  // namespace
+
+RawVolumeRAMLoader::RawVolumeRAMLoader(const std::string& rawFile, size_t offset, bool littleEndian,
+                                       Mode mode)
+    : rawFile_(rawFile), offset_(offset), littleEndian_(littleEndian), mode_(mode) {}
 
 RawVolumeRAMLoader* RawVolumeRAMLoader::clone() const { return new RawVolumeRAMLoader(*this); }
 
+void RawVolumeRAMLoader::setProgressCallback(std::function<void(float)> progress) {
+    progress_ = std::move(progress);
+}
+
 std::shared_ptr<VolumeRepresentation> RawVolumeRAMLoader::createRepresentation(
     const VolumeRepresentation& src) const {
 
-    const auto size = glm::compMul(src.getDimensions()) * src.getDataFormat()->getSize();
+    const auto format = src.getDataFormat();
+    const auto size = glm::compMul(src.getDimensions()) * format->getSize();
+    const auto componentSize = format->getSize() / format->getComponents();
+
+    if (mode_ == Mode::MemoryMap) {
+        auto file = mapFile(rawFile_, offset_, size);
+        const bool swap = littleEndian_ != util::isSystemLittleEndian() && componentSize > 1;
+
+        // The mapping is page aligned, hence the data is aligned if the offset is
+        if (!swap && offset_ % componentSize == 0 && size > 0) {
+            file->prefetch(offset_, size);
+            auto volumeRAM =
+                createVolumeRAM(src.getDimensions(), format, file->mutableData() + offset_,
+                                src.getSwizzleMask(), src.getInterpolation(), src.getWrapping());
+            volumeRAM->removeDataOwnership();
+            if (progress_) progress_(1.0f);
+
+            // Keep the mapping alive for as long as the representation
+            struct MappedVolumeRAM {
+                std::shared_ptr<util::MemoryMappedFile> file;
+                std::shared_ptr<VolumeRAM> volume;
+            };
+            auto mapped = std::make_shared<MappedVolumeRAM>(
+                MappedVolumeRAM{std::move(file), std::move(volumeRAM)});
+            return std::shared_ptr<VolumeRepresentation>(mapped, mapped->volume.get());
+        }
+
+        auto data = std::make_unique<char[]>(size);
+        util::copyBytesIntoBuffer(file->data() + offset_, size, littleEndian_, componentSize,
+                                  data.get(), progress_);
+        auto volumeRAM =
+            createVolumeRAM(src.getDimensions(), format, data.get(), src.getSwizzleMask(),
+                            src.getInterpolation(), src.getWrapping());
+        data.release();
+        return volumeRAM;
+    }
+
     auto data = std::make_unique<char[]>(size);
-    util::readBytesIntoBuffer(rawFile_, offset_, size, littleEndian_,
-                              src.getDataFormat()->getSize(), data.get());
+    util::readBytesIntoBuffer(rawFile_, offset_, size, littleEndian_, componentSize, data.get(),
+                              progress_);
 
     auto volumeRAM =
-        createVolumeRAM(src.getDimensions(), src.getDataFormat(), data.get(), src.getSwizzleMask(),
+        createVolumeRAM(src.getDimensions(), format, data.get(), src.getSwizzleMask(),
                         src.getInterpolation(), src.getWrapping());
     data.release();
 
@@ -62,12 +131,46 @@ void RawVolumeRAMLoader::updateRepresentation(std::shared_ptr<VolumeRepresentati
         volumeDst->setDimensions(src.getDimensions());
     }
 
-    const auto size = glm::compMul(src.getDimensions());
-    util::readBytesIntoBuffer(rawFile_, offset_, size * src.getDataFormat()->getSize(),
-                              littleEndian_, src.getDataFormat()->getSize(), volumeDst->getData());
+    const auto format = src.getDataFormat();
+    const auto size = glm::compMul(src.getDimensions()) * format->getSize();
+    const auto componentSize = format->getSize() / format->getComponents();
+    if (mode_ == Mode::MemoryMap) {
+        const auto file = mapFile(rawFile_, offset_, size);
+        util::copyBytesIntoBuffer(file->data() + offset_, size, littleEndian_, componentSize,
+                                  volumeDst->getData(), progress_);
+    } else {
+        util::readBytesIntoBuffer(rawFile_, offset_, size, littleEndian_, componentSize,
+                                  volumeDst->getData(), progress_);
+    }
 
     volumeDst->setSwizzleMask(src.getSwizzleMask());
     volumeDst->setInterpolation(src.getInterpolation());
     volumeDst->setWrapping(src.getWrapping());
 }
+
+bool RawVolumeReaderOptions::setOption(std::string_view key, const std::any& value) {
+    if (key == "MemoryMap") {
+        if (auto enable = std::any_cast<bool>(&value)) {
+            memoryMap = *enable;
+            return true;
+        }
+    } else if (key == "BrickSize") {
+        if (auto size = std::any_cast<size3_t>(&value)) {
+            brickSize = *size;
+            return true;
+        }
+    }
+    return false;
+}
+
+std::any RawVolumeReaderOptions::getOption(std::string_view key) const {
+    if (key == "MemoryMap") return memoryMap;
+    if (key == "BrickSize") return brickSize;
+    return std::any{};
+}
+
+RawVolumeRAMLoader::Mode RawVolumeReaderOptions::getMode() const {
+    return memoryMap ? RawVolumeRAMLoader::Mode::MemoryMap : RawVolumeRAMLoader::Mode::Read;
+}
+
 }  // namespace inviwo
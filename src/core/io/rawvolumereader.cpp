@@ -34,6 +34,7 @@
 #include <inviwo/core/util/formatconversion.h>
 #include <inviwo/core/io/datareaderexception.h>
 #include <inviwo/core/io/rawvolumeramloader.h>
+#include <inviwo/core/io/rawvolumebrickloader.h>
 #include <inviwo/core/metadata/metadataowner.h>
 
 namespace inviwo {
@@ -46,7 +47,8 @@ RawVolumeReader::RawVolumeReader()
     , spacing_(0.01f)
     , format_(nullptr)
     , byteOffset_(0u)
-    , parametersSet_(false) {
+    , parametersSet_(false)
+    , options_() {
     addExtension(FileExtension("raw", "Raw binary file"));
 }
 
@@ -58,7 +60,8 @@ RawVolumeReader::RawVolumeReader(const RawVolumeReader& rhs)
     , spacing_(rhs.spacing_)
     , format_(rhs.format_)
     , byteOffset_(rhs.byteOffset_)
-    , parametersSet_(false) {}
+    , parametersSet_(false)
+    , options_(rhs.options_) {}
 
 RawVolumeReader& RawVolumeReader::operator=(const RawVolumeReader& that) {
     if (this != &that) {
@@ -69,6 +72,7 @@ RawVolumeReader& RawVolumeReader::operator=(const RawVolumeReader& that) {
         format_ = that.format_;
         dataMapper_ = that.dataMapper_;
         byteOffset_ = that.byteOffset_;
+        options_ = that.options_;
         DataReaderType<Volume>::operator=(that);
     }
 
@@ -87,6 +91,14 @@ void RawVolumeReader::setParameters(const DataFormatBase* format, ivec3 dimensio
     byteOffset_ = byteOffset;
 }
 
+bool RawVolumeReader::setOption(std::string_view key, std::any value) {
+    return options_.setOption(key, value);
+}
+
+std::any RawVolumeReader::getOption(std::string_view key) {
+    return options_.getOption(key);
+}
+
 std::shared_ptr<Volume> RawVolumeReader::readData(const std::string& filePath) {
     return readData(filePath, nullptr);
 }
@@ -173,10 +185,18 @@ std::shared_ptr<Volume> RawVolumeReader::readData(const std::string& filePath,
         volume->setBasis(basis);
         volume->setOffset(offset);
         volume->setWorldMatrix(wtm);
-        auto vd = std::make_shared<VolumeDisk>(filePath, dimensions_, format_);
-        auto loader = std::make_unique<RawVolumeRAMLoader>(rawFile_, byteOffset_, littleEndian_);
-        vd->setLoader(loader.release());
-        volume->addRepresentation(vd);
+        if (options_.brickSize != size3_t{0u}) {
+            auto loader = std::make_shared<RawVolumeBrickLoader>(
+                rawFile_, byteOffset_, littleEndian_, dimensions_, format_);
+            volume->addRepresentation(
+                std::make_shared<VolumeBricked>(loader, dimensions_, format_, options_.brickSize));
+        } else {
+            auto vd = std::make_shared<VolumeDisk>(filePath, dimensions_, format_);
+            auto loader = std::make_unique<RawVolumeRAMLoader>(rawFile_, byteOffset_,
+                                                               littleEndian_, options_.getMode());
+            vd->setLoader(loader.release());
+            volume->addRepresentation(vd);
+        }
 
         volume->dataMap_ = dataMapper_;
         std::string size = util::formatBytesToString(dimensions_.x * dimensions_.y * dimensions_.z *
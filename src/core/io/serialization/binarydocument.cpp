@@ -0,0 +1,369 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <inviwo/core/io/serialization/binarydocument.h>
+#include <inviwo/core/io/serialization/serializationexception.h>
+#include <inviwo/core/io/serialization/ticpp.h>
+
+#include <array>
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include <fmt/format.h>
+
+namespace inviwo {
+
+namespace {
+
+// The first byte is not valid at the start of an xml document, which makes detection trivial.
+constexpr std::array<char, 4> magic{'\x89', 'I', 'V', 'B'};
+constexpr std::uint8_t formatVersion = 1;
+
+enum class Record : std::uint8_t { End, Element, Run, Text, Comment, Declaration, Unknown };
+
+/**
+ * ticpp does not expose the wrapped TinyXML nodes, but the visitor gets them. Working on the raw
+ * nodes avoids creating a ticpp wrapper for every node.
+ */
+struct DocumentGetter : TiXmlVisitor {
+    virtual bool VisitEnter(const TiXmlDocument& doc) override {
+        document = &doc;
+        return false;
+    }
+    const TiXmlDocument* document = nullptr;
+};
+
+const TiXmlDocument& getDocument(const TxDocument& doc) {
+    DocumentGetter getter;
+    doc.Accept(&getter);
+    return *getter.document;
+}
+
+bool sameLayout(const TiXmlElement& a, const TiXmlElement& b) {
+    if (a.ValueStr() != b.ValueStr()) return false;
+    auto aa = a.FirstAttribute();
+    auto ba = b.FirstAttribute();
+    for (; aa && ba; aa = aa->Next(), ba = ba->Next()) {
+        if (aa->NameTStr() != ba->NameTStr()) return false;
+    }
+    return aa == nullptr && ba == nullptr;
+}
+
+size_t attributeCount(const TiXmlElement& elem) {
+    size_t count = 0;
+    for (auto attr = elem.FirstAttribute(); attr; attr = attr->Next()) ++count;
+    return count;
+}
+
+class Writer {
+public:
+    void writeChildren(const TiXmlNode& parent) {
+        for (auto node = parent.FirstChild(); node;) {
+            switch (node->Type()) {
+                case TiXmlNode::ELEMENT: {
+                    const auto& elem = *node->ToElement();
+                    size_t count = 1;
+                    auto next = node->NextSibling();
+                    while (next && next->Type() == TiXmlNode::ELEMENT &&
+                           sameLayout(elem, *next->ToElement())) {
+                        ++count;
+                        next = next->NextSibling();
+                    }
+                    if (count == 1) {
+                        writeElement(elem);
+                    } else {
+                        writeRun(elem, count);
+                    }
+                    node = next;
+                    continue;
+                }
+                case TiXmlNode::TEXT: {
+                    put(Record::Text);
+                    put(static_cast<std::uint8_t>(node->ToText()->CDATA()));
+                    writeString(node->ValueStr());
+                    break;
+                }
+                case TiXmlNode::COMMENT:
+                    put(Record::Comment);
+                    writeString(node->ValueStr());
+                    break;
+                case TiXmlNode::DECLARATION: {
+                    const auto& decl = *node->ToDeclaration();
+                    put(Record::Declaration);
+                    writeString(decl.Version());
+                    writeString(decl.Encoding());
+                    writeString(decl.Standalone());
+                    break;
+                }
+                case TiXmlNode::UNKNOWN:
+                    put(Record::Unknown);
+                    writeString(node->ValueStr());
+                    break;
+                default:
+                    break;
+            }
+            node = node->NextSibling();
+        }
+        put(Record::End);
+    }
+
+    void write(std::ostream& stream) const {
+        stream.write(magic.data(), magic.size());
+        stream.put(static_cast<char>(formatVersion));
+
+        std::string header;
+        writeVarint(header, names_.size());
+        for (auto name : names_) writeString(header, *name);
+        stream.write(header.data(), header.size());
+        stream.write(body_.data(), body_.size());
+    }
+
+private:
+    void writeElement(const TiXmlElement& elem) {
+        put(Record::Element);
+        writeName(elem.ValueStr());
+        writeVarint(attributeCount(elem));
+        for (auto attr = elem.FirstAttribute(); attr; attr = attr->Next()) {
+            writeName(attr->NameTStr());
+            writeString(attr->ValueStr());
+        }
+        writeChildren(elem);
+    }
+
+    void writeRun(const TiXmlElement& first, size_t count) {
+        put(Record::Run);
+        writeVarint(count);
+        writeName(first.ValueStr());
+        writeVarint(attributeCount(first));
+        for (auto attr = first.FirstAttribute(); attr; attr = attr->Next()) {
+            writeName(attr->NameTStr());
+        }
+        const TiXmlNode* node = &first;
+        for (size_t i = 0; i < count; ++i, node = node->NextSibling()) {
+            const auto& elem = *node->ToElement();
+            for (auto attr = elem.FirstAttribute(); attr; attr = attr->Next()) {
+                writeString(attr->ValueStr());
+            }
+            writeChildren(elem);
+        }
+    }
+
+    void writeName(const std::string& name) {
+        auto [it, inserted] = index_.try_emplace(name, names_.size());
+        if (inserted) names_.push_back(&it->first);
+        writeVarint(it->second);
+    }
+
+    void put(Record record) { body_.push_back(static_cast<char>(record)); }
+    void put(std::uint8_t byte) { body_.push_back(static_cast<char>(byte)); }
+    void writeVarint(size_t value) { writeVarint(body_, value); }
+    void writeString(std::string_view str) { writeString(body_, str); }
+
+    static void writeVarint(std::string& buffer, size_t value) {
+        while (value >= 0x80) {
+            buffer.push_back(static_cast<char>((value & 0x7f) | 0x80));
+            value >>= 7;
+        }
+        buffer.push_back(static_cast<char>(value));
+    }
+    static void writeString(std::string& buffer, std::string_view str) {
+        writeVarint(buffer, str.size());
+        buffer.append(str);
+    }
+
+    std::string body_;
+    std::unordered_map<std::string, size_t> index_;
+    std::vector<const std::string*> names_;
+};
+
+class Reader {
+public:
+    Reader(std::string_view data) : data_{data}, pos_{0} {
+        if (data_.size() < magic.size() + 1 ||
+            data_.substr(0, magic.size()) != std::string_view{magic.data(), magic.size()}) {
+            throw SerializationException("Missing binary document header",
+                                         IVW_CONTEXT_CUSTOM("readBinaryDocument"));
+        }
+        pos_ = magic.size();
+        if (const auto version = readByte(); version != formatVersion) {
+            throw SerializationException(
+                fmt::format("Unsupported binary document version: {}", version),
+                IVW_CONTEXT_CUSTOM("readBinaryDocument"));
+        }
+        const auto nNames = readVarint();
+        for (size_t i = 0; i < nNames; ++i) {
+            names_.emplace_back(readString());
+        }
+    }
+
+    void readChildren(TiXmlNode& parent) {
+        for (;;) {
+            switch (static_cast<Record>(readByte())) {
+                case Record::End:
+                    return;
+                case Record::Element: {
+                    auto elem = new TiXmlElement(readName());
+                    parent.LinkEndChild(elem);
+                    const auto nAttributes = readVarint();
+                    for (size_t i = 0; i < nAttributes; ++i) {
+                        const auto& name = readName();
+                        elem->SetAttribute(name, std::string{readString()});
+                    }
+                    readChildren(*elem);
+                    break;
+                }
+                case Record::Run: {
+                    const auto count = readVarint();
+                    const auto& name = readName();
+                    std::vector<const std::string*> attributes(readVarint());
+                    for (auto& attribute : attributes) attribute = &readName();
+                    for (size_t i = 0; i < count; ++i) {
+                        auto elem = new TiXmlElement(name);
+                        parent.LinkEndChild(elem);
+                        for (auto attribute : attributes) {
+                            elem->SetAttribute(*attribute, std::string{readString()});
+                        }
+                        readChildren(*elem);
+                    }
+                    break;
+                }
+                case Record::Text: {
+                    const bool cdata = readByte() != 0;
+                    auto text = new TiXmlText(std::string{readString()});
+                    text->SetCDATA(cdata);
+                    parent.LinkEndChild(text);
+                    break;
+                }
+                case Record::Comment: {
+                    auto comment = new TiXmlComment();
+                    comment->SetValue(std::string{readString()});
+                    parent.LinkEndChild(comment);
+                    break;
+                }
+                case Record::Declaration: {
+                    const std::string version{readString()};
+                    const std::string encoding{readString()};
+                    const std::string standalone{readString()};
+                    parent.LinkEndChild(new TiXmlDeclaration(version, encoding, standalone));
+                    break;
+                }
+                case Record::Unknown: {
+                    auto unknown = new TiXmlUnknown();
+                    unknown->SetValue(std::string{readString()});
+                    parent.LinkEndChild(unknown);
+                    break;
+                }
+                default:
+                    throw SerializationException(
+                        fmt::format("Invalid record in binary document at byte {}", pos_ - 1),
+                        IVW_CONTEXT_CUSTOM("readBinaryDocument"));
+            }
+        }
+    }
+
+    bool atEnd() const { return pos_ == data_.size(); }
+
+private:
+    std::uint8_t readByte() {
+        if (pos_ >= data_.size()) truncated();
+        return static_cast<std::uint8_t>(data_[pos_++]);
+    }
+
+    size_t readVarint() {
+        size_t value = 0;
+        for (size_t shift = 0; shift < 64; shift += 7) {
+            const auto byte = readByte();
+            value |= static_cast<size_t>(byte & 0x7f) << shift;
+            if ((byte & 0x80) == 0) return value;
+        }
+        throw SerializationException("Invalid integer in binary document",
+                                     IVW_CONTEXT_CUSTOM("readBinaryDocument"));
+    }
+
+    std::string_view readString() {
+        const auto size = readVarint();
+        if (size > data_.size() - pos_) truncated();
+        const auto str = data_.substr(pos_, size);
+        pos_ += size;
+        return str;
+    }
+
+    const std::string& readName() {
+        const auto index = readVarint();
+        if (index >= names_.size()) {
+            throw SerializationException(
+                fmt::format("Invalid name index {} in binary document", index),
+                IVW_CONTEXT_CUSTOM("readBinaryDocument"));
+        }
+        return names_[index];
+    }
+
+    [[noreturn]] void truncated() const {
+        throw SerializationException("Unexpected end of binary document",
+                                     IVW_CONTEXT_CUSTOM("readBinaryDocument"));
+    }
+
+    std::string_view data_;
+    size_t pos_;
+    std::vector<std::string> names_;
+};
+
+}  // namespace
+
+void util::writeBinaryDocument(const TxDocument& doc, std::ostream& stream) {
+    Writer writer;
+    writer.writeChildren(getDocument(doc));
+    writer.write(stream);
+}
+
+void util::readBinaryDocument(std::istream& stream, TxDocument& doc) {
+    std::stringstream buffer;
+    buffer << stream.rdbuf();
+    const auto data = std::move(buffer).str();
+
+    Reader reader{data};
+    // The document is owned by doc, we only get const access to it through the visitor.
+    reader.readChildren(const_cast<TiXmlDocument&>(getDocument(doc)));
+    if (!reader.atEnd()) {
+        throw SerializationException("Unexpected data after the end of binary document",
+                                     IVW_CONTEXT_CUSTOM("readBinaryDocument"));
+    }
+}
+
+bool util::isBinaryDocument(std::istream& stream) {
+    return stream.peek() == static_cast<unsigned char>(magic[0]);
+}
+
+}  // namespace inviwo
@@ -60,6 +60,8 @@ Deserializer::Deserializer(std::istream& stream, std::string_view path)
     try {
         // Base streamed in the xml data. Get the first node.
         rootElement_ = doc_->FirstChildElement();
+        rootElement_->GetAttribute(std::string{SerializeConstants::VersionAttribute},
+                                   &inviwoWorkspaceVersion_, false);
     } catch (TxException& e) {
         throw AbortException(e.what(), IVW_CONTEXT);
     }
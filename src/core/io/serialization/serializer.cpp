@@ -29,6 +29,7 @@
 
 #include <inviwo/core/io/serialization/serializable.h>
 #include <inviwo/core/io/serialization/serializer.h>
+#include <inviwo/core/io/serialization/binarydocument.h>
 #include <inviwo/core/util/exception.h>
 #include <inviwo/core/util/safecstr.h>
 #include <inviwo/core/io/serialization/ticpp.h>
@@ -113,4 +114,12 @@ void Serializer::writeFile(std::ostream& stream, bool format) {
     }
 }
 
+void Serializer::writeBinary(std::ostream& stream) {
+    try {
+        util::writeBinaryDocument(*doc_, stream);
+    } catch (TxException& e) {
+        throw SerializationException(e.what(), IVW_CONTEXT);
+    }
+}
+
 }  // namespace inviwo
@@ -41,6 +41,7 @@
 #include <inviwo/core/metadata/processormetadata.h>
 #include <inviwo/core/network/networkvisitor.h>
 #include <inviwo/core/network/networkedge.h>
+#include <inviwo/core/properties/compositeproperty.h>
 
 #include <fmt/format.h>
 
@@ -82,6 +83,7 @@ bool ProcessorNetwork::addProcessor(Processor* processor) {
             std::string old{oldID};
             processors_[std::string{newID}] = processors_[old];
             processors_.erase(old);
+            clearPropertyPathCache();
         });
     addPropertyOwnerObservation(processor);
 
@@ -131,6 +133,7 @@ void ProcessorNetwork::removeProcessor(Processor* processor) {
     // remove processor itself
     notifyObserversProcessorNetworkWillRemoveProcessor(processor);
     processors_.erase(processor->getIdentifier());
+    clearPropertyPathCache();
     processor->ProcessorObservable::removeObserver(this);
     onIdChange_.erase(processor);
     removePropertyOwnerObservation(processor);
@@ -149,6 +152,7 @@ void ProcessorNetwork::removeAndDeleteProcessor(Processor* processor) {
     // remove processor itself
     notifyObserversProcessorNetworkWillRemoveProcessor(processor);
     processors_.erase(processor->getIdentifier());
+    clearPropertyPathCache();
     removePropertyOwnerObservation(processor);
     processor->setNetwork(nullptr);
     processor->setProcessorWidget(nullptr);
@@ -280,13 +284,22 @@ void ProcessorNetwork::removeLink(Property* src, Property* dst) {
     removeLink(link);
 }
 
+void ProcessorNetwork::onDidAddProperty(Property* property, size_t /*index*/) {
+    clearPropertyPathCache();
+    if (auto comp = dynamic_cast<CompositeProperty*>(property)) {
+        addPropertyOwnerObservation(comp);
+    }
+}
+
 void ProcessorNetwork::onWillRemoveProperty(Property* property, size_t /*index*/) {
+    clearPropertyPathCache();
     if (auto comp = dynamic_cast<PropertyOwner*>(property)) {
         size_t i = 0;
         for (auto p : comp->getProperties()) {
             onWillRemoveProperty(p, i);
             i++;
         }
+        comp->removeObserver(this);
     }
 
     auto toDelete =
@@ -294,6 +307,8 @@ void ProcessorNetwork::onWillRemoveProperty(Property* property, size_t /*index*/
     for (auto& link : toDelete) removeLink(link);
 }
 
+void ProcessorNetwork::onDidChangePropertyIdentifier(Property*) { clearPropertyPathCache(); }
+
 bool ProcessorNetwork::isLinked(const PropertyLink& link) const {
     return links_.find(link) != links_.end();
 }
@@ -586,13 +601,37 @@ void ProcessorNetwork::deserialize(Deserializer& d) {
 bool ProcessorNetwork::isDeserializing() const { return deserializing_; }
 
 Property* ProcessorNetwork::getProperty(std::string_view path) const {
+    std::string key{path};
+    size_t generation = 0;
+    {
+        std::scoped_lock lock{propertyPathCacheMutex_};
+        if (auto it = propertyPathCache_.find(key); it != propertyPathCache_.end()) {
+            return it->second;
+        }
+        generation = propertyPathCacheGeneration_;
+    }
+
     const auto [processorId, propertyPath] = util::splitByFirst(path, '.');
     if (auto processor = getProcessorByIdentifier(processorId)) {
-        return processor->getPropertyByPath(propertyPath);
+        if (auto property = processor->getPropertyByPath(propertyPath)) {
+            std::scoped_lock lock{propertyPathCacheMutex_};
+            // Don't cache the result if the cache was cleared while resolving the path, the
+            // property might have been removed since.
+            if (generation == propertyPathCacheGeneration_) {
+                propertyPathCache_.emplace(std::move(key), property);
+            }
+            return property;
+        }
     }
     return nullptr;
 }
 
+void ProcessorNetwork::clearPropertyPathCache() {
+    std::scoped_lock lock{propertyPathCacheMutex_};
+    propertyPathCache_.clear();
+    ++propertyPathCacheGeneration_;
+}
+
 Port* ProcessorNetwork::getPort(std::string_view path) const {
     const auto [processorId, portId] = util::splitByFirst(path, '.');
     if (auto processor = getProcessorByIdentifier(processorId)) {
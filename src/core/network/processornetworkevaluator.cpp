@@ -35,6 +35,14 @@
 #include <inviwo/core/network/networkutils.h>
 #include <inviwo/core/network/networklock.h>
 #include <inviwo/core/util/clock.h>
+#include <inviwo/core/util/evaluationprofiler.h>
+#include <inviwo/core/util/threadpool.h>
+#include <inviwo/core/common/inviwoapplication.h>
+
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <unordered_map>
 
 namespace inviwo {
 
@@ -42,7 +50,8 @@ ProcessorNetworkEvaluator::ProcessorNetworkEvaluator(ProcessorNetwork* processor
     : processorNetwork_(processorNetwork)
     , processorsSorted_(util::topologicalSortFiltered(processorNetwork_))
     , evaulationQueued_(false)
-    , exceptionHandler_(StandardEvaluationErrorHandler()) {
+    , exceptionHandler_(StandardEvaluationErrorHandler())
+    , evaluationMode_(EvaluationMode::Serial) {
 
     processorNetwork_->addObserver(this);
 }
@@ -51,6 +60,12 @@ void ProcessorNetworkEvaluator::setExceptionHandler(EvaluationErrorHandler handl
     exceptionHandler_ = handler;
 }
 
+void ProcessorNetworkEvaluator::setEvaluationMode(EvaluationMode mode) {
+    evaluationMode_ = mode;
+}
+
+EvaluationMode ProcessorNetworkEvaluator::getEvaluationMode() const { return evaluationMode_; }
+
 void ProcessorNetworkEvaluator::onProcessorNetworkEvaluateRequest() {
     // Direct request, thus we don't want to queue the evaluation anymore
     evaulationQueued_ = false;
@@ -101,58 +116,218 @@ void ProcessorNetworkEvaluator::evaluate() {
 
     IVW_CPU_PROFILING_IF(500, "Evaluated Processor Network");
 
+    switch (evaluationMode_) {
+        case EvaluationMode::Parallel:
+            evaluateParallel();
+            break;
+        case EvaluationMode::Serial:
+        default:
+            evaluateSerial();
+            break;
+    }
+
+    notifyObserversProcessorNetworkEvaluationEnd();
+}
+
+void ProcessorNetworkEvaluator::evaluateSerial() {
     for (auto processor : processorsSorted_) {
         if (!processor->isValid()) {
             if (processor->isReady()) {
-                try {
-                    // re-initialize resources (e.g., shaders) if necessary
-                    if (processor->getInvalidationLevel() >= InvalidationLevel::InvalidResources) {
-                        processor->initializeResources();
-                    }
-                } catch (...) {
-                    exceptionHandler_(processor, EvaluationType::InitResource, IVW_CONTEXT);
-                    continue;
-                }
-
-                try {
-                    // call onChange for all invalid inports
-                    for (auto inport : processor->getInports()) {
-                        inport->callOnChangeIfChanged();
-                    }
-                } catch (...) {
-                    exceptionHandler_(processor, EvaluationType::PortOnChange, IVW_CONTEXT);
-                    continue;
-                }
+                if (!prepareProcess(processor)) continue;
 
                 processor->notifyObserversAboutToProcess(processor);
 
+                std::exception_ptr error;
                 try {
                     IVW_CPU_PROFILING_IF(500, "Processed " << processor->getIdentifier());
+                    EvaluationProfiler::Scope scope("process", processor->getIdentifier());
                     // do the actual processing
                     processor->process();
-
-                    // Set processor as valid only if we still are ready.
-                    // Callbacks might have made our inports invalid, if so abort
-                    // the evaluation by not setting the processor valid.
-                    if (processor->isReady()) processor->setValid();
-
                 } catch (...) {
-                    exceptionHandler_(processor, EvaluationType::Process, IVW_CONTEXT);
+                    error = std::current_exception();
                 }
 
-                processor->notifyObserversFinishedProcess(processor);
+                finishProcess(processor, error);
+
+            } else {
+                handleNotReady(processor);
+            }
+        }
+    }
+}
+
+void ProcessorNetworkEvaluator::evaluateParallel() {
+    auto& pool = processorNetwork_->getApplication()->getThreadPool();
+
+    const auto size = processorsSorted_.size();
+    std::unordered_map<Processor*, size_t> indices;
+    for (size_t i = 0; i < size; ++i) {
+        indices[processorsSorted_[i]] = i;
+    }
+
+    // Build the dependency graph. Only the processors in processorsSorted_ take part in the
+    // evaluation, hence other predecessors are ignored.
+    std::vector<size_t> pending(size, 0);
+    std::vector<std::vector<size_t>> successors(size);
+    std::vector<bool> threadSafe(size, false);
+    for (size_t i = 0; i < size; ++i) {
+        auto processor = processorsSorted_[i];
+        for (auto predecessor : util::getDirectPredecessors(processor)) {
+            if (auto it = indices.find(predecessor); it != indices.end()) {
+                ++pending[i];
+                successors[it->second].push_back(i);
+            }
+        }
+        threadSafe[i] = util::contains(processor->getTags().tags_, Tag::ThreadSafe);
+    }
+
+    // Processors that have all predecessors done. Thread safe processors are put in front such
+    // that they get dispatched to the pool before we start working on the calling thread.
+    std::deque<size_t> ready;
+    const auto enqueueReady = [&](size_t i) {
+        if (threadSafe[i]) {
+            ready.push_front(i);
+        } else {
+            ready.push_back(i);
+        }
+    };
+    for (size_t i = 0; i < size; ++i) {
+        if (pending[i] == 0) enqueueReady(i);
+    }
+
+    size_t done = 0;
+    const auto complete = [&](size_t i) {
+        ++done;
+        for (auto successor : successors[i]) {
+            if (--pending[successor] == 0) enqueueReady(successor);
+        }
+    };
+
+    // Results from processors running in the pool
+    std::mutex mutex;
+    std::condition_variable condition;
+    std::vector<std::pair<size_t, std::exception_ptr>> finished;
+    size_t inFlight = 0;
+
+    const auto collect = [&](bool wait) {
+        std::vector<std::pair<size_t, std::exception_ptr>> results;
+        {
+            std::unique_lock<std::mutex> lock{mutex};
+            if (wait) condition.wait(lock, [&]() { return !finished.empty(); });
+            std::swap(results, finished);
+        }
+        for (auto& [i, error] : results) {
+            --inFlight;
+            finishProcess(processorsSorted_[i], error);
+            complete(i);
+        }
+    };
 
+    while (done < size) {
+        if (!ready.empty()) {
+            const auto i = ready.front();
+            ready.pop_front();
+            auto processor = processorsSorted_[i];
+
+            if (processor->isValid()) {
+                complete(i);
+            } else if (!processor->isReady()) {
+                handleNotReady(processor);
+                complete(i);
+            } else if (!prepareProcess(processor)) {
+                complete(i);
+            } else if (threadSafe[i]) {
+                processor->notifyObserversAboutToProcess(processor);
+                ++inFlight;
+                pool.enqueueRaw([&mutex, &condition, &finished, i, processor]() {
+                    std::exception_ptr error;
+                    try {
+                        IVW_CPU_PROFILING_IF_CUSTOM(500, "ProcessorNetworkEvaluator",
+                                                    "Processed " << processor->getIdentifier());
+                        EvaluationProfiler::Scope scope("process", processor->getIdentifier());
+                        processor->process();
+                    } catch (...) {
+                        error = std::current_exception();
+                    }
+                    // Notify while holding the lock, the evaluator might return and destroy
+                    // the condition variable as soon as the lock is released.
+                    std::scoped_lock lock{mutex};
+                    finished.emplace_back(i, error);
+                    condition.notify_one();
+                });
             } else {
+                processor->notifyObserversAboutToProcess(processor);
+                std::exception_ptr error;
                 try {
-                    processor->doIfNotReady();
+                    IVW_CPU_PROFILING_IF(500, "Processed " << processor->getIdentifier());
+                    EvaluationProfiler::Scope scope("process", processor->getIdentifier());
+                    processor->process();
                 } catch (...) {
-                    exceptionHandler_(processor, EvaluationType::NotReady, IVW_CONTEXT);
+                    error = std::current_exception();
                 }
+                finishProcess(processor, error);
+                complete(i);
             }
+            // pick up any processors that finished in the mean time
+            if (inFlight > 0) collect(false);
+
+        } else if (inFlight > 0) {
+            collect(true);
+        } else {
+            // Nothing is ready and nothing is running, should not happen for an acyclic network
+            break;
         }
     }
+}
 
-    notifyObserversProcessorNetworkEvaluationEnd();
+bool ProcessorNetworkEvaluator::prepareProcess(Processor* processor) {
+    try {
+        // re-initialize resources (e.g., shaders) if necessary
+        if (processor->getInvalidationLevel() >= InvalidationLevel::InvalidResources) {
+            EvaluationProfiler::Scope scope("initializeResources", processor->getIdentifier());
+            processor->initializeResources();
+        }
+    } catch (...) {
+        exceptionHandler_(processor, EvaluationType::InitResource, IVW_CONTEXT);
+        return false;
+    }
+
+    try {
+        // call onChange for all invalid inports
+        EvaluationProfiler::Scope scope("onChange", processor->getIdentifier());
+        for (auto inport : processor->getInports()) {
+            inport->callOnChangeIfChanged();
+        }
+    } catch (...) {
+        exceptionHandler_(processor, EvaluationType::PortOnChange, IVW_CONTEXT);
+        return false;
+    }
+    return true;
+}
+
+void ProcessorNetworkEvaluator::finishProcess(Processor* processor, std::exception_ptr error) {
+    if (error) {
+        try {
+            std::rethrow_exception(error);
+        } catch (...) {
+            exceptionHandler_(processor, EvaluationType::Process, IVW_CONTEXT);
+        }
+    } else {
+        // Set processor as valid only if we still are ready.
+        // Callbacks might have made our inports invalid, if so abort
+        // the evaluation by not setting the processor valid.
+        if (processor->isReady()) processor->setValid();
+    }
+
+    processor->notifyObserversFinishedProcess(processor);
+}
+
+void ProcessorNetworkEvaluator::handleNotReady(Processor* processor) {
+    try {
+        processor->doIfNotReady();
+    } catch (...) {
+        exceptionHandler_(processor, EvaluationType::NotReady, IVW_CONTEXT);
+    }
 }
 
 void ProcessorNetworkEvaluator::onProcessorSinkChanged(Processor*) {
@@ -152,7 +152,11 @@ void WorkspaceManager::save(std::ostream& stream, std::string_view refPath,
     }
 
     serializers_.invoke(serializer, exceptionHandler, mode);
-    serializer.writeFile(stream, true);
+    if (mode == WorkspaceSaveMode::Undo) {
+        serializer.writeBinary(stream);
+    } else {
+        serializer.writeFile(stream, true);
+    }
 }
 
 void WorkspaceManager::load(std::istream& stream, std::string_view refPath,
@@ -180,7 +184,8 @@ void WorkspaceManager::save(std::string_view path, const ExceptionHandler& excep
 }
 
 void WorkspaceManager::load(std::string_view path, const ExceptionHandler& exceptionHandler) {
-    auto istream = filesystem::ifstream(std::string(path));
+    // Binary mode since the file might be a binary undo snapshot, xml is not affected.
+    auto istream = filesystem::ifstream(std::string(path), std::ios::in | std::ios::binary);
     if (istream.is_open()) {
         load(istream, path, exceptionHandler);
     } else {
@@ -107,7 +107,8 @@ void PoolProcessor::submit(Submission& job) {
     states_.push_back(job.state);
     notifyObserversStartBackgroundWork(this, job.tasks.size());
     for (auto& task : job.tasks) {
-        getNetwork()->getApplication()->getThreadPool().enqueueRaw(std::move(task));
+        getNetwork()->getApplication()->getThreadPool().enqueueRaw(std::move(task),
+                                                                 ThreadPool::Priority::Background);
     }
 }
 
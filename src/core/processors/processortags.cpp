@@ -48,6 +48,7 @@ const Tag Tag::GL("GL");
 const Tag Tag::CL("CL");
 const Tag Tag::CPU("CPU");
 const Tag Tag::PY("PY");
+const Tag Tag::ThreadSafe("ThreadSafe");
 
 Tags::Tags(const Tag& tag) : tags_{tag} {}
 
@@ -28,6 +28,7 @@
  *********************************************************************************/
 
 #include <inviwo/core/properties/property.h>
+#include <inviwo/core/properties/propertyowner.h>
 #include <inviwo/core/common/inviwoapplication.h>
 #include <inviwo/core/util/settings/systemsettings.h>
 #include <inviwo/core/util/stdextensions.h>
@@ -81,7 +82,13 @@ Property::~Property() {
 const std::string& Property::getIdentifier() const { return identifier_; }
 Property& Property::setIdentifier(std::string_view identifier) {
     if (identifier_ != identifier) {
+        // The owner's index refers to our identifier, update it around the change.
+        if (owner_) owner_->unindexProperty(this);
         identifier_ = identifier;
+        if (owner_) {
+            owner_->indexProperty(this);
+            owner_->notifyObserversDidChangePropertyIdentifier(this);
+        }
 
         util::validateIdentifier(identifier, "Property", IVW_CONTEXT);
 
@@ -85,6 +85,7 @@ void PropertyOwner::insertProperty(size_t index, Property* property, bool owner)
 
     notifyObserversWillAddProperty(property, index);
     properties_.insert(properties_.begin() + index, property);
+    indexProperty(property);
     property->setOwner(this);
 
     if (dynamic_cast<EventProperty*>(property)) {
@@ -107,9 +108,9 @@ void PropertyOwner::insertProperty(size_t index, Property& property) {
 }
 
 Property* PropertyOwner::removeProperty(std::string_view identifier) {
-    return removeProperty(
-        std::find_if(properties_.begin(), properties_.end(),
-                     [&identifier](Property* p) { return p->getIdentifier() == identifier; }));
+    auto it = index_.find(identifier);
+    if (it == index_.end()) return nullptr;
+    return removeProperty(std::find(properties_.begin(), properties_.end(), it->second));
 }
 
 Property* PropertyOwner::removeProperty(Property* property) {
@@ -147,6 +148,7 @@ Property* PropertyOwner::removeProperty(std::vector<Property*>::iterator it) {
 
         util::erase_remove(eventProperties_, *it);
         util::erase_remove(compositeProperties_, *it);
+        unindexProperty(prop);
 
         prop->setOwner(nullptr);
         properties_.erase(it);
@@ -191,9 +193,7 @@ std::vector<Property*> PropertyOwner::getPropertiesRecursive() const {
 
 Property* PropertyOwner::getPropertyByIdentifier(std::string_view identifier,
                                                  bool recursiveSearch) const {
-    for (auto* property : properties_) {
-        if (property->getIdentifier() == identifier) return property;
-    }
+    if (auto it = index_.find(identifier); it != index_.end()) return it->second;
     if (recursiveSearch) {
         for (auto* compositeProperty : compositeProperties_) {
             if (auto* p = compositeProperty->getPropertyByIdentifier(identifier, true)) return p;
@@ -205,16 +205,33 @@ Property* PropertyOwner::getPropertyByIdentifier(std::string_view identifier,
 Property* PropertyOwner::getPropertyByPath(std::string_view path) const {
     if (path.empty()) return nullptr;
 
-    const auto [first, rest] = util::splitByFirst(path, '.');
-    if (rest.empty()) {
-        return getPropertyByIdentifier(first);
-    } else {
-        auto it = std::find_if(compositeProperties_.begin(), compositeProperties_.end(),
-                               [f = first](auto* comp) { return comp->getIdentifier() == f; });
-        if (it != compositeProperties_.end()) {
-            return (*it)->getPropertyByPath(rest);
-        } else {
-            return nullptr;
+    const PropertyOwner* owner = this;
+    for (;;) {
+        const auto [first, rest] = util::splitByFirst(path, '.');
+        auto it = owner->index_.find(first);
+        if (it == owner->index_.end()) return nullptr;
+        if (rest.empty()) return it->second;
+
+        owner = dynamic_cast<CompositeProperty*>(it->second);
+        if (!owner) return nullptr;
+        path = rest;
+    }
+}
+
+void PropertyOwner::indexProperty(Property* property) {
+    index_.try_emplace(property->getIdentifier(), property);
+}
+
+void PropertyOwner::unindexProperty(Property* property) {
+    auto it = index_.find(property->getIdentifier());
+    if (it == index_.end() || it->second != property) return;
+    index_.erase(it);
+
+    // A rename might have left another property with the same identifier, let that one take over
+    for (auto* p : properties_) {
+        if (p != property && p->getIdentifier() == property->getIdentifier()) {
+            index_.try_emplace(p->getIdentifier(), p);
+            break;
         }
     }
 }
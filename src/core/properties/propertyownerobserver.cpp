@@ -39,6 +39,8 @@ void PropertyOwnerObserver::onWillRemoveProperty(Property*, size_t) {}
 
 void PropertyOwnerObserver::onDidRemoveProperty(Property*, size_t) {}
 
+void PropertyOwnerObserver::onDidChangePropertyIdentifier(Property*) {}
+
 void PropertyOwnerObservable::notifyObserversWillAddProperty(Property* property, size_t index) {
     forEachObserver([&](PropertyOwnerObserver* o) { o->onWillAddProperty(property, index); });
 }
@@ -55,4 +57,8 @@ void PropertyOwnerObservable::notifyObserversDidRemoveProperty(Property* propert
     forEachObserver([&](PropertyOwnerObserver* o) { o->onDidRemoveProperty(property, index); });
 }
 
+void PropertyOwnerObservable::notifyObserversDidChangePropertyIdentifier(Property* property) {
+    forEachObserver([&](PropertyOwnerObserver* o) { o->onDidChangePropertyIdentifier(property); });
+}
+
 }  // namespace inviwo
@@ -0,0 +1,143 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <warn/push>
+#include <warn/ignore/all>
+#include <gtest/gtest.h>
+#include <warn/pop>
+
+#include <inviwo/core/util/evaluationprofiler.h>
+
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace inviwo {
+
+namespace {
+
+// Gives each test an empty, enabled profiler and restores the previous state afterwards
+class ProfilerState {
+public:
+    explicit ProfilerState(size_t capacity)
+        : enabled_{EvaluationProfiler::get().isEnabled()}
+        , capacity_{EvaluationProfiler::get().getCapacity()} {
+        EvaluationProfiler::get().setCapacity(capacity);
+        EvaluationProfiler::get().setEnabled(true);
+    }
+    ~ProfilerState() {
+        EvaluationProfiler::get().setEnabled(enabled_);
+        EvaluationProfiler::get().setCapacity(capacity_);
+    }
+
+private:
+    bool enabled_;
+    size_t capacity_;
+};
+
+struct TestConverter {};
+
+}  // namespace
+
+TEST(EvaluationProfiler, RecordScopes) {
+    ProfilerState state{16};
+    {
+        EvaluationProfiler::Scope outer("process", "Outer");
+        EvaluationProfiler::Scope inner("convert", typeid(TestConverter));
+    }
+    const auto events = EvaluationProfiler::get().getEvents();
+    ASSERT_EQ(2, events.size());
+
+    // The inner scope is destroyed, and recorded, first
+    EXPECT_STREQ("convert", events[0].category);
+    EXPECT_EQ(&typeid(TestConverter), events[0].type);
+    EXPECT_STREQ("", events[0].name.data());
+    EXPECT_STREQ("process", events[1].category);
+    EXPECT_STREQ("Outer", events[1].name.data());
+    EXPECT_LE(events[1].start, events[0].start);
+    EXPECT_GE(events[1].start + events[1].duration, events[0].start + events[0].duration);
+}
+
+TEST(EvaluationProfiler, Disabled) {
+    ProfilerState state{16};
+    EvaluationProfiler::get().setEnabled(false);
+    { EvaluationProfiler::Scope scope("process", "Processor"); }
+    EXPECT_TRUE(EvaluationProfiler::get().getEvents().empty());
+}
+
+TEST(EvaluationProfiler, TruncateName) {
+    ProfilerState state{16};
+    const std::string name(100, 'a');
+    { EvaluationProfiler::Scope scope("process", name); }
+    const auto events = EvaluationProfiler::get().getEvents();
+    ASSERT_EQ(1, events.size());
+    EXPECT_EQ(name.substr(0, 63), std::string(events[0].name.data()));
+}
+
+TEST(EvaluationProfiler, RingBuffer) {
+    ProfilerState state{8};
+    for (int i = 0; i < 20; ++i) {
+        EvaluationProfiler::Scope scope("process", std::to_string(i));
+    }
+    const auto events = EvaluationProfiler::get().getEvents();
+    ASSERT_EQ(8, events.size());
+    for (int i = 0; i < 8; ++i) {
+        EXPECT_EQ(std::to_string(12 + i), std::string(events[i].name.data()));
+    }
+}
+
+TEST(EvaluationProfiler, ConcurrentRecording) {
+    ProfilerState state{4096};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([]() {
+            for (int i = 0; i < 500; ++i) EvaluationProfiler::Scope scope("process", "Worker");
+        });
+    }
+    for (auto& thread : threads) thread.join();
+
+    const auto events = EvaluationProfiler::get().getEvents();
+    EXPECT_EQ(2000, events.size());
+    for (const auto& event : events) EXPECT_STREQ("Worker", event.name.data());
+}
+
+TEST(EvaluationProfiler, ChromeTrace) {
+    ProfilerState state{16};
+    { EvaluationProfiler::Scope scope("process", "My \"Processor\""); }
+
+    std::stringstream ss;
+    EvaluationProfiler::get().writeChromeTrace(ss);
+    const auto trace = ss.str();
+    EXPECT_EQ(0, trace.find("{\"traceEvents\":["));
+    EXPECT_NE(std::string::npos, trace.find(R"("name":"My \"Processor\"")"));
+    EXPECT_NE(std::string::npos, trace.find(R"("cat":"process","ph":"X")"));
+}
+
+}  // namespace inviwo
@@ -0,0 +1,138 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <warn/push>
+#include <warn/ignore/all>
+#include <gtest/gtest.h>
+#include <warn/pop>
+
+#include <inviwo/core/datastructures/histogram.h>
+
+#include <cstdint>
+#include <vector>
+
+namespace inviwo {
+
+namespace {
+
+std::vector<std::uint16_t> testData(size_t size) {
+    std::vector<std::uint16_t> data(size);
+    std::uint32_t state = 12345;
+    for (auto& v : data) {
+        state = state * 1664525u + 1013904223u;
+        v = static_cast<std::uint16_t>((state >> 16) % 1000);
+    }
+    return data;
+}
+
+void expectEqual(const util::HistogramAccumulator& a, const util::HistogramAccumulator& b) {
+    ASSERT_EQ(a.getComponents(), b.getComponents());
+    EXPECT_EQ(a.getBins(), b.getBins());
+    EXPECT_EQ(a.getCount(), b.getCount());
+    for (size_t i = 0; i < a.getComponents(); ++i) {
+        EXPECT_EQ(a.getCounts(i), b.getCounts(i));
+    }
+}
+
+}  // namespace
+
+TEST(Histogram, MergedPartsEqualSerial) {
+    const auto data = testData(10007);
+    const dvec2 range{0.0, 999.0};
+
+    auto serial = util::HistogramAccumulator::create<std::uint16_t>(range, 100);
+    serial.add(data.begin(), data.end());
+
+    util::HistogramAccumulator merged;
+    const size_t parts = 7;
+    for (size_t part = 0; part < parts; ++part) {
+        auto acc = util::HistogramAccumulator::create<std::uint16_t>(range, 100);
+        acc.add(data.begin() + data.size() * part / parts,
+                data.begin() + data.size() * (part + 1) / parts);
+        merged.merge(acc);
+    }
+    expectEqual(serial, merged);
+
+    const auto a = serial.toContainer();
+    const auto b = merged.toContainer();
+    ASSERT_EQ(a.size(), 1);
+    EXPECT_EQ(a[0].getData(), b[0].getData());
+    EXPECT_DOUBLE_EQ(a[0].stats_.mean, b[0].stats_.mean);
+    EXPECT_DOUBLE_EQ(a[0].stats_.standardDeviation, b[0].stats_.standardDeviation);
+    EXPECT_EQ(a[0].stats_.min, 0.0);
+    EXPECT_EQ(a[0].stats_.max, 999.0);
+}
+
+TEST(Histogram, IntegralBinsAreLimitedByRange) {
+    const auto acc = util::HistogramAccumulator::create<std::uint8_t>(dvec2{0.0, 255.0}, 2048);
+    EXPECT_EQ(acc.getBins(), 256);
+}
+
+TEST(Histogram, RebinIntegralIsExact) {
+    const auto data = testData(5000);
+
+    auto fine = util::HistogramAccumulator::create<std::uint16_t>(dvec2{0.0, 1999.0}, 65536);
+    fine.add(data.begin(), data.end());
+    EXPECT_EQ(fine.getBins(), 2000);
+
+    for (auto [range, bins] : {std::pair{dvec2{0.0, 1999.0}, size_t{64}},
+                               std::pair{dvec2{100.0, 900.0}, size_t{33}}}) {
+        auto direct = util::HistogramAccumulator::create<std::uint16_t>(range, bins);
+        direct.add(data.begin(), data.end());
+        expectEqual(fine.rebin(range, bins), direct);
+    }
+}
+
+TEST(Histogram, RebinAlignedFloatIsExact) {
+    const auto ints = testData(5000);
+    std::vector<float> data;
+    for (auto v : ints) data.push_back(static_cast<float>(v) * 0.013f);
+    const dvec2 range{0.0, 13.0};
+
+    // 10 fine bins for each coarse bin
+    auto fine = util::HistogramAccumulator::create<float>(range, 10 * 63 + 1);
+    fine.add(data.begin(), data.end());
+    auto direct = util::HistogramAccumulator::create<float>(range, 64);
+    direct.add(data.begin(), data.end());
+
+    expectEqual(fine.rebin(range, 64), direct);
+}
+
+TEST(Histogram, StridedEstimate) {
+    const auto data = testData(10000);
+    auto acc = util::HistogramAccumulator::create<std::uint16_t>(dvec2{0.0, 999.0}, 10);
+    acc.add(data.data(), data.data() + data.size(), 7);
+    EXPECT_EQ(acc.getCount(), (data.size() + 6) / 7);
+
+    const HistogramContainer container(dvec2{0.0, 999.0}, 10, data.begin(), data.end());
+    ASSERT_EQ(container.size(), 1);
+    EXPECT_EQ(container[0].getData().size(), 10);
+}
+
+}  // namespace inviwo
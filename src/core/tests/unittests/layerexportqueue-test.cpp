@@ -0,0 +1,145 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <warn/push>
+#include <warn/ignore/all>
+#include <gtest/gtest.h>
+#include <warn/pop>
+
+#include <inviwo/core/io/layerexportqueue.h>
+#include <inviwo/core/common/inviwoapplication.h>
+#include <inviwo/core/datastructures/image/layer.h>
+#include <inviwo/core/datastructures/image/layerramprecision.h>
+#include <inviwo/core/io/datawriter.h>
+#include <inviwo/core/io/datawriterexception.h>
+#include <inviwo/core/io/datawriterfactory.h>
+
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace inviwo {
+
+namespace {
+
+struct WrittenFrames {
+    std::mutex mutex;
+    std::map<std::string, unsigned char> frames;
+};
+
+// Records the first value of each written layer, and fails for file names containing "fail"
+class TestLayerWriter : public DataWriterType<Layer> {
+public:
+    explicit TestLayerWriter(std::shared_ptr<WrittenFrames> written)
+        : DataWriterType<Layer>(), written_{std::move(written)} {
+        addExtension(FileExtension("layerexportqueuetest", "Layer export queue test"));
+    }
+    virtual TestLayerWriter* clone() const override { return new TestLayerWriter(*this); }
+
+    virtual void writeData(const Layer* layer, const std::string filePath) const override {
+        if (filePath.find("fail") != std::string::npos) {
+            throw DataWriterException("Could not write " + filePath, IVW_CONTEXT);
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        const auto data =
+            static_cast<const unsigned char*>(layer->getRepresentation<LayerRAM>()->getData());
+        std::scoped_lock lock{written_->mutex};
+        written_->frames[filePath] = data[0];
+    }
+
+private:
+    std::shared_ptr<WrittenFrames> written_;
+};
+
+class RegisteredWriter {
+public:
+    RegisteredWriter() : written{std::make_shared<WrittenFrames>()}, writer_{written} {
+        InviwoApplication::getPtr()->getDataWriterFactory()->registerObject(&writer_);
+    }
+    ~RegisteredWriter() {
+        InviwoApplication::getPtr()->getDataWriterFactory()->unRegisterObject(&writer_);
+    }
+    std::shared_ptr<WrittenFrames> written;
+
+private:
+    TestLayerWriter writer_;
+};
+
+}  // namespace
+
+TEST(LayerExportQueue, WritesCopiesOfTheFrames) {
+    RegisteredWriter registered;
+
+    auto ram = std::make_shared<LayerRAMPrecision<unsigned char>>(size2_t{16, 8});
+    const Layer layer(ram);
+
+    LayerExportQueue queue(2);
+    for (unsigned char i = 0; i < 10; ++i) {
+        // The frame is copied on enqueue, hence the layer can be changed right away
+        ram->getDataTyped()[0] = i;
+        EXPECT_TRUE(queue.enqueue(layer, "frame" + std::to_string(i) + ".layerexportqueuetest"));
+        EXPECT_LE(queue.getPending(), queue.getCapacity());
+    }
+    queue.wait();
+    EXPECT_EQ(0u, queue.getPending());
+
+    ASSERT_EQ(10u, registered.written->frames.size());
+    for (unsigned char i = 0; i < 10; ++i) {
+        EXPECT_EQ(i, registered.written->frames["frame" + std::to_string(i) +
+                                                ".layerexportqueuetest"]);
+    }
+
+    const auto stats = queue.getStatistics();
+    EXPECT_EQ(10u, stats.written);
+    EXPECT_EQ(0u, stats.failed);
+    EXPECT_GT(stats.framesPerSecond(), 0.0);
+}
+
+TEST(LayerExportQueue, FailuresAndMissingWriters) {
+    RegisteredWriter registered;
+
+    const Layer layer(std::make_shared<LayerRAMPrecision<unsigned char>>(size2_t{4, 4}));
+
+    LayerExportQueue queue;
+    EXPECT_FALSE(queue.enqueue(layer, "frame.nowriterforthisextension"));
+    EXPECT_TRUE(queue.enqueue(layer, "fail.layerexportqueuetest"));
+    EXPECT_TRUE(queue.enqueue(layer, "frame.layerexportqueuetest"));
+    queue.wait();
+
+    const auto stats = queue.getStatistics();
+    EXPECT_EQ(1u, stats.written);
+    EXPECT_EQ(1u, stats.failed);
+
+    queue.resetStatistics();
+    EXPECT_EQ(0u, queue.getStatistics().written);
+}
+
+}  // namespace inviwo
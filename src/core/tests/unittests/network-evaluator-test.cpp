@@ -44,6 +44,7 @@
 #include <inviwo/core/ports/dataoutport.h>
 
 #include <functional>
+#include <atomic>
 
 namespace inviwo {
 
@@ -80,6 +81,22 @@ const ProcessorInfo TestProcessor::processorInfo_{
     Tags::CPU,                   // Tags
 };
 
+struct ThreadSafeTestProcessor : TestProcessor {
+    using TestProcessor::TestProcessor;
+
+    virtual const ProcessorInfo getProcessorInfo() const override { return processorInfo_; }
+
+    static const ProcessorInfo processorInfo_;
+};
+
+const ProcessorInfo ThreadSafeTestProcessor::processorInfo_{
+    "org.inviwo.ThreadSafeTestProcessor",  // Class identifier
+    "ThreadSafeTestProcessor",             // Display name
+    "Testing",                             // Category
+    CodeState::Stable,                     // Code state
+    Tags::CPU | Tag::ThreadSafe,           // Tags
+};
+
 struct Instrument {
     Instrument(TestProcessor& p) {
         name = p.getIdentifier();
@@ -257,4 +274,94 @@ TEST(NetworkEvaluator, Error) {
     }
 }
 
+TEST(NetworkEvaluator, ParallelEval) {
+    ProcessorNetwork network{InviwoApplication::getPtr()};
+    ProcessorNetworkEvaluator evaluator{&network};
+    evaluator.setEvaluationMode(EvaluationMode::Parallel);
+
+    const auto createSource = [](const std::string& id) {
+        auto p = std::make_unique<ThreadSafeTestProcessor>(id);
+        p->addPort(std::make_unique<DataOutport<int>>("out"));
+        p->onProcess = [](TestProcessor& self) {
+            static_cast<DataOutport<int>*>(self.getOutports()[0])
+                ->setData(std::make_shared<int>(1));
+        };
+        return p;
+    };
+
+    auto a1t = createSource("a1");
+    auto a1 = a1t.get();
+    auto a2t = createSource("a2");
+    auto a2 = a2t.get();
+
+    auto sinkt = std::make_unique<TestProcessor>("sink");
+    sinkt->addPort(std::make_unique<DataInport<int>>("in1"));
+    sinkt->addPort(std::make_unique<DataInport<int>>("in2"));
+    auto sink = sinkt.get();
+
+    std::atomic<int> sourceProcess{0};
+    const auto countProcess = [&](TestProcessor& p) {
+        auto func = p.onProcess;
+        p.onProcess = [func, &sourceProcess](TestProcessor& self) {
+            func(self);
+            ++sourceProcess;
+        };
+    };
+    countProcess(*a1);
+    countProcess(*a2);
+
+    Instrument si(*sink);
+    int sinkSum = 0;
+    sink->onProcess = [func = sink->onProcess, &sinkSum](TestProcessor& p) {
+        func(p);
+        sinkSum = *static_cast<DataInport<int>*>(p.getInports()[0])->getData() +
+                  *static_cast<DataInport<int>*>(p.getInports()[1])->getData();
+    };
+
+    {
+        NetworkLock lock(&network);
+        network.addProcessor(std::move(a1t));
+        network.addProcessor(std::move(a2t));
+        network.addProcessor(std::move(sinkt));
+        network.addConnection(a1->getOutports()[0], sink->getInports()[0]);
+        network.addConnection(a2->getOutports()[0], sink->getInports()[1]);
+    }
+
+    EXPECT_EQ(sourceProcess, 2);
+    si.checkAndReset(1, 1, 0);
+    EXPECT_EQ(sinkSum, 2);
+    EXPECT_TRUE(a1->isValid());
+    EXPECT_TRUE(a2->isValid());
+    EXPECT_TRUE(sink->isValid());
+
+    {
+        SCOPED_TRACE("Invalid output of one branch");
+        sourceProcess = 0;
+        a2->invalidate(InvalidationLevel::InvalidOutput);
+        EXPECT_EQ(sourceProcess, 1);
+        si.checkAndReset(0, 1, 0);
+    }
+
+    {
+        SCOPED_TRACE("Throw in thread safe processor");
+        unsigned int throwCount = 0;
+        Processor* thrower = nullptr;
+        evaluator.setExceptionHandler(
+            [&throwCount, &thrower](Processor* p, EvaluationType type, ExceptionContext) {
+                EXPECT_EQ(type, EvaluationType::Process);
+                thrower = p;
+                ++throwCount;
+            });
+
+        a1->onProcess = [](TestProcessor&) {
+            throw Exception("Error", IVW_CONTEXT_CUSTOM("ThreadSafeTestProcessor"));
+        };
+        a1->invalidate(InvalidationLevel::InvalidOutput);
+        EXPECT_EQ(throwCount, 1);
+        EXPECT_EQ(thrower, a1);
+        EXPECT_FALSE(a1->isValid());
+        si.checkAndReset(0, 0, 1);
+    }
+}
+
 }  // namespace inviwo
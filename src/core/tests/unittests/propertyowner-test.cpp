@@ -0,0 +1,129 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <warn/push>
+#include <warn/ignore/all>
+#include <gtest/gtest.h>
+#include <warn/pop>
+
+#include <inviwo/core/common/inviwoapplication.h>
+#include <inviwo/core/processors/processor.h>
+#include <inviwo/core/network/processornetwork.h>
+#include <inviwo/core/properties/compositeproperty.h>
+#include <inviwo/core/properties/ordinalproperty.h>
+
+namespace inviwo {
+
+namespace {
+
+struct PropertyTestProcessor : Processor {
+    PropertyTestProcessor(const std::string& id)
+        : Processor(id, id), comp("comp", "Comp"), value("value", "Value") {
+        comp.addProperty(value);
+        addProperty(comp);
+    }
+
+    virtual const ProcessorInfo getProcessorInfo() const override { return processorInfo_; }
+    virtual void process() override {}
+
+    static const ProcessorInfo processorInfo_;
+
+    CompositeProperty comp;
+    IntProperty value;
+};
+
+const ProcessorInfo PropertyTestProcessor::processorInfo_{
+    "org.inviwo.PropertyTestProcessor",  // Class identifier
+    "PropertyTestProcessor",             // Display name
+    "Testing",                           // Category
+    CodeState::Stable,                   // Code state
+    Tags::CPU,                           // Tags
+};
+
+}  // namespace
+
+TEST(PropertyOwner, LookupFollowsStructure) {
+    CompositeProperty root("root", "Root");
+    CompositeProperty inner("inner", "Inner");
+    IntProperty a("a", "A");
+    IntProperty b("b", "B");
+
+    inner.addProperty(b);
+    root.addProperties(a, inner);
+
+    EXPECT_EQ(&a, root.getPropertyByIdentifier("a"));
+    EXPECT_EQ(nullptr, root.getPropertyByIdentifier("b"));
+    EXPECT_EQ(&b, root.getPropertyByIdentifier("b", true));
+    EXPECT_EQ(&b, root.getPropertyByPath("inner.b"));
+    EXPECT_EQ(nullptr, root.getPropertyByPath("a.b"));
+    EXPECT_EQ(nullptr, root.getPropertyByPath("inner.c"));
+
+    b.setIdentifier("c");
+    EXPECT_EQ(nullptr, root.getPropertyByPath("inner.b"));
+    EXPECT_EQ(&b, root.getPropertyByPath("inner.c"));
+
+    IntProperty duplicate("a", "A");
+    EXPECT_THROW(root.addProperty(duplicate), Exception);
+    root.removeProperty(&inner);
+    EXPECT_EQ(nullptr, root.getPropertyByPath("inner.c"));
+    EXPECT_EQ(&a, root.removeProperty("a"));
+    EXPECT_TRUE(root.empty());
+}
+
+TEST(PropertyOwner, NetworkPathCacheInvalidation) {
+    ProcessorNetwork network{InviwoApplication::getPtr()};
+    auto* p1 = network.addProcessor(std::make_unique<PropertyTestProcessor>("p1"));
+    auto* processor = static_cast<PropertyTestProcessor*>(p1);
+
+    EXPECT_EQ(&processor->value, network.getProperty("p1.comp.value"));
+    EXPECT_EQ(&processor->value, network.getProperty("p1.comp.value"));
+
+    processor->value.setIdentifier("renamed");
+    EXPECT_EQ(nullptr, network.getProperty("p1.comp.value"));
+    EXPECT_EQ(&processor->value, network.getProperty("p1.comp.renamed"));
+
+    processor->comp.setIdentifier("group");
+    EXPECT_EQ(nullptr, network.getProperty("p1.comp.renamed"));
+    EXPECT_EQ(&processor->value, network.getProperty("p1.group.renamed"));
+
+    auto* dynamic = new IntProperty("dynamic", "Dynamic");
+    processor->comp.addProperty(dynamic);
+    EXPECT_EQ(dynamic, network.getProperty("p1.group.dynamic"));
+    processor->comp.removeProperty(dynamic);  // owned, hence deleted
+    EXPECT_EQ(nullptr, network.getProperty("p1.group.dynamic"));
+
+    p1->setIdentifier("p2");
+    EXPECT_EQ(nullptr, network.getProperty("p1.group.renamed"));
+    EXPECT_EQ(&processor->value, network.getProperty("p2.group.renamed"));
+
+    network.removeAndDeleteProcessor(p1);
+    EXPECT_EQ(nullptr, network.getProperty("p2.group.renamed"));
+}
+
+}  // namespace inviwo
@@ -0,0 +1,211 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <warn/push>
+#include <warn/ignore/all>
+#include <gtest/gtest.h>
+#include <warn/pop>
+
+#include <inviwo/core/datastructures/ramallocator.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace inviwo {
+
+namespace {
+
+// Counts the allocations and forwards them to a PooledRAMAllocator without a pool
+class CountingAllocator : public RAMAllocator {
+public:
+    virtual void* allocate(size_t size) override {
+        ++allocations;
+        return pooled.allocate(size);
+    }
+    virtual void deallocate(void* ptr, size_t size) noexcept override {
+        ++deallocations;
+        pooled.deallocate(ptr, size);
+    }
+    virtual Stats getStats() const override { return pooled.getStats(); }
+
+    size_t allocations = 0;
+    size_t deallocations = 0;
+    PooledRAMAllocator pooled{0};
+};
+
+}  // namespace
+
+TEST(RAMAllocator, SizeClass) {
+    EXPECT_EQ(64, PooledRAMAllocator::sizeClass(1));
+    EXPECT_EQ(64, PooledRAMAllocator::sizeClass(64));
+    EXPECT_EQ(128, PooledRAMAllocator::sizeClass(65));
+
+    const size_t kb64 = PooledRAMAllocator::minPoolSize;
+    EXPECT_EQ(kb64, PooledRAMAllocator::sizeClass(kb64));
+    EXPECT_EQ(kb64 + kb64 / 8, PooledRAMAllocator::sizeClass(kb64 + 1));
+
+    const size_t mb = size_t{1} << 20;
+    EXPECT_EQ(mb, PooledRAMAllocator::sizeClass(mb));
+    EXPECT_EQ(mb + mb / 8, PooledRAMAllocator::sizeClass(mb + 1));
+    EXPECT_EQ(2 * mb, PooledRAMAllocator::sizeClass(2 * mb - 1));
+
+    for (size_t size = 1; size < 10 * mb; size = size * 3 + 7) {
+        const auto sizeClass = PooledRAMAllocator::sizeClass(size);
+        EXPECT_GE(sizeClass, size);
+        EXPECT_LE(sizeClass, size + size / 8 + RAMAllocator::alignment);
+        EXPECT_EQ(0, sizeClass % RAMAllocator::alignment);
+    }
+}
+
+TEST(RAMAllocator, Alignment) {
+    PooledRAMAllocator allocator;
+    for (size_t size : {size_t{1}, size_t{100}, size_t{100000}, size_t{3} << 20}) {
+        auto ptr = allocator.allocate(size);
+        EXPECT_EQ(0, reinterpret_cast<std::uintptr_t>(ptr) % RAMAllocator::alignment)
+            << "size: " << size;
+        if (size >= PooledRAMAllocator::hugePageSize) {
+            EXPECT_EQ(0, reinterpret_cast<std::uintptr_t>(ptr) % PooledRAMAllocator::hugePageSize);
+        }
+        allocator.deallocate(ptr, size);
+    }
+}
+
+TEST(RAMAllocator, Reuse) {
+    PooledRAMAllocator allocator{size_t{16} << 20};
+
+    const size_t size = size_t{1} << 20;
+    auto ptr = allocator.allocate(size);
+    allocator.deallocate(ptr, size);
+    auto stats = allocator.getStats();
+    EXPECT_EQ(1, stats.buffersPooled);
+    EXPECT_EQ(size, stats.bytesPooled);
+
+    // a size of the same size class reuses the memory
+    auto reused = allocator.allocate(size - 1000);
+    EXPECT_EQ(ptr, reused);
+    EXPECT_EQ(stats.reused + 1, allocator.getStats().reused);
+    EXPECT_EQ(0, allocator.getStats().buffersPooled);
+
+    allocator.deallocate(reused, size - 1000);
+    EXPECT_EQ(1, allocator.getStats().buffersPooled);
+}
+
+TEST(RAMAllocator, SmallAllocationsAreNotPooled) {
+    PooledRAMAllocator allocator{size_t{16} << 20};
+
+    auto ptr = allocator.allocate(1000);
+    allocator.deallocate(ptr, 1000);
+    EXPECT_EQ(0, allocator.getStats().buffersPooled);
+}
+
+TEST(RAMAllocator, Capacity) {
+    const size_t size = size_t{1} << 20;
+    PooledRAMAllocator allocator{2 * size};
+
+    void* ptrs[3];
+    for (auto& ptr : ptrs) ptr = allocator.allocate(size);
+    for (auto& ptr : ptrs) allocator.deallocate(ptr, size);
+
+    // the least recently released memory is freed
+    auto stats = allocator.getStats();
+    EXPECT_EQ(2, stats.buffersPooled);
+    EXPECT_EQ(2 * size, stats.bytesPooled);
+
+    allocator.setCapacity(size);
+    EXPECT_EQ(1, allocator.getStats().buffersPooled);
+    EXPECT_EQ(ptrs[2], allocator.allocate(size));
+    allocator.deallocate(ptrs[2], size);
+
+    allocator.trim();
+    EXPECT_EQ(0, allocator.getStats().buffersPooled);
+    EXPECT_EQ(0, allocator.getStats().bytesPooled);
+
+    allocator.setCapacity(0);
+    auto ptr = allocator.allocate(size);
+    allocator.deallocate(ptr, size);
+    EXPECT_EQ(0, allocator.getStats().buffersPooled);
+}
+
+TEST(RAMAllocator, DataInit) {
+    auto allocator = std::make_shared<PooledRAMAllocator>(size_t{16} << 20);
+
+    const size_t count = size_t{1} << 18;
+    {
+        auto data = allocateRAMData<float>(count, DataInit::Uninitialized, allocator);
+        for (size_t i = 0; i < count; ++i) data[i] = 1.0f;
+    }
+    // gets the pooled memory with the ones, but has to be zeroed
+    auto data = allocateRAMData<float>(count, DataInit::Zero, allocator);
+    EXPECT_EQ(1, allocator->getStats().reused);
+    for (size_t i = 0; i < count; ++i) {
+        ASSERT_EQ(0.0f, data[i]) << "index: " << i;
+    }
+
+    auto strings = allocateRAMData<std::string>(10, DataInit::Uninitialized);
+    for (size_t i = 0; i < 10; ++i) EXPECT_TRUE(strings[i].empty());
+}
+
+TEST(RAMAllocator, ReplaceAllocator) {
+    auto counting = std::make_shared<CountingAllocator>();
+    std::weak_ptr<CountingAllocator> observer = counting;
+
+    RAMAllocator::set(counting);
+    EXPECT_EQ(counting, RAMAllocator::get());
+    auto data = allocateRAMData<float>(100);
+    EXPECT_EQ(1, counting->allocations);
+
+    // the data keeps the allocator alive and is released by it
+    RAMAllocator::set(nullptr);
+    EXPECT_EQ(PooledRAMAllocator::getDefault(), RAMAllocator::get());
+    counting.reset();
+    ASSERT_FALSE(observer.expired());
+    EXPECT_EQ(0, observer.lock()->deallocations);
+    data.reset();
+    EXPECT_TRUE(observer.expired());
+}
+
+TEST(RAMAllocator, NewDeleter) {
+    const auto inUse = RAMAllocator::get()->getStats().bytesInUse;
+    RAMData<int> data(new int[100]());
+    EXPECT_EQ(inUse, RAMAllocator::get()->getStats().bytesInUse);
+}
+
+TEST(RAMAllocator, AdoptedData) {
+    auto owner = std::make_shared<std::vector<int>>(100, 7);
+    std::weak_ptr<std::vector<int>> observer = owner;
+    auto ptr = owner->data();
+    auto data = adoptRAMData(ptr, std::move(owner));
+    EXPECT_FALSE(observer.expired());
+    EXPECT_EQ(7, data[99]);
+    data.reset();
+    EXPECT_TRUE(observer.expired());
+}
+
+}  // namespace inviwo
@@ -0,0 +1,182 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <warn/push>
+#include <warn/ignore/all>
+#include <gtest/gtest.h>
+#include <warn/pop>
+
+#include <inviwo/core/io/rawvolumeramloader.h>
+#include <inviwo/core/io/bytereaderutil.h>
+#include <inviwo/core/io/tempfilehandle.h>
+#include <inviwo/core/datastructures/volume/volumedisk.h>
+#include <inviwo/core/datastructures/volume/volumeramprecision.h>
+
+#include <cstdio>
+#include <cstdint>
+#include <vector>
+
+namespace inviwo {
+
+namespace {
+
+using Mode = RawVolumeRAMLoader::Mode;
+
+// Writes the values 0, 1, 2, ... as uint16 after offset bytes of padding
+std::string writeRawFile(util::TempFileHandle& file, size_t count, size_t offset,
+                         bool littleEndian) {
+    std::vector<unsigned char> bytes(offset, 0xff);
+    for (size_t i = 0; i < count; ++i) {
+        const auto low = static_cast<unsigned char>(i & 0xff);
+        const auto high = static_cast<unsigned char>((i >> 8) & 0xff);
+        bytes.push_back(littleEndian ? low : high);
+        bytes.push_back(littleEndian ? high : low);
+    }
+    std::fwrite(bytes.data(), sizeof(unsigned char), bytes.size(), file.getHandle());
+    std::fflush(file.getHandle());
+    return file.getFileName();
+}
+
+template <typename T>
+std::shared_ptr<VolumeRAMPrecision<T>> load(const RawVolumeRAMLoader& loader,
+                                            const size3_t& dims) {
+    const VolumeDisk disk(dims, DataFormat<T>::get());
+    return std::dynamic_pointer_cast<VolumeRAMPrecision<T>>(loader.createRepresentation(disk));
+}
+
+}  // namespace
+
+TEST(RawVolumeRAMLoader, ReadAndMemoryMap) {
+    const size3_t dims{8, 7, 6};
+    const auto count = glm::compMul(dims);
+
+    for (auto mode : {Mode::Read, Mode::MemoryMap}) {
+        for (size_t offset : {0, 3, 8}) {
+            for (bool littleEndian : {true, false}) {
+                util::TempFileHandle tmpFile("", ".raw");
+                const auto filename = writeRawFile(tmpFile, count, offset, littleEndian);
+
+                const RawVolumeRAMLoader loader(filename, offset, littleEndian, mode);
+                auto volume = load<std::uint16_t>(loader, dims);
+                ASSERT_TRUE(volume != nullptr);
+                EXPECT_EQ(dims, volume->getDimensions());
+
+                const auto data = volume->getDataTyped();
+                for (size_t i = 0; i < count; ++i) {
+                    ASSERT_EQ(i, data[i]) << "offset " << offset << " little endian "
+                                          << littleEndian << " index " << i;
+                }
+            }
+        }
+    }
+}
+
+TEST(RawVolumeRAMLoader, ByteSwapPerComponent) {
+    const size3_t dims{4, 4, 4};
+    const auto count = glm::compMul(dims);
+
+    for (auto mode : {Mode::Read, Mode::MemoryMap}) {
+        util::TempFileHandle tmpFile("", ".raw");
+        const auto filename = writeRawFile(tmpFile, 2 * count, 0, false);
+
+        const RawVolumeRAMLoader loader(filename, 0, false, mode);
+        auto volume = load<glm::u16vec2>(loader, dims);
+        ASSERT_TRUE(volume != nullptr);
+
+        const auto data = volume->getDataTyped();
+        for (size_t i = 0; i < count; ++i) {
+            ASSERT_EQ(2 * i, data[i].x);
+            ASSERT_EQ(2 * i + 1, data[i].y);
+        }
+    }
+}
+
+TEST(RawVolumeRAMLoader, MemoryMapIsCopyOnWrite) {
+    const size3_t dims{4, 4, 4};
+    util::TempFileHandle tmpFile("", ".raw");
+    const auto filename = writeRawFile(tmpFile, glm::compMul(dims), 0, true);
+
+    const RawVolumeRAMLoader loader(filename, 0, true, Mode::MemoryMap);
+    auto volume = load<std::uint16_t>(loader, dims);
+    ASSERT_TRUE(volume != nullptr);
+    volume->getDataTyped()[0] = 1234;
+    auto clone = std::shared_ptr<VolumeRAMPrecision<std::uint16_t>>(volume->clone());
+    volume.reset();
+
+    EXPECT_EQ(1234, clone->getDataTyped()[0]);
+    EXPECT_EQ(0, load<std::uint16_t>(loader, dims)->getDataTyped()[0]);
+}
+
+TEST(RawVolumeRAMLoader, FileTooSmall) {
+    util::TempFileHandle tmpFile("", ".raw");
+    const auto filename = writeRawFile(tmpFile, 10, 0, true);
+
+    for (auto mode : {Mode::Read, Mode::MemoryMap}) {
+        const RawVolumeRAMLoader loader(filename, 0, true, mode);
+        EXPECT_THROW(load<std::uint16_t>(loader, size3_t{4, 4, 4}), DataReaderException);
+    }
+}
+
+TEST(RawVolumeRAMLoader, CopyBytesIntoBuffer) {
+    // Large enough to be split into several chunks, with elements of 3 bytes
+    const size_t count = 5'000'000;
+    std::vector<unsigned char> source(3 * count);
+    for (size_t i = 0; i < source.size(); ++i) source[i] = static_cast<unsigned char>(i % 251);
+
+    std::vector<unsigned char> dest(source.size());
+    util::copyBytesIntoBuffer(source.data(), source.size(), !util::isSystemLittleEndian(), 3,
+                              dest.data());
+    for (size_t i = 0; i < count; ++i) {
+        ASSERT_EQ(source[3 * i], dest[3 * i + 2]) << "element " << i;
+        ASSERT_EQ(source[3 * i + 1], dest[3 * i + 1]) << "element " << i;
+        ASSERT_EQ(source[3 * i + 2], dest[3 * i]) << "element " << i;
+    }
+
+    // In place, swapping twice restores the data
+    util::copyBytesIntoBuffer(dest.data(), dest.size(), !util::isSystemLittleEndian(), 3,
+                              dest.data());
+    EXPECT_EQ(source, dest);
+}
+
+TEST(RawVolumeRAMLoader, Progress) {
+    const size3_t dims{4, 4, 4};
+    util::TempFileHandle tmpFile("", ".raw");
+    const auto filename = writeRawFile(tmpFile, glm::compMul(dims), 0, false);
+
+    for (auto mode : {Mode::Read, Mode::MemoryMap}) {
+        RawVolumeRAMLoader loader(filename, 0, false, mode);
+        std::vector<float> progress;
+        loader.setProgressCallback([&](float p) { progress.push_back(p); });
+        load<std::uint16_t>(loader, dims);
+        ASSERT_FALSE(progress.empty());
+        EXPECT_FLOAT_EQ(1.0f, progress.back());
+    }
+}
+
+}  // namespace inviwo
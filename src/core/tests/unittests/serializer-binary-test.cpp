@@ -0,0 +1,151 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <warn/push>
+#include <warn/ignore/all>
+#include <gtest/gtest.h>
+#include <warn/pop>
+
+#include <inviwo/core/io/serialization/serialization.h>
+#include <inviwo/core/io/serialization/binarydocument.h>
+#include <inviwo/core/io/serialization/ticpp.h>
+
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace inviwo {
+
+namespace {
+
+std::string toXml(const TxDocument& doc) {
+    std::stringstream ss;
+    ss << doc;
+    return std::move(ss).str();
+}
+
+}  // namespace
+
+TEST(SerializationBinaryTest, DocumentRoundTrip) {
+    const std::string xml =
+        R"(<?xml version="1.0" ?>)"
+        R"(<!-- comment -->)"
+        R"(<Root version="3">)"
+        R"(<Points>)"
+        R"(<Point><pos content="0.1" /><rgba x="1" y="0" z="0" w="1" /></Point>)"
+        R"(<Point><pos content="0.5" /><rgba x="0" y="1" z="0" w="0.5" /></Point>)"
+        R"(<Point><pos content="0.9" /><rgba x="0" y="0" z="1" w="0" /></Point>)"
+        R"(<Point mask="1"><pos content="1" /></Point>)"
+        R"(</Points>)"
+        R"(<Text>some &amp; text</Text>)"
+        R"(<Empty />)"
+        R"(<Empty />)"
+        R"(</Root>)";
+
+    TxDocument doc;
+    std::stringstream in{xml};
+    in >> doc;
+
+    std::stringstream binary;
+    util::writeBinaryDocument(doc, binary);
+    EXPECT_TRUE(util::isBinaryDocument(binary));
+
+    TxDocument copy;
+    util::readBinaryDocument(binary, copy);
+    EXPECT_EQ(toXml(doc), toXml(copy));
+}
+
+TEST(SerializationBinaryTest, DetectsXml) {
+    std::stringstream xml{R"(<?xml version="1.0" ?><Root />)"};
+    EXPECT_FALSE(util::isBinaryDocument(xml));
+    std::stringstream empty;
+    EXPECT_FALSE(util::isBinaryDocument(empty));
+}
+
+TEST(SerializationBinaryTest, SerializerRoundTrip) {
+    std::stringstream ss;
+    Serializer serializer("");
+
+    const std::vector<float> vector{1.0f, 0.25f, -3.5f, 1e-7f};
+    const std::map<std::string, int> map{{"a", 1}, {"b", 2}, {"c", 3}};
+    serializer.serialize("Vector", vector, "Item");
+    serializer.serialize("Map", map, "Item");
+    serializer.serialize("Value", 42.0);
+    serializer.serialize("Name", std::string{"a \"quoted\" <name>"});
+    serializer.writeBinary(ss);
+
+    std::vector<float> vectorOut;
+    std::map<std::string, int> mapOut;
+    double value = 0.0;
+    std::string name;
+
+    Deserializer deserializer(ss, "");
+    EXPECT_EQ(SerializeConstants::InviwoWorkspaceVersion,
+              deserializer.getInviwoWorkspaceVersion());
+    deserializer.deserialize("Vector", vectorOut, "Item");
+    deserializer.deserialize("Map", mapOut, "Item");
+    deserializer.deserialize("Value", value);
+    deserializer.deserialize("Name", name);
+
+    EXPECT_EQ(vector, vectorOut);
+    EXPECT_EQ(map, mapOut);
+    EXPECT_EQ(42.0, value);
+    EXPECT_EQ("a \"quoted\" <name>", name);
+}
+
+TEST(SerializationBinaryTest, SmallerThanXml) {
+    Serializer serializer("");
+    std::vector<int> vector(1000);
+    for (size_t i = 0; i < vector.size(); ++i) vector[i] = static_cast<int>(i);
+    serializer.serialize("Vector", vector, "Item");
+
+    std::stringstream xml;
+    serializer.writeFile(xml);
+    std::stringstream binary;
+    serializer.writeBinary(binary);
+
+    EXPECT_LT(binary.str().size(), xml.str().size() / 2);
+}
+
+TEST(SerializationBinaryTest, Truncated) {
+    Serializer serializer("");
+    serializer.serialize("Vector", std::vector<int>{1, 2, 3}, "Item");
+    std::stringstream ss;
+    serializer.writeBinary(ss);
+    auto data = ss.str();
+
+    for (size_t size : {size_t{2}, size_t{5}, data.size() / 2, data.size() - 1}) {
+        std::stringstream truncated{data.substr(0, size)};
+        TxDocument doc;
+        EXPECT_THROW(util::readBinaryDocument(truncated, doc), SerializationException);
+    }
+}
+
+}  // namespace inviwo
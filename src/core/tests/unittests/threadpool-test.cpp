@@ -0,0 +1,194 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <warn/push>
+#include <warn/ignore/all>
+#include <gtest/gtest.h>
+#include <warn/pop>
+
+#include <inviwo/core/util/threadpool.h>
+#include <inviwo/core/util/foreach.h>
+#include <inviwo/core/common/inviwoapplication.h>
+
+#include <algorithm>
+#include <array>
+#include <numeric>
+
+namespace inviwo {
+
+TEST(ThreadPool, Enqueue) {
+    ThreadPool pool(4);
+    std::vector<std::future<size_t>> futures;
+    for (size_t i = 0; i < 1000; ++i) {
+        futures.push_back(pool.enqueue([](size_t a, size_t b) { return a * b; }, i, 2));
+    }
+    for (size_t i = 0; i < futures.size(); ++i) {
+        EXPECT_EQ(2 * i, futures[i].get());
+    }
+}
+
+TEST(ThreadPool, NoWorkers) {
+    ThreadPool pool(0);
+    auto future = pool.enqueue([]() { return 5; });
+    ASSERT_EQ(std::future_status::ready, future.wait_for(std::chrono::seconds(0)));
+    EXPECT_EQ(5, future.get());
+}
+
+TEST(ThreadPool, Exceptions) {
+    ThreadPool pool(2);
+    auto future = pool.enqueue([]() -> int { throw std::runtime_error("error"); });
+    EXPECT_THROW(future.get(), std::runtime_error);
+}
+
+TEST(ThreadPool, LargeTask) {
+    ThreadPool pool(2);
+    std::array<size_t, 64> data{};
+    std::iota(data.begin(), data.end(), size_t{0});
+    auto future =
+        pool.enqueue([data]() { return std::accumulate(data.begin(), data.end(), size_t{0}); });
+    EXPECT_EQ(64 * 63 / 2, future.get());
+}
+
+namespace {
+
+size_t fib(ThreadPool& pool, size_t n) {
+    if (n < 10) return n < 2 ? n : fib(pool, n - 1) + fib(pool, n - 2);
+    auto a = pool.enqueue([&pool, n]() { return fib(pool, n - 1); });
+    const auto b = fib(pool, n - 2);
+    pool.wait(a);
+    return a.get() + b;
+}
+
+}  // namespace
+
+TEST(ThreadPool, NestedWait) {
+    // all workers wait for sub tasks, which would deadlock with a plain future.wait()
+    ThreadPool pool(2);
+    std::vector<std::future<size_t>> futures;
+    for (size_t i = 0; i < 4; ++i) {
+        futures.push_back(pool.enqueue([&pool]() {
+            EXPECT_TRUE(pool.isWorkerThread());
+            return fib(pool, 20);
+        }));
+    }
+    EXPECT_FALSE(pool.isWorkerThread());
+    for (auto& future : futures) {
+        EXPECT_EQ(6765, future.get());
+    }
+}
+
+TEST(ThreadPool, WaitWithoutPendingTasks) {
+    // the waiting worker has nothing to run and has to be woken when the other worker finishes
+    ThreadPool pool(2);
+    auto outer = pool.enqueue([&pool]() {
+        std::promise<void> started;
+        auto inner = pool.enqueue([&started]() {
+            started.set_value();
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            return 42;
+        });
+        started.get_future().wait();
+        pool.wait(inner);
+        return inner.get();
+    });
+    EXPECT_EQ(42, outer.get());
+}
+
+TEST(ThreadPool, Priority) {
+    ThreadPool pool(1);
+
+    std::promise<void> start;
+    auto blocker = pool.enqueue([started = start.get_future()]() { started.wait(); });
+
+    std::mutex mutex;
+    std::vector<ThreadPool::Priority> order;
+    std::vector<std::future<void>> futures;
+    for (auto priority : {ThreadPool::Priority::Background, ThreadPool::Priority::Interactive,
+                          ThreadPool::Priority::Background, ThreadPool::Priority::Interactive}) {
+        futures.push_back(pool.enqueue(priority, [&mutex, &order, priority]() {
+            std::scoped_lock lock{mutex};
+            order.push_back(priority);
+        }));
+    }
+    start.set_value();
+    for (auto& future : futures) future.wait();
+
+    const std::vector<ThreadPool::Priority> expected = {
+        ThreadPool::Priority::Interactive, ThreadPool::Priority::Interactive,
+        ThreadPool::Priority::Background, ThreadPool::Priority::Background};
+    EXPECT_EQ(expected, order);
+}
+
+TEST(ThreadPool, Resize) {
+    ThreadPool pool(2);
+    std::atomic<size_t> count{0};
+    for (size_t size : {4, 1, 8, 0}) {
+        for (size_t i = 0; i < 100; ++i) pool.enqueueRaw([&count]() { ++count; });
+        while (pool.trySetSize(size) != size) {
+        }
+        EXPECT_EQ(size, pool.getSize());
+    }
+    EXPECT_EQ(400, count);
+    EXPECT_EQ(0, pool.getQueueSize());
+}
+
+TEST(ForEachIndexParallel, VisitsEachIndexOnce) {
+    std::vector<std::atomic<int>> visits(1000);
+    util::forEachIndexParallel(visits.size(), [&](size_t i) { ++visits[i]; });
+    EXPECT_TRUE(std::all_of(visits.begin(), visits.end(), [](auto& v) { return v == 1; }));
+}
+
+TEST(ForEachIndexParallel, Exceptions) {
+    std::atomic<size_t> count{0};
+    const auto callback = [&](size_t i) {
+        ++count;
+        if (i == 7) throw std::runtime_error("error");
+    };
+    EXPECT_THROW(util::forEachIndexParallel(100, callback), std::runtime_error);
+    EXPECT_LE(count, 100);
+}
+
+TEST(ForEachIndexParallel, AllWorkersBlocked) {
+    // The caller holds a lock that all workers are waiting for, it has to do all the work itself
+    auto& pool = InviwoApplication::getPtr()->getThreadPool();
+    std::mutex mutex;
+    std::vector<std::future<void>> blocked;
+    std::atomic<size_t> sum{0};
+    {
+        std::scoped_lock lock{mutex};
+        for (size_t i = 0; i < pool.getSize(); ++i) {
+            blocked.push_back(pool.enqueue([&mutex]() { std::scoped_lock lock{mutex}; }));
+        }
+        util::forEachIndexParallel(100, [&](size_t i) { sum += i; });
+    }
+    for (auto& future : blocked) future.wait();
+    EXPECT_EQ(100 * 99 / 2, sum);
+}
+
+}  // namespace inviwo
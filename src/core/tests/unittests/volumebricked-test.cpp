@@ -0,0 +1,300 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <warn/push>
+#include <warn/ignore/all>
+#include <gtest/gtest.h>
+#include <warn/pop>
+
+#include <inviwo/core/datastructures/volume/volume.h>
+#include <inviwo/core/datastructures/volume/volumebricked.h>
+#include <inviwo/core/datastructures/volume/volumeramprecision.h>
+#include <inviwo/core/common/inviwoapplication.h>
+#include <inviwo/core/io/bytereaderutil.h>
+#include <inviwo/core/io/datareaderexception.h>
+#include <inviwo/core/io/rawvolumebrickloader.h>
+#include <inviwo/core/io/tempfilehandle.h>
+#include <inviwo/core/util/indexmapper.h>
+#include <inviwo/core/util/lrucache.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+namespace inviwo {
+
+namespace {
+
+std::uint16_t voxelValue(size3_t pos, size3_t dims) {
+    return static_cast<std::uint16_t>(util::IndexMapper3D{dims}(pos));
+}
+
+// Generates the voxel values from their positions and counts the number of loaded bricks
+class TestBrickLoader : public VolumeBrickLoader {
+public:
+    explicit TestBrickLoader(size3_t dims) : dims_{dims} {}
+
+    virtual void loadBrick(size3_t offset, size3_t extent, void* dest) const override {
+        auto data = static_cast<std::uint16_t*>(dest);
+        const util::IndexMapper3D im{extent};
+        for (size_t z = 0; z < extent.z; ++z) {
+            for (size_t y = 0; y < extent.y; ++y) {
+                for (size_t x = 0; x < extent.x; ++x) {
+                    data[im(x, y, z)] = voxelValue(offset + size3_t{x, y, z}, dims_);
+                }
+            }
+        }
+        ++loads;
+    }
+
+    mutable std::atomic<size_t> loads{0};
+
+private:
+    size3_t dims_;
+};
+
+void expectRegion(const VolumeRAM& region, size3_t offset, size3_t dims) {
+    const auto data = static_cast<const std::uint16_t*>(region.getData());
+    const auto extent = region.getDimensions();
+    const util::IndexMapper3D im{extent};
+    for (size_t z = 0; z < extent.z; ++z) {
+        for (size_t y = 0; y < extent.y; ++y) {
+            for (size_t x = 0; x < extent.x; ++x) {
+                ASSERT_EQ(voxelValue(offset + size3_t{x, y, z}, dims), data[im(x, y, z)])
+                    << "at (" << x << ", " << y << ", " << z << ")";
+            }
+        }
+    }
+}
+
+}  // namespace
+
+TEST(LRUCache, EvictsLeastRecentlyUsed) {
+    util::LRUCache<int, int> cache{3};
+    cache.put(1, 10);
+    cache.put(2, 20);
+    cache.put(3, 30);
+    EXPECT_EQ(10, cache.get(1));  // 2 is now the least recently used
+    cache.put(4, 40);
+
+    EXPECT_TRUE(cache.contains(1));
+    EXPECT_FALSE(cache.contains(2));
+    EXPECT_TRUE(cache.contains(3));
+    EXPECT_TRUE(cache.contains(4));
+    EXPECT_EQ(std::nullopt, cache.get(2));
+    EXPECT_EQ(3u, cache.getCost());
+
+    ASSERT_NE(nullptr, cache.peek(3));  // does not change the order, 3 is still evicted first
+    EXPECT_EQ(30, *cache.peek(3));
+    EXPECT_EQ(nullptr, cache.peek(2));
+
+    cache.put(5, 50, 2);
+    EXPECT_EQ(2u, cache.size());
+    EXPECT_TRUE(cache.contains(5));
+    EXPECT_TRUE(cache.contains(4));
+
+    cache.put(6, 60, 10);  // larger than the capacity, kept until the next insertion
+    EXPECT_EQ(1u, cache.size());
+    EXPECT_EQ(60, cache.get(6));
+
+    EXPECT_TRUE(cache.erase(6));
+    EXPECT_TRUE(cache.empty());
+    EXPECT_EQ(0u, cache.getCost());
+}
+
+TEST(VolumeBricked, BrickLayout) {
+    const size3_t dims{9, 7, 5};
+    const VolumeBricked volume(std::make_shared<TestBrickLoader>(dims), dims, DataUInt16::get(),
+                               size3_t{4, 3, 0});
+
+    EXPECT_EQ(size3_t(4, 3, 5), volume.getBrickSize());
+    EXPECT_EQ(size3_t(3, 3, 1), volume.getBrickCounts());
+    EXPECT_EQ(9u, volume.getNumberOfBricks());
+
+    EXPECT_EQ(size3_t(0, 0, 0), volume.getBrickOffset(0));
+    EXPECT_EQ(size3_t(4, 3, 5), volume.getBrickExtent(0));
+    EXPECT_EQ(size3_t(8, 3, 0), volume.getBrickOffset(5));
+    EXPECT_EQ(size3_t(1, 3, 5), volume.getBrickExtent(5));
+    EXPECT_EQ(size3_t(8, 6, 0), volume.getBrickOffset(8));
+    EXPECT_EQ(size3_t(1, 1, 5), volume.getBrickExtent(8));
+
+    EXPECT_EQ(std::vector<size_t>({4, 5, 7, 8}), volume.getBricks({5, 4, 1}, {4, 3, 2}));
+    EXPECT_EQ(std::vector<size_t>({0}), volume.getBricks({1, 1, 1}, {2, 2, 2}));
+    EXPECT_TRUE(volume.getBricks({1, 1, 1}, {2, 0, 2}).empty());
+}
+
+TEST(VolumeBricked, BricksAndRegions) {
+    const size3_t dims{9, 7, 5};
+    const auto loader = std::make_shared<TestBrickLoader>(dims);
+    const VolumeBricked volume(loader, dims, DataUInt16::get(), size3_t{4, 3, 2});
+
+    for (size_t brick = 0; brick < volume.getNumberOfBricks(); ++brick) {
+        const auto brickRAM = volume.getBrick(brick);
+        EXPECT_EQ(volume.getBrickExtent(brick), brickRAM->getDimensions());
+        expectRegion(*brickRAM, volume.getBrickOffset(brick), dims);
+    }
+    EXPECT_THROW(volume.getBrick(volume.getNumberOfBricks()), RangeException);
+
+    const auto whole = volume.readRegion(size3_t{0}, dims);
+    expectRegion(*whole, size3_t{0}, dims);
+
+    const size3_t offset{3, 2, 1};
+    const auto region = volume.readRegion(offset, size3_t{5, 4, 3});
+    EXPECT_EQ(size3_t(5, 4, 3), region->getDimensions());
+    expectRegion(*region, offset, dims);
+
+    EXPECT_THROW(volume.readRegion(offset, dims), RangeException);
+
+    size_t voxels = 0;
+    volume.forEachBrick([&](const VolumeRAM& brick, size3_t brickOffset) {
+        expectRegion(brick, brickOffset, dims);
+        voxels += glm::compMul(brick.getDimensions());
+    });
+    EXPECT_EQ(glm::compMul(dims), voxels);
+}
+
+TEST(VolumeBricked, CacheIsBounded) {
+    const size3_t dims{8, 8, 8};
+    const size3_t brickSize{4, 4, 4};
+    const size_t brickBytes = glm::compMul(brickSize) * sizeof(std::uint16_t);
+    const auto loader = std::make_shared<TestBrickLoader>(dims);
+    VolumeBricked volume(loader, dims, DataUInt16::get(), brickSize, 2 * brickBytes);
+
+    volume.getBrick(0);
+    volume.getBrick(1);
+    volume.getBrick(0);
+    EXPECT_EQ(2u, loader->loads.load());
+
+    volume.getBrick(2);  // evicts brick 1
+    volume.getBrick(0);
+    EXPECT_EQ(3u, loader->loads.load());
+    volume.getBrick(1);
+    EXPECT_EQ(4u, loader->loads.load());
+
+    // Bricks in use stay valid after they are evicted
+    const auto brick = volume.getBrick(3);
+    volume.clearCache();
+    expectRegion(*brick, volume.getBrickOffset(3), dims);
+
+    // Clones share the cache
+    const std::unique_ptr<VolumeBricked> clone{volume.clone()};
+    volume.getBrick(5);
+    clone->getBrick(5);
+    EXPECT_EQ(6u, loader->loads.load());
+
+    volume.setCacheSize(0);
+    volume.getBrick(6);
+    volume.getBrick(7);
+    volume.getBrick(6);
+    EXPECT_EQ(9u, loader->loads.load());
+}
+
+TEST(VolumeBricked, RawLinearAndBrickedLayout) {
+    const size3_t dims{9, 7, 5};
+    const size3_t brickSize{4, 3, 2};
+    const size_t offset = 3;
+
+    for (bool littleEndian : {true, false}) {
+        util::TempFileHandle linearFile("", ".raw");
+        std::vector<unsigned char> bytes(offset, 0xff);
+        for (size_t i = 0; i < glm::compMul(dims); ++i) {
+            const auto low = static_cast<unsigned char>(i & 0xff);
+            const auto high = static_cast<unsigned char>((i >> 8) & 0xff);
+            bytes.push_back(littleEndian ? low : high);
+            bytes.push_back(littleEndian ? high : low);
+        }
+        std::fwrite(bytes.data(), sizeof(unsigned char), bytes.size(), linearFile.getHandle());
+        std::fflush(linearFile.getHandle());
+
+        const VolumeBricked linear(
+            std::make_shared<RawVolumeBrickLoader>(linearFile.getFileName(), offset, littleEndian,
+                                                   dims, DataUInt16::get()),
+            dims, DataUInt16::get(), brickSize);
+        expectRegion(*linear.readRegion(size3_t{0}, dims), size3_t{0}, dims);
+        expectRegion(*linear.readRegion({2, 1, 3}, {6, 6, 2}), {2, 1, 3}, dims);
+
+        util::TempFileHandle brickedFile("", ".raw");
+        util::writeBrickedRawFile(linear, brickedFile.getFileName());
+
+        const auto brickedLoader = std::make_shared<RawVolumeBrickLoader>(
+            brickedFile.getFileName(), 0, util::isSystemLittleEndian(), dims, DataUInt16::get(),
+            RawVolumeBrickLoader::Layout::Bricked, brickSize);
+        const VolumeBricked bricked(brickedLoader, dims, DataUInt16::get(), brickSize);
+        for (size_t brick = 0; brick < bricked.getNumberOfBricks(); ++brick) {
+            expectRegion(*bricked.getBrick(brick), bricked.getBrickOffset(brick), dims);
+        }
+        expectRegion(*bricked.readRegion({2, 1, 3}, {6, 6, 2}), {2, 1, 3}, dims);
+    }
+}
+
+TEST(VolumeBricked, RawFileTooSmall) {
+    util::TempFileHandle tmpFile("", ".raw");
+    std::vector<unsigned char> bytes(100, 0);
+    std::fwrite(bytes.data(), sizeof(unsigned char), bytes.size(), tmpFile.getHandle());
+    std::fflush(tmpFile.getHandle());
+
+    EXPECT_THROW(RawVolumeBrickLoader(tmpFile.getFileName(), 0, true, size3_t{8, 8, 8},
+                                      DataUInt16::get()),
+                 DataReaderException);
+}
+
+TEST(VolumeBricked, HistogramEqualsRAM) {
+    // More bricks than histogram parts, with partial bricks at the upper border
+    const size3_t dims{16, 16, 17};
+    auto bricked = std::make_shared<VolumeBricked>(std::make_shared<TestBrickLoader>(dims), dims,
+                                                   DataUInt16::get(), size3_t{4, 4, 4});
+    Volume brickedVolume(bricked);
+    Volume ramVolume(bricked->readRegion(size3_t{0}, dims));
+    for (auto volume : {&brickedVolume, &ramVolume}) {
+        volume->dataMap_.dataRange = dvec2{0.0, glm::compMul(dims) - 1.0};
+    }
+
+    auto brickedState = brickedVolume.calculateHistograms(100);
+    auto ramState = ramVolume.calculateHistograms(100);
+    const auto timeout = std::chrono::steady_clock::now() + std::chrono::seconds(30);
+    while (!(brickedState->isDone() && ramState->isDone()) &&
+           std::chrono::steady_clock::now() < timeout) {
+        InviwoApplication::getPtr()->processFront();
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    ASSERT_TRUE(brickedState->isDone());
+    ASSERT_TRUE(ramState->isDone());
+
+    const auto& brickedHist = brickedVolume.getHistograms()[0];
+    const auto& ramHist = ramVolume.getHistograms()[0];
+    EXPECT_EQ(ramHist.getData(), brickedHist.getData());
+    EXPECT_EQ(ramHist.stats_.min, brickedHist.stats_.min);
+    EXPECT_EQ(ramHist.stats_.max, brickedHist.stats_.max);
+    EXPECT_DOUBLE_EQ(ramHist.stats_.mean, brickedHist.stats_.mean);
+}
+
+}  // namespace inviwo
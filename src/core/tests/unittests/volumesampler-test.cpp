@@ -0,0 +1,163 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <warn/push>
+#include <warn/ignore/all>
+#include <gtest/gtest.h>
+#include <warn/pop>
+
+#include <inviwo/core/datastructures/volume/volume.h>
+#include <inviwo/core/datastructures/volume/volumeramprecision.h>
+#include <inviwo/core/util/volumesampler.h>
+#include <inviwo/core/util/templatesampler.h>
+#include <inviwo/core/util/indexmapper.h>
+
+#include <array>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace inviwo {
+
+namespace {
+
+template <typename T>
+std::shared_ptr<Volume> createVolume(const size3_t& dims) {
+    auto ram = std::make_shared<VolumeRAMPrecision<T>>(dims);
+    auto data = ram->getDataTyped();
+    const util::IndexMapper3D im(dims);
+    for (size_t z = 0; z < dims.z; ++z) {
+        for (size_t y = 0; y < dims.y; ++y) {
+            for (size_t x = 0; x < dims.x; ++x) {
+                const double v = static_cast<double>(x * x + 3 * y + 7 * z * y);
+                data[im(x, y, z)] = util::glm_convert<T>(dvec4{v, -v, 0.5 * v, v + 1.0});
+            }
+        }
+    }
+    auto volume = std::make_shared<Volume>(ram);
+    volume->setBasis(mat3{vec3{2.0f, 0.0f, 0.0f}, vec3{0.5f, 1.5f, 0.0f}, vec3{0.0f, 0.0f, 3.0f}});
+    volume->setOffset(vec3{-1.0f, 0.5f, 2.0f});
+    return volume;
+}
+
+// Data space positions inside, on the border of, and outside of the volume, in a structure of
+// arrays layout. More than the 64 positions the samplers transform at a time.
+std::array<std::vector<double>, 3> createPositions() {
+    std::array<std::vector<double>, 3> pos;
+    const auto add = [&](const dvec3& p) {
+        for (size_t d = 0; d < 3; ++d) pos[d].push_back(p[d]);
+    };
+    for (double x : {0.0, 0.5, 1.0}) {
+        for (double y : {0.0, 0.25, 1.0}) {
+            for (double z : {0.0, 0.75, 1.0}) add(dvec3{x, y, z});
+        }
+    }
+    add(dvec3{-0.01, 0.5, 0.5});
+    add(dvec3{0.5, 1.01, 0.5});
+    add(dvec3{0.5, 0.5, 2.0});
+    add(dvec3{-1.0, -1.0, -1.0});
+
+    std::mt19937 rand(4711);
+    std::uniform_real_distribution<double> dist(-0.2, 1.2);
+    for (size_t i = 0; i < 200; ++i) add(dvec3{dist(rand), dist(rand), dist(rand)});
+    return pos;
+}
+
+// Transform the data space positions to the space of the sampler
+template <typename Sampler>
+std::array<std::vector<double>, 3> toSpace(const Sampler& sampler,
+                                           const std::array<std::vector<double>, 3>& pos,
+                                           CoordinateSpace space) {
+    const dmat4 m{sampler.getCoordinateTransformer().getMatrix(CoordinateSpace::Data, space)};
+    auto res = pos;
+    for (size_t i = 0; i < pos[0].size(); ++i) {
+        const auto p = m * dvec4{pos[0][i], pos[1][i], pos[2][i], 1.0};
+        for (size_t d = 0; d < 3; ++d) res[d][i] = p[d] / p[3];
+    }
+    return res;
+}
+
+template <typename Sampler>
+void expectBatchEqualsSample(const Sampler& sampler,
+                             const std::array<std::vector<double>, 3>& pos) {
+    const auto count = pos[0].size();
+    std::vector<typename Sampler::ReturnType> batch(count);
+    sampler.sampleBatch({pos[0].data(), pos[1].data(), pos[2].data()}, batch.data(), count);
+
+    auto within = std::make_unique<bool[]>(count);
+    sampler.withinBoundsBatch({pos[0].data(), pos[1].data(), pos[2].data()}, within.get(),
+                              count);
+
+    for (size_t i = 0; i < count; ++i) {
+        const dvec3 p{pos[0][i], pos[1][i], pos[2][i]};
+        EXPECT_EQ(sampler.sample(p), batch[i]) << "position " << i;
+        EXPECT_EQ(sampler.withinBounds(p), within[i]) << "position " << i;
+    }
+}
+
+}  // namespace
+
+TEST(VolumeSamplerBatch, VolumeDoubleSampler) {
+    const auto volume = createVolume<float>(size3_t{5, 4, 3});
+    const auto pos = createPositions();
+
+    for (auto space : {CoordinateSpace::Data, CoordinateSpace::Model, CoordinateSpace::World}) {
+        const VolumeDoubleSampler<1> sampler1(volume, space);
+        expectBatchEqualsSample(sampler1, toSpace(sampler1, pos, space));
+        const VolumeDoubleSampler<4> sampler4(volume, space);
+        expectBatchEqualsSample(sampler4, toSpace(sampler4, pos, space));
+    }
+}
+
+TEST(VolumeSamplerBatch, VolumeDoubleSamplerVector) {
+    const auto volume = createVolume<glm::i16vec3>(size3_t{4, 6, 5});
+    const auto pos = createPositions();
+
+    for (auto space : {CoordinateSpace::Data, CoordinateSpace::World}) {
+        const VolumeDoubleSampler<2> sampler2(volume, space);
+        expectBatchEqualsSample(sampler2, toSpace(sampler2, pos, space));
+        const VolumeDoubleSampler<3> sampler3(volume, space);
+        expectBatchEqualsSample(sampler3, toSpace(sampler3, pos, space));
+    }
+}
+
+TEST(VolumeSamplerBatch, TemplateVolumeSampler) {
+    const auto pos = createPositions();
+
+    const auto scalar = createVolume<float>(size3_t{5, 4, 3});
+    const auto vector = createVolume<vec3>(size3_t{4, 6, 5});
+    for (auto space : {CoordinateSpace::Data, CoordinateSpace::World}) {
+        const TemplateVolumeSampler<float, double> scalarSampler(scalar, space);
+        expectBatchEqualsSample(scalarSampler, toSpace(scalarSampler, pos, space));
+        const TemplateVolumeSampler<vec3, float> vectorSampler(vector, space);
+        expectBatchEqualsSample(vectorSampler, toSpace(vectorSampler, pos, space));
+    }
+}
+
+}  // namespace inviwo
@@ -0,0 +1,172 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <warn/push>
+#include <warn/ignore/all>
+#include <gtest/gtest.h>
+#include <warn/pop>
+
+#include <inviwo/core/util/volumesequencestreamer.h>
+#include <inviwo/core/datastructures/volume/volume.h>
+#include <inviwo/core/datastructures/volume/volumedisk.h>
+#include <inviwo/core/datastructures/volume/volumeramprecision.h>
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+
+namespace inviwo {
+
+namespace {
+
+class CountingLoader : public DiskRepresentationLoader<VolumeRepresentation> {
+public:
+    explicit CountingLoader(std::shared_ptr<std::atomic<int>> loads) : loads_{loads} {}
+    virtual CountingLoader* clone() const override { return new CountingLoader(*this); }
+    virtual std::shared_ptr<VolumeRepresentation> createRepresentation(
+        const VolumeRepresentation& src) const override {
+        ++*loads_;
+        return std::make_shared<VolumeRAMPrecision<unsigned char>>(src.getDimensions());
+    }
+    virtual void updateRepresentation(std::shared_ptr<VolumeRepresentation>,
+                                      const VolumeRepresentation&) const override {
+        ++*loads_;
+    }
+
+private:
+    std::shared_ptr<std::atomic<int>> loads_;
+};
+
+// A sequence of volumes of 4x4x4 bytes that are loaded from "disk"
+std::shared_ptr<VolumeSequence> createSequence(size_t size,
+                                               std::shared_ptr<std::atomic<int>> loads) {
+    auto sequence = std::make_shared<VolumeSequence>();
+    for (size_t i = 0; i < size; ++i) {
+        auto disk = std::make_shared<VolumeDisk>(size3_t{4}, DataUInt8::get());
+        disk->setLoader(new CountingLoader(loads));
+        sequence->push_back(std::make_shared<Volume>(disk));
+    }
+    return sequence;
+}
+
+size_t loaded(const VolumeSequence& sequence) {
+    return std::count_if(sequence.begin(), sequence.end(), [](const auto& volume) {
+        return volume->template hasRepresentation<VolumeRAM>();
+    });
+}
+
+}  // namespace
+
+TEST(VolumeSequenceStreamer, PrefetchForward) {
+    auto loads = std::make_shared<std::atomic<int>>(0);
+    auto sequence = createSequence(10, loads);
+
+    VolumeSequenceStreamer streamer{2};
+    streamer.setSequence(sequence);
+    streamer.select(0);
+    streamer.wait();
+
+    EXPECT_FALSE((*sequence)[0]->hasRepresentation<VolumeRAM>());
+    EXPECT_TRUE((*sequence)[1]->hasRepresentation<VolumeRAM>());
+    EXPECT_TRUE((*sequence)[2]->hasRepresentation<VolumeRAM>());
+    EXPECT_FALSE((*sequence)[3]->hasRepresentation<VolumeRAM>());
+    EXPECT_EQ(2, loads->load());
+
+    (*sequence)[0]->getRepresentation<VolumeRAM>();
+    streamer.select(1);
+    streamer.wait();
+    EXPECT_TRUE((*sequence)[3]->hasRepresentation<VolumeRAM>());
+
+    const auto& stats = streamer.getStatistics();
+    EXPECT_EQ(1, stats.misses);
+    EXPECT_EQ(1, stats.hits);
+    EXPECT_EQ(3, stats.prefetched);
+    EXPECT_EQ(0, stats.evicted);
+}
+
+TEST(VolumeSequenceStreamer, PrefetchBackwardWithStride) {
+    auto loads = std::make_shared<std::atomic<int>>(0);
+    auto sequence = createSequence(10, loads);
+
+    VolumeSequenceStreamer streamer{2};
+    streamer.setSequence(sequence);
+    streamer.select(5);
+    streamer.wait();
+    streamer.select(3);
+    streamer.wait();
+
+    // Two steps backwards, wrapping around at the start
+    EXPECT_TRUE((*sequence)[1]->hasRepresentation<VolumeRAM>());
+    EXPECT_TRUE((*sequence)[9]->hasRepresentation<VolumeRAM>());
+    EXPECT_FALSE((*sequence)[0]->hasRepresentation<VolumeRAM>());
+    EXPECT_FALSE((*sequence)[2]->hasRepresentation<VolumeRAM>());
+}
+
+TEST(VolumeSequenceStreamer, MemoryBudget) {
+    auto loads = std::make_shared<std::atomic<int>>(0);
+    auto sequence = createSequence(10, loads);
+
+    // Room for three steps of 64 bytes
+    VolumeSequenceStreamer streamer{1, 3 * 64};
+    streamer.setSequence(sequence);
+    for (size_t i = 0; i < 20; ++i) {
+        streamer.select(i % 10);
+        (*sequence)[i % 10]->getRepresentation<VolumeRAM>();
+        streamer.wait();
+        EXPECT_LE(loaded(*sequence), 3);
+        EXPECT_TRUE((*sequence)[(i + 1) % 10]->hasRepresentation<VolumeRAM>());
+    }
+
+    const auto& stats = streamer.getStatistics();
+    EXPECT_EQ(1, stats.misses);
+    EXPECT_EQ(19, stats.hits);
+    EXPECT_GT(stats.evicted, 0);
+    EXPECT_LE(stats.residentBytes, 3 * 64);
+    // Every step is loaded at most once per round
+    EXPECT_LE(loads->load(), 20);
+}
+
+TEST(VolumeSequenceStreamer, KeepVolumesWithoutDisk) {
+    auto sequence = std::make_shared<VolumeSequence>();
+    for (size_t i = 0; i < 5; ++i) {
+        sequence->push_back(std::make_shared<Volume>(
+            std::make_shared<VolumeRAMPrecision<unsigned char>>(size3_t{4})));
+    }
+
+    VolumeSequenceStreamer streamer{1, 64};
+    streamer.setSequence(sequence);
+    for (size_t i = 0; i < 5; ++i) streamer.select(i);
+    streamer.wait();
+
+    EXPECT_EQ(5, loaded(*sequence));
+    EXPECT_EQ(0, streamer.getStatistics().evicted);
+    EXPECT_EQ(5, streamer.getStatistics().hits);
+}
+
+}  // namespace inviwo
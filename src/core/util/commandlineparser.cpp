@@ -62,6 +62,9 @@ CommandLineParser::CommandLineParser(int argc, char** argv)
     , workspace_("w", "workspace", "Specify workspace to open", false, "", "workspace file")
     , outputPath_("o", "output", "Specify output path", false, "", "output path")
     , logfile_("l", "logfile", "Write log messages to file.", false, "", "logfile")
+    , trace_("", "trace",
+             "Record the network evaluation and write it to file as a Chrome trace on exit.",
+             false, "", "trace file")
     , logConsole_("c", "logconsole", "Write log messages to console (cout)", false)
     , noSplashScreen_("n", "nosplash", "Pass this flag if you do not want to show a splash screen.")
     , quitAfterStartup_("q", "quit", "Pass this flag if you want to close inviwo after startup.")
@@ -76,6 +79,7 @@ CommandLineParser::CommandLineParser(int argc, char** argv)
     cmdQuiet_.add(noSplashScreen_);
     cmdQuiet_.add(logfile_);
     cmdQuiet_.add(logConsole_);
+    cmdQuiet_.add(trace_);
     cmdQuiet_.add(helpQuiet_);
     cmdQuiet_.add(versionQuiet_);
     cmdQuiet_.add(disableResourceManager_);
@@ -87,6 +91,7 @@ CommandLineParser::CommandLineParser(int argc, char** argv)
     cmd_.add(noSplashScreen_);
     cmd_.add(logfile_);
     cmd_.add(logConsole_);
+    cmd_.add(trace_);
     cmd_.add(disableResourceManager_);
 
     parse(Mode::Quiet);
@@ -149,6 +154,11 @@ const std::string CommandLineParser::getLogToFileFileName() const {
         return "";
 }
 
+std::string CommandLineParser::getTraceFileName() const {
+    if (trace_.isSet()) return trace_.getValue();
+    return "";
+}
+
 bool CommandLineParser::getQuitApplicationAfterStartup() const {
     return quitAfterStartup_.getValue();
 }
@@ -0,0 +1,181 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <inviwo/core/util/evaluationprofiler.h>
+#include <inviwo/core/util/stringconversion.h>
+
+#include <algorithm>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+
+#include <fmt/format.h>
+
+namespace inviwo {
+
+namespace {
+
+constexpr size_t defaultCapacity = size_t{1} << 16;
+
+std::string jsonEscape(std::string_view str) {
+    std::string result;
+    result.reserve(str.size());
+    for (auto c : str) {
+        switch (c) {
+            case '"':
+                result += "\\\"";
+                break;
+            case '\\':
+                result += "\\\\";
+                break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    result += fmt::format("\\u{:04x}", static_cast<int>(c));
+                } else {
+                    result += c;
+                }
+        }
+    }
+    return result;
+}
+
+}  // namespace
+
+EvaluationProfiler::EvaluationProfiler()
+    : enabled_{false}
+    , head_{0}
+    , capacity_{defaultCapacity}
+    , slots_{}
+    , epoch_{std::chrono::steady_clock::now()} {}
+
+EvaluationProfiler& EvaluationProfiler::get() {
+    static EvaluationProfiler profiler;
+    return profiler;
+}
+
+void EvaluationProfiler::setEnabled(bool enabled) {
+    if (enabled && !slots_) slots_ = std::make_unique<Slot[]>(capacity_);
+    enabled_.store(enabled, std::memory_order_release);
+}
+
+void EvaluationProfiler::setCapacity(size_t capacity) {
+    capacity_ = std::max(capacity, size_t{1});
+    head_ = 0;
+    slots_ = std::make_unique<Slot[]>(capacity_);
+}
+
+size_t EvaluationProfiler::getCapacity() const { return capacity_; }
+
+void EvaluationProfiler::clear() {
+    if (!slots_) return;
+    head_ = 0;
+    for (size_t i = 0; i < capacity_; ++i) slots_[i].sequence = 0;
+}
+
+void EvaluationProfiler::record(const char* category, std::string_view name,
+                                const std::type_info* type, std::int64_t start) noexcept {
+    Event event;
+    event.category = category;
+    event.type = type;
+    const auto size = std::min(name.size(), event.name.size() - 1);
+    std::copy_n(name.data(), size, event.name.data());
+    event.name[size] = '\0';
+    event.start = start;
+    event.duration = now() - start;
+    event.thread = threadId();
+    record(event);
+}
+
+void EvaluationProfiler::record(const Event& event) noexcept {
+    // A sequence lock per slot: odd while writing, 2 * (index + 1) when the event of index is
+    // written. Readers check the sequence before and after copying an event.
+    const auto index = head_.fetch_add(1, std::memory_order_relaxed);
+    auto& slot = slots_[index % capacity_];
+    slot.sequence.store(2 * index + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.event = event;
+    slot.sequence.store(2 * index + 2, std::memory_order_release);
+}
+
+std::vector<EvaluationProfiler::Event> EvaluationProfiler::getEvents() const {
+    std::vector<Event> events;
+    if (!slots_) return events;
+
+    const auto head = head_.load(std::memory_order_acquire);
+    const auto first = head > capacity_ ? head - capacity_ : 0;
+    events.reserve(head - first);
+    for (auto index = first; index < head; ++index) {
+        const auto& slot = slots_[index % capacity_];
+        const auto sequence = slot.sequence.load(std::memory_order_acquire);
+        if (sequence != 2 * index + 2) continue;
+        Event event = slot.event;
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.sequence.load(std::memory_order_relaxed) != sequence) continue;
+        events.push_back(event);
+    }
+    return events;
+}
+
+void EvaluationProfiler::writeChromeTrace(std::ostream& os) const {
+    auto events = getEvents();
+    std::stable_sort(events.begin(), events.end(),
+                     [](const Event& a, const Event& b) { return a.start < b.start; });
+
+    std::unordered_map<const std::type_info*, std::string> typeNames;
+    const auto name = [&](const Event& event) -> std::string {
+        if (event.name[0] != '\0' || !event.type) return jsonEscape(event.name.data());
+        auto it = typeNames.find(event.type);
+        if (it == typeNames.end()) {
+            it = typeNames
+                     .emplace(event.type, jsonEscape(parseTypeIdName(event.type->name())))
+                     .first;
+        }
+        return it->second;
+    };
+
+    os << "{\"traceEvents\":[";
+    bool first = true;
+    for (const auto& event : events) {
+        os << (first ? "\n" : ",\n");
+        first = false;
+        os << fmt::format(
+            R"({{"name":"{}","cat":"{}","ph":"X","ts":{:.3f},"dur":{:.3f},"pid":0,"tid":{}}})",
+            name(event), event.category ? event.category : "", event.start / 1000.0,
+            event.duration / 1000.0, event.thread);
+    }
+    os << "\n],\"displayTimeUnit\":\"ms\"}\n";
+}
+
+std::uint32_t EvaluationProfiler::threadId() noexcept {
+    static std::atomic<std::uint32_t> counter{0};
+    thread_local const std::uint32_t id = counter++;
+    return id;
+}
+
+}  // namespace inviwo
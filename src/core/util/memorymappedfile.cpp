@@ -0,0 +1,248 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <inviwo/core/util/memorymappedfile.h>
+#include <inviwo/core/util/exception.h>
+#include <inviwo/core/util/stringconversion.h>
+
+#include <algorithm>
+#include <utility>
+
+#include <fmt/format.h>
+
+#ifdef WIN32
+struct IUnknown;  // Workaround for "combaseapi.h(229): error C2187: syntax error: 'identifier' was
+                  // unexpected here" when using /permissive-
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace inviwo {
+
+namespace util {
+
+#ifdef WIN32
+
+MemoryMappedFile::MemoryMappedFile(std::string_view filePath, Access access, Mode mode)
+    : filePath_{filePath}
+    , mode_{mode}
+    , data_{nullptr}
+    , size_{0}
+    , file_{nullptr}
+    , mapping_{nullptr} {
+
+    const DWORD flags = [&]() -> DWORD {
+        switch (access) {
+            case Access::Sequential:
+                return FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN;
+            case Access::Random:
+                return FILE_ATTRIBUTE_NORMAL | FILE_FLAG_RANDOM_ACCESS;
+            case Access::Normal:
+            default:
+                return FILE_ATTRIBUTE_NORMAL;
+        }
+    }();
+
+    HANDLE file =
+        CreateFileW(util::toWstring(filePath_).c_str(), GENERIC_READ,
+                    FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, OPEN_EXISTING, flags, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        throw FileException(fmt::format("Could not open file '{}'", filePath_),
+                            IVW_CONTEXT_CUSTOM("MemoryMappedFile"));
+    }
+    file_ = file;
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize)) {
+        unmap();
+        throw FileException(fmt::format("Could not query size of file '{}'", filePath_),
+                            IVW_CONTEXT_CUSTOM("MemoryMappedFile"));
+    }
+    if (fileSize.QuadPart == 0) return;
+
+    HANDLE mapping = CreateFileMappingW(
+        file, nullptr, mode_ == Mode::CopyOnWrite ? PAGE_WRITECOPY : PAGE_READONLY, 0, 0, nullptr);
+    if (mapping == nullptr) {
+        unmap();
+        throw FileException(fmt::format("Could not map file '{}'", filePath_),
+                            IVW_CONTEXT_CUSTOM("MemoryMappedFile"));
+    }
+    mapping_ = mapping;
+
+    auto view =
+        MapViewOfFile(mapping, mode_ == Mode::CopyOnWrite ? FILE_MAP_COPY : FILE_MAP_READ, 0, 0, 0);
+    if (view == nullptr) {
+        unmap();
+        throw FileException(fmt::format("Could not map view of file '{}'", filePath_),
+                            IVW_CONTEXT_CUSTOM("MemoryMappedFile"));
+    }
+    data_ = static_cast<const char*>(view);
+    size_ = static_cast<size_t>(fileSize.QuadPart);
+}
+
+void MemoryMappedFile::unmap() {
+    if (data_) UnmapViewOfFile(data_);
+    if (mapping_) CloseHandle(static_cast<HANDLE>(mapping_));
+    if (file_) CloseHandle(static_cast<HANDLE>(file_));
+    data_ = nullptr;
+    size_ = 0;
+    mapping_ = nullptr;
+    file_ = nullptr;
+}
+
+void MemoryMappedFile::prefetch(size_t offset, size_t size) const {
+    if (!data_ || offset >= size_) return;
+
+    // PrefetchVirtualMemory is only available from Windows 8, look it up at runtime. MemoryRange
+    // has the same layout as WIN32_MEMORY_RANGE_ENTRY.
+    struct MemoryRange {
+        PVOID address;
+        SIZE_T bytes;
+    };
+    using PrefetchVirtualMemoryFunc = BOOL(WINAPI*)(HANDLE, ULONG_PTR, MemoryRange*, ULONG);
+    static const auto prefetchVirtualMemory = reinterpret_cast<PrefetchVirtualMemoryFunc>(
+        GetProcAddress(GetModuleHandle(TEXT("kernel32.dll")), "PrefetchVirtualMemory"));
+    if (prefetchVirtualMemory) {
+        MemoryRange range{const_cast<char*>(data_ + offset), std::min(size, size_ - offset)};
+        prefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+    }
+}
+
+MemoryMappedFile::MemoryMappedFile(MemoryMappedFile&& rhs) noexcept
+    : filePath_{std::move(rhs.filePath_)}
+    , mode_{rhs.mode_}
+    , data_{std::exchange(rhs.data_, nullptr)}
+    , size_{std::exchange(rhs.size_, 0)}
+    , file_{std::exchange(rhs.file_, nullptr)}
+    , mapping_{std::exchange(rhs.mapping_, nullptr)} {}
+
+MemoryMappedFile& MemoryMappedFile::operator=(MemoryMappedFile&& rhs) noexcept {
+    if (this != &rhs) {
+        unmap();
+        filePath_ = std::move(rhs.filePath_);
+        mode_ = rhs.mode_;
+        data_ = std::exchange(rhs.data_, nullptr);
+        size_ = std::exchange(rhs.size_, 0);
+        file_ = std::exchange(rhs.file_, nullptr);
+        mapping_ = std::exchange(rhs.mapping_, nullptr);
+    }
+    return *this;
+}
+
+#else
+
+MemoryMappedFile::MemoryMappedFile(std::string_view filePath, Access access, Mode mode)
+    : filePath_{filePath}, mode_{mode}, data_{nullptr}, size_{0}, file_{-1} {
+
+    file_ = ::open(filePath_.c_str(), O_RDONLY);
+    if (file_ < 0) {
+        throw FileException(fmt::format("Could not open file '{}'", filePath_),
+                            IVW_CONTEXT_CUSTOM("MemoryMappedFile"));
+    }
+
+    struct stat info;
+    if (::fstat(file_, &info) != 0) {
+        unmap();
+        throw FileException(fmt::format("Could not query size of file '{}'", filePath_),
+                            IVW_CONTEXT_CUSTOM("MemoryMappedFile"));
+    }
+    if (info.st_size == 0) return;
+
+    const auto size = static_cast<size_t>(info.st_size);
+    const int protection = mode_ == Mode::CopyOnWrite ? PROT_READ | PROT_WRITE : PROT_READ;
+    void* ptr = ::mmap(nullptr, size, protection, MAP_PRIVATE, file_, 0);
+    if (ptr == MAP_FAILED) {
+        unmap();
+        throw FileException(fmt::format("Could not map file '{}'", filePath_),
+                            IVW_CONTEXT_CUSTOM("MemoryMappedFile"));
+    }
+    data_ = static_cast<const char*>(ptr);
+    size_ = size;
+
+    switch (access) {
+        case Access::Sequential:
+            ::madvise(ptr, size_, MADV_SEQUENTIAL);
+            break;
+        case Access::Random:
+            ::madvise(ptr, size_, MADV_RANDOM);
+            break;
+        case Access::Normal:
+        default:
+            break;
+    }
+}
+
+void MemoryMappedFile::unmap() {
+    if (data_) ::munmap(const_cast<char*>(data_), size_);
+    if (file_ >= 0) ::close(file_);
+    data_ = nullptr;
+    size_ = 0;
+    file_ = -1;
+}
+
+void MemoryMappedFile::prefetch(size_t offset, size_t size) const {
+    if (!data_ || offset >= size_) return;
+
+    // madvise requires a page aligned address
+    const auto pageSize = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+    const auto begin = offset - offset % pageSize;
+    const auto end = std::min(size_, offset + std::min(size, size_ - offset));
+    ::madvise(const_cast<char*>(data_ + begin), end - begin, MADV_WILLNEED);
+}
+
+MemoryMappedFile::MemoryMappedFile(MemoryMappedFile&& rhs) noexcept
+    : filePath_{std::move(rhs.filePath_)}
+    , mode_{rhs.mode_}
+    , data_{std::exchange(rhs.data_, nullptr)}
+    , size_{std::exchange(rhs.size_, 0)}
+    , file_{std::exchange(rhs.file_, -1)} {}
+
+MemoryMappedFile& MemoryMappedFile::operator=(MemoryMappedFile&& rhs) noexcept {
+    if (this != &rhs) {
+        unmap();
+        filePath_ = std::move(rhs.filePath_);
+        mode_ = rhs.mode_;
+        data_ = std::exchange(rhs.data_, nullptr);
+        size_ = std::exchange(rhs.size_, 0);
+        file_ = std::exchange(rhs.file_, -1);
+    }
+    return *this;
+}
+
+#endif
+
+MemoryMappedFile::~MemoryMappedFile() { unmap(); }
+
+}  // namespace util
+
+}  // namespace inviwo
@@ -30,6 +30,7 @@
 #include <inviwo/core/util/settings/systemsettings.h>
 #include <inviwo/core/common/inviwoapplication.h>
 #include <inviwo/core/util/logstream.h>
+#include <inviwo/core/datastructures/ramallocator.h>
 
 namespace inviwo {
 
@@ -41,6 +42,10 @@ SystemSettings::SystemSettings(InviwoApplication* app)
                              {"developerMode", "Developer Mode", UsageMode::Development}},
                             1)
     , poolSize_("poolSize", "Pool Size", defaultPoolSize(), 0, 32)
+    , ramPoolCapacity_("ramPoolCapacity", "RAM Pool Capacity (MB)",
+                       PooledRAMAllocator::defaultCapacity >> 20, 0, size_t{1} << 20)
+    , logRAMAllocatorStats_("logRAMAllocatorStats", "Log RAM Allocator Statistics")
+    , parallelEvaluation_("parallelEvaluation", "Parallel Network Evaluation", false)
     , enablePortInspectors_("enablePortInspectors", "Enable port inspectors", true)
     , portInspectorSize_("portInspectorSize", "Port inspector size", 128, 1, 1024)
 #if __APPLE__
@@ -66,6 +71,9 @@ SystemSettings::SystemSettings(InviwoApplication* app)
     addProperty(workspaceAuthor_);
     addProperty(applicationUsageMode_);
     addProperty(poolSize_);
+    addProperty(ramPoolCapacity_);
+    addProperty(logRAMAllocatorStats_);
+    addProperty(parallelEvaluation_);
     addProperty(enablePortInspectors_);
     addProperty(portInspectorSize_);
     addProperty(enableTouchProperty_);
@@ -80,6 +88,21 @@ SystemSettings::SystemSettings(InviwoApplication* app)
     addProperty(redirectCout_);
     addProperty(redirectCerr_);
 
+    ramPoolCapacity_.onChange([this]() {
+        PooledRAMAllocator::getDefault()->setCapacity(ramPoolCapacity_.get() << 20);
+    });
+
+    logRAMAllocatorStats_.onChange([this]() {
+        const auto stats = RAMAllocator::get()->getStats();
+        constexpr size_t mb = size_t{1} << 20;
+        LogInfo("RAM allocator: " << stats.allocations << " allocations, " << stats.reused
+                                  << " reused from the pool, " << stats.bytesInUse / mb
+                                  << " MB in use (peak " << stats.peakBytesInUse / mb << " MB, "
+                                  << stats.hugePageBytes / mb << " MB huge pages), "
+                                  << stats.bytesPooled / mb << " MB in " << stats.buffersPooled
+                                  << " pooled buffers, " << stats.bytesFreed / mb << " MB freed");
+    });
+
     logStackTraceProperty_.onChange(
         [this]() { LogCentral::getPtr()->setLogStacktrace(logStackTraceProperty_.get()); });
 
@@ -110,6 +133,7 @@ SystemSettings::SystemSettings(InviwoApplication* app)
     });
 
     load();
+    PooledRAMAllocator::getDefault()->setCapacity(ramPoolCapacity_.get() << 20);
 }
 
 SystemSettings::~SystemSettings() = default;
@@ -32,20 +32,33 @@
 #include <inviwo/core/util/stdextensions.h>
 #include <inviwo/core/util/threadutil.h>
 
+#include <algorithm>
+
 namespace inviwo {
 
+namespace {
+
+// The worker running on the current thread, if any
+thread_local void* currentWorker = nullptr;
+
+// Max number of tasks a worker moves from the shared queue to its own queue at once
+constexpr size_t maxBatchSize = 8;
+
+}  // namespace
+
 // the constructor just launches some amount of workers
 ThreadPool::ThreadPool(size_t threads, std::function<void()> onThreadStart,
                        std::function<void()> onThreadStop)
     : onThreadStart_{std::move(onThreadStart)}, onThreadStop_{std::move(onThreadStop)} {
-    while (workers.size() < threads) {
-        workers.push_back(std::make_unique<Worker>(*this));
-    }
+    trySetSize(threads);
 }
 
 size_t ThreadPool::trySetSize(size_t size) {
     while (workers.size() < size) {
-        workers.push_back(std::make_unique<Worker>(*this));
+        auto worker = std::make_unique<Worker>(*this);
+        std::unique_lock<std::shared_mutex> lock(workers_mutex);
+        workers.push_back(std::move(worker));
+        numWorkers = workers.size();
     }
 
     if (workers.size() > size) {
@@ -60,50 +73,79 @@ size_t ThreadPool::trySetSize(size_t size) {
             if (active <= size) break;
         }
 
-        condition.notify_all();
+        wakeAll();
 
-        util::erase_remove_if(
-            workers, [](std::unique_ptr<Worker>& worker) { return worker->state == State::Done; });
+        // Join the stopped workers outside of the lock, other workers might be waiting for it to
+        // steal tasks.
+        std::vector<std::unique_ptr<Worker>> done;
+        {
+            std::unique_lock<std::shared_mutex> lock(workers_mutex);
+            auto it = std::stable_partition(
+                workers.begin(), workers.end(),
+                [](std::unique_ptr<Worker>& worker) { return worker->state != State::Done; });
+            std::move(it, workers.end(), std::back_inserter(done));
+            workers.erase(it, workers.end());
+            numWorkers = workers.size();
+        }
     }
     return workers.size();
 }
 
-size_t ThreadPool::getSize() const { return workers.size(); }
+size_t ThreadPool::getSize() const { return numWorkers; }
+
+size_t ThreadPool::getQueueSize() { return queued; }
 
-size_t ThreadPool::getQueueSize() {
-    std::unique_lock<std::mutex> lock(queue_mutex);
-    return tasks.size();
+ThreadPool::Worker* ThreadPool::getCurrentWorker() const {
+    auto worker = static_cast<Worker*>(currentWorker);
+    return worker && &worker->pool == this ? worker : nullptr;
 }
 
+bool ThreadPool::isWorkerThread() const { return getCurrentWorker() != nullptr; }
+
 ThreadPool::~ThreadPool() {
     for (auto& worker : workers) worker->state = State::Abort;
-    condition.notify_all();
-    workers.clear();  // this will join all threads.
+    wakeAll();
+
+    std::vector<std::unique_ptr<Worker>> done;
+    {
+        std::unique_lock<std::shared_mutex> lock(workers_mutex);
+        std::swap(done, workers);
+        numWorkers = 0;
+    }
+    done.clear();  // this will join all threads.
 }
 
 ThreadPool::Worker::~Worker() { thread.join(); }
 
 ThreadPool::Worker::Worker(ThreadPool& pool)
-    : state{State::Free}, thread{[this, &pool]() {
-        pool.onThreadStart_();
-        util::OnScopeExit cleanup{[&pool]() { pool.onThreadStop_(); }};
+    : pool{pool}, state{State::Free}, thread{[this]() {
+        currentWorker = this;
+        this->pool.onThreadStart_();
+        util::OnScopeExit cleanup{[this]() {
+            this->pool.onThreadStop_();
+            currentWorker = nullptr;
+        }};
 
         for (;;) {
-            std::function<void()> task;
-            state = State::Free;
-            {
-                std::unique_lock<std::mutex> lock(pool.queue_mutex);
-                pool.condition.wait(lock, [this, &pool] {
-                    return state == State::Abort || state == State::Stop || !pool.tasks.empty();
+            if (state == State::Abort) break;
+
+            if (auto task = this->pool.pop(*this)) {
+                auto expected = State::Free;
+                state.compare_exchange_strong(expected, State::Working);
+                this->pool.run(task);
+                expected = State::Working;
+                state.compare_exchange_strong(expected, State::Free);
+            } else if (state == State::Stop) {
+                break;
+            } else {
+                // Announce that we are going to sleep before checking for tasks, push() does the
+                // opposite, hence either we see the new task or push() sees us sleeping.
+                std::unique_lock<std::mutex> lock(this->pool.sleep_mutex);
+                ++this->pool.sleeping;
+                this->pool.condition.wait(lock, [this] {
+                    return state == State::Abort || state == State::Stop || this->pool.queued > 0;
                 });
-                if (state == State::Abort || (state == State::Stop && pool.tasks.empty())) break;
-                task = std::move(pool.tasks.front());
-                pool.tasks.pop();
-            }
-            state = State::Working;
-            try {
-                task();
-            } catch (...) {  // Make sure we don't leak any exceptions.
+                --this->pool.sleeping;
             }
         }
         state = State::Done;
@@ -112,14 +154,121 @@ ThreadPool::Worker::Worker(ThreadPool& pool)
     util::setThreadDescription(thread, "Inviwo Worker Thread");
 }
 
-void ThreadPool::enqueueRaw(std::function<void()> task) {
-    if (workers.empty()) {
+void ThreadPool::enqueueRaw(Task task, Priority priority) {
+    if (getSize() == 0) {
         task();  // No worker threads, just run the task.
+    } else {
+        push(Task{std::move(task)}, priority);
+    }
+}
+
+bool ThreadPool::runPendingTask() {
+    auto worker = getCurrentWorker();
+    if (!worker) return false;
+    if (auto task = pop(*worker)) {
+        run(task);
+        return true;
+    }
+    return false;
+}
+
+void ThreadPool::push(Task task, Priority priority) {
+    const auto p = static_cast<size_t>(priority);
+    if (auto worker = getCurrentWorker()) {
+        std::unique_lock<std::mutex> lock(worker->mutex);
+        worker->tasks[p].push_back(std::move(task));
     } else {
         std::unique_lock<std::mutex> lock(queue_mutex);
-        tasks.emplace(std::move(task));
+        tasks[p].push_back(std::move(task));
+    }
+    ++queued;
+    wakeOne();
+    wakeWaiting();
+}
+
+ThreadPool::Task ThreadPool::pop(Worker& worker) {
+    Task task;
+    for (size_t p = 0; p < numPriorities; ++p) {
+        // Our own tasks, newest first
+        {
+            std::unique_lock<std::mutex> lock(worker.mutex);
+            if (auto& queue = worker.tasks[p]; !queue.empty()) {
+                task = std::move(queue.back());
+                queue.pop_back();
+            }
+        }
+        if (task) break;
+
+        // Tasks from outside the pool, oldest first. Take a few extra to our own queue to reduce
+        // contention on the shared queue, other workers can steal them if they are idle.
+        {
+            std::unique_lock<std::mutex> lock(queue_mutex);
+            if (auto& queue = tasks[p]; !queue.empty()) {
+                task = std::move(queue.front());
+                queue.pop_front();
+
+                const auto batch = std::min(queue.size() / std::max(getSize(), size_t{1}),
+                                            maxBatchSize);
+                if (batch > 0) {
+                    std::unique_lock<std::mutex> workerLock(worker.mutex);
+                    for (size_t i = 0; i < batch; ++i) {
+                        worker.tasks[p].push_front(std::move(queue.front()));
+                        queue.pop_front();
+                    }
+                }
+            }
+        }
+        if (task) break;
+
+        // Steal the oldest task of some other worker
+        {
+            std::shared_lock<std::shared_mutex> lock(workers_mutex);
+            const auto size = workers.size();
+            for (size_t i = 0; i < size && !task; ++i) {
+                auto& victim = *workers[(worker.victim + i) % size];
+                if (&victim == &worker) continue;
+                std::unique_lock<std::mutex> victimLock(victim.mutex);
+                if (auto& queue = victim.tasks[p]; !queue.empty()) {
+                    task = std::move(queue.front());
+                    queue.pop_front();
+                    worker.victim = (worker.victim + i) % size;
+                }
+            }
+        }
+        if (task) break;
+    }
+    if (task) --queued;
+    return task;
+}
+
+void ThreadPool::wakeOne() {
+    if (sleeping > 0) {
+        // Make sure the sleeping worker is waiting on the condition before we notify it.
+        { std::unique_lock<std::mutex> lock(sleep_mutex); }
+        condition.notify_one();
+    }
+}
+
+void ThreadPool::wakeAll() {
+    { std::unique_lock<std::mutex> lock(sleep_mutex); }
+    condition.notify_all();
+}
+
+void ThreadPool::wakeWaiting() {
+    if (waiting > 0) {
+        { std::unique_lock<std::mutex> lock(wait_mutex); }
+        wait_condition.notify_all();
+    }
+}
+
+void ThreadPool::run(Task& task) {
+    try {
+        task();
+    } catch (...) {  // Make sure we don't leak any exceptions.
     }
-    condition.notify_one();
+    // The task might have made a future ready that some worker is waiting for.
+    ++completed;
+    wakeWaiting();
 }
 
 }  // namespace inviwo
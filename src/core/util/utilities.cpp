@@ -33,6 +33,7 @@
 #include <inviwo/core/network/processornetwork.h>
 #include <inviwo/core/processors/canvasprocessor.h>
 #include <inviwo/core/processors/processorwidget.h>
+#include <inviwo/core/io/layerexportqueue.h>
 #include <inviwo/core/util/stringconversion.h>
 
 #include <inviwo/core/properties/property.h>
@@ -55,7 +56,7 @@ void saveNetwork(ProcessorNetwork* network, std::string_view filename) {
 }
 
 void saveAllCanvases(ProcessorNetwork* network, std::string_view dir, std::string_view name,
-                     std::string_view ext, bool onlyActiveCanvases) {
+                     std::string_view ext, bool onlyActiveCanvases, LayerExportQueue* queue) {
 
     // Get all canvases, possibly only the active ones. We need their count below.
     auto allCanvases = network->getProcessorsByType<inviwo::CanvasProcessor>();
@@ -100,8 +101,17 @@ void saveAllCanvases(ProcessorNetwork* network, std::string_view dir, std::strin
                 filepath.append("{}", ext);
             }
 
-            LogInfoCustom("util::saveAllCanvases", "Saving canvas to: " << filepath.view());
-            cp->saveImageLayer(filepath.view());
+            if (queue) {
+                if (auto layer = cp->getVisibleLayer()) {
+                    queue->enqueue(*layer, filepath.view());
+                } else {
+                    LogErrorCustom("util::saveAllCanvases",
+                                   "Could not find visible layer of " << cp->getIdentifier());
+                }
+            } else {
+                LogInfoCustom("util::saveAllCanvases", "Saving canvas to: " << filepath.view());
+                cp->saveImageLayer(filepath.view());
+            }
         }
         i++;
     }
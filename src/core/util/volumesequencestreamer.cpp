@@ -0,0 +1,231 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2021 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <inviwo/core/util/volumesequencestreamer.h>
+
+#include <inviwo/core/common/inviwoapplication.h>
+#include <inviwo/core/datastructures/representationconverter.h>
+#include <inviwo/core/datastructures/volume/volume.h>
+#include <inviwo/core/datastructures/volume/volumedisk.h>
+#include <inviwo/core/datastructures/volume/volumeram.h>
+#include <inviwo/core/util/logcentral.h>
+#include <inviwo/core/util/volumeutils.h>
+
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+namespace inviwo {
+
+namespace {
+
+size_t ramSize(const Volume& volume) {
+    return glm::compMul(volume.getDimensions()) * volume.getDataFormat()->getSize();
+}
+
+bool canReload(const Volume& volume) {
+    if (!volume.hasRepresentation<VolumeDisk>()) return false;
+    try {
+        volume.getRepresentation<VolumeDisk>();
+        return true;
+    } catch (const ConverterException&) {
+        // The disk representation is outdated since another representation has been edited
+        return false;
+    }
+}
+
+}  // namespace
+
+VolumeSequenceStreamer::VolumeSequenceStreamer(size_t prefetchSteps, size_t memoryBudget)
+    : sequence_{}
+    , prefetchSteps_{prefetchSteps}
+    , memoryBudget_{memoryBudget}
+    , last_{}
+    , step_{1}
+    , loading_{}
+    , stats_{} {}
+
+VolumeSequenceStreamer::~VolumeSequenceStreamer() = default;
+
+void VolumeSequenceStreamer::setSequence(std::shared_ptr<const VolumeSequence> sequence) {
+    if (sequence == sequence_) return;
+    sequence_ = std::move(sequence);
+    // The loading tasks keep their volumes alive, no need to wait for them
+    loading_.clear();
+    last_.reset();
+    step_ = 1;
+}
+
+const std::shared_ptr<const VolumeSequence>& VolumeSequenceStreamer::getSequence() const {
+    return sequence_;
+}
+
+void VolumeSequenceStreamer::setPrefetchSteps(size_t steps) { prefetchSteps_ = steps; }
+
+size_t VolumeSequenceStreamer::getPrefetchSteps() const { return prefetchSteps_; }
+
+void VolumeSequenceStreamer::setMemoryBudget(size_t bytes) { memoryBudget_ = bytes; }
+
+size_t VolumeSequenceStreamer::getMemoryBudget() const { return memoryBudget_; }
+
+const VolumeSequenceStreamer::Statistics& VolumeSequenceStreamer::getStatistics() const {
+    return stats_;
+}
+
+void VolumeSequenceStreamer::resetStatistics() {
+    stats_ = Statistics{};
+}
+
+void VolumeSequenceStreamer::collect() {
+    for (auto it = loading_.begin(); it != loading_.end();) {
+        if (it->second.wait_for(std::chrono::seconds{0}) != std::future_status::ready) {
+            ++it;
+            continue;
+        }
+        try {
+            it->second.get();
+        } catch (const Exception& e) {
+            LogWarnCustom("VolumeSequenceStreamer",
+                          "Failed to prefetch step " << it->first + 1 << ": " << e.getMessage());
+        } catch (const std::exception& e) {
+            LogWarnCustom("VolumeSequenceStreamer",
+                          "Failed to prefetch step " << it->first + 1 << ": " << e.what());
+        }
+        it = loading_.erase(it);
+    }
+}
+
+void VolumeSequenceStreamer::wait() {
+    for (auto& item : loading_) {
+        if (InviwoApplication::isInitialized()) {
+            InviwoApplication::getPtr()->getThreadPool().wait(item.second);
+        } else {
+            item.second.wait();
+        }
+    }
+    collect();
+}
+
+void VolumeSequenceStreamer::select(size_t index) {
+    if (!sequence_ || index >= sequence_->size()) return;
+    const auto& sequence = *sequence_;
+    const auto size = sequence.size();
+
+    collect();
+
+    // The playback direction and speed, i.e. the shortest way from the last step, with wrap around
+    if (last_ && *last_ != index) {
+        const auto forward = (index + size - *last_) % size;
+        const auto backward = size - forward;
+        step_ = forward <= backward ? static_cast<std::ptrdiff_t>(forward)
+                                    : -static_cast<std::ptrdiff_t>(backward);
+    }
+    last_ = index;
+
+    const auto& selected = *sequence[index];
+    if (loading_.count(index)) {
+        ++stats_.waits;
+    } else if (selected.hasRepresentation<VolumeRAM>()) {
+        ++stats_.hits;
+    } else {
+        ++stats_.misses;
+    }
+
+    // The steps to keep, the selected one first, then in playback order
+    std::vector<size_t> window{index};
+    const auto signedSize = static_cast<std::ptrdiff_t>(size);
+    for (size_t i = 1; i <= prefetchSteps_; ++i) {
+        const auto next = static_cast<size_t>(
+            ((static_cast<std::ptrdiff_t>(index) + static_cast<std::ptrdiff_t>(i) * step_) %
+                 signedSize +
+             signedSize) %
+            signedSize);
+        if (std::find(window.begin(), window.end(), next) != window.end()) break;
+        window.push_back(next);
+    }
+    const auto inWindow = [&](size_t i) {
+        return std::find(window.begin(), window.end(), i) != window.end();
+    };
+
+    // The selected step will be loaded by its user if it is not loaded already
+    size_t resident = 0;
+    std::vector<size_t> evictable;
+    for (size_t i = 0; i < size; ++i) {
+        const auto& volume = *sequence[i];
+        if (i == index || loading_.count(i) || volume.hasRepresentation<VolumeRAM>()) {
+            resident += ramSize(volume);
+            if (i != index && !loading_.count(i) && !inWindow(i) && canReload(volume)) {
+                evictable.push_back(i);
+            }
+        }
+    }
+
+    // The size needed to also load the rest of the window
+    size_t required = resident;
+    for (auto it = std::next(window.begin()); it != window.end(); ++it) {
+        const auto& volume = *sequence[*it];
+        if (!loading_.count(*it) && !volume.hasRepresentation<VolumeRAM>() && canReload(volume)) {
+            required += ramSize(volume);
+        }
+    }
+
+    // Evict the steps furthest away in the playback direction first, i.e. the ones just played
+    if (memoryBudget_ > 0 && required > memoryBudget_) {
+        const auto distance = [&](size_t i) {
+            return step_ >= 0 ? (i + size - index) % size : (index + size - i) % size;
+        };
+        std::sort(evictable.begin(), evictable.end(),
+                  [&](size_t a, size_t b) { return distance(a) > distance(b); });
+        for (auto i : evictable) {
+            if (required <= memoryBudget_) break;
+            auto& volume = *sequence[i];
+            volume.removeOtherRepresentations(volume.getRepresentation<VolumeDisk>());
+            resident -= ramSize(volume);
+            required -= ramSize(volume);
+            ++stats_.evicted;
+        }
+    }
+
+    // Prefetch the next steps as long as they fit in the budget
+    for (auto it = std::next(window.begin()); it != window.end(); ++it) {
+        const auto& volume = sequence[*it];
+        if (loading_.count(*it) || volume->hasRepresentation<VolumeRAM>() ||
+            !canReload(*volume)) {
+            continue;
+        }
+        if (memoryBudget_ > 0 && resident + ramSize(*volume) > memoryBudget_) break;
+        loading_.emplace(*it, util::loadVolumeRAMAsync(volume));
+        resident += ramSize(*volume);
+        ++stats_.prefetched;
+    }
+
+    stats_.residentBytes = resident;
+}
+
+}  // namespace inviwo
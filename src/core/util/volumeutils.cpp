@@ -29,6 +29,10 @@
 
 #include <inviwo/core/util/volumeutils.h>
 #include <inviwo/core/datastructures/volume/volume.h>
+#include <inviwo/core/datastructures/volume/volumeram.h>
+#include <inviwo/core/datastructures/volume/volumebricked.h>
+#include <inviwo/core/datastructures/representationconverter.h>
+#include <inviwo/core/common/inviwoapplication.h>
 
 namespace inviwo {
 
@@ -98,6 +102,28 @@ double voxelVolume(const Volume& volume) {
     return glm::dot(glm::cross(a, b), c);
 }
 
+std::future<void> loadVolumeRAMAsync(std::shared_ptr<const Volume> volume) {
+    const auto load = [volume = std::move(volume)]() { volume->getRepresentation<VolumeRAM>(); };
+    if (InviwoApplication::isInitialized()) {
+        return dispatchPool(load);
+    } else {
+        std::packaged_task<void()> task{load};
+        task();
+        return task.get_future();
+    }
+}
+
+const VolumeBricked* getBrickedRepresentation(const Volume& volume) {
+    if (volume.hasRepresentation<VolumeBricked>() && !volume.hasRepresentation<VolumeRAM>()) {
+        try {
+            return volume.getRepresentation<VolumeBricked>();
+        } catch (const ConverterException&) {
+            // The bricks are outdated since another representation has been edited
+        }
+    }
+    return nullptr;
+}
+
 }  // namespace util
 
 }  // namespace inviwo
@@ -49,16 +49,20 @@
 #include <atomic>
 #include <vector>
 #include <string>
+#include <string_view>
+#include <array>
+#include <cstdint>
+#include <unordered_map>
 
 namespace inviwo {
 
 class AutoSaver {
 public:
     AutoSaver()
-        : path_{filesystem::getPath(PathType::Settings)}
+        : file_{filesystem::getPath(PathType::Settings) + "/autosave.invb"}
         , restored_{[this]() -> std::optional<std::string> {
-            if (filesystem::fileExists(path_ + "/autosave.inv")) {
-                auto ifstream = filesystem::ifstream(path_ + "/autosave.inv");
+            if (filesystem::fileExists(file_)) {
+                auto ifstream = filesystem::ifstream(file_, std::ios::in | std::ios::binary);
                 std::stringstream buffer;
                 buffer << ifstream.rdbuf();
                 return std::move(buffer).str();
@@ -86,9 +90,11 @@ public:
                 }
 
                 if (str) {
-                    auto ofstream = filesystem::ofstream(path_ + "/autosave.inv.tmp");
+                    auto ofstream =
+                        filesystem::ofstream(file_ + ".tmp", std::ios::out | std::ios::binary);
                     ofstream << *str;
-                    filesystem::copyFile(path_ + "/autosave.inv.tmp", path_ + "/autosave.inv");
+                    ofstream.close();
+                    filesystem::copyFile(file_ + ".tmp", file_);
                 }
             }
         }} {}
@@ -110,7 +116,7 @@ public:
     }
 
 private:
-    std::string path_;
+    std::string file_;  // binary encoded, see Serializer::writeBinary
     std::optional<std::string> restored_;
     std::atomic<bool> quit_;
     std::condition_variable condition_;
@@ -120,10 +126,92 @@ private:
     std::thread saver_;
 };
 
+/**
+ * Splits snapshots into content defined chunks and shares equal chunks between snapshots. The
+ * chunk boundaries are placed where a rolling hash of the preceding bytes matches a pattern, hence
+ * an edit only changes the chunks around it and the remaining chunks of the snapshot are found in
+ * the store. Every snapshot can be assembled on its own, there is no chain of deltas to replay.
+ */
+class SnapshotStore {
+public:
+    using Chunk = std::shared_ptr<const std::string>;
+    using Snapshot = std::vector<Chunk>;
+
+    Snapshot add(std::string_view data) {
+        Snapshot snapshot;
+        size_t start = 0;
+        std::uint64_t hash = 0;
+        for (size_t i = 0; i < data.size(); ++i) {
+            hash = (hash << 1) + gear[static_cast<std::uint8_t>(data[i])];
+            const auto size = i + 1 - start;
+            if ((size >= minChunkSize && (hash & boundaryMask) == 0) || size >= maxChunkSize) {
+                snapshot.push_back(intern(data.substr(start, size)));
+                start = i + 1;
+                hash = 0;
+            }
+        }
+        if (start < data.size()) snapshot.push_back(intern(data.substr(start)));
+        return snapshot;
+    }
+
+    static void write(const Snapshot& snapshot, std::ostream& stream) {
+        for (const auto& chunk : snapshot) {
+            stream.write(chunk->data(), static_cast<std::streamsize>(chunk->size()));
+        }
+    }
+
+    /**
+     * Remove chunks that are no longer used by any snapshot from the lookup.
+     */
+    void prune() {
+        for (auto it = chunks_.begin(); it != chunks_.end();) {
+            it = it->second.expired() ? chunks_.erase(it) : std::next(it);
+        }
+    }
+
+private:
+    // Chunks are between 512 bytes and 16 kB, about 2.5 kB on average
+    static constexpr size_t minChunkSize = 512;
+    static constexpr size_t maxChunkSize = 16384;
+    static constexpr std::uint64_t boundaryMask = std::uint64_t{0x7ff} << 53;
+
+    static constexpr std::array<std::uint64_t, 256> gear = []() {
+        std::array<std::uint64_t, 256> table{};
+        std::uint64_t state = 0;
+        for (auto& item : table) {  // splitmix64
+            state += 0x9e3779b97f4a7c15;
+            auto z = state;
+            z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+            z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+            item = z ^ (z >> 31);
+        }
+        return table;
+    }();
+
+    Chunk intern(std::string_view data) {
+        const auto key = std::hash<std::string_view>{}(data);
+        auto [begin, end] = chunks_.equal_range(key);
+        for (auto it = begin; it != end; ++it) {
+            if (auto chunk = it->second.lock(); chunk && *chunk == data) return chunk;
+        }
+        auto chunk = std::make_shared<const std::string>(data);
+        chunks_.emplace(key, chunk);
+        return chunk;
+    }
+
+    std::unordered_multimap<size_t, std::weak_ptr<const std::string>> chunks_;
+};
+
+namespace {
+// Property changes closer than this are merged into one undo step
+constexpr std::chrono::milliseconds coalesceInterval{500};
+}  // namespace
+
 UndoManager::UndoManager(InviwoMainWindow* mainWindow)
     : mainWindow_(mainWindow)
     , manager_{mainWindow_->getInviwoApplication()->getWorkspaceManager()}
     , refPath_{filesystem::findBasePath()}
+    , snapshots_{std::make_unique<SnapshotStore>()}
     , autoSaver_{std::make_unique<AutoSaver>()} {
 
     mainWindow_->getInviwoApplicationQt()->setUndoTrigger([this]() { pushStateIfDirty(); });
@@ -170,14 +258,28 @@ void UndoManager::pushState() {
         return;
     }
     auto str = std::make_shared<const std::string>(std::move(stream).str());
+    auto snapshot = snapshots_->add(*str);
 
     dirty_ = false;
-    if (head_ >= 0 && *str == *undoBuffer_[head_]) return;  // No Change
-
-    ++head_;
-    auto offset = std::min(std::distance(undoBuffer_.begin(), undoBuffer_.end()), head_);
-    undoBuffer_.erase(undoBuffer_.begin() + offset, undoBuffer_.end());
-    undoBuffer_.push_back(str);
+    if (head_ >= 0 && snapshot == undoBuffer_[head_]) return;  // No Change
+
+    // Merge rapid property changes on top of the stack into the last step
+    const auto now = std::chrono::steady_clock::now();
+    const bool coalesce = head_ > 0 && head_ + 1 == static_cast<DiffType>(undoBuffer_.size()) &&
+                          !structural_ && !headStructural_ && now - lastPush_ < coalesceInterval;
+    lastPush_ = now;
+    headStructural_ = structural_;
+    structural_ = false;
+
+    if (coalesce) {
+        undoBuffer_[head_] = std::move(snapshot);
+    } else {
+        ++head_;
+        auto offset = std::min(std::distance(undoBuffer_.begin(), undoBuffer_.end()), head_);
+        undoBuffer_.erase(undoBuffer_.begin() + offset, undoBuffer_.end());
+        undoBuffer_.push_back(std::move(snapshot));
+    }
+    snapshots_->prune();
 
     autoSaver_->save(str);
 
@@ -189,10 +291,11 @@ void UndoManager::undoState() {
         --head_;
 
         std::stringstream stream;
-        stream << *undoBuffer_[head_];
+        SnapshotStore::write(undoBuffer_[head_], stream);
         manager_->load(stream, refPath_);
 
         dirty_ = false;
+        headStructural_ = true;
         updateActions();
     }
 }
@@ -203,10 +306,11 @@ void UndoManager::redoState() {
         ++head_;
 
         std::stringstream stream;
-        stream << *undoBuffer_[head_];
+        SnapshotStore::write(undoBuffer_[head_], stream);
         manager_->load(stream, refPath_);
 
         dirty_ = false;
+        headStructural_ = true;
         updateActions();
     }
 }
@@ -214,6 +318,9 @@ void UndoManager::redoState() {
 void UndoManager::clear() {
     head_ = -1;
     undoBuffer_.clear();
+    snapshots_->prune();
+    structural_ = false;
+    headStructural_ = true;
 }
 
 QAction* UndoManager::getUndoAction() const { return undoAction_; }
@@ -243,10 +350,28 @@ void UndoManager::updateActions() {
 }
 
 void UndoManager::onProcessorNetworkChange() { dirty_ = true; }
-void UndoManager::onProcessorNetworkDidAddProcessor(Processor*) { dirty_ = true; }
-void UndoManager::onProcessorNetworkDidRemoveProcessor(Processor*) { dirty_ = true; }
-void UndoManager::onProcessorNetworkDidAddConnection(const PortConnection&) { dirty_ = true; }
-void UndoManager::onProcessorNetworkDidRemoveConnection(const PortConnection&) { dirty_ = true; }
-void UndoManager::onProcessorNetworkDidAddLink(const PropertyLink&) { dirty_ = true; }
-void UndoManager::onProcessorNetworkDidRemoveLink(const PropertyLink&) { dirty_ = true; }
+void UndoManager::onProcessorNetworkDidAddProcessor(Processor*) {
+    dirty_ = true;
+    structural_ = true;
+}
+void UndoManager::onProcessorNetworkDidRemoveProcessor(Processor*) {
+    dirty_ = true;
+    structural_ = true;
+}
+void UndoManager::onProcessorNetworkDidAddConnection(const PortConnection&) {
+    dirty_ = true;
+    structural_ = true;
+}
+void UndoManager::onProcessorNetworkDidRemoveConnection(const PortConnection&) {
+    dirty_ = true;
+    structural_ = true;
+}
+void UndoManager::onProcessorNetworkDidAddLink(const PropertyLink&) {
+    dirty_ = true;
+    structural_ = true;
+}
+void UndoManager::onProcessorNetworkDidRemoveLink(const PropertyLink&) {
+    dirty_ = true;
+    structural_ = true;
+}
 }  // namespace inviwo